@@ -0,0 +1,270 @@
+/* Benchmarks for the board module. */
+
+#include "board_bench.h"
+
+#include "common.h"
+#include "../main/board.h"
+#include "../main/common.h"
+#include "../main/threads.h"
+#include "../main/timer.h"
+#include "../main/win_scan.h"
+
+#include <stdio.h>
+#include <time.h>
+
+
+/* Approximate number of cells scanned per measurement, to keep the run time of
+   each measurement similar regardless of board size. */
+#define CELLS_PER_MEASUREMENT 5000000ul
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Fills a board with a dense pattern that contains no run longer than 2 for
+   either player, so every win check has to scan the whole board. */
+static void fillNoWinPattern(GameBoard* board)
+{
+    unsigned i = 0;
+    unsigned j = 0;
+
+    for (i = 0; i < board->rows; ++i)
+    {
+        for (j = 0; j < board->columns; ++j)
+        {
+            switch ((i + 2u * j) % 4u)
+            {
+                case 0:
+                case 1: setBoardCell(board, i, j, CELL_X); break;
+                case 2: setBoardCell(board, i, j, CELL_O); break;
+                default: break;
+            }
+        }
+    }
+}
+
+
+/* Times hasPlayerWon() on a board with the given backend.
+   Returns the average time per call in microseconds. */
+static double timeHasPlayerWon(unsigned size, unsigned winRequirement,
+    BoardBackend backend)
+{
+    GameBoard board = createGameBoardWithBackend(size, size, winRequirement,
+        backend);
+    unsigned long const cells = (unsigned long)size * size;
+    unsigned long reps = CELLS_PER_MEASUREMENT / cells;
+    unsigned long i = 0;
+    unsigned long wins = 0;
+    clock_t start;
+    double seconds = 0.0;
+
+    if (reps == 0)
+    {
+        reps = 1;
+    }
+
+    fillNoWinPattern(&board);
+
+    start = clock();
+    for (i = 0; i < reps; ++i)
+    {
+        wins += hasPlayerWon(&board, PLAYER_X);
+        wins += hasPlayerWon(&board, PLAYER_O);
+    }
+    seconds = secondsSince(start);
+
+    /* Also stops the calls being optimised away. */
+    if (wins != 0)
+    {
+        printf("Unexpected win in benchmark pattern.\n");
+    }
+
+    destroyGameBoard(&board);
+
+    return seconds * 1e6 / (reps * 2.0);
+}
+
+
+/* Compares hasPlayerWon() between the array and bitboard backends. */
+static void hasPlayerWonBenchmark(void)
+{
+    static unsigned const SIZES[] = {3, 15, 64, 1000};
+    static unsigned const WIN_REQUIREMENTS[] = {3, 5};
+    WinScanKernel const kernel = activeWinScanKernel();
+    unsigned i = 0;
+    unsigned j = 0;
+    double arrayTime = 0.0;
+    double bitTime = 0.0;
+
+    printf("hasPlayerWon() on a full board with no win, per call:\n");
+    printf("%10s %3s %14s %14s %8s\n", "size", "k", "array (us)",
+        "bitboard (us)", "speedup");
+
+    for (i = 0; i < sizeof SIZES / sizeof SIZES[0]; ++i)
+    {
+        for (j = 0; j < sizeof WIN_REQUIREMENTS / sizeof WIN_REQUIREMENTS[0];
+            ++j)
+        {
+            if (WIN_REQUIREMENTS[j] <= SIZES[i])
+            {
+                /* The array column is the cell by cell scan; the vector
+                   kernels have their own benchmark. */
+                selectWinScanKernel(WIN_SCAN_SCALAR);
+                arrayTime = timeHasPlayerWon(SIZES[i], WIN_REQUIREMENTS[j],
+                    BOARD_BACKEND_ARRAY);
+                selectWinScanKernel(kernel);
+                bitTime = timeHasPlayerWon(SIZES[i], WIN_REQUIREMENTS[j],
+                    BOARD_BACKEND_BITBOARD);
+                printf("%4ux%-5u %3u %14.3f %14.3f %7.1fx\n", SIZES[i],
+                    SIZES[i], WIN_REQUIREMENTS[j], arrayTime, bitTime,
+                    bitTime > 0.0 ? arrayTime / bitTime : 0.0);
+            }
+        }
+    }
+    printf("\n");
+}
+
+
+/* Compares the per-turn win check of hasPlayerWonAt() with the full scan of
+   hasPlayerWon(). */
+static void hasPlayerWonAtBenchmark(void)
+{
+    static unsigned const SIZE = 500;
+    static unsigned long const REPS = 1000000ul;
+    GameBoard board = createGameBoard(SIZE, SIZE, 5);
+    unsigned long i = 0;
+    unsigned long wins = 0;
+    clock_t start;
+    double atTime = 0.0;
+    double scanTime = 0.0;
+
+    fillNoWinPattern(&board);
+
+    start = clock();
+    for (i = 0; i < REPS; ++i)
+    {
+        wins += hasPlayerWonAt(&board, i % SIZE, (i / SIZE) % SIZE);
+    }
+    atTime = secondsSince(start) * 1e6 / REPS;
+
+    start = clock();
+    wins += hasPlayerWon(&board, PLAYER_X);
+    scanTime = secondsSince(start) * 1e6;
+
+    if (wins != 0)
+    {
+        printf("Unexpected win in benchmark pattern.\n");
+    }
+
+    printf("Per-turn win check on a %ux%u board, k=5, per call:\n", SIZE, SIZE);
+    printf("   hasPlayerWonAt(): %.3f us\n", atTime);
+    printf("   hasPlayerWon():   %.3f us\n", scanTime);
+    printf("\n");
+
+    destroyGameBoard(&board);
+}
+
+
+/* Compares hasPlayerWonParallel() with increasing numbers of threads against
+   hasPlayerWon(), on a large board with no win. */
+static void hasPlayerWonParallelBenchmark(void)
+{
+    static unsigned const SIZE = 4000;
+    GameBoard board = createGameBoardWithBackend(SIZE, SIZE, 5,
+        BOARD_BACKEND_ARRAY);
+    unsigned const processors = processorCount();
+    unsigned threads = 0;
+    unsigned long wins = 0;
+    double start = 0.0;
+    double sequential = 0.0;
+    double parallel = 0.0;
+
+    fillNoWinPattern(&board);
+
+    /* The bands are scanned one cell at a time too. */
+    selectWinScanKernel(WIN_SCAN_SCALAR);
+    start = monotonicSeconds();
+    wins += hasPlayerWon(&board, PLAYER_X);
+    sequential = monotonicSeconds() - start;
+    selectWinScanKernel(WIN_SCAN_AUTO);
+
+    printf("Full win scan of a %ux%u board, k=5:\n", SIZE, SIZE);
+    printf("%8s %12s %8s\n", "threads", "time (ms)", "speedup");
+    printf("%8s %12.1f %8s\n", "serial", sequential * 1e3, "1.0x");
+    for (threads = 1; threads <= processors; threads *= 2u)
+    {
+        start = monotonicSeconds();
+        wins += hasPlayerWonParallel(&board, PLAYER_X, threads);
+        parallel = monotonicSeconds() - start;
+        printf("%8u %12.1f %7.1fx\n", threads, parallel * 1e3,
+            parallel > 0.0 ? sequential / parallel : 0.0);
+    }
+
+    if (wins != 0)
+    {
+        printf("Unexpected win in benchmark pattern.\n");
+    }
+    printf("\n");
+
+    destroyGameBoard(&board);
+}
+
+
+/* Compares hasPlayerWon() with each supported win scan kernel on a large
+   board with no win. */
+static void winScanKernelBenchmark(void)
+{
+    static unsigned const SIZE = 2000;
+    static WinScanKernel const KERNELS[] = {WIN_SCAN_SCALAR, WIN_SCAN_SSE2,
+        WIN_SCAN_AVX2};
+    GameBoard board = createGameBoardWithBackend(SIZE, SIZE, 5,
+        BOARD_BACKEND_ARRAY);
+    unsigned long wins = 0;
+    unsigned i = 0;
+    double start = 0.0;
+    double scalar = 0.0;
+    double seconds = 0.0;
+
+    fillNoWinPattern(&board);
+
+    printf("Full win scan of a %ux%u board by kernel, k=5:\n", SIZE, SIZE);
+    printf("%8s %12s %8s\n", "kernel", "time (ms)", "speedup");
+    for (i = 0; i < sizeof KERNELS / sizeof KERNELS[0]; ++i)
+    {
+        if (selectWinScanKernel(KERNELS[i]))
+        {
+            start = monotonicSeconds();
+            wins += hasPlayerWon(&board, PLAYER_X);
+            seconds = monotonicSeconds() - start;
+            if (KERNELS[i] == WIN_SCAN_SCALAR)
+            {
+                scalar = seconds;
+            }
+            printf("%8s %12.1f %7.1fx\n", winScanKernelName(KERNELS[i]),
+                seconds * 1e3, seconds > 0.0 ? scalar / seconds : 0.0);
+        }
+    }
+    selectWinScanKernel(WIN_SCAN_AUTO);
+
+    if (wins != 0)
+    {
+        printf("Unexpected win in benchmark pattern.\n");
+    }
+    printf("\n");
+
+    destroyGameBoard(&board);
+}
+
+
+/* PUBLIC INTERFACE */
+
+
+void boardBenchmark(void)
+{
+    moduleBenchmarkHeader("board");
+
+    hasPlayerWonBenchmark();
+    hasPlayerWonAtBenchmark();
+    hasPlayerWonParallelBenchmark();
+    winScanKernelBenchmark();
+}
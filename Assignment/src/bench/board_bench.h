@@ -0,0 +1,11 @@
+/* Benchmarks for the board module. */
+
+#ifndef BENCH_BOARD_BENCH_H
+#define BENCH_BOARD_BENCH_H
+
+
+/* Runs the benchmarks for the board module. */
+void boardBenchmark(void);
+
+
+#endif
@@ -0,0 +1,24 @@
+/* Miscellaneous benchmarking utilities. */
+
+#include "common.h"
+
+#include <stdio.h>
+#include <time.h>
+
+
+/* PUBLIC INTERFACE */
+
+
+void moduleBenchmarkHeader(char const* moduleName)
+{
+    printf("~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n");
+    printf("%s module benchmark\n", moduleName);
+    printf("~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~\n");
+    printf("\n");
+}
+
+
+double secondsSince(clock_t start)
+{
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
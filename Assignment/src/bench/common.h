@@ -0,0 +1,15 @@
+/* Miscellaneous benchmarking utilities. */
+
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include <time.h>
+
+
+void moduleBenchmarkHeader(char const* moduleName);
+
+/* Returns the processor time in seconds elapsed since start. */
+double secondsSince(clock_t start);
+
+
+#endif
@@ -0,0 +1,96 @@
+/* Benchmarks for the log module. */
+
+/* For sysconf(). */
+#define _POSIX_C_SOURCE 200112L
+
+#include "log_bench.h"
+
+#include "common.h"
+#include "../main/common.h"
+#include "../main/log.h"
+#include "../main/timer.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+
+/* Moves logged by the benchmark, over games of MOVES_PER_GAME moves. */
+#define LOGGED_MOVES 1000000ul
+#define MOVES_PER_GAME 100ul
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Gets the resident memory of the process in bytes, from Linux's /proc.
+   Returns 0 if it's unavailable. */
+static unsigned long residentBytes(void)
+{
+    FILE* file = fopen("/proc/self/statm", "r");
+    unsigned long size = 0;
+    unsigned long resident = 0;
+    long const pageSize = sysconf(_SC_PAGESIZE);
+
+    if (file)
+    {
+        if (fscanf(file, "%lu %lu", &size, &resident) != 2 || pageSize <= 0)
+        {
+            resident = 0;
+        }
+        fclose(file);
+    }
+
+    return resident * (pageSize > 0 ? (unsigned long)pageSize : 0);
+}
+
+
+/* Measures logging a million moves into the game logs and freeing them. */
+static void logTurnBenchmark(void)
+{
+    unsigned long const before = residentBytes();
+    unsigned long after = 0;
+    unsigned long i = 0;
+    double start = monotonicSeconds();
+    double logSeconds = 0.0;
+    double freeSeconds = 0.0;
+
+    for (i = 0; i < LOGGED_MOVES; ++i)
+    {
+        if (i % MOVES_PER_GAME == 0)
+        {
+            newGameLog();
+        }
+        logTurn(i % 2u == 0 ? PLAYER_X : PLAYER_O, (unsigned)(i % 15u),
+            (unsigned)(i / 15u % 15u));
+    }
+    logSeconds = monotonicSeconds() - start;
+    after = residentBytes();
+
+    start = monotonicSeconds();
+    freeGameLogs();
+    freeSeconds = monotonicSeconds() - start;
+
+    printf("logTurn() for %lu moves in games of %lu:\n", LOGGED_MOVES,
+        MOVES_PER_GAME);
+    printf("   Logging: %.3fs (%.1f ns per move).\n", logSeconds,
+        logSeconds * 1e9 / LOGGED_MOVES);
+    printf("   freeGameLogs(): %.3fs.\n", freeSeconds);
+    if (before > 0 && after > 0)
+    {
+        printf("   Resident memory grew %.1f MB (%.1f bytes per move).\n",
+            (after > before ? after - before : 0) / 1e6,
+            (after > before ? after - before : 0) / (double)LOGGED_MOVES);
+    }
+    printf("\n");
+}
+
+
+/* PUBLIC INTERFACE */
+
+
+void logBenchmark(void)
+{
+    moduleBenchmarkHeader("log");
+
+    logTurnBenchmark();
+}
@@ -0,0 +1,11 @@
+/* Benchmarks for the log module. */
+
+#ifndef BENCH_LOG_BENCH_H
+#define BENCH_LOG_BENCH_H
+
+
+/* Runs the benchmarks for the log module. */
+void logBenchmark(void);
+
+
+#endif
@@ -0,0 +1,17 @@
+/* Benchmark entry point. */
+
+#include "board_bench.h"
+#include "log_bench.h"
+#include "mcts_bench.h"
+#include "search_bench.h"
+
+
+int main(void)
+{
+    boardBenchmark();
+    logBenchmark();
+    mctsBenchmark();
+    searchBenchmark();
+
+    return 0;
+}
@@ -0,0 +1,87 @@
+/* Benchmarks for the Monte Carlo tree search module. */
+
+#include "mcts_bench.h"
+
+#include "common.h"
+#include "../main/board.h"
+#include "../main/common.h"
+#include "../main/mcts.h"
+#include "../main/threads.h"
+
+#include <stdio.h>
+
+
+/* Wall-clock time given to each measurement. */
+#define SECONDS_PER_MEASUREMENT 2.0
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Measures playouts per second on a board with a few stones placed, using the
+   given number of threads. */
+static double playoutRate(unsigned size, unsigned winRequirement,
+    unsigned threads)
+{
+    GameBoard board = createGameBoard(size, size, winRequirement);
+    MctsLimits limits = defaultMctsLimits();
+    MctsResult result;
+    unsigned const centre = size / 2u;
+
+    setBoardCell(&board, centre, centre, CELL_X);
+    setBoardCell(&board, centre + 1u, centre, CELL_O);
+    setBoardCell(&board, centre, centre + 1u, CELL_X);
+
+    limits.threads = threads;
+    limits.maxSeconds = SECONDS_PER_MEASUREMENT;
+    result = mctsBestMove(&board, limits);
+
+    destroyGameBoard(&board);
+
+    return result.seconds > 0.0 ? result.playouts / result.seconds : 0.0;
+}
+
+
+/* Measures how playout throughput scales with the number of threads, up to
+   one per processor. */
+static void threadScalingBenchmark(void)
+{
+    unsigned const processors = processorCount();
+    unsigned threads = 1;
+    double single = 0.0;
+    double rate = 0.0;
+
+    printf("mctsBestMove() on a 19x19 board, k=5, %u processors:\n",
+        processors);
+    printf("%8s %16s %8s\n", "threads", "playouts/s", "speedup");
+
+    for (threads = 1; threads <= processors; threads *= 2u)
+    {
+        rate = playoutRate(19, 5, threads);
+        if (threads == 1)
+        {
+            single = rate;
+        }
+        printf("%8u %16.0f %7.2fx\n", threads, rate,
+            single > 0.0 ? rate / single : 0.0);
+    }
+    if (processors & (processors - 1u))
+    {
+        rate = playoutRate(19, 5, processors);
+        printf("%8u %16.0f %7.2fx\n", processors, rate,
+            single > 0.0 ? rate / single : 0.0);
+    }
+    printf("\n");
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+void mctsBenchmark(void)
+{
+    moduleBenchmarkHeader("mcts");
+
+    threadScalingBenchmark();
+}
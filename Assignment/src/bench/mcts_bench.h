@@ -0,0 +1,11 @@
+/* Benchmarks for the Monte Carlo tree search module. */
+
+#ifndef BENCH_MCTS_BENCH_H
+#define BENCH_MCTS_BENCH_H
+
+
+/* Runs the benchmarks for the Monte Carlo tree search module. */
+void mctsBenchmark(void);
+
+
+#endif
@@ -0,0 +1,106 @@
+/* Benchmarks for the alpha-beta search module. */
+
+#include "search_bench.h"
+
+#include "common.h"
+#include "../main/board.h"
+#include "../main/search.h"
+#include "../main/threads.h"
+#include "../main/transposition.h"
+
+#include <stdio.h>
+
+
+/* Iteration each measurement searches to. */
+#define BENCHMARK_DEPTH 8u
+
+/* Entries in the transposition table of each measurement. */
+#define BENCHMARK_TABLE_ENTRIES (1ul << 20)
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Searches a board with a few stones placed to a fixed depth with the given
+   number of threads, from an empty table. */
+static SearchResult timeToDepth(unsigned size, unsigned winRequirement,
+    unsigned threads)
+{
+    GameBoard board = createGameBoard(size, size, winRequirement);
+    TranspositionTable table = createTranspositionTable(
+        BENCHMARK_TABLE_ENTRIES);
+    SearchLimits limits = defaultSearchLimits();
+    SearchResult result;
+    unsigned const centre = size / 2u;
+
+    setBoardCell(&board, centre, centre, CELL_X);
+    setBoardCell(&board, centre + 1u, centre, CELL_O);
+    setBoardCell(&board, centre, centre + 1u, CELL_X);
+
+    limits.threads = threads;
+    limits.maxDepth = BENCHMARK_DEPTH;
+    limits.softSeconds = 600.0;
+    limits.maxSeconds = 600.0;
+    result = searchBestMove(&board, &table, limits);
+
+    destroyTranspositionTable(&table);
+    destroyGameBoard(&board);
+
+    return result;
+}
+
+
+/* Prints one row of the thread scaling table. */
+static void printScaling(SearchResult const* result, double singleSeconds)
+{
+    printf("%8u %10.2f %14.0f %8.1f%% %7.2fx\n", result->threads,
+        result->seconds, result->seconds > 0.0
+            ? result->nodes / result->seconds : 0.0,
+        result->ttProbes > 0 ? 100.0 * result->ttHits / result->ttProbes
+            : 0.0,
+        result->seconds > 0.0 ? singleSeconds / result->seconds : 0.0);
+}
+
+
+/* Measures how Lazy SMP speeds up reaching a fixed depth with the number of
+   threads, up to one per processor. */
+static void threadScalingBenchmark(void)
+{
+    unsigned const processors = processorCount();
+    unsigned threads = 1;
+    double single = 0.0;
+    SearchResult result;
+
+    printf("searchBestMove() to depth %u on a 15x15 board, k=5, "
+        "%u processors:\n", BENCHMARK_DEPTH, processors);
+    printf("%8s %10s %14s %9s %8s\n", "threads", "seconds", "nodes/s",
+        "TT hits", "speedup");
+
+    for (threads = 1; threads <= processors; threads *= 2u)
+    {
+        result = timeToDepth(15, 5, threads);
+        if (threads == 1)
+        {
+            single = result.seconds;
+        }
+        printScaling(&result, single);
+    }
+    if (processors & (processors - 1u))
+    {
+        result = timeToDepth(15, 5, processors);
+        printScaling(&result, single);
+    }
+    printf("\n");
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+void searchBenchmark(void)
+{
+    moduleBenchmarkHeader("search");
+
+    threadScalingBenchmark();
+}
@@ -0,0 +1,11 @@
+/* Benchmarks for the alpha-beta search module. */
+
+#ifndef BENCH_SEARCH_BENCH_H
+#define BENCH_SEARCH_BENCH_H
+
+
+/* Runs the benchmarks for the alpha-beta search module. */
+void searchBenchmark(void);
+
+
+#endif
@@ -0,0 +1,214 @@
+/* Bitboard storage for the game board. */
+
+#include "bitboard.h"
+
+#include "common.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Number of bits in each word of a bitplane. */
+#define WORD_BITS (CHAR_BIT * sizeof(unsigned long))
+
+
+/* Gets the index of a cell's bit within a bitplane. */
+static unsigned long bitIndex(BitBoard const* bits, unsigned row,
+    unsigned column)
+{
+    assert(row < bits->rows && column < bits->columns);
+
+    return row * bits->stride + column;
+}
+
+
+/* ANDs every bit of a plane with the bit shift places after it, in place.
+   Returns non-zero if any bits remain set.
+   The words past the end of the plane must be zero and there must be at least
+   shift / WORD_BITS + 1 of them. */
+static int shiftAnd(unsigned long* plane, size_t words, unsigned long shift)
+{
+    size_t const wordShift = shift / WORD_BITS;
+    unsigned const bitShift = shift % WORD_BITS;
+    unsigned long any = 0;
+    unsigned long shifted = 0;
+    size_t i = 0;
+
+    /* Ascending order means plane[i + wordShift] and the word after it have
+       not yet been overwritten when plane[i] is updated. */
+    for (i = 0; i < words; ++i)
+    {
+        shifted = plane[i + wordShift] >> bitShift;
+        if (bitShift != 0)
+        {
+            shifted |= plane[i + wordShift + 1] << (WORD_BITS - bitShift);
+        }
+        plane[i] &= shifted;
+        any |= plane[i];
+    }
+
+    return any != 0;
+}
+
+
+/* Checks for winRequirement consecutive bits spaced shift bits apart, using
+   scratch, of allocatedWords words, as working space. */
+static int hasRun(BitBoard const* bits, Player player, unsigned long shift,
+    unsigned winRequirement, unsigned long* scratch)
+{
+    int remaining = 0;
+    unsigned step = 1;
+    size_t i = 0;
+
+    memcpy(scratch, bits->planes[player],
+        bits->allocatedWords * sizeof(unsigned long));
+
+    for (i = 0; i < bits->words && !remaining; ++i)
+    {
+        remaining = scratch[i] != 0;
+    }
+
+    for (step = 1; step < winRequirement && remaining; ++step)
+    {
+        remaining = shiftAnd(scratch, bits->words, shift);
+    }
+
+    return remaining;
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+BitBoard zeroedBitBoard(void)
+{
+    BitBoard bits;
+
+    bits.rows = 0;
+    bits.columns = 0;
+    bits.stride = 0;
+    bits.words = 0;
+    bits.allocatedWords = 0;
+    bits.planes[PLAYER_X] = NULL;
+    bits.planes[PLAYER_O] = NULL;
+
+    return bits;
+}
+
+
+BitBoard createBitBoard(unsigned rows, unsigned columns)
+{
+    BitBoard bits = zeroedBitBoard();
+
+    assert(rows > 0);
+    assert(columns > 0);
+
+    bits.rows = rows;
+    bits.columns = columns;
+    bits.stride = columns + 1ul;
+    bits.words = (rows * bits.stride + WORD_BITS - 1u) / WORD_BITS;
+    /* The largest shift is one row plus one cell (falling diagonal). */
+    bits.allocatedWords = bits.words + (bits.stride + 1u) / WORD_BITS + 1u;
+
+    bits.planes[PLAYER_X] = malloc(bits.allocatedWords * sizeof(unsigned long));
+    bits.planes[PLAYER_O] = malloc(bits.allocatedWords * sizeof(unsigned long));
+
+    clearBitBoard(&bits);
+
+    return bits;
+}
+
+
+BitBoard copyBitBoard(BitBoard const* bits)
+{
+    BitBoard copy = createBitBoard(bits->rows, bits->columns);
+    size_t const size = bits->allocatedWords * sizeof(unsigned long);
+
+    memcpy(copy.planes[PLAYER_X], bits->planes[PLAYER_X], size);
+    memcpy(copy.planes[PLAYER_O], bits->planes[PLAYER_O], size);
+
+    return copy;
+}
+
+
+void destroyBitBoard(BitBoard* bits)
+{
+    free(bits->planes[PLAYER_X]);
+    free(bits->planes[PLAYER_O]);
+    *bits = zeroedBitBoard();
+}
+
+
+void clearBitBoard(BitBoard* bits)
+{
+    size_t const size = bits->allocatedWords * sizeof(unsigned long);
+
+    memset(bits->planes[PLAYER_X], 0, size);
+    memset(bits->planes[PLAYER_O], 0, size);
+}
+
+
+void setBitBoardBit(BitBoard* bits, Player player, unsigned row,
+    unsigned column, int value)
+{
+    unsigned long const index = bitIndex(bits, row, column);
+    unsigned long const mask = 1ul << (index % WORD_BITS);
+
+    if (value)
+    {
+        bits->planes[player][index / WORD_BITS] |= mask;
+    }
+    else
+    {
+        bits->planes[player][index / WORD_BITS] &= ~mask;
+    }
+}
+
+
+int getBitBoardBit(BitBoard const* bits, Player player, unsigned row,
+    unsigned column)
+{
+    unsigned long const index = bitIndex(bits, row, column);
+    unsigned long const word = bits->planes[player][index / WORD_BITS];
+
+    return (word >> (index % WORD_BITS)) & 1u;
+}
+
+
+int bitBoardHasWon(BitBoard const* bits, Player player,
+    unsigned winRequirement)
+{
+    /* Allocated per call rather than kept in the bitboard, so checking a
+       const board never writes to it. */
+    unsigned long* const scratch = malloc(bits->allocatedWords
+        * sizeof(unsigned long));
+    int win = 0;
+
+    assert(winRequirement > 0);
+
+    /* Row. */
+    win = win || hasRun(bits, player, 1u, winRequirement, scratch);
+
+    /* Column. */
+    win = win || hasRun(bits, player, bits->stride, winRequirement, scratch);
+
+    /* Rising diagonal (one row down, one cell left). The padding bit at the
+       end of each row stops runs wrapping around the left edge. */
+    win = win || hasRun(bits, player, bits->stride - 1u, winRequirement,
+        scratch);
+
+    /* Falling diagonal (one row down, one cell right). */
+    win = win || hasRun(bits, player, bits->stride + 1u, winRequirement,
+        scratch);
+
+    free(scratch);
+
+    return win;
+}
@@ -0,0 +1,63 @@
+/* Bitboard storage for the game board.
+   Each player has a bitplane with one bit per cell. Rows are padded with a
+   spare, always-zero bit so that shifting a plane never carries a run of cells
+   from the end of one row onto the start of the next. */
+
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include "common.h"
+
+#include <stddef.h>
+
+
+/* Bitboard data.
+   Use createBitBoard to properly create it, and destroyBitBoard to properly
+   destroy it. */
+typedef struct
+{
+    unsigned rows;              /* Height of the board. */
+    unsigned columns;           /* Width of the board. */
+    unsigned long stride;       /* Bits per padded row (columns + 1). */
+    size_t words;               /* Words in use per bitplane. */
+    size_t allocatedWords;      /* Words allocated per bitplane, including
+                                   zeroed words past the end for shifting. */
+    unsigned long* planes[2];   /* One bitplane per player, indexed by Player. */
+} BitBoard;
+
+
+/* Returns a BitBoard object with all members zeroed out. */
+BitBoard zeroedBitBoard(void);
+
+/* Creates an empty bitboard with the given dimensions.
+   rows and columns must both be >0. */
+BitBoard createBitBoard(unsigned rows, unsigned columns);
+
+/* Creates an independent copy of a bitboard. */
+BitBoard copyBitBoard(BitBoard const* bits);
+
+/* Destroys a bitboard (deallocates resources, etc.). */
+void destroyBitBoard(BitBoard* bits);
+
+/* Clears all bits of both players' bitplanes. */
+void clearBitBoard(BitBoard* bits);
+
+/* Sets or clears a player's bit for a cell.
+   row and column must be within the bounds of the board. */
+void setBitBoardBit(BitBoard* bits, Player player, unsigned row,
+    unsigned column, int value);
+
+/* Gets a player's bit for a cell.
+   row and column must be within the bounds of the board. */
+int getBitBoardBit(BitBoard const* bits, Player player, unsigned row,
+    unsigned column);
+
+/* Checks if a player has winRequirement consecutive bits set along any row,
+   column or diagonal.
+   Uses winRequirement - 1 shift-and steps per direction, in working space
+   allocated for the call, so threads may check the same bitboard at once. */
+int bitBoardHasWon(BitBoard const* bits, Player player,
+    unsigned winRequirement);
+
+
+#endif
@@ -2,17 +2,51 @@
 
 #include "board.h"
 
+#include "bitboard.h"
 #include "common.h"
+#include "render.h"
+#include "sparse_board.h"
+#include "threads.h"
+#include "win_scan.h"
+#include "window_counts.h"
 
 #include <assert.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 
 /* PRIVATE INTERFACE */
 
 
+/* Rows in each task of hasPlayerWonParallel(). */
+#define SCAN_BAND_ROWS 64ul
+
+/* Narrowest board hasPlayerWon() scans with a vector kernel. The kernels'
+   run buffers cost more than they save on narrower boards. */
+#define VECTOR_SCAN_MIN_COLUMNS 16u
+
+
+/* Largest part of a board of more than SPARSE_BOARD_THRESHOLD cells printed by
+   displayGameBoard(). */
+#define DISPLAY_VIEWPORT_ROWS 20u
+#define DISPLAY_VIEWPORT_COLUMNS 20u
+
+
+/* State shared by the threads of hasPlayerWonParallel(). */
+typedef struct
+{
+    GameBoard const* board;
+    CellStatus status;
+    /* Each thread's run lengths ending at each column of the row before the
+       one being scanned: down the columns, then down and right, then down
+       and left. */
+    unsigned* runs;
+    volatile int won;       /* Set once any thread finds a win. */
+} ParallelScan;
+
+
 /* Checks if the given status occurs consecutively enough along any row to be a
    win. */
 static int hasWonRow(GameBoard const* board, CellStatus status)
@@ -179,6 +213,194 @@ static int hasWonFallingDiagonal(GameBoard const* board, CellStatus status)
 }
 
 
+/* Checks if the line through a cell in the direction (rowStep, columnStep)
+   contains enough consecutive cells matching the cell's status to be a win. */
+static int hasWonLineAt(GameBoard const* board, unsigned row, unsigned column,
+    CellStatus status, int rowStep, int columnStep)
+{
+    unsigned const needed = board->winRequirement - 1u;
+    unsigned consecutive = 0;
+
+    consecutive = countBoardRun(board, row, column, status, rowStep,
+        columnStep, needed);
+    consecutive += countBoardRun(board, row, column, status, -rowStep,
+        -columnStep, needed - consecutive);
+
+    return consecutive >= needed;
+}
+
+
+/* Checks if the given status has a win through any of its cells on a board
+   using BOARD_BACKEND_SPARSE. */
+static int hasWonSparse(GameBoard const* board, CellStatus status)
+{
+    int win = 0;
+    size_t i = 0;
+    SparseCell const* cell = NULL;
+
+    for (i = 0; i < board->sparse.capacity && !win; ++i)
+    {
+        cell = board->sparse.slots + i;
+        if (cell->value == (unsigned char)status)
+        {
+            win = hasPlayerWonAt(board, cell->row, cell->column);
+        }
+    }
+
+    return win;
+}
+
+
+/* Task function for runWorkStealing() checking for wins starting in the band
+   of rows with the given index. Runs down the board are counted from the top
+   of the band, and followed up to winRequirement - 1 rows past its end, so
+   every window is checked by the band holding its top cell. */
+static void scanBandTask(unsigned long index, unsigned worker, void* context)
+{
+    ParallelScan* const scan = context;
+    GameBoard const* const board = scan->board;
+    unsigned const k = board->winRequirement;
+    unsigned* const columnRuns = scan->runs
+        + (size_t)worker * 3u * board->columns;
+    unsigned* const fallingRuns = columnRuns + board->columns;
+    unsigned* const risingRuns = fallingRuns + board->columns;
+    unsigned long const first = index * SCAN_BAND_ROWS;
+    unsigned long const end = first + SCAN_BAND_ROWS < board->rows
+        ? first + SCAN_BAND_ROWS : board->rows;
+    unsigned long const last = end + k - 1u < board->rows
+        ? end + k - 1u : board->rows;
+    unsigned long i = 0;
+    unsigned j = 0;
+    unsigned rowRun = 0;
+    unsigned aboveLeft = 0;
+    unsigned above = 0;
+    int match = 0;
+    int win = 0;
+
+    memset(columnRuns, 0, 3u * board->columns * sizeof(unsigned));
+
+    for (i = first; i < last && !win && !scan->won; ++i)
+    {
+        rowRun = 0;
+        aboveLeft = 0;
+        for (j = 0; j < board->columns && !win; ++j)
+        {
+            match = getBoardCell(board, i, j) == scan->status;
+            /* Runs from the row above, before this row overwrites them. */
+            above = fallingRuns[j];
+            fallingRuns[j] = match ? aboveLeft + 1u : 0;
+            aboveLeft = above;
+            risingRuns[j] = !match ? 0
+                : j + 1u < board->columns ? risingRuns[j + 1u] + 1u : 1u;
+            columnRuns[j] = match ? columnRuns[j] + 1u : 0;
+            /* Rows past the band are the next band's. */
+            rowRun = match && i < end ? rowRun + 1u : 0;
+
+            win = rowRun >= k || columnRuns[j] >= k || fallingRuns[j] >= k
+                || risingRuns[j] >= k;
+        }
+    }
+
+    if (win)
+    {
+        scan->won = 1;
+    }
+}
+
+
+/* Stores the status of a cell in the board's backend, without updating
+   anything else. */
+static void storeCell(GameBoard* board, unsigned row, unsigned column,
+    CellStatus status)
+{
+    switch (board->backend)
+    {
+        case BOARD_BACKEND_ARRAY:
+            board->cells[row * board->columns + column] = status;
+            break;
+        case BOARD_BACKEND_BITBOARD:
+            setBitBoardBit(&board->bits, PLAYER_X, row, column,
+                status == CELL_X);
+            setBitBoardBit(&board->bits, PLAYER_O, row, column,
+                status == CELL_O);
+            break;
+        case BOARD_BACKEND_SPARSE:
+            /* CELL_EMPTY is 0, which removes the cell from the table. */
+            setSparseCell(&board->sparse, row, column, (unsigned char)status);
+            break;
+        default:
+            assert(0);
+    }
+}
+
+
+/* Updates the board's window counts, if it has them, for a cell changing from
+   previous to status. */
+static void updateCellWindows(GameBoard* board, unsigned row,
+    unsigned column, CellStatus previous, CellStatus status)
+{
+    if (hasWindowCounts(board))
+    {
+        if (previous != CELL_EMPTY)
+        {
+            updateWindowCounts(&board->windows,
+                previous == CELL_X ? PLAYER_X : PLAYER_O, row, column, 0);
+        }
+        if (status != CELL_EMPTY)
+        {
+            updateWindowCounts(&board->windows,
+                status == CELL_X ? PLAYER_X : PLAYER_O, row, column, 1);
+        }
+    }
+}
+
+
+/* Updates the hashes of the board's symmetric images, other than the
+   identity, for a cell changing from previous to status. */
+static void updateSymmetryHashes(GameBoard* board, unsigned row,
+    unsigned column, CellStatus previous, CellStatus status)
+{
+    unsigned const symmetries = countBoardSymmetries(board);
+    unsigned imageRow = 0;
+    unsigned imageColumn = 0;
+    unsigned s = 0;
+
+    for (s = 1; s < symmetries; ++s)
+    {
+        imageRow = row;
+        imageColumn = column;
+        transformCell(board, s, &imageRow, &imageColumn);
+        board->symmetryHashes[s] ^= cellHashKey(imageRow, imageColumn,
+            previous) ^ cellHashKey(imageRow, imageColumn, status);
+    }
+}
+
+
+/* Grows a bounding rectangle to include the given cell.
+   If first is non-zero, the rectangle is set to just that cell. */
+static void includeInBounds(unsigned row, unsigned column, int first,
+    unsigned* minRow, unsigned* minColumn, unsigned* maxRow,
+    unsigned* maxColumn)
+{
+    if (first || row < *minRow)
+    {
+        *minRow = row;
+    }
+    if (first || row > *maxRow)
+    {
+        *maxRow = row;
+    }
+    if (first || column < *minColumn)
+    {
+        *minColumn = column;
+    }
+    if (first || column > *maxColumn)
+    {
+        *maxColumn = column;
+    }
+}
+
+
 
 /* PUBLIC INTERFACE */
 
@@ -186,10 +408,25 @@ static int hasWonFallingDiagonal(GameBoard const* board, CellStatus status)
 GameBoard zeroedGameBoard(void)
 {
     GameBoard board;
+    unsigned i = 0;
 
     board.rows = 0;
     board.columns = 0;
     board.winRequirement = 0;
+    board.backend = BOARD_BACKEND_ARRAY;
+    board.hash = 0;
+    for (i = 0; i < BOARD_SYMMETRIES; ++i)
+    {
+        board.symmetryHashes[i] = 0;
+    }
+    board.occupied = 0;
+    board.cells = NULL;
+    board.bits = zeroedBitBoard();
+    board.sparse = zeroedSparseBoard();
+    board.windows = zeroedWindowCounts();
+    board.moves = NULL;
+    board.moveCount = 0;
+    board.moveCapacity = 0;
 
     return board;
 }
@@ -198,16 +435,49 @@ GameBoard zeroedGameBoard(void)
 GameBoard createGameBoard(unsigned rows, unsigned columns,
     unsigned winRequirement)
 {
-    GameBoard board;
+    BoardBackend backend = BOARD_BACKEND_ARRAY;
+
+    assert(columns > 0);
+
+    /* Divide rather than multiply so huge dimensions can't overflow. */
+    if (rows > SPARSE_BOARD_THRESHOLD / columns)
+    {
+        backend = BOARD_BACKEND_SPARSE;
+    }
+
+    return createGameBoardWithBackend(rows, columns, winRequirement, backend);
+}
+
+
+GameBoard createGameBoardWithBackend(unsigned rows, unsigned columns,
+    unsigned winRequirement, BoardBackend backend)
+{
+    GameBoard board = zeroedGameBoard();
 
     assert(rows > 0);
     assert(columns > 0);
     assert(winRequirement > 0);
 
-    board.cells = malloc(rows * columns * sizeof(CellStatus));
     board.rows = rows;
     board.columns = columns;
     board.winRequirement = winRequirement;
+    board.backend = backend;
+
+    switch (backend)
+    {
+        case BOARD_BACKEND_ARRAY:
+            assert(rows <= (size_t)-1 / sizeof(CellStatus) / columns);
+            board.cells = malloc((size_t)rows * columns * sizeof(CellStatus));
+            break;
+        case BOARD_BACKEND_BITBOARD:
+            board.bits = createBitBoard(rows, columns);
+            break;
+        case BOARD_BACKEND_SPARSE:
+            board.sparse = createSparseBoard();
+            break;
+        default:
+            assert(0);
+    }
 
     clearBoardCells(&board);
 
@@ -215,52 +485,290 @@ GameBoard createGameBoard(unsigned rows, unsigned columns,
 }
 
 
+GameBoard copyGameBoard(GameBoard const* board)
+{
+    GameBoard copy = copyGameBoardWithoutWindowCounts(board);
+
+    if (hasWindowCounts(board))
+    {
+        copy.windows = copyWindowCounts(&board->windows);
+    }
+
+    return copy;
+}
+
+
+GameBoard copyGameBoardWithoutWindowCounts(GameBoard const* board)
+{
+    GameBoard copy = *board;
+    size_t const size = (size_t)board->rows * board->columns
+        * sizeof(CellStatus);
+
+    switch (board->backend)
+    {
+        case BOARD_BACKEND_ARRAY:
+            copy.cells = malloc(size);
+            memcpy(copy.cells, board->cells, size);
+            break;
+        case BOARD_BACKEND_BITBOARD:
+            copy.bits = copyBitBoard(&board->bits);
+            break;
+        case BOARD_BACKEND_SPARSE:
+            copy.sparse = copySparseBoard(&board->sparse);
+            break;
+        default:
+            assert(0);
+    }
+
+    copy.windows = zeroedWindowCounts();
+    copy.moveCapacity = board->moveCount;
+    copy.moves = NULL;
+    if (board->moveCount > 0)
+    {
+        copy.moves = malloc(board->moveCount * sizeof(BoardMove));
+        memcpy(copy.moves, board->moves, board->moveCount * sizeof(BoardMove));
+    }
+
+    return copy;
+}
+
+
 void destroyGameBoard(GameBoard* board)
 {
+    unsigned s = 0;
+
     board->rows = 0;
     board->columns = 0;
     board->winRequirement = 0;
+    board->hash = 0;
+    for (s = 0; s < BOARD_SYMMETRIES; ++s)
+    {
+        board->symmetryHashes[s] = 0;
+    }
+    board->occupied = 0;
     free(board->cells);
     board->cells = NULL;
+    destroyBitBoard(&board->bits);
+    destroySparseBoard(&board->sparse);
+    destroyWindowCounts(&board->windows);
+    free(board->moves);
+    board->moves = NULL;
+    board->moveCount = 0;
+    board->moveCapacity = 0;
 }
 
 
 void clearBoardCells(GameBoard* board)
 {
+    size_t const cells = (size_t)board->rows * board->columns;
+    size_t i = 0;
+    unsigned s = 0;
+
+    switch (board->backend)
+    {
+        case BOARD_BACKEND_ARRAY:
+            for (i = 0; i < cells; ++i)
+            {
+                board->cells[i] = CELL_EMPTY;
+            }
+            break;
+        case BOARD_BACKEND_BITBOARD:
+            clearBitBoard(&board->bits);
+            break;
+        case BOARD_BACKEND_SPARSE:
+            clearSparseBoard(&board->sparse);
+            break;
+        default:
+            assert(0);
+    }
+
+    if (hasWindowCounts(board))
+    {
+        clearWindowCounts(&board->windows);
+    }
+
+    board->hash = 0;
+    for (s = 0; s < BOARD_SYMMETRIES; ++s)
+    {
+        board->symmetryHashes[s] = 0;
+    }
+    board->occupied = 0;
+    board->moveCount = 0;
+}
+
+
+void enableWindowCounts(GameBoard* board)
+{
+    CellStatus status = CELL_EMPTY;
     unsigned i = 0;
     unsigned j = 0;
 
+    assert(board->backend != BOARD_BACKEND_SPARSE);
+    assert(!hasWindowCounts(board));
+
+    board->windows = createWindowCounts(board->rows, board->columns,
+        board->winRequirement);
     for (i = 0; i < board->rows; ++i)
     {
         for (j = 0; j < board->columns; ++j)
         {
-            setBoardCell(board, i, j, CELL_EMPTY);
+            status = getBoardCell(board, i, j);
+            if (status != CELL_EMPTY)
+            {
+                updateWindowCounts(&board->windows,
+                    status == CELL_X ? PLAYER_X : PLAYER_O, i, j, 1);
+            }
         }
     }
 }
 
 
+int hasWindowCounts(GameBoard const* board)
+{
+    return board->windows.counts != NULL;
+}
+
+
+int enableSmallWindowCounts(GameBoard* board)
+{
+    if (!hasWindowCounts(board) && board->backend != BOARD_BACKEND_SPARSE
+        && board->rows <= WINDOW_COUNTS_MAX_CELLS / board->columns)
+    {
+        enableWindowCounts(board);
+    }
+
+    return hasWindowCounts(board);
+}
+
+
+int isDeadDraw(GameBoard const* board)
+{
+    assert(hasWindowCounts(board));
+
+    return windowCountsAllDead(&board->windows);
+}
+
+
 int hasPlayerWon(GameBoard const* board, Player player)
 {
     int win = 0;
     CellStatus cellStatus = playerToCell(player);
 
-    /* Check for a win along a row. */
-    win = win || hasWonRow(board, cellStatus);
+    if (hasWindowCounts(board))
+    {
+        /* Any win fills at least one window. */
+        win = windowCountsHasWon(&board->windows, player);
+    }
+    else if (board->backend == BOARD_BACKEND_BITBOARD)
+    {
+        /* Shift-and over whole bitplanes covers all four directions. */
+        win = bitBoardHasWon(&board->bits, player, board->winRequirement);
+    }
+    else if (board->backend == BOARD_BACKEND_SPARSE)
+    {
+        /* Scanning every row of a huge board is out of the question, but any
+           win must pass through one of the player's occupied cells. */
+        win = hasWonSparse(board, cellStatus);
+    }
+    else if (board->columns >= VECTOR_SCAN_MIN_COLUMNS
+        && activeWinScanKernel() != WIN_SCAN_SCALAR)
+    {
+        win = vectorHasWon(board, cellStatus, activeWinScanKernel());
+    }
+    else
+    {
+        /* Check for a win along a row. */
+        win = win || hasWonRow(board, cellStatus);
+
+        /* Check for a win along a column. */
+        win = win || hasWonColumn(board, cellStatus);
+
+        /* Check for a win along a rising diagonal.*/
+        win = win || hasWonRisingDiagonal(board, cellStatus);
+
+        /* Check for a win along a falling diagonal. */
+        win = win || hasWonFallingDiagonal(board, cellStatus);
+    }
+
+    return win;
+}
+
+
+int hasPlayerWonParallel(GameBoard const* board, Player player,
+    unsigned threads)
+{
+    ParallelScan scan;
+    int win = 0;
+
+    assert(threads > 0);
 
-    /* Check for a win along a column. */
-    win = win || hasWonColumn(board, cellStatus);
+    if (hasWindowCounts(board) || board->backend != BOARD_BACKEND_ARRAY)
+    {
+        /* Already faster than any scan of the cells. */
+        win = hasPlayerWon(board, player);
+    }
+    else
+    {
+        scan.board = board;
+        scan.status = playerToCell(player);
+        scan.runs = malloc((size_t)threads * 3u * board->columns
+            * sizeof(unsigned));
+        scan.won = 0;
 
-    /* Check for a win along a rising diagonal.*/
-    win = win || hasWonRisingDiagonal(board, cellStatus);
+        runWorkStealing((board->rows + SCAN_BAND_ROWS - 1u) / SCAN_BAND_ROWS,
+            threads, scanBandTask, &scan, NULL);
 
-    /* Check for a win along a falling diagonal. */
-    win = win || hasWonFallingDiagonal(board, cellStatus);
+        win = scan.won;
+        free(scan.runs);
+    }
 
     return win;
 }
 
 
+int hasPlayerWonAt(GameBoard const* board, unsigned row, unsigned column)
+{
+    int win = 0;
+    CellStatus const status = getBoardCell(board, row, column);
+
+    if (status != CELL_EMPTY)
+    {
+        /* Check the row. */
+        win = win || hasWonLineAt(board, row, column, status, 0, 1);
+
+        /* Check the column. */
+        win = win || hasWonLineAt(board, row, column, status, 1, 0);
+
+        /* Check the rising diagonal. */
+        win = win || hasWonLineAt(board, row, column, status, -1, 1);
+
+        /* Check the falling diagonal. */
+        win = win || hasWonLineAt(board, row, column, status, 1, 1);
+    }
+
+    return win;
+}
+
+
+unsigned countBoardRun(GameBoard const* board, unsigned row, unsigned column,
+    CellStatus status, int rowStep, int columnStep, unsigned limit)
+{
+    unsigned count = 0;
+    long i = (long)row + rowStep;
+    long j = (long)column + columnStep;
+
+    while (count < limit && i >= 0 && j >= 0 && inBoardBounds(board, i, j)
+        && getBoardCell(board, i, j) == status)
+    {
+        ++count;
+        i += rowStep;
+        j += columnStep;
+    }
+
+    return count;
+}
+
+
 int inBoardBounds(GameBoard const* board, unsigned row, unsigned column)
 {
     return row < board->rows && column < board->columns;
@@ -269,68 +777,324 @@ int inBoardBounds(GameBoard const* board, unsigned row, unsigned column)
 
 void setBoardCell(GameBoard* board, unsigned row, unsigned column, CellStatus status)
 {
-    assert(inBoardBounds(board, row, column));
+    CellStatus const previous = getBoardCell(board, row, column);
 
-    board->cells[row * board->columns + column] = status;
+    board->hash ^= cellHashKey(row, column, previous)
+        ^ cellHashKey(row, column, status);
+    board->symmetryHashes[0] = board->hash;
+    updateSymmetryHashes(board, row, column, previous, status);
+    if (previous == CELL_EMPTY && status != CELL_EMPTY)
+    {
+        ++board->occupied;
+    }
+    else if (previous != CELL_EMPTY && status == CELL_EMPTY)
+    {
+        --board->occupied;
+    }
+
+    storeCell(board, row, column, status);
+    updateCellWindows(board, row, column, previous, status);
+}
+
+
+void makeMove(GameBoard* board, unsigned row, unsigned column,
+    CellStatus status)
+{
+    BoardMove* move = NULL;
+
+    if (board->moveCount == board->moveCapacity)
+    {
+        board->moveCapacity = board->moveCapacity > 0
+            ? 2u * board->moveCapacity : 64u;
+        board->moves = realloc(board->moves,
+            board->moveCapacity * sizeof(BoardMove));
+    }
+
+    move = board->moves + board->moveCount;
+    move->row = row;
+    move->column = column;
+    move->previous = getBoardCell(board, row, column);
+    move->hash = board->hash;
+    move->occupied = board->occupied;
+    ++board->moveCount;
+
+    setBoardCell(board, row, column, status);
+}
+
+
+BoardMove unmakeMove(GameBoard* board)
+{
+    BoardMove move;
+    CellStatus status = CELL_EMPTY;
+
+    assert(board->moveCount > 0);
+
+    --board->moveCount;
+    move = board->moves[board->moveCount];
+    status = getBoardCell(board, move.row, move.column);
+
+    storeCell(board, move.row, move.column, move.previous);
+    updateCellWindows(board, move.row, move.column, status, move.previous);
+    updateSymmetryHashes(board, move.row, move.column, status, move.previous);
+    board->hash = move.hash;
+    board->symmetryHashes[0] = move.hash;
+    board->occupied = move.occupied;
+
+    return move;
 }
 
 
 CellStatus getBoardCell(GameBoard const* board, unsigned row, unsigned column)
 {
+    CellStatus status = CELL_EMPTY;
+
     assert(inBoardBounds(board, row, column));
 
-    return board->cells[row * board->columns + column];
+    switch (board->backend)
+    {
+        case BOARD_BACKEND_ARRAY:
+            status = board->cells[row * board->columns + column];
+            break;
+        case BOARD_BACKEND_BITBOARD:
+            if (getBitBoardBit(&board->bits, PLAYER_X, row, column))
+            {
+                status = CELL_X;
+            }
+            else if (getBitBoardBit(&board->bits, PLAYER_O, row, column))
+            {
+                status = CELL_O;
+            }
+            break;
+        case BOARD_BACKEND_SPARSE:
+            status = (CellStatus)getSparseCell(&board->sparse, row, column);
+            break;
+        default:
+            assert(0);
+    }
+
+    return status;
 }
 
 
-void displayGameBoard(GameBoard const* board)
+Player nextPlayer(GameBoard const* board)
 {
-    static char const X_CHAR = 'X';
-    static char const O_CHAR = 'O';
-    static char const EMPTY_CHAR = ' ';
+    return board->occupied % 2u == 0 ? PLAYER_X : PLAYER_O;
+}
 
-    unsigned const horizontalDividerWidth = board->columns * 4 + 1;
+
+int getOccupiedBounds(GameBoard const* board, unsigned* minRow,
+    unsigned* minColumn, unsigned* maxRow, unsigned* maxColumn)
+{
+    int found = 0;
     unsigned i = 0;
     unsigned j = 0;
-    char cell;
+    size_t slot = 0;
+    SparseCell const* cell = NULL;
 
-    /* Top border. */
-    for (i = 0; i < horizontalDividerWidth; ++i)
+    if (board->backend == BOARD_BACKEND_SPARSE)
     {
-        printf("-");
+        for (slot = 0; slot < board->sparse.capacity; ++slot)
+        {
+            cell = board->sparse.slots + slot;
+            if (cell->value != 0)
+            {
+                includeInBounds(cell->row, cell->column, !found, minRow,
+                    minColumn, maxRow, maxColumn);
+                found = 1;
+            }
+        }
+    }
+    else if (board->occupied > 0)
+    {
+        for (i = 0; i < board->rows; ++i)
+        {
+            for (j = 0; j < board->columns; ++j)
+            {
+                if (getBoardCell(board, i, j) != CELL_EMPTY)
+                {
+                    includeInBounds(i, j, !found, minRow, minColumn, maxRow,
+                        maxColumn);
+                    found = 1;
+                }
+            }
+        }
     }
-    printf("\n");
 
-    /* Board body. */
-    for (i = 0; i < board->rows; ++i)
+    return found;
+}
+
+
+int hasNeighbour(GameBoard const* board, unsigned row, unsigned column)
+{
+    int found = 0;
+    int i = 0;
+    int j = 0;
+    long r = 0;
+    long c = 0;
+
+    for (i = -1; i <= 1 && !found; ++i)
     {
-        printf("|");
-        for (j = 0; j < board->columns; ++j)
+        for (j = -1; j <= 1 && !found; ++j)
         {
-            switch (getBoardCell(board, i, j))
+            r = (long)row + i;
+            c = (long)column + j;
+            if ((i != 0 || j != 0) && r >= 0 && c >= 0
+                && inBoardBounds(board, r, c))
             {
-                case CELL_X:
-                    cell = X_CHAR;
-                    break;
-                case CELL_O:
-                    cell = O_CHAR;
-                    break;
-                case CELL_EMPTY:
-                    cell = EMPTY_CHAR;
-                    break;
-                default:
-                    assert(0);
+                found = getBoardCell(board, r, c) != CELL_EMPTY;
             }
-            printf(" %c |", cell);
         }
-        printf("\n");
+    }
+
+    return found;
+}
+
+
+unsigned long cellHashKey(unsigned row, unsigned column, CellStatus status)
+{
+    unsigned long key = 0;
+
+    if (status != CELL_EMPTY)
+    {
+        /* SplitMix64 finaliser over the cell's coordinates and status. */
+        key = ((unsigned long)row * 0x9E3779B97F4A7C15ul)
+            ^ ((unsigned long)column * 0xC2B2AE3D27D4EB4Ful)
+            ^ ((unsigned long)status * 0x165667B19E3779F9ul);
+        key ^= key >> 30;
+        key *= 0xBF58476D1CE4E5B9ul;
+        key ^= key >> 27;
+        key *= 0x94D049BB133111EBul;
+        key ^= key >> 31;
+    }
+
+    return key;
+}
+
+
+unsigned countBoardSymmetries(GameBoard const* board)
+{
+    return board->rows == board->columns ? BOARD_SYMMETRIES : 4u;
+}
+
+
+void transformCell(GameBoard const* board, unsigned symmetry, unsigned* row,
+    unsigned* column)
+{
+    unsigned const lastRow = board->rows - 1u;
+    unsigned const lastColumn = board->columns - 1u;
+    unsigned const r = *row;
+    unsigned const c = *column;
+
+    assert(symmetry < countBoardSymmetries(board));
+
+    switch (symmetry)
+    {
+        case 0:
+            break;
+        case 1:
+            *row = lastRow - r;
+            *column = lastColumn - c;
+            break;
+        case 2:
+            *column = lastColumn - c;
+            break;
+        case 3:
+            *row = lastRow - r;
+            break;
+        case 4:
+            *row = c;
+            *column = r;
+            break;
+        case 5:
+            *row = lastColumn - c;
+            *column = lastRow - r;
+            break;
+        case 6:
+            *row = c;
+            *column = lastRow - r;
+            break;
+        case 7:
+            *row = lastColumn - c;
+            *column = r;
+            break;
+        default:
+            assert(0);
+    }
+}
+
+
+void untransformCell(GameBoard const* board, unsigned symmetry,
+    unsigned* row, unsigned* column)
+{
+    /* The quarter turns undo each other, and the rest undo themselves. */
+    if (symmetry == 6u)
+    {
+        symmetry = 7u;
+    }
+    else if (symmetry == 7u)
+    {
+        symmetry = 6u;
+    }
+
+    transformCell(board, symmetry, row, column);
+}
 
-        for (j = 0; j < horizontalDividerWidth; ++j)
+
+unsigned canonicalSymmetry(GameBoard const* board)
+{
+    unsigned const symmetries = countBoardSymmetries(board);
+    unsigned best = 0;
+    unsigned s = 0;
+
+    for (s = 1; s < symmetries; ++s)
+    {
+        if (board->symmetryHashes[s] < board->symmetryHashes[best])
         {
-            printf("-");
+            best = s;
         }
-        printf("\n");
     }
+
+    return best;
+}
+
+
+unsigned long canonicalHash(GameBoard const* board)
+{
+    return board->symmetryHashes[canonicalSymmetry(board)];
+}
+
+
+int displayGameBoard(GameBoard const* board)
+{
+    FrameBuffer frame = zeroedFrameBuffer();
+    Viewport viewport = fullViewport(board);
+    unsigned minRow = board->rows / 2u;
+    unsigned minColumn = board->columns / 2u;
+    unsigned maxRow = minRow;
+    unsigned maxColumn = minColumn;
+    int const windowed = (unsigned long)board->rows * board->columns
+        > SPARSE_BOARD_THRESHOLD;
+    int res = 1;
+
+    /* Centred on the occupied cells, or the middle of an empty board. */
+    if (windowed)
+    {
+        getOccupiedBounds(board, &minRow, &minColumn, &maxRow, &maxColumn);
+        viewport = viewportAround(board, minRow + (maxRow - minRow) / 2u,
+            minColumn + (maxColumn - minColumn) / 2u, DISPLAY_VIEWPORT_ROWS,
+            DISPLAY_VIEWPORT_COLUMNS);
+        res = printf("Columns %u-%u, rows %u-%u of %ux%u:\n",
+            viewport.firstColumn, viewport.firstColumn + viewport.columns - 1u,
+            viewport.firstRow, viewport.firstRow + viewport.rows - 1u,
+            board->columns, board->rows) > 0;
+    }
+
+    res = res && renderBoard(&frame, board, &viewport, windowed)
+        && writeFrame(&frame, stdout);
+
+    destroyFrameBuffer(&frame);
+
+    return res;
 }
 
 
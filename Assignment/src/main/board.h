@@ -5,7 +5,10 @@
 #define BOARD_H
 
 
+#include "bitboard.h"
 #include "common.h"
+#include "sparse_board.h"
+#include "window_counts.h"
 
 
 /* Represents a cell in the tic-tac-toe board. */
@@ -17,6 +20,44 @@ typedef enum
 } CellStatus;
 
 
+/* Selects how the cells of a GameBoard are stored. */
+typedef enum
+{
+    BOARD_BACKEND_ARRAY,    /* One CellStatus per cell, scanned for wins. */
+    BOARD_BACKEND_BITBOARD, /* One bitplane per player, shift-and win check. */
+    BOARD_BACKEND_SPARSE    /* Hash table of occupied cells only. */
+} BoardBackend;
+
+
+/* Boards with more cells than this are created with BOARD_BACKEND_SPARSE by
+   createGameBoard(). A full array of this many cells is already 64MB, and games
+   on boards this large only ever fill a tiny fraction of them. */
+#define SPARSE_BOARD_THRESHOLD (1ul << 24)
+
+/* Boards with more cells than this don't get window counts from
+   enableSmallWindowCounts(). The counts take 32 bytes per cell. */
+#define WINDOW_COUNTS_MAX_CELLS (1ul << 20)
+
+
+/* Number of rotations and reflections of a board, counting the identity.
+   Symmetry 0 is the identity, 1 the half turn, 2 and 3 the left-right and
+   top-bottom mirror images, 4 and 5 the reflections in the two diagonals, and
+   6 and 7 the quarter turns clockwise and anticlockwise. Only symmetries 0-3
+   keep the shape of a board that isn't square. */
+#define BOARD_SYMMETRIES 8u
+
+
+/* A move on a board's move stack, with the state needed to undo it. */
+typedef struct
+{
+    unsigned row;
+    unsigned column;
+    CellStatus previous;            /* Status of the cell before the move. */
+    unsigned long hash;             /* Board hash before the move. */
+    unsigned long occupied;         /* Occupied cells before the move. */
+} BoardMove;
+
+
 /* Represents the tic-tac-toe board.
    Use createGameBoard to properly create the board,
    and destroyGameBoard to properly destroy it. */
@@ -25,9 +66,29 @@ typedef struct
     unsigned rows;                  /* Height of the board ("n" value). */
     unsigned columns;               /* Width of the board ("m" value). */
     unsigned winRequirement;        /* Consecutive cells to win ("k" value). */
+    BoardBackend backend;           /* Storage used for the cells. */
+    unsigned long hash;             /* Zobrist hash of the cells, kept up to
+                                       date by setBoardCell(). */
+    /* Zobrist hash of the image of the cells under each symmetry, also kept
+       up to date by setBoardCell(). The first is the same as hash. Those of
+       symmetries that don't apply to the board are 0. */
+    unsigned long symmetryHashes[BOARD_SYMMETRIES];
+    unsigned long occupied;         /* Number of non-empty cells. */
     /* Cells are stored in row-major format
-        (i.e. consecutive cells in a row are consecutive in the array). */
+        (i.e. consecutive cells in a row are consecutive in the array).
+       Only used by BOARD_BACKEND_ARRAY, otherwise NULL. */
     CellStatus* cells;
+    /* Only used by BOARD_BACKEND_BITBOARD, otherwise zeroed. */
+    BitBoard bits;
+    /* Only used by BOARD_BACKEND_SPARSE, otherwise zeroed. */
+    SparseBoard sparse;
+    /* Kept up to date by setBoardCell() once enabled by
+       enableWindowCounts(), otherwise zeroed. */
+    WindowCounts windows;
+    BoardMove* moves;               /* Moves made by makeMove() and not yet
+                                       undone, the last being the latest. */
+    size_t moveCount;
+    size_t moveCapacity;
 } GameBoard;
 
 
@@ -37,19 +98,76 @@ typedef struct
 GameBoard zeroedGameBoard(void);
 
 /* Creates a game board from the given parameters.
+   Uses BOARD_BACKEND_ARRAY storage, unless the board has more than
+   SPARSE_BOARD_THRESHOLD cells in which case BOARD_BACKEND_SPARSE is used.
    rows, columns and winRequirement must all be >0. */
 GameBoard createGameBoard(unsigned rows, unsigned columns,
     unsigned winRequirement);
 
+/* Same as createGameBoard(), but with the given cell storage.
+   BOARD_BACKEND_ARRAY and BOARD_BACKEND_BITBOARD require memory proportional
+   to rows * columns. */
+GameBoard createGameBoardWithBackend(unsigned rows, unsigned columns,
+    unsigned winRequirement, BoardBackend backend);
+
+/* Creates an independent copy of a game board, with the same backend. */
+GameBoard copyGameBoard(GameBoard const* board);
+
+/* Creates an independent copy of a game board, with the same backend but
+   without window counts, even if the original has them. */
+GameBoard copyGameBoardWithoutWindowCounts(GameBoard const* board);
+
 /* Destroys a game board (deallocates resources, etc.). */
 void destroyGameBoard(GameBoard* board);
 
-/* Sets all cells of a board to CELL_EMPTY. */
+/* Sets all cells of a board to CELL_EMPTY and empties its move stack. */
 void clearBoardCells(GameBoard* board);
 
-/* Checks if the given player has won on a board. */
+/* Starts keeping the counts of every window of winRequirement cells on the
+   board (see window_counts.h), built from its current cells. Needs memory
+   proportional to rows * columns, so can't be used with BOARD_BACKEND_SPARSE.
+   Copies of the board keep the counts too. */
+void enableWindowCounts(GameBoard* board);
+
+/* Checks if enableWindowCounts() has been called on a board. */
+int hasWindowCounts(GameBoard const* board);
+
+/* Calls enableWindowCounts() if the board doesn't have window counts yet, has
+   at most WINDOW_COUNTS_MAX_CELLS cells and doesn't use BOARD_BACKEND_SPARSE.
+   Returns non-zero if the board has window counts afterwards. */
+int enableSmallWindowCounts(GameBoard* board);
+
+/* Checks if no line of winRequirement cells can still be completed by either
+   player, so the game can only end in a draw. O(1).
+   The board must have window counts. */
+int isDeadDraw(GameBoard const* board);
+
+/* Checks if the given player has won on a board.
+   O(1) if the board has window counts. Boards using BOARD_BACKEND_ARRAY
+   are scanned with the kernel selected in win_scan.h. */
 int hasPlayerWon(GameBoard const* board, Player player);
 
+/* Same as hasPlayerWon(), but scans boards using BOARD_BACKEND_ARRAY with the
+   given number of threads (>0), for full checks of very large boards. The
+   rows are split into bands, and each band is checked for wins in every
+   direction starting in it, following lines on into the next band. All the
+   threads stop soon after any of them finds a win. */
+int hasPlayerWonParallel(GameBoard const* board, Player player,
+    unsigned threads);
+
+/* Checks if the player occupying the given cell has won with a line through
+   that cell. Only the four lines through the cell are examined, so this is
+   O(winRequirement) rather than O(rows * columns). Intended to be called after
+   each move with the cell just placed; returns 0 for an empty cell.
+   row and column must be within the bounds of the board. */
+int hasPlayerWonAt(GameBoard const* board, unsigned row, unsigned column);
+
+/* Counts the consecutive cells matching status starting one step away from
+   the given cell and moving by (rowStep, columnStep) each step, where the steps
+   are -1, 0 or 1. Stops counting at limit. */
+unsigned countBoardRun(GameBoard const* board, unsigned row, unsigned column,
+    CellStatus status, int rowStep, int columnStep, unsigned limit);
+
 /* Checks if the given row and column are within the bounds of the board. */
 int inBoardBounds(GameBoard const* board, unsigned row, unsigned column);
 
@@ -58,12 +176,69 @@ int inBoardBounds(GameBoard const* board, unsigned row, unsigned column);
 void setBoardCell(GameBoard* board, unsigned row, unsigned column,
     CellStatus status);
 
+/* Same as setBoardCell(), but also pushes the move onto the board's move stack
+   so that unmakeMove() can undo it. */
+void makeMove(GameBoard* board, unsigned row, unsigned column,
+    CellStatus status);
+
+/* Undoes the latest move on the board's move stack, restoring the cell, hash,
+   occupied count and window counts to what they were before it, and returns
+   the move. O(1) apart from the window counts, which are O(winRequirement).
+   There must be a move on the stack, and its cell must not have been changed
+   by setBoardCell() since. */
+BoardMove unmakeMove(GameBoard* board);
+
 /* Gets the status of a board cell.
    row and column must be within the bounds of the board. */
 CellStatus getBoardCell(GameBoard const* board, unsigned row, unsigned column);
 
-/* Prints a game board to stdout. */
-void displayGameBoard(GameBoard const* board);
+/* Gets the player whose turn it is, given that X moves first and the players
+   alternate. */
+Player nextPlayer(GameBoard const* board);
+
+/* Gets the smallest rectangle containing all non-empty cells.
+   Returns 0 if the board is empty, in which case the outputs are unchanged. */
+int getOccupiedBounds(GameBoard const* board, unsigned* minRow,
+    unsigned* minColumn, unsigned* maxRow, unsigned* maxColumn);
+
+/* Checks if any of the 8 cells around a cell are occupied. */
+int hasNeighbour(GameBoard const* board, unsigned row, unsigned column);
+
+/* Gets the Zobrist key for a cell having the given status. The hash of a board
+   is the XOR of the keys of all its cells, and CELL_EMPTY's key is 0.
+   Keys are computed rather than looked up, so boards of any size can be
+   hashed without a table of keys. */
+unsigned long cellHashKey(unsigned row, unsigned column, CellStatus status);
+
+/* Gets the number of symmetries that apply to a board: BOARD_SYMMETRIES for a
+   square board, otherwise 4. */
+unsigned countBoardSymmetries(GameBoard const* board);
+
+/* Maps a cell to where it is in the image of the board under a symmetry.
+   The symmetry must apply to the board. */
+void transformCell(GameBoard const* board, unsigned symmetry, unsigned* row,
+    unsigned* column);
+
+/* Maps a cell in the image of the board under a symmetry back to where it is
+   on the board. The inverse of transformCell(). */
+void untransformCell(GameBoard const* board, unsigned symmetry,
+    unsigned* row, unsigned* column);
+
+/* Gets the symmetry whose image of the board has the smallest hash, the
+   lowest numbered if there are several. All positions equivalent under the
+   board's symmetries have the same image under their canonical symmetry. */
+unsigned canonicalSymmetry(GameBoard const* board);
+
+/* Gets the smallest hash of the images of the board under its symmetries,
+   which is the same for all equivalent positions. O(BOARD_SYMMETRIES). */
+unsigned long canonicalHash(GameBoard const* board);
+
+/* Prints a game board to stdout, composed in memory and written in one go
+   (see render.h). Boards of more than SPARSE_BOARD_THRESHOLD cells are far
+   too big to print whole, so only a 20x20 part around the occupied cells is
+   printed, with row and column numbers, under a line naming it.
+   Returns 0 if the board is too big to draw or writing fails. */
+int displayGameBoard(GameBoard const* board);
 
 /* Returns CELL_X for PLAYER_X and CELL_O for PLAYER_O. */
 CellStatus playerToCell(Player player);
@@ -0,0 +1,376 @@
+/* Opening books. */
+
+/* mmap() and the file descriptor functions are POSIX, not ANSI C. */
+#define _POSIX_C_SOURCE 200112L
+
+#include "book.h"
+
+#include "board.h"
+#include "common.h"
+#include "search.h"
+#include "transposition.h"
+
+#include <assert.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Identifies book files, and their format version. */
+static char const FILE_MAGIC[8] = {'M', 'N', 'K', 'B', 'O', 'O', 'K', '1'};
+
+/* Bytes in a book file before the entries: the magic, the rows, columns and
+   win requirement as 4 byte little-endian integers, 4 bytes of padding, and
+   the number of entries as an 8 byte little-endian integer. */
+#define FILE_HEADER_SIZE 32u
+
+/* Bytes per entry: the canonical hash of the position as an 8 byte
+   little-endian integer, then the row and column of the move in the
+   canonical image of the position as 4 byte little-endian integers. */
+#define ENTRY_SIZE 16u
+
+/* Number of entries in the transposition table used to build books. */
+#define TRANSPOSITION_TABLE_ENTRIES (1ul << 18)
+
+
+/* State of buildOpeningBook(). */
+typedef struct
+{
+    OpeningBook book;
+    GameBoard board;
+    TranspositionTable table;
+    SearchLimits limits;
+    unsigned depth;     /* Positions with this many moves played aren't
+                           added. */
+    int verbose;
+} BookBuilder;
+
+
+/* Finds the entry for a key with a binary search. If there isn't one, sets
+   index to where it would be inserted and returns 0. */
+static int findEntry(OpeningBook const* book, unsigned long key,
+    size_t* index)
+{
+    size_t low = 0;
+    size_t high = book->count;
+    size_t middle = 0;
+    unsigned long middleKey = 0;
+    int found = 0;
+
+    while (low < high && !found)
+    {
+        middle = low + (high - low) / 2u;
+        middleKey = readLittleEndian(book->entries + middle * ENTRY_SIZE, 8);
+        if (middleKey < key)
+        {
+            low = middle + 1u;
+        }
+        else if (middleKey > key)
+        {
+            high = middle;
+        }
+        else
+        {
+            low = middle;
+            found = 1;
+        }
+    }
+
+    *index = low;
+
+    return found;
+}
+
+
+/* Adds the builder's board position and the positions after it to the book,
+   unless it or an equivalent position is already there. */
+static void buildPosition(BookBuilder* builder)
+{
+    GameBoard* const board = &builder->board;
+    unsigned long const cells = (unsigned long)board->rows * board->columns;
+    SearchResult result;
+    unsigned row = 0;
+    unsigned column = 0;
+    int over = 0;
+
+    if (board->occupied < builder->depth
+        && !bookMove(&builder->book, board, &row, &column))
+    {
+        result = searchBestMove(board, &builder->table, builder->limits);
+        assert(result.found);
+        addBookMove(&builder->book, board, result.row, result.column);
+        if (builder->verbose)
+        {
+            printf("Position %lu (%lu moves played): best move %u,%u.\n",
+                (unsigned long)builder->book.count, board->occupied,
+                result.column, result.row);
+        }
+
+        for (row = 0; row < board->rows; ++row)
+        {
+            for (column = 0; column < board->columns; ++column)
+            {
+                if (getBoardCell(board, row, column) == CELL_EMPTY
+                    && (board->occupied == 0
+                        || hasNeighbour(board, row, column)))
+                {
+                    makeMove(board, row, column,
+                        playerToCell(nextPlayer(board)));
+                    over = hasPlayerWonAt(board, row, column)
+                        || board->occupied == cells;
+                    if (!over)
+                    {
+                        buildPosition(builder);
+                    }
+                    unmakeMove(board);
+                }
+            }
+        }
+    }
+}
+
+
+/* Checks a mapped book file's header and size, and sets up a book for it.
+   Returns a zeroed book if the file isn't valid. */
+static OpeningBook readHeader(unsigned char const* data, size_t size)
+{
+    OpeningBook book = zeroedOpeningBook();
+    unsigned long count = 0;
+
+    if (size >= FILE_HEADER_SIZE
+        && memcmp(data, FILE_MAGIC, sizeof FILE_MAGIC) == 0)
+    {
+        count = readLittleEndian(data + 24, 8);
+        if ((size - FILE_HEADER_SIZE) / ENTRY_SIZE == count
+            && (size - FILE_HEADER_SIZE) % ENTRY_SIZE == 0)
+        {
+            book.rows = readLittleEndian(data + 8, 4);
+            book.columns = readLittleEndian(data + 12, 4);
+            book.winRequirement = readLittleEndian(data + 16, 4);
+            book.count = count;
+            book.entries = data + FILE_HEADER_SIZE;
+        }
+    }
+
+    return book;
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+OpeningBook zeroedOpeningBook(void)
+{
+    OpeningBook book;
+
+    book.rows = 0;
+    book.columns = 0;
+    book.winRequirement = 0;
+    book.count = 0;
+    book.capacity = 0;
+    book.entries = NULL;
+    book.ownedEntries = NULL;
+    book.mapping = NULL;
+    book.mappingSize = 0;
+
+    return book;
+}
+
+
+OpeningBook createOpeningBook(unsigned rows, unsigned columns,
+    unsigned winRequirement)
+{
+    OpeningBook book = zeroedOpeningBook();
+
+    book.rows = rows;
+    book.columns = columns;
+    book.winRequirement = winRequirement;
+    book.capacity = 16;
+    book.ownedEntries = malloc(book.capacity * ENTRY_SIZE);
+    book.entries = book.ownedEntries;
+
+    return book;
+}
+
+
+OpeningBook buildOpeningBook(unsigned rows, unsigned columns,
+    unsigned winRequirement, unsigned depth, SearchLimits limits,
+    int verbose)
+{
+    BookBuilder builder;
+
+    builder.book = createOpeningBook(rows, columns, winRequirement);
+    builder.board = createGameBoard(rows, columns, winRequirement);
+    builder.table = createTranspositionTable(TRANSPOSITION_TABLE_ENTRIES);
+    builder.limits = limits;
+    builder.depth = depth;
+    builder.verbose = verbose;
+
+    buildPosition(&builder);
+
+    destroyTranspositionTable(&builder.table);
+    destroyGameBoard(&builder.board);
+
+    return builder.book;
+}
+
+
+void addBookMove(OpeningBook* book, GameBoard const* board, unsigned row,
+    unsigned column)
+{
+    unsigned const symmetry = canonicalSymmetry(board);
+    unsigned long const key = board->symmetryHashes[symmetry];
+    size_t index = 0;
+
+    assert(book->ownedEntries);
+    assert(openingBookMatches(book, board));
+
+    if (!findEntry(book, key, &index))
+    {
+        if (book->count == book->capacity)
+        {
+            book->capacity *= 2u;
+            book->ownedEntries = realloc(book->ownedEntries,
+                book->capacity * ENTRY_SIZE);
+            book->entries = book->ownedEntries;
+        }
+        memmove(book->ownedEntries + (index + 1u) * ENTRY_SIZE,
+            book->ownedEntries + index * ENTRY_SIZE,
+            (book->count - index) * ENTRY_SIZE);
+        ++book->count;
+    }
+
+    transformCell(board, symmetry, &row, &column);
+    storeLittleEndian(book->ownedEntries + index * ENTRY_SIZE, key, 8);
+    storeLittleEndian(book->ownedEntries + index * ENTRY_SIZE + 8, row, 4);
+    storeLittleEndian(book->ownedEntries + index * ENTRY_SIZE + 12, column,
+        4);
+}
+
+
+void writeOpeningBook(FILE* stream, OpeningBook const* book)
+{
+    fwrite(FILE_MAGIC, 1, sizeof FILE_MAGIC, stream);
+    writeLittleEndian(stream, book->rows, 4);
+    writeLittleEndian(stream, book->columns, 4);
+    writeLittleEndian(stream, book->winRequirement, 4);
+    writeLittleEndian(stream, 0, 4);
+    writeLittleEndian(stream, book->count, 8);
+    fwrite(book->entries, ENTRY_SIZE, book->count, stream);
+}
+
+
+OpeningBook openOpeningBook(char const* filePath, int* error)
+{
+    OpeningBook book = zeroedOpeningBook();
+    struct stat status;
+    void* mapping = MAP_FAILED;
+    int file = open(filePath, O_RDONLY);
+
+    if (file < 0 || fstat(file, &status) != 0 || status.st_size == 0)
+    {
+        fprintf(stderr, "Error: could not open opening book \"%s\".\n",
+            filePath);
+        *error = 1;
+    }
+    else
+    {
+        mapping = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_SHARED,
+            file, 0);
+        if (mapping == MAP_FAILED)
+        {
+            fprintf(stderr, "Error: could not map opening book \"%s\".\n",
+                filePath);
+            *error = 1;
+        }
+    }
+
+    if (mapping != MAP_FAILED)
+    {
+        book = readHeader(mapping, (size_t)status.st_size);
+        if (book.entries)
+        {
+            book.mapping = mapping;
+            book.mappingSize = (size_t)status.st_size;
+        }
+        else
+        {
+            fprintf(stderr, "Error: \"%s\" is not a valid opening book.\n",
+                filePath);
+            *error = 1;
+            munmap(mapping, (size_t)status.st_size);
+        }
+    }
+
+    /* The mapping stays valid after the file is closed. */
+    if (file >= 0)
+    {
+        close(file);
+    }
+
+    return book;
+}
+
+
+void destroyOpeningBook(OpeningBook* book)
+{
+    if (book->mapping)
+    {
+        munmap(book->mapping, book->mappingSize);
+    }
+    free(book->ownedEntries);
+    *book = zeroedOpeningBook();
+}
+
+
+int openingBookMatches(OpeningBook const* book, GameBoard const* board)
+{
+    return book->entries && book->rows == board->rows
+        && book->columns == board->columns
+        && book->winRequirement == board->winRequirement;
+}
+
+
+int bookMove(OpeningBook const* book, GameBoard const* board, unsigned* row,
+    unsigned* column)
+{
+    unsigned const symmetry = canonicalSymmetry(board);
+    unsigned char const* entry = NULL;
+    unsigned bookRow = 0;
+    unsigned bookColumn = 0;
+    size_t index = 0;
+    int found = 0;
+
+    assert(openingBookMatches(book, board));
+
+    if (findEntry(book, board->symmetryHashes[symmetry], &index))
+    {
+        entry = book->entries + index * ENTRY_SIZE;
+        bookRow = readLittleEndian(entry + 8, 4);
+        bookColumn = readLittleEndian(entry + 12, 4);
+        /* A corrupt file or a hash collision could give any cell. */
+        found = inBoardBounds(board, bookRow, bookColumn);
+        if (found)
+        {
+            untransformCell(board, symmetry, &bookRow, &bookColumn);
+            found = getBoardCell(board, bookRow, bookColumn) == CELL_EMPTY;
+        }
+    }
+
+    if (found)
+    {
+        *row = bookRow;
+        *column = bookColumn;
+    }
+
+    return found;
+}
@@ -0,0 +1,80 @@
+/* Opening books, which hold searched best moves for the positions near the
+   start of a game so computer players can play them without searching.
+   Positions are keyed by their canonical hash, so one entry covers all the
+   positions equivalent under the board's symmetries, and entries are sorted
+   by key so lookups are a binary search. Books are written to files which are
+   memory mapped when opened, so loading one costs no time. */
+
+#ifndef BOOK_H
+#define BOOK_H
+
+#include "board.h"
+#include "search.h"
+
+#include <stddef.h>
+#include <stdio.h>
+
+
+/* Opening book.
+   Use createOpeningBook, buildOpeningBook or openOpeningBook to properly
+   create it, and destroyOpeningBook to properly destroy it. */
+typedef struct OpeningBook
+{
+    unsigned rows;                  /* Height of the board. */
+    unsigned columns;               /* Width of the board. */
+    unsigned winRequirement;        /* Number of consecutive cells to win. */
+    size_t count;                   /* Number of positions in the book. */
+    size_t capacity;                /* Entries allocated in ownedEntries. */
+    /* Packed entries in the file format, sorted by key. */
+    unsigned char const* entries;
+    unsigned char* ownedEntries;    /* entries, if allocated rather than
+                                       mapped. */
+    void* mapping;                  /* Mapped file, or NULL. */
+    size_t mappingSize;
+} OpeningBook;
+
+
+/* Returns an OpeningBook object with all members zeroed out. */
+OpeningBook zeroedOpeningBook(void);
+
+/* Creates an empty book for boards with the given dimensions. */
+OpeningBook createOpeningBook(unsigned rows, unsigned columns,
+    unsigned winRequirement);
+
+/* Searches every position reachable from an empty board in fewer than depth
+   moves, where each move is next to an occupied cell, and adds the best move
+   of each to a new book. Positions that are already over are left out.
+   If verbose is non-zero, prints progress to stdout. */
+OpeningBook buildOpeningBook(unsigned rows, unsigned columns,
+    unsigned winRequirement, unsigned depth, SearchLimits limits,
+    int verbose);
+
+/* Adds the move to play in a board position to a book created by
+   createOpeningBook or buildOpeningBook, replacing any move already there for
+   the position or an equivalent one. The book must match the board. */
+void addBookMove(OpeningBook* book, GameBoard const* board, unsigned row,
+    unsigned column);
+
+/* Writes a book to a stream in the format read by openOpeningBook. */
+void writeOpeningBook(FILE* stream, OpeningBook const* book);
+
+/* Opens a book file by mapping it into memory.
+   If an error occurs, prints info to stderr, sets error to 1, and returns a
+   zeroed OpeningBook object. */
+OpeningBook openOpeningBook(char const* filePath, int* error);
+
+/* Destroys a book (unmaps or deallocates resources, etc.). */
+void destroyOpeningBook(OpeningBook* book);
+
+/* Checks if a book was built for boards with the dimensions and win
+   requirement of the given board. */
+int openingBookMatches(OpeningBook const* book, GameBoard const* board);
+
+/* Looks up the move to play in a board position. The book must match the
+   board. If the position is in the book, sets row and column and returns 1,
+   otherwise returns 0. O(log(count)). */
+int bookMove(OpeningBook const* book, GameBoard const* board, unsigned* row,
+    unsigned* column);
+
+
+#endif
@@ -4,7 +4,10 @@
 
 #include <assert.h>
 #include <ctype.h>
+#include <errno.h>
+#include <limits.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 
 /* PUBLIC INTERFACE */
@@ -25,6 +28,21 @@ char playerToChar(Player player)
 }
 
 
+Player otherPlayer(Player player)
+{
+    Player res = PLAYER_X;
+
+    switch (player)
+    {
+        case PLAYER_X: res = PLAYER_O; break;
+        case PLAYER_O: res = PLAYER_X; break;
+        default: assert(0);
+    }
+
+    return res;
+}
+
+
 int readUntil(FILE* file, char c, int consume)
 {
     int read = '\0';
@@ -55,3 +73,101 @@ int isWhitespace(char const* str)
 
     return res;
 }
+
+
+int parseCount(char const* arg, unsigned long* count, int allowZero)
+{
+    int res = 0;
+    char* end = NULL;
+
+    errno = 0;
+    *count = strtoul(arg, &end, 10);
+    /* strtoul() accepts leading whitespace and signs, which aren't wanted. */
+    res = errno == 0 && *end == '\0' && arg[0] >= (allowZero ? '0' : '1')
+        && arg[0] <= '9';
+    if (!res)
+    {
+        fprintf(stderr, "Error: invalid number \"%s\".\n", arg);
+    }
+
+    return res;
+}
+
+
+void writeLittleEndian(FILE* file, unsigned long value, unsigned bytes)
+{
+    unsigned i = 0;
+
+    for (i = 0; i < bytes; ++i)
+    {
+        fputc((int)(value & 0xffu), file);
+        /* Two shifts, as shifting by the width of the type is undefined. */
+        value = value >> 4 >> 4;
+    }
+}
+
+
+void storeLittleEndian(unsigned char* data, unsigned long value,
+    unsigned bytes)
+{
+    unsigned i = 0;
+
+    for (i = 0; i < bytes; ++i)
+    {
+        data[i] = (unsigned char)(value & 0xffu);
+        value = value >> 4 >> 4;
+    }
+}
+
+
+unsigned long readLittleEndian(unsigned char const* data, unsigned bytes)
+{
+    unsigned long value = 0;
+    unsigned i = 0;
+
+    for (i = bytes; i > 0; --i)
+    {
+        value = value << 4 << 4 | data[i - 1u];
+    }
+
+    return value;
+}
+
+
+void writeVarint(FILE* file, unsigned long value)
+{
+    while (value >= 0x80u)
+    {
+        fputc((int)(value & 0x7fu) | 0x80, file);
+        value >>= 7;
+    }
+    fputc((int)value, file);
+}
+
+
+int readVarint(FILE* file, unsigned long* value)
+{
+    unsigned const bits = sizeof(unsigned long) * CHAR_BIT;
+    unsigned shift = 0;
+    int more = 1;
+    int res = 1;
+    int c = 0;
+
+    *value = 0;
+    while (res && more)
+    {
+        c = fgetc(file);
+        /* Bits shifted past the top of the type would be lost. */
+        res = c != EOF && shift < bits
+            && ((unsigned long)(c & 0x7f) << shift >> shift)
+                == (unsigned long)(c & 0x7f);
+        if (res)
+        {
+            *value |= (unsigned long)(c & 0x7f) << shift;
+            shift += 7u;
+            more = c & 0x80;
+        }
+    }
+
+    return res;
+}
@@ -17,6 +17,9 @@ typedef enum
 /* Returns 'X' for PLAYER_X, 'O' for PLAYER_O. */
 char playerToChar(Player player);
 
+/* Returns PLAYER_O for PLAYER_X, PLAYER_X for PLAYER_O. */
+Player otherPlayer(Player player);
+
 /* Reads characters from a file until a given character is encountered.
    consume controls whether or not that character is consumed from the file.
    On success, returns 1.
@@ -27,5 +30,30 @@ int readUntil(FILE* file, char c, int consume);
    Empty string is considered to be all whitespace. */
 int isWhitespace(char const* str);
 
+/* Parses a whole number command line argument, which may only be 0 if
+   allowZero is non-zero.
+   If it's invalid, prints an error to stderr and returns 0. */
+int parseCount(char const* arg, unsigned long* count, int allowZero);
+
+/* Writes the low bytes of an integer to a file, least significant first. */
+void writeLittleEndian(FILE* file, unsigned long value, unsigned bytes);
+
+/* Stores the low bytes of an integer in memory, least significant first. */
+void storeLittleEndian(unsigned char* data, unsigned long value,
+    unsigned bytes);
+
+/* Reads an integer of the given number of bytes (at most sizeof(unsigned
+   long)) from memory, least significant first. */
+unsigned long readLittleEndian(unsigned char const* data, unsigned bytes);
+
+/* Writes an integer to a file as a varint: seven bits per byte, least
+   significant first, with the top bit set on every byte but the last. */
+void writeVarint(FILE* file, unsigned long value);
+
+/* Reads a varint written by writeVarint() from a file.
+   Returns 0 if the file ends before it does, or it doesn't fit an unsigned
+   long. */
+int readVarint(FILE* file, unsigned long* value);
+
 
 #endif
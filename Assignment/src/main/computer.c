@@ -0,0 +1,399 @@
+/* Computer players, which choose moves without user input. */
+
+/* pthreads and nanosleep() are POSIX, not ANSI C. */
+#define _POSIX_C_SOURCE 200112L
+
+#include "computer.h"
+
+#include "board.h"
+#include "book.h"
+#include "mcts.h"
+#include "random.h"
+#include "search.h"
+#include "settings.h"
+#include "solved_db.h"
+#include "timer.h"
+#include "transposition.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Number of entries in the transposition table of alpha-beta players. */
+#define TRANSPOSITION_TABLE_ENTRIES (1ul << 18)
+
+/* Random cells tried before falling back to a scan for an empty cell. */
+#define RANDOM_MOVE_ATTEMPTS 32u
+
+/* Time limit of a ponder search, which is normally stopped long before. */
+#define PONDER_MAX_SECONDS 1e6
+
+/* Interval between checks for a ponder search finishing early. */
+#define PONDER_POLL_NANOSECONDS 1000000l
+
+
+/* Background search started by startPondering(). */
+struct Ponder
+{
+    GameBoard board;            /* Position after the expected reply. */
+    TranspositionTable* table;
+    SearchLimits limits;
+    SearchResult result;        /* Set once the search returns. */
+    double start;               /* monotonicSeconds() when it started. */
+    volatile int stop;          /* Set to stop the search. */
+    volatile int finished;      /* Set by the search thread once done. */
+    pthread_t thread;
+};
+
+
+/* Chooses a uniformly random cell, then scans forward from it if it is
+   occupied. Nearly uniform while most cells are empty, and always finds a cell
+   on boards that are nearly full. */
+static void randomMove(ComputerPlayer* player, GameBoard const* board,
+    unsigned* row, unsigned* column)
+{
+    unsigned attempts = 0;
+    int found = 0;
+
+    while (!found && attempts < RANDOM_MOVE_ATTEMPTS)
+    {
+        *row = randomBelow(&player->random, board->rows);
+        *column = randomBelow(&player->random, board->columns);
+        found = getBoardCell(board, *row, *column) == CELL_EMPTY;
+        ++attempts;
+    }
+
+    while (!found)
+    {
+        ++*column;
+        if (*column == board->columns)
+        {
+            *column = 0;
+            ++*row;
+            if (*row == board->rows)
+            {
+                *row = 0;
+            }
+        }
+        found = getBoardCell(board, *row, *column) == CELL_EMPTY;
+    }
+}
+
+
+
+/* Thread entry point of a ponder search. */
+static void* ponderMain(void* arg)
+{
+    Ponder* const ponder = arg;
+
+    ponder->result = searchBestMove(&ponder->board, ponder->table,
+        ponder->limits);
+    ponder->finished = 1;
+
+    return NULL;
+}
+
+
+/* Stops the player's ponder search and waits for its thread to finish.
+   Returns the search's result. */
+static SearchResult endPondering(ComputerPlayer* player)
+{
+    Ponder* const ponder = player->ponder;
+    SearchResult result;
+    int res = 0;
+
+    ponder->stop = 1;
+    res = pthread_join(ponder->thread, NULL);
+    assert(res == 0);
+    (void)res;
+    result = ponder->result;
+
+    destroyGameBoard(&ponder->board);
+    free(ponder);
+    player->ponder = NULL;
+
+    return result;
+}
+
+
+/* Ends the player's ponder search. If it was on board, first lets it run
+   until it has had as long as a search from now would have, and returns
+   non-zero and sets result. Otherwise discards it. */
+static int finishPondering(ComputerPlayer* player, GameBoard const* board,
+    SearchResult* result)
+{
+    Ponder* const ponder = player->ponder;
+    struct timespec const poll = {0, PONDER_POLL_NANOSECONDS};
+    int const hit = ponder->board.hash == board->hash
+        && ponder->board.occupied == board->occupied;
+
+    while (hit && !ponder->finished && monotonicSeconds() - ponder->start
+        < player->searchLimits.softSeconds)
+    {
+        nanosleep(&poll, NULL);
+    }
+
+    if (hit)
+    {
+        ++player->ponderHits;
+        *result = endPondering(player);
+    }
+    else
+    {
+        endPondering(player);
+    }
+
+    return hit;
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+ComputerPlayer zeroedComputerPlayer(void)
+{
+    ComputerPlayer player;
+
+    player.type = PLAYER_TYPE_HUMAN;
+    player.table = zeroedTranspositionTable();
+    player.searchLimits = defaultSearchLimits();
+    player.mctsLimits = defaultMctsLimits();
+    player.random = 0;
+    player.solved = NULL;
+    player.book = NULL;
+    player.ponder = NULL;
+    player.predictions = 0;
+    player.ponderHits = 0;
+
+    return player;
+}
+
+
+ComputerPlayer createComputerPlayer(PlayerType type, Settings const* settings,
+    unsigned long seed)
+{
+    ComputerPlayer player = zeroedComputerPlayer();
+
+    assert(type != PLAYER_TYPE_HUMAN);
+
+    player.type = type;
+    player.random = seedRandom(seed);
+    if (type != PLAYER_TYPE_RANDOM)
+    {
+        player.solved = settings->solved;
+        player.book = settings->book;
+    }
+
+    if (type == PLAYER_TYPE_ALPHA_BETA)
+    {
+        player.table = createTranspositionTable(TRANSPOSITION_TABLE_ENTRIES);
+    }
+    if (settings->threads > 0)
+    {
+        player.searchLimits.threads = settings->threads;
+        player.mctsLimits.threads = settings->threads;
+    }
+
+    return player;
+}
+
+
+void destroyComputerPlayer(ComputerPlayer* player)
+{
+    stopPondering(player);
+    destroyTranspositionTable(&player->table);
+    *player = zeroedComputerPlayer();
+}
+
+
+void setComputerMoveTime(ComputerPlayer* player, double softSeconds,
+    double hardSeconds)
+{
+    assert(softSeconds <= hardSeconds);
+
+    player->searchLimits.softSeconds = softSeconds;
+    player->searchLimits.maxSeconds = hardSeconds;
+    /* Playouts are short, so stopping at any time loses little. */
+    player->mctsLimits.maxSeconds = softSeconds;
+}
+
+
+void computerPlayerMove(ComputerPlayer* player, GameBoard const* board,
+    unsigned* row, unsigned* column, int verbose)
+{
+    SearchResult searchResult;
+    MctsResult mctsResult;
+    SolvedValue solvedValue;
+    int solved = 0;
+    int booked = 0;
+    int pondered = 0;
+    int const predicted = player->ponder != NULL;
+
+    if (predicted)
+    {
+        pondered = finishPondering(player, board, &searchResult);
+    }
+
+    if (player->solved && solvedDatabaseMatches(player->solved, board))
+    {
+        solved = solvedBestMove(player->solved, board, row, column,
+            &solvedValue);
+    }
+
+    if (!solved && player->book && openingBookMatches(player->book, board))
+    {
+        booked = bookMove(player->book, board, row, column);
+    }
+
+    /* Positions in the solved database or opening book need no search. */
+    if (!solved && !booked && pondered)
+    {
+        assert(searchResult.found);
+        *row = searchResult.row;
+        *column = searchResult.column;
+    }
+    else if (!solved && !booked)
+    {
+        switch (player->type)
+        {
+            case PLAYER_TYPE_ALPHA_BETA:
+                searchResult = searchBestMove(board, &player->table,
+                    player->searchLimits);
+                assert(searchResult.found);
+                *row = searchResult.row;
+                *column = searchResult.column;
+                break;
+            case PLAYER_TYPE_MCTS:
+                mctsResult = mctsBestMove(board, player->mctsLimits);
+                assert(mctsResult.found);
+                *row = mctsResult.row;
+                *column = mctsResult.column;
+                break;
+            case PLAYER_TYPE_RANDOM:
+                randomMove(player, board, row, column);
+                break;
+            default:
+                assert(0);
+        }
+    }
+
+    if (verbose)
+    {
+        printf("Computer plays %u,%u.\n", *column, *row);
+        if (solved)
+        {
+            printf("Solved position: ");
+            writeSolvedValue(stdout, solvedValue);
+            printf(".\n");
+        }
+        else if (booked)
+        {
+            printf("Played from the opening book.\n");
+        }
+        else if (player->type == PLAYER_TYPE_ALPHA_BETA)
+        {
+            if (pondered)
+            {
+                printf("Ponder hit, searched during the opponent's turn.\n");
+            }
+            printSearchStatistics(&searchResult);
+        }
+        else if (player->type == PLAYER_TYPE_MCTS)
+        {
+            printMctsStatistics(&mctsResult);
+        }
+
+        /* Kept up to date with every move, not just given at the end. */
+        if (predicted)
+        {
+            writePonderStatistics(stderr, player);
+        }
+    }
+}
+
+
+void startPondering(ComputerPlayer* player, GameBoard const* board)
+{
+    unsigned long const cells = (unsigned long)board->rows * board->columns;
+    unsigned const symmetry = canonicalSymmetry(board);
+    Ponder* ponder = NULL;
+    TableEntry entry;
+    int expected = 0;
+    int res = 0;
+
+    if (player->type == PLAYER_TYPE_ALPHA_BETA && !player->ponder
+        && board->occupied < cells)
+    {
+        /* The last search stored the best reply it found, in the canonical
+           image of the position. */
+        expected = probeTable(&player->table, board->symmetryHashes[symmetry],
+            &entry) && entry.hasMove;
+    }
+
+    if (expected)
+    {
+        untransformCell(board, symmetry, &entry.row, &entry.column);
+        expected = inBoardBounds(board, entry.row, entry.column)
+            && getBoardCell(board, entry.row, entry.column) == CELL_EMPTY;
+    }
+
+    if (expected)
+    {
+        ponder = malloc(sizeof(Ponder));
+        ponder->board = copyGameBoard(board);
+        makeMove(&ponder->board, entry.row, entry.column,
+            playerToCell(nextPlayer(board)));
+        expected = !hasPlayerWonAt(&ponder->board, entry.row, entry.column)
+            && ponder->board.occupied < cells;
+        if (!expected)
+        {
+            destroyGameBoard(&ponder->board);
+            free(ponder);
+        }
+    }
+
+    if (expected)
+    {
+        ponder->table = &player->table;
+        ponder->limits = player->searchLimits;
+        ponder->limits.softSeconds = PONDER_MAX_SECONDS;
+        ponder->limits.maxSeconds = PONDER_MAX_SECONDS;
+        ponder->limits.stop = &ponder->stop;
+        ponder->start = monotonicSeconds();
+        ponder->stop = 0;
+        ponder->finished = 0;
+        player->ponder = ponder;
+        ++player->predictions;
+
+        res = pthread_create(&ponder->thread, NULL, ponderMain, ponder);
+        assert(res == 0);
+        (void)res;
+    }
+}
+
+
+void stopPondering(ComputerPlayer* player)
+{
+    if (player->ponder)
+    {
+        endPondering(player);
+    }
+}
+
+
+void writePonderStatistics(FILE* stream, ComputerPlayer const* player)
+{
+    if (player->predictions > 0)
+    {
+        fprintf(stream, "Pondering: %lu of %lu expected replies played "
+            "(%.0f%% ponder hits).\n", player->ponderHits, player->predictions,
+            100.0 * player->ponderHits / player->predictions);
+    }
+}
@@ -0,0 +1,86 @@
+/* Computer players, which choose moves without user input. */
+
+#ifndef COMPUTER_H
+#define COMPUTER_H
+
+#include "board.h"
+#include "book.h"
+#include "mcts.h"
+#include "search.h"
+#include "settings.h"
+#include "solved_db.h"
+#include "transposition.h"
+
+#include <stdio.h>
+
+
+/* Background search of the position a computer player expects after its
+   opponent's reply. Private to the computer module. */
+typedef struct Ponder Ponder;
+
+
+/* State kept by a computer player between moves.
+   Use createComputerPlayer to properly create it, and destroyComputerPlayer to
+   properly destroy it. */
+typedef struct
+{
+    PlayerType type;            /* Any type except PLAYER_TYPE_HUMAN. */
+    TranspositionTable table;   /* Used by alpha-beta search only. */
+    SearchLimits searchLimits;
+    MctsLimits mctsLimits;
+    unsigned long random;       /* Random number generator state. */
+    /* Played from instead of searching, where it matches the board. Not used
+       by random players. May be NULL. */
+    SolvedDatabase const* solved;
+    /* Played from instead of searching, where it matches the board and the
+       solved database doesn't. Not used by random players. May be NULL. */
+    OpeningBook const* book;
+    Ponder* ponder;             /* Background search in progress, or NULL. */
+    unsigned long predictions;  /* Replies pondered on. */
+    unsigned long ponderHits;   /* Pondered replies the opponent played. */
+} ComputerPlayer;
+
+
+/* Returns a ComputerPlayer object with all members zeroed out. */
+ComputerPlayer zeroedComputerPlayer(void);
+
+/* Creates a computer player of the given type, configured from settings.
+   type must not be PLAYER_TYPE_HUMAN. seed seeds any random choices. */
+ComputerPlayer createComputerPlayer(PlayerType type, Settings const* settings,
+    unsigned long seed);
+
+/* Destroys a computer player (stops pondering, deallocates resources,
+   etc.). */
+void destroyComputerPlayer(ComputerPlayer* player);
+
+/* Sets how long the player's moves may take. Alpha-beta searches start no new
+   iteration after softSeconds and stop at hardSeconds, and Monte Carlo tree
+   searches stop at softSeconds. softSeconds must be at most hardSeconds. */
+void setComputerMoveTime(ComputerPlayer* player, double softSeconds,
+    double hardSeconds);
+
+/* Chooses a move for the player whose turn it is. board must not be full.
+   If the player was pondering on this position, carries on with that search
+   for what is left of its time rather than starting again.
+   If verbose is non-zero, prints the move and any search statistics, solved
+   value or use of the opening book to stdout. */
+void computerPlayerMove(ComputerPlayer* player, GameBoard const* board,
+    unsigned* row, unsigned* column, int verbose);
+
+/* Starts pondering: searching in a background thread, sharing the player's
+   table, the position after the reply that the player's last search expects
+   to the move it just made on board. The search runs until the player's next
+   move, which uses it if the opponent made that reply and discards it
+   otherwise. Only alpha-beta players ponder. Does nothing if the player
+   expects no reply or the reply ends the game. */
+void startPondering(ComputerPlayer* player, GameBoard const* board);
+
+/* Stops and discards any search started by startPondering(). */
+void stopPondering(ComputerPlayer* player);
+
+/* Writes how often the player's pondered replies were played so far to a
+   stream, if it pondered at all. */
+void writePonderStatistics(FILE* stream, ComputerPlayer const* player);
+
+
+#endif
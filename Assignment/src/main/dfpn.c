@@ -0,0 +1,615 @@
+/* Depth-first proof-number search. */
+
+#include "dfpn.h"
+
+#include "board.h"
+#include "common.h"
+#include "timer.h"
+#include "window_counts.h"
+
+#include <assert.h>
+#include <signal.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Number of entries in each bucket of the table. A position may be stored in
+   any entry of the bucket its key maps to. */
+#define DFPN_BUCKET_SIZE 4u
+
+/* Positions expanded between checks of the clock and stop flag. */
+#define DFPN_CHECK_INTERVAL 1024ul
+
+/* Identifies checkpoint files, and their format version. */
+static char const CHECKPOINT_MAGIC[8] = {'M', 'N', 'K', 'D', 'F', 'P', 'N',
+    '1'};
+
+
+/* Proof and disproof numbers stored for a position. The numbers are for the
+   player to move: the proof number is the least number of positions that
+   must be solved to show the player reaches their goal, and the disproof
+   number to show they don't. X's goal is to win, and O's is to stop X
+   winning. */
+typedef struct
+{
+    unsigned long key;          /* Canonical hash of the position, or 0 if the
+                                   entry is unused. */
+    unsigned long proof;
+    unsigned long disproof;
+    unsigned long work;         /* Positions expanded to find the numbers.
+                                   Entries with less work are replaced
+                                   first. */
+} DfpnEntry;
+
+
+/* A move from the position being expanded, and the numbers of the position
+   after it. */
+typedef struct
+{
+    unsigned row;
+    unsigned column;
+    unsigned long proof;
+    unsigned long disproof;
+} DfpnChild;
+
+
+/* State of a search. */
+typedef struct
+{
+    GameBoard board;            /* Position being expanded. */
+    DfpnOptions options;
+    DfpnEntry* table;
+    size_t bucketCount;         /* Number of buckets, a power of 2. */
+    size_t used;                /* Entries of table in use. */
+    DfpnChild* children;        /* Moves of each position on the path from
+                                   the root, cells entries per ply. */
+    unsigned long nodes;        /* Positions expanded. */
+    double startSeconds;        /* When the search started, less the time
+                                   taken before a resumed checkpoint. */
+    double lastCheckpoint;      /* When the table was last saved. */
+    double lastProgress;        /* When progress was last reported. */
+    int rootExpanded;           /* Whether the first entries of children hold
+                                   the moves from the root. */
+    int stopped;                /* Whether the search is stopping early. */
+    int error;                  /* Whether saving a checkpoint failed. */
+} DfpnSolver;
+
+
+/* Adds proof or disproof numbers, saturating at DFPN_INFINITY. */
+static unsigned long addNumbers(unsigned long a, unsigned long b)
+{
+    return a >= DFPN_INFINITY - b ? DFPN_INFINITY : a + b;
+}
+
+
+/* Finds the entry for a key, or NULL if it isn't in the table. */
+static DfpnEntry* findEntry(DfpnSolver* solver, unsigned long key)
+{
+    DfpnEntry* bucket = solver->table
+        + (key & (solver->bucketCount - 1u)) * DFPN_BUCKET_SIZE;
+    DfpnEntry* entry = NULL;
+    unsigned i = 0;
+
+    for (i = 0; i < DFPN_BUCKET_SIZE && !entry; ++i)
+    {
+        if (bucket[i].key == key)
+        {
+            entry = bucket + i;
+        }
+    }
+
+    return entry;
+}
+
+
+/* Stores the numbers of a position, replacing its existing entry, otherwise
+   an unused entry, otherwise the entry in the bucket with the least work. */
+static void storeEntry(DfpnSolver* solver, unsigned long key,
+    unsigned long proof, unsigned long disproof, unsigned long work)
+{
+    DfpnEntry* bucket = solver->table
+        + (key & (solver->bucketCount - 1u)) * DFPN_BUCKET_SIZE;
+    DfpnEntry* entry = findEntry(solver, key);
+    unsigned i = 0;
+
+    for (i = 0; i < DFPN_BUCKET_SIZE && !entry; ++i)
+    {
+        if (bucket[i].key == 0)
+        {
+            entry = bucket + i;
+            ++solver->used;
+        }
+    }
+    if (!entry)
+    {
+        entry = bucket;
+        for (i = 1; i < DFPN_BUCKET_SIZE; ++i)
+        {
+            if (bucket[i].work < entry->work)
+            {
+                entry = bucket + i;
+            }
+        }
+    }
+
+    entry->key = key;
+    entry->proof = proof;
+    entry->disproof = disproof;
+    entry->work = work;
+}
+
+
+/* Gets the key of the position on the solver's board. Equivalent positions
+   share a key, and so an entry. */
+static unsigned long positionKey(DfpnSolver const* solver)
+{
+    unsigned long const key = canonicalHash(&solver->board);
+
+    return key == 0 ? 1 : key;
+}
+
+
+/* Checks if X can still complete a line: some window holds no O cells. */
+static int firstPlayerCanWin(GameBoard const* board)
+{
+    unsigned long open = 0;
+    unsigned count = 0;
+
+    for (count = 0; count <= board->winRequirement && open == 0; ++count)
+    {
+        open += countOpenWindows(&board->windows, PLAYER_X, count);
+    }
+
+    return open > 0;
+}
+
+
+/* Gets the numbers of the position on the solver's board, if they are known
+   without expanding it: the game is over, X can no longer win, or the player
+   to move can win at once. Otherwise gets any stored numbers, or 1 and 1 for
+   an unseen position. */
+static void evaluatePosition(DfpnSolver* solver, unsigned long* proof,
+    unsigned long* disproof)
+{
+    GameBoard const* const board = &solver->board;
+    Player const mover = nextPlayer(board);
+    unsigned long const cells = (unsigned long)board->rows * board->columns;
+    DfpnEntry const* entry = NULL;
+    int goalReached = 0;
+    int known = 1;
+
+    if (board->occupied > 0 && hasPlayerWon(board, otherPlayer(mover)))
+    {
+        /* A win for either player is a loss for the player to move. */
+        goalReached = 0;
+    }
+    else if (board->occupied == cells || !firstPlayerCanWin(board))
+    {
+        /* No win for X, which is O's goal. */
+        goalReached = mover == PLAYER_O;
+    }
+    else if (countOpenWindows(&board->windows, mover,
+        board->winRequirement - 1u) > 0)
+    {
+        /* Any win achieves either player's goal. */
+        goalReached = 1;
+    }
+    else
+    {
+        known = 0;
+        entry = findEntry(solver, positionKey(solver));
+    }
+
+    if (known)
+    {
+        *proof = goalReached ? 0 : DFPN_INFINITY;
+        *disproof = goalReached ? DFPN_INFINITY : 0;
+    }
+    else if (entry)
+    {
+        *proof = entry->proof;
+        *disproof = entry->disproof;
+    }
+    else
+    {
+        *proof = 1;
+        *disproof = 1;
+    }
+}
+
+
+/* Gets the current proof and disproof numbers of the empty board, from those
+   of its moves if it has been expanded. */
+static void rootNumbers(DfpnSolver* solver, unsigned long* proof,
+    unsigned long* disproof)
+{
+    unsigned const cells = solver->board.rows * solver->board.columns;
+    unsigned i = 0;
+
+    if (solver->rootExpanded)
+    {
+        *proof = DFPN_INFINITY;
+        *disproof = 0;
+        for (i = 0; i < cells; ++i)
+        {
+            if (solver->children[i].disproof < *proof)
+            {
+                *proof = solver->children[i].disproof;
+            }
+            *disproof = addNumbers(*disproof, solver->children[i].proof);
+        }
+    }
+    else
+    {
+        /* Not expanded yet, so the search is still at the root. */
+        evaluatePosition(solver, proof, disproof);
+    }
+}
+
+
+/* Reads an 8 byte little-endian integer from a file. Returns 0 at the end of
+   the file. */
+static int readInteger(FILE* file, unsigned long* value)
+{
+    unsigned char bytes[8];
+    int const res = fread(bytes, 1, sizeof bytes, file) == sizeof bytes;
+
+    *value = res ? readLittleEndian(bytes, sizeof bytes) : 0;
+
+    return res;
+}
+
+
+/* Saves the table to the checkpoint file. The file is written under a
+   temporary name then renamed, so an interruption never leaves a partial
+   checkpoint. */
+static void saveCheckpoint(DfpnSolver* solver)
+{
+    size_t const entries = solver->bucketCount * DFPN_BUCKET_SIZE;
+    char const* const path = solver->options.checkpointPath;
+    char* tempPath = malloc(strlen(path) + 5u);
+    FILE* file = NULL;
+    size_t i = 0;
+
+    sprintf(tempPath, "%s.tmp", path);
+    file = fopen(tempPath, "wb");
+
+    if (file)
+    {
+        fwrite(CHECKPOINT_MAGIC, 1, sizeof CHECKPOINT_MAGIC, file);
+        writeLittleEndian(file, solver->board.rows, 8);
+        writeLittleEndian(file, solver->board.columns, 8);
+        writeLittleEndian(file, solver->board.winRequirement, 8);
+        writeLittleEndian(file, solver->nodes, 8);
+        writeLittleEndian(file, (unsigned long)((monotonicSeconds()
+            - solver->startSeconds) * 1000.0), 8);
+        writeLittleEndian(file, solver->used, 8);
+        for (i = 0; i < entries; ++i)
+        {
+            if (solver->table[i].key != 0)
+            {
+                writeLittleEndian(file, solver->table[i].key, 8);
+                writeLittleEndian(file, solver->table[i].proof, 8);
+                writeLittleEndian(file, solver->table[i].disproof, 8);
+                writeLittleEndian(file, solver->table[i].work, 8);
+            }
+        }
+
+        solver->error = ferror(file);
+        solver->error |= fclose(file) != 0;
+    }
+
+    if (!file || solver->error || rename(tempPath, path) != 0)
+    {
+        perror("Error saving checkpoint");
+        solver->error = 1;
+    }
+
+    free(tempPath);
+    solver->lastCheckpoint = monotonicSeconds();
+}
+
+
+/* Loads the table from the checkpoint file, which must be for the same
+   board. If it can't, prints info to stderr and returns 0. */
+static int loadCheckpoint(DfpnSolver* solver)
+{
+    FILE* file = fopen(solver->options.checkpointPath, "rb");
+    char magic[sizeof CHECKPOINT_MAGIC];
+    unsigned long header[6];
+    unsigned long entry[4];
+    unsigned long i = 0;
+    int res = file != NULL;
+
+    res = res && fread(magic, 1, sizeof magic, file) == sizeof magic
+        && memcmp(magic, CHECKPOINT_MAGIC, sizeof magic) == 0;
+    for (i = 0; i < 6u && res; ++i)
+    {
+        res = readInteger(file, header + i);
+    }
+    res = res && header[0] == solver->board.rows
+        && header[1] == solver->board.columns
+        && header[2] == solver->board.winRequirement;
+
+    for (i = 0; res && i < header[5]; ++i)
+    {
+        res = readInteger(file, entry) && readInteger(file, entry + 1)
+            && readInteger(file, entry + 2) && readInteger(file, entry + 3);
+        if (res)
+        {
+            storeEntry(solver, entry[0], entry[1], entry[2], entry[3]);
+        }
+    }
+
+    if (res)
+    {
+        solver->nodes = header[3];
+        solver->startSeconds -= header[4] / 1000.0;
+    }
+    else
+    {
+        fprintf(stderr, "Error: could not load checkpoint \"%s\" for this "
+            "board.\n", solver->options.checkpointPath);
+    }
+
+    if (file)
+    {
+        fclose(file);
+    }
+
+    return res;
+}
+
+
+/* Prints a progress report to stderr. */
+static void reportProgress(DfpnSolver* solver)
+{
+    double const seconds = monotonicSeconds() - solver->startSeconds;
+    unsigned long proof = 0;
+    unsigned long disproof = 0;
+
+    rootNumbers(solver, &proof, &disproof);
+    fprintf(stderr, "dfpn: %.0fs, %lu nodes (%.0f/s), root proof %lu "
+        "disproof %lu, table %.1f%% full, depth %lu.\n", seconds,
+        solver->nodes, seconds > 0.0 ? solver->nodes / seconds : 0.0, proof,
+        disproof, 100.0 * solver->used
+            / (solver->bucketCount * DFPN_BUCKET_SIZE),
+        (unsigned long)solver->board.moveCount);
+
+    solver->lastProgress = monotonicSeconds();
+}
+
+
+/* Checks the node limit and stop flag, and saves checkpoints and reports
+   progress when they are due. */
+static void checkSolver(DfpnSolver* solver)
+{
+    DfpnOptions const* const options = &solver->options;
+    double const now = monotonicSeconds();
+
+    if ((options->maxNodes > 0 && solver->nodes >= options->maxNodes)
+        || (options->stop && *options->stop))
+    {
+        solver->stopped = 1;
+    }
+    if (options->checkpointPath
+        && now - solver->lastCheckpoint >= options->checkpointSeconds)
+    {
+        saveCheckpoint(solver);
+    }
+    if (options->progressSeconds > 0.0
+        && now - solver->lastProgress >= options->progressSeconds)
+    {
+        reportProgress(solver);
+    }
+}
+
+
+/* Expands the position on the solver's board until its proof number reaches
+   proofThreshold or its disproof number reaches disproofThreshold, then
+   stores and gets its numbers. The position must not be known without
+   expanding it (see evaluatePosition()). ply is the number of moves from the
+   root. */
+static void expand(DfpnSolver* solver, unsigned ply,
+    unsigned long proofThreshold, unsigned long disproofThreshold,
+    unsigned long* proof, unsigned long* disproof)
+{
+    GameBoard* const board = &solver->board;
+    unsigned const cells = board->rows * board->columns;
+    CellStatus const mover = playerToCell(nextPlayer(board));
+    unsigned long const key = positionKey(solver);
+    unsigned long const startNodes = solver->nodes;
+    DfpnChild* const children = solver->children + (size_t)ply * cells;
+    DfpnChild* best = NULL;
+    unsigned long secondDisproof = 0;
+    unsigned childCount = 0;
+    int done = 0;
+    unsigned row = 0;
+    unsigned column = 0;
+    unsigned i = 0;
+
+    ++solver->nodes;
+    if (solver->nodes % DFPN_CHECK_INTERVAL == 0)
+    {
+        checkSolver(solver);
+    }
+
+    for (row = 0; row < board->rows; ++row)
+    {
+        for (column = 0; column < board->columns; ++column)
+        {
+            if (getBoardCell(board, row, column) == CELL_EMPTY)
+            {
+                children[childCount].row = row;
+                children[childCount].column = column;
+                makeMove(board, row, column, mover);
+                evaluatePosition(solver, &children[childCount].proof,
+                    &children[childCount].disproof);
+                unmakeMove(board);
+                ++childCount;
+            }
+        }
+    }
+    assert(childCount > 0);
+    solver->rootExpanded |= ply == 0;
+
+    do
+    {
+        /* The player to move reaches their goal if any move stops the
+           opponent reaching theirs, and fails only if every move does. */
+        *proof = DFPN_INFINITY;
+        *disproof = 0;
+        secondDisproof = DFPN_INFINITY;
+        best = children;
+        for (i = 0; i < childCount; ++i)
+        {
+            *disproof = addNumbers(*disproof, children[i].proof);
+            if (children[i].disproof < *proof)
+            {
+                secondDisproof = *proof;
+                *proof = children[i].disproof;
+                best = children + i;
+            }
+            else if (children[i].disproof < secondDisproof)
+            {
+                secondDisproof = children[i].disproof;
+            }
+        }
+
+        done = *proof >= proofThreshold || *disproof >= disproofThreshold
+            || solver->stopped;
+
+        /* Search the most proving move until it's no longer the most
+           proving, or this position's thresholds would be reached. */
+        if (!done)
+        {
+            makeMove(board, best->row, best->column, mover);
+            expand(solver, ply + 1u,
+                disproofThreshold >= DFPN_INFINITY ? DFPN_INFINITY
+                    : disproofThreshold - *disproof + best->proof,
+                addNumbers(secondDisproof, 1) < proofThreshold
+                    ? addNumbers(secondDisproof, 1) : proofThreshold,
+                &best->proof, &best->disproof);
+            unmakeMove(board);
+        }
+    } while (!done);
+
+    storeEntry(solver, key, *proof, *disproof, solver->nodes - startNodes);
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+DfpnOptions defaultDfpnOptions(void)
+{
+    DfpnOptions options;
+
+    options.tableBytes = (size_t)64 << 20;
+    options.maxNodes = 0;
+    options.checkpointPath = NULL;
+    options.checkpointSeconds = 600.0;
+    options.resume = 0;
+    options.progressSeconds = 0.0;
+    options.stop = NULL;
+
+    return options;
+}
+
+
+DfpnResult proveFirstPlayerWin(unsigned rows, unsigned columns,
+    unsigned winRequirement, DfpnOptions const* options)
+{
+    DfpnSolver solver;
+    DfpnResult result;
+    unsigned const cells = rows * columns;
+    int counted = 0;
+
+    assert(rows > 0 && columns > 0 && winRequirement > 0);
+    assert(columns <= DFPN_MAX_CELLS / rows);
+
+    solver.board = createGameBoard(rows, columns, winRequirement);
+    solver.options = *options;
+    solver.bucketCount = 1;
+    /* Divided rather than multiplied so a huge table can't overflow. */
+    while (solver.bucketCount * 2u
+        <= options->tableBytes / (DFPN_BUCKET_SIZE * sizeof(DfpnEntry)))
+    {
+        solver.bucketCount *= 2u;
+    }
+    solver.table = calloc(solver.bucketCount * DFPN_BUCKET_SIZE,
+        sizeof(DfpnEntry));
+    solver.used = 0;
+    solver.children = malloc((size_t)cells * (cells + 1u) * sizeof(DfpnChild));
+    solver.nodes = 0;
+    solver.startSeconds = monotonicSeconds();
+    solver.lastCheckpoint = solver.startSeconds;
+    solver.lastProgress = solver.startSeconds;
+    solver.rootExpanded = 0;
+    solver.stopped = 0;
+    solver.error = 0;
+
+    counted = enableSmallWindowCounts(&solver.board);
+    assert(counted);
+
+    result.outcome = DFPN_UNKNOWN;
+    result.proof = DFPN_INFINITY;
+    result.disproof = DFPN_INFINITY;
+    if (!solver.table || !solver.children)
+    {
+        fprintf(stderr, "Error: not enough memory for a %luMB table.\n",
+            (unsigned long)(options->tableBytes >> 20));
+        solver.error = 1;
+    }
+    else if (options->resume && options->checkpointPath)
+    {
+        solver.error = !loadCheckpoint(&solver);
+    }
+
+    if (!solver.error)
+    {
+        evaluatePosition(&solver, &result.proof, &result.disproof);
+        checkSolver(&solver);
+        if (result.proof != 0 && result.disproof != 0 && !solver.stopped)
+        {
+            expand(&solver, 0, DFPN_INFINITY, DFPN_INFINITY, &result.proof,
+                &result.disproof);
+        }
+
+        if (options->checkpointPath)
+        {
+            saveCheckpoint(&solver);
+        }
+        if (options->progressSeconds > 0.0)
+        {
+            reportProgress(&solver);
+        }
+    }
+
+    /* The root is an X position, so its proof number is for X winning. */
+    if (!solver.error && result.proof == 0)
+    {
+        result.outcome = DFPN_PROVEN;
+    }
+    else if (!solver.error && result.disproof == 0)
+    {
+        result.outcome = DFPN_DISPROVEN;
+    }
+    result.error = solver.error;
+    result.nodes = solver.nodes;
+    result.seconds = monotonicSeconds() - solver.startSeconds;
+    result.tableFill = (double)solver.used
+        / (solver.bucketCount * DFPN_BUCKET_SIZE);
+
+    free(solver.children);
+    free(solver.table);
+    destroyGameBoard(&solver.board);
+
+    return result;
+}
@@ -0,0 +1,84 @@
+/* Depth-first proof-number search, which proves or disproves that the first
+   player (X) can force a win from an empty board.
+   Proof and disproof numbers are kept in a fixed-size table, so memory use is
+   bounded however long the search runs. The table is the whole state of the
+   search, so it can be saved to a checkpoint file and loaded to resume an
+   interrupted search. */
+
+#ifndef DFPN_H
+#define DFPN_H
+
+#include <signal.h>
+#include <stddef.h>
+
+
+/* Proof or disproof number of a position that has been disproved or proved. */
+#define DFPN_INFINITY 0x3ffffffful
+
+/* Most cells on a board that can be searched. The moves of every position on
+   the path being expanded take cells * (cells + 1) * 24 bytes or so, which is
+   about 25MB at this limit. */
+#define DFPN_MAX_CELLS 1024u
+
+
+/* Outcome of a proof-number search. */
+typedef enum
+{
+    DFPN_UNKNOWN,       /* Search stopped before finishing. */
+    DFPN_PROVEN,        /* X can force a win. */
+    DFPN_DISPROVEN      /* O can force a win or a draw. */
+} DfpnOutcome;
+
+
+/* Options of a proof-number search. */
+typedef struct
+{
+    size_t tableBytes;          /* Memory for the table, rounded down to a
+                                   power of 2 number of buckets. */
+    unsigned long maxNodes;     /* Positions to expand before stopping, or 0
+                                   for no limit. */
+    /* File to save the table to every checkpointSeconds and when the search
+       ends, or NULL to not save it. */
+    char const* checkpointPath;
+    double checkpointSeconds;
+    int resume;                 /* Whether to load checkpointPath before
+                                   searching. */
+    double progressSeconds;     /* Interval between progress reports to stderr,
+                                   or 0 for none. */
+    /* Set to non-zero (e.g. from a signal handler) to stop the search early,
+       or NULL. */
+    volatile sig_atomic_t const* stop;
+} DfpnOptions;
+
+
+/* Outcome and statistics of a proof-number search. */
+typedef struct
+{
+    DfpnOutcome outcome;
+    int error;                  /* Whether memory couldn't be allocated or a
+                                   checkpoint couldn't be loaded or saved. */
+    unsigned long proof;        /* Proof and disproof numbers of the empty
+                                   board. */
+    unsigned long disproof;
+    unsigned long nodes;        /* Positions expanded, including before a
+                                   resumed checkpoint. */
+    double seconds;             /* Wall-clock time taken, including before a
+                                   resumed checkpoint. */
+    double tableFill;           /* Fraction of table entries in use. */
+} DfpnResult;
+
+
+/* Returns the default options: a table of about 64MB, no node limit, and no
+   checkpoints or progress reports. */
+DfpnOptions defaultDfpnOptions(void);
+
+/* Proves or disproves that X can force a win from an empty board with the
+   given dimensions. rows, columns and winRequirement must all be >0, and the
+   board must have at most DFPN_MAX_CELLS cells.
+   If memory can't be allocated or an error occurs loading or saving a
+   checkpoint, prints info to stderr and sets the result's error. */
+DfpnResult proveFirstPlayerWin(unsigned rows, unsigned columns,
+    unsigned winRequirement, DfpnOptions const* options);
+
+
+#endif
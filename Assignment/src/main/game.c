@@ -0,0 +1,75 @@
+/* Game rules. */
+
+#include "game.h"
+
+#include "board.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+
+/* PUBLIC INTERFACE */
+
+
+GameHooks zeroedGameHooks(void)
+{
+    GameHooks hooks;
+
+    hooks.move = NULL;
+    hooks.moved = NULL;
+    hooks.turnEnded = NULL;
+    hooks.context = NULL;
+
+    return hooks;
+}
+
+
+GameResult playGame(GameBoard* board, GameHooks const* hooks)
+{
+    unsigned long const cells = (unsigned long)board->rows * board->columns;
+    Player player = PLAYER_X;
+    TurnInput input = TURN_MOVE;
+    unsigned row = 0;
+    unsigned column = 0;
+    int won = 0;
+    /* Every line is blocked on a full board, so a draw is only dead if it
+       ends the game early. */
+    int deadDraw = board->occupied < cells && hasWindowCounts(board)
+        && isDeadDraw(board);
+    int stopped = 0;
+
+    /* Checking for a full board before every turn (rather than every pair of
+       turns) stops O being asked to play on a full board with an odd number
+       of cells. */
+    while (board->occupied < cells && !won && !deadDraw && !stopped)
+    {
+        player = nextPlayer(board);
+        input = hooks->move(hooks->context, board, player, &row, &column);
+        stopped = input == TURN_STOP;
+
+        if (input == TURN_MOVE)
+        {
+            assert(inBoardBounds(board, row, column));
+            assert(getBoardCell(board, row, column) == CELL_EMPTY);
+            makeMove(board, row, column, playerToCell(player));
+
+            /* Any win must include the cell just placed, so only the lines
+               through it need checking. */
+            won = hasPlayerWonAt(board, row, column);
+            if (hooks->moved)
+            {
+                hooks->moved(hooks->context, board, player, row, column, won);
+            }
+        }
+
+        deadDraw = !won && !stopped && board->occupied < cells
+            && hasWindowCounts(board) && isDeadDraw(board);
+        if (!stopped && hooks->turnEnded)
+        {
+            hooks->turnEnded(hooks->context, board);
+        }
+    }
+
+    return won ? GAME_WON : deadDraw ? GAME_DEAD_DRAW
+        : stopped ? GAME_STOPPED : GAME_DRAWN;
+}
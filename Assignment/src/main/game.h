@@ -0,0 +1,58 @@
+/* The rules of a game: turns until a player completes a line or the game is
+   drawn, with where moves come from and what is done after each turn left to
+   hooks, so interactive and scripted games play by the same loop. */
+
+#ifndef GAME_H
+#define GAME_H
+
+#include "board.h"
+
+
+/* What a GameHooks::move hook asks for. */
+typedef enum
+{
+    TURN_MOVE,          /* Make the move given. */
+    TURN_UNDONE,        /* The hook took back moves instead, so the player
+                           then to move takes a turn. */
+    TURN_STOP           /* End the game here, without a move. */
+} TurnInput;
+
+
+/* How a game ended. */
+typedef enum
+{
+    GAME_WON,           /* The player who made the last move won. */
+    GAME_DRAWN,         /* The board was filled without a winner. */
+    GAME_DEAD_DRAW,     /* Neither player could complete a line any more. */
+    GAME_STOPPED        /* A move hook ended the game. */
+} GameResult;
+
+
+/* Hooks called by playGame(). context is passed to each. */
+typedef struct
+{
+    /* Gets the move of the player to move, which must be inside the board on
+       an empty cell. Must be set. */
+    TurnInput (*move)(void* context, GameBoard* board, Player player,
+        unsigned* row, unsigned* column);
+    /* Called after a move is made, with whether it won. Optional. */
+    void (*moved)(void* context, GameBoard const* board, Player player,
+        unsigned row, unsigned column, int won);
+    /* Called after every turn that didn't stop the game. Optional. */
+    void (*turnEnded)(void* context, GameBoard const* board);
+    void* context;
+} GameHooks;
+
+
+/* Returns a GameHooks object with all members zeroed out. */
+GameHooks zeroedGameHooks(void);
+
+/* Plays turns on a board from its current position, X moving first, until a
+   player completes a line, the board is full, or a move hook stops the game.
+   If the board has window counts, the game also ends in a dead draw once
+   neither player can complete a line, which may be before any turns. The
+   moves made are left on the board. */
+GameResult playGame(GameBoard* board, GameHooks const* hooks);
+
+
+#endif
@@ -4,8 +4,15 @@
 
 #include "board.h"
 #include "common.h"
+#include "computer.h"
+#include "game.h"
 #include "log.h"
+#include "render.h"
 #include "settings.h"
+#include "solved_db.h"
+#include "terminal.h"
+#include "time_control.h"
+#include "timer.h"
 
 #include <assert.h>
 #include <errno.h>
@@ -19,6 +26,77 @@
 /* PRIVATE INTERFACE */
 
 
+/* Largest part of a board shown at once during a game. Bigger boards are
+   shown through a viewport around the latest move, with row and column
+   numbers, so they don't flood the terminal. */
+#define VIEWPORT_ROWS 20u
+#define VIEWPORT_COLUMNS 20u
+
+/* Screen lines a live display keeps free under the board for the status line,
+   clock, prompt and any errors, so the board isn't scrolled away. */
+#define LIVE_TEXT_LINES 8u
+
+/* Enough for the line naming the part of a board shown through a viewport. */
+#define VIEWPORT_HEADER_SIZE 160u
+
+
+/* Names of each PlayerType, as shown to the user. */
+static char const* const PLAYER_TYPE_NAMES[] = {
+    "Human",
+    "Computer (alpha-beta search)",
+    "Computer (Monte Carlo tree search)",
+    "Computer (random moves)"
+};
+
+static unsigned const PLAYER_TYPE_COUNT =
+    sizeof PLAYER_TYPE_NAMES / sizeof PLAYER_TYPE_NAMES[0];
+
+
+/* What the user entered at a coordinate prompt. */
+typedef enum
+{
+    INPUT_COORDINATE,
+    INPUT_UNDO,
+    INPUT_HINT,
+    INPUT_VIEW          /* Asked to see the board around a coordinate. */
+} CoordinateInputKind;
+
+
+/* How the board is drawn during a game. */
+typedef struct
+{
+    FrameBuffer frame;  /* Reused for every redraw. */
+    int windowed;       /* Whether the board is too big to show whole, so is
+                           shown through a viewport. */
+    int live;           /* Whether the board is kept at the top of the
+                           screen, and only cells that change are redrawn,
+                           with ANSI escape codes, when it fits. */
+    int fitted;         /* Whether the last frame was drawn live, fitting
+                           the screen, so its cells can be redrawn. */
+    int labels;         /* Whether the last frame has row and column
+                           numbers. */
+    unsigned long lines;        /* Screen size the last frame fitted. */
+    unsigned long characters;
+    Viewport viewport;  /* Part of the board last drawn. */
+    unsigned long top;  /* Screen line the last frame drawn starts on. */
+    size_t drawnMoves;  /* Moves on the board when it was last drawn. */
+} BoardDisplay;
+
+
+/* State of an interactive game, shared by its GameHooks. */
+typedef struct
+{
+    Settings const* settings;
+    ComputerPlayer* computers;      /* Indexed by Player, for computer
+                                       players. */
+    BoardDisplay* display;
+    GameClock clock;
+    int timed;                      /* Whether the clock is used. */
+    int outOfTime;                  /* Set once the player to move has run
+                                       out of time. */
+} InteractiveGame;
+
+
 /* Stores data required for main menu options. */
 typedef struct
 {
@@ -101,11 +179,19 @@ static unsigned unsignedIntInput(char const* prompt)
 }
 
 
-/* Gets a coordinate from the user in the form column,row. */
-static void coordinateInput(char const* prompt, long* row, long* column)
+/* Gets a coordinate from the user in the form column,row, or "view column,row"
+   to look at another part of the board.
+   If allowUndo or allowHint is non-zero, the user may enter "undo" or "hint"
+   instead, in which case row and column are left unchanged.
+   Returns which was entered. */
+static CoordinateInputKind coordinateInput(char const* prompt, long* row,
+    long* column, int allowUndo, int allowHint)
 {
     int valid = 0;
+    CoordinateInputKind kind = INPUT_COORDINATE;
     char line[128] = {0};
+    char const* coordinate = NULL;
+    int viewing = 0;
     int scanRes = 0;
     int scanned = 0;
 
@@ -115,16 +201,31 @@ static void coordinateInput(char const* prompt, long* row, long* column)
         fgets(line, sizeof line, stdin);
 
         /* Whole line was read. */
-        if (strchr(line, '\n'))
+        if (allowUndo && strncmp(line, "undo", 4) == 0
+            && isWhitespace(line + 4))
+        {
+            kind = INPUT_UNDO;
+            valid = 1;
+        }
+        else if (allowHint && strncmp(line, "hint", 4) == 0
+            && isWhitespace(line + 4))
+        {
+            kind = INPUT_HINT;
+            valid = 1;
+        }
+        else if (strchr(line, '\n'))
         {
+            viewing = strncmp(line, "view", 4) == 0;
+            coordinate = viewing ? line + 4 : line;
             /* Can't use %u format specifier again. */
-            scanRes = sscanf(line, "%ld ,%ld%n", column, row, &scanned);
+            scanRes = sscanf(coordinate, "%ld ,%ld%n", column, row, &scanned);
             /* No idea what happens if the character read count can't fit in an
                int (%n doesn't seem to work correctly with long int), it doesn't
                seem to be documented. That shouldn't happen in this case,
                however.*/
-            if (scanRes == 2 && isWhitespace(line + scanned))
+            if (scanRes == 2 && isWhitespace(coordinate + scanned))
             {
+                kind = viewing ? INPUT_VIEW : INPUT_COORDINATE;
                 valid = 1;
             }
             else
@@ -140,27 +241,229 @@ static void coordinateInput(char const* prompt, long* row, long* column)
             readUntil(stdin, '\n', 1);
         }
     } while (!valid);
+
+    return kind;
 }
 
 
-/* Inputs and executes a player's turn. */
-static void playerTurn(GameBoard* board, Player player)
+/* Writes the line naming the part of a board a viewport shows into a buffer
+   of VIEWPORT_HEADER_SIZE characters. Returns its length. */
+static unsigned long formatViewportHeader(char* header,
+    Viewport const* viewport, GameBoard const* board)
 {
-    long row = 0;
-    long column = 0;
-    int validCoordinate = 0;
+    return (unsigned long)sprintf(header, "Columns %u-%u, rows %u-%u of "
+        "%ux%u (enter \"view column,row\" to look elsewhere):",
+        viewport->firstColumn, viewport->firstColumn + viewport->columns - 1u,
+        viewport->firstRow, viewport->firstRow + viewport->rows - 1u,
+        board->columns, board->rows);
+}
+
+
+/* Counts the screen lines a line of text of the given length takes up. */
+static unsigned long screenLines(unsigned long length,
+    unsigned long characters)
+{
+    return length > 0 ? (length - 1u) / characters + 1u : 1u;
+}
+
+
+/* Picks the viewport a live display draws the board through on a screen of
+   the given size, so that the viewport's header, the frame and the text under
+   it neither scroll nor wrap. Returns 0 if the screen is too small. */
+static int fitLiveViewport(GameBoard const* board, unsigned row,
+    unsigned column, unsigned long lines, unsigned long characters,
+    Viewport* viewport, int* labels)
+{
+    char header[VIEWPORT_HEADER_SIZE];
+    /* The header is longest for the last cell's coordinates. */
+    Viewport const last = viewportAround(board, board->rows - 1u,
+        board->columns - 1u, 1u, 1u);
+    unsigned long const headerLines = screenLines(
+        formatViewportHeader(header, &last, board), characters);
+
+    return lines > headerLines + LIVE_TEXT_LINES
+        && fitViewport(board, row, column, VIEWPORT_ROWS, VIEWPORT_COLUMNS,
+            lines - headerLines - LIVE_TEXT_LINES, characters, viewport,
+            labels);
+}
 
-    printf("Player %c's turn.\n", playerToChar(player));
+
+/* Draws the board, through a viewport centred on the given cell if it is
+   too big to show whole. A live display is drawn from the top of a cleared
+   screen, through a smaller viewport if needed to fit it; if even that
+   doesn't fit, or the screen size is unknown, it is printed in full like any
+   other display. */
+static void showBoard(BoardDisplay* display, GameBoard const* board,
+    unsigned row, unsigned column)
+{
+    Viewport viewport = fullViewport(board);
+    int labels = display->windowed;
+    unsigned long lines = 0;
+    unsigned long characters = 0;
+    char header[VIEWPORT_HEADER_SIZE];
+    unsigned long headerLength = 0;
+
+    display->fitted = display->live
+        && terminalSize(stdout, &lines, &characters)
+        && fitLiveViewport(board, row, column, lines, characters, &viewport,
+            &labels);
+    if (display->fitted)
+    {
+        clearScreen(stdout);
+        display->lines = lines;
+        display->characters = characters;
+    }
+    else if (labels)
+    {
+        viewport = viewportAround(board, row, column, VIEWPORT_ROWS,
+            VIEWPORT_COLUMNS);
+    }
+
+    display->top = 0;
+    if (labels)
+    {
+        headerLength = formatViewportHeader(header, &viewport, board);
+        printf("%s\n", header);
+        display->top = display->fitted
+            ? screenLines(headerLength, characters) : 1u;
+    }
+
+    /* A viewport is always small enough, so only allocation can fail. */
+    if (!renderBoard(&display->frame, board, &viewport, labels))
+    {
+        fprintf(stderr, "Error: not enough memory to draw the board.\n");
+    }
+    writeFrame(&display->frame, stdout);
+    display->labels = labels;
+    display->viewport = viewport;
+    display->drawnMoves = board->moveCount;
+}
+
+
+/* Draws the board around the latest move, or its middle before any moves.
+   If the last frame was drawn live, the screen is the same size, and the only
+   change since is a move inside its viewport, just that cell is redrawn, and
+   the text under the board is cleared. */
+static void showLatestMove(BoardDisplay* display, GameBoard const* board)
+{
+    BoardMove const* latest = board->moveCount > 0
+        ? board->moves + board->moveCount - 1u : NULL;
+    unsigned long line = 0;
+    unsigned long character = 0;
+    unsigned long lines = 0;
+    unsigned long characters = 0;
+
+    if (display->fitted && latest
+        && board->moveCount == display->drawnMoves + 1u
+        && viewportContains(&display->viewport, latest->row, latest->column)
+        && terminalSize(stdout, &lines, &characters)
+        && lines == display->lines && characters == display->characters)
+    {
+        renderedCellPosition(&display->viewport, display->labels,
+            latest->row, latest->column, &line, &character);
+        moveCursor(stdout, display->top + line, character);
+        putchar(renderedCellChar(getBoardCell(board, latest->row,
+            latest->column)));
+        moveCursor(stdout, display->top
+            + renderedLineCount(&display->viewport, display->labels), 0);
+        clearToScreenEnd(stdout);
+        fflush(stdout);
+        display->drawnMoves = board->moveCount;
+    }
+    else
+    {
+        showBoard(display, board, latest ? latest->row : board->rows / 2u,
+            latest ? latest->column : board->columns / 2u);
+    }
+}
+
+
+/* Shows the board after a turn. A live display gets a status line under the
+   board with the latest move, as the turn's text is cleared; otherwise the
+   board is printed again after it. */
+static void showTurn(BoardDisplay* display, GameBoard const* board)
+{
+    BoardMove const* latest = board->moveCount > 0
+        ? board->moves + board->moveCount - 1u : NULL;
+
+    if (!display->fitted)
+    {
+        printf("\n");
+    }
+    showLatestMove(display, board);
+    if (display->live && latest)
+    {
+        printf("Latest move: %c at %u,%u.\n",
+            playerToChar(otherPlayer(nextPlayer(board))), latest->column,
+            latest->row);
+    }
+    printf("\n");
+}
+
+
+/* Prints the solved value of a position and the best move from it. */
+static void printHint(SolvedDatabase const* solved, GameBoard const* board)
+{
+    SolvedValue value;
+    unsigned row = 0;
+    unsigned column = 0;
+
+    if (solvedBestMove(solved, board, &row, &column, &value))
+    {
+        printf("Hint: play %u,%u (", column, row);
+        writeSolvedValue(stdout, value);
+        printf(").\n");
+    }
+    else
+    {
+        printf("No hint for this position.\n");
+    }
+}
+
+
+/* Inputs a move from the user, who may instead ask to undo if any moves have
+   been made, or for a hint if solved is a database matching the board (or
+   NULL). The user may also look at other parts of the board on display.
+   Returns non-zero if the user asked to undo, otherwise sets row and column. */
+static int humanMove(GameBoard const* board, SolvedDatabase const* solved,
+    BoardDisplay* display, unsigned* row, unsigned* column)
+{
+    long inputRow = 0;
+    long inputColumn = 0;
+    int validCoordinate = 0;
+    int undo = 0;
+    int const allowUndo = board->moveCount > 0;
+    int const allowHint = solved != NULL;
+    CoordinateInputKind kind = INPUT_COORDINATE;
 
     do
     {
-        coordinateInput("Enter coordinate: ", &row, &column);
-        if (row < 0 || row > UINT_MAX || column < 0 || column > UINT_MAX ||
-            !inBoardBounds(board, row, column))
+        kind = coordinateInput(allowUndo && allowHint
+            ? "Enter coordinate (or \"undo\" or \"hint\"): "
+            : allowUndo ? "Enter coordinate (or \"undo\"): "
+            : allowHint ? "Enter coordinate (or \"hint\"): "
+            : "Enter coordinate: ", &inputRow, &inputColumn, allowUndo,
+            allowHint);
+        undo = kind == INPUT_UNDO;
+        if (undo)
+        {
+            validCoordinate = 1;
+        }
+        else if (kind == INPUT_HINT)
+        {
+            printHint(solved, board);
+        }
+        else if (inputRow < 0 || inputRow > UINT_MAX || inputColumn < 0
+            || inputColumn > UINT_MAX
+            || !inBoardBounds(board, inputRow, inputColumn))
         {
             fprintf(stderr, "Error: coordinate out of bounds.\n");
         }
-        else if (getBoardCell(board, row, column) != CELL_EMPTY)
+        else if (kind == INPUT_VIEW)
+        {
+            showBoard(display, board, inputRow, inputColumn);
+        }
+        else if (getBoardCell(board, inputRow, inputColumn) != CELL_EMPTY)
         {
             fprintf(stderr, "Error: cell already occupied.\n");
         }
@@ -170,65 +473,266 @@ static void playerTurn(GameBoard* board, Player player)
         }
     } while(!validCoordinate);
 
-    setBoardCell(board, row, column, playerToCell(player));
-    logTurn(player, row, column);
+    if (!undo)
+    {
+        *row = inputRow;
+        *column = inputColumn;
+    }
+
+    return undo;
 }
 
 
-/* Runs a game using the given settings. */
-static int runGame(Settings* settings)
+/* Takes back the latest move, then any moves of computer players before it,
+   so that a human player is to move again. The current game log is rolled
+   back to match. */
+static void undoTurns(GameBoard* board, Settings const* settings)
 {
-    GameBoard board = createGameBoard(settings->n, settings->m, settings->k);
-    int xWon = 0;
-    int oWon = 0;
-    unsigned long placed = 0;
-    unsigned long const cells = board.rows * board.columns;
+    BoardMove move;
 
-    newGameLog();
-    displayGameBoard(&board);
-    printf("\n");
+    do
+    {
+        move = unmakeMove(board);
+        unlogTurn();
+        /* The player who made the move is to move again. */
+        printf("Took back %c at %u,%u.\n", playerToChar(nextPlayer(board)),
+            move.column, move.row);
+    } while (board->moveCount > 0
+        && settings->players[nextPlayer(board)] != PLAYER_TYPE_HUMAN);
+}
 
-    while (placed < cells && !xWon && !oWon)
+
+/* GameHooks::move hook of an interactive game. Inputs a player's turn, which
+   a human player may use to undo moves instead, and charges the time taken
+   to the player's clock. The game is stopped if the player runs out of time,
+   as a move made after the clock ran out doesn't count. */
+static TurnInput interactiveMove(void* context, GameBoard* board,
+    Player player, unsigned* row, unsigned* column)
+{
+    InteractiveGame* const game = context;
+    Settings const* const settings = game->settings;
+    ComputerPlayer* const computer = game->computers + player;
+    SolvedDatabase const* solved = NULL;
+    TurnInput input = TURN_MOVE;
+    double softSeconds = 0.0;
+    double hardSeconds = 0.0;
+    double start = 0.0;
+    int undo = 0;
+
+    if (game->timed && settings->players[player] != PLAYER_TYPE_HUMAN)
     {
-        playerTurn(&board, PLAYER_X);
-        ++placed;
+        moveTimeBudget(&game->clock, board, &softSeconds, &hardSeconds);
+        setComputerMoveTime(computer, softSeconds, hardSeconds);
+    }
 
-        printf("\n");
-        displayGameBoard(&board);
-        printf("\n");
+    printf("Player %c's turn.\n", playerToChar(player));
 
-        xWon = hasPlayerWon(&board, PLAYER_X);
+    if (settings->solved && solvedDatabaseMatches(settings->solved, board))
+    {
+        solved = settings->solved;
+    }
 
-        if (!xWon)
-        {
-            playerTurn(&board, PLAYER_O);
-            ++placed;
+    start = monotonicSeconds();
+    if (settings->players[player] == PLAYER_TYPE_HUMAN)
+    {
+        undo = humanMove(board, solved, game->display, row, column);
+    }
+    else
+    {
+        computerPlayerMove(computer, board, row, column, 1);
+    }
+    game->outOfTime = game->timed && !chargeGameClock(&game->clock, player,
+        monotonicSeconds() - start);
 
-            printf("\n");
-            displayGameBoard(&board);
-            printf("\n");
+    if (game->outOfTime)
+    {
+        input = TURN_STOP;
+    }
+    else if (undo)
+    {
+        undoTurns(board, settings);
+        input = TURN_UNDONE;
+    }
 
-            oWon = hasPlayerWon(&board, PLAYER_O);
-        }
+    return input;
+}
+
+
+/* GameHooks::moved hook of an interactive game. Logs the move, and has a
+   computer player think on while waiting for a human's reply. */
+static void interactiveMoved(void* context, GameBoard const* board,
+    Player player, unsigned row, unsigned column, int won)
+{
+    InteractiveGame* const game = context;
+    Settings const* const settings = game->settings;
+
+    logTurn(player, row, column);
+
+    if (!won && settings->players[player] != PLAYER_TYPE_HUMAN
+        && settings->players[otherPlayer(player)] == PLAYER_TYPE_HUMAN)
+    {
+        startPondering(game->computers + player, board);
+    }
+}
+
+
+/* GameHooks::turnEnded hook of an interactive game. Shows the board, and the
+   clocks in a timed game. */
+static void interactiveTurnEnded(void* context, GameBoard const* board)
+{
+    InteractiveGame* const game = context;
+    GameClock const* const clock = &game->clock;
+
+    showTurn(game->display, board);
+    if (game->timed)
+    {
+        printf("Time left: X %.1fs, O %.1fs.\n\n",
+            clock->remaining[PLAYER_X] > 0.0 ? clock->remaining[PLAYER_X]
+                : 0.0,
+            clock->remaining[PLAYER_O] > 0.0 ? clock->remaining[PLAYER_O]
+                : 0.0);
+    }
+}
+
+
+/* Runs a game using the given settings. */
+static int runGame(Settings* settings)
+{
+    GameBoard board = createGameBoard(settings->n, settings->m, settings->k);
+    ComputerPlayer computers[2];
+    BoardDisplay display;
+    InteractiveGame game;
+    GameHooks hooks = zeroedGameHooks();
+    GameResult result = GAME_DRAWN;
+
+    display.frame = zeroedFrameBuffer();
+    display.windowed = board.rows > VIEWPORT_ROWS
+        || board.columns > VIEWPORT_COLUMNS;
+    /* Cursor movement means nothing in a file or pipe. */
+    display.live = settings->ansiRedraw && isTerminal(stdout);
+    display.fitted = 0;
+    display.labels = display.windowed;
+    display.lines = 0;
+    display.characters = 0;
+    display.viewport = fullViewport(&board);
+    display.top = 0;
+    display.drawnMoves = 0;
+
+    computers[PLAYER_X] = zeroedComputerPlayer();
+    computers[PLAYER_O] = zeroedComputerPlayer();
+    if (settings->players[PLAYER_X] != PLAYER_TYPE_HUMAN)
+    {
+        computers[PLAYER_X] = createComputerPlayer(
+            settings->players[PLAYER_X], settings, (unsigned long)rand());
+    }
+    if (settings->players[PLAYER_O] != PLAYER_TYPE_HUMAN)
+    {
+        computers[PLAYER_O] = createComputerPlayer(
+            settings->players[PLAYER_O], settings, (unsigned long)rand());
+    }
+
+    game.settings = settings;
+    game.computers = computers;
+    game.display = &display;
+    game.clock = createGameClock(settings->gameSeconds,
+        settings->incrementSeconds);
+    game.timed = settings->gameSeconds > 0;
+    game.outOfTime = 0;
+    hooks.move = interactiveMove;
+    hooks.moved = interactiveMoved;
+    hooks.turnEnded = interactiveTurnEnded;
+    hooks.context = &game;
+
+    /* Huge boards go without dead draw detection, as the counts would cost
+       too much memory. */
+    if (!settings->strictRules)
+    {
+        enableSmallWindowCounts(&board);
     }
 
+    newGameLog();
+    showLatestMove(&display, &board);
+    printf("\n");
+
+    result = playGame(&board, &hooks);
+
     printf("Game complete.\n");
     printf("Result: ");
-    assert(!(xWon && oWon));
-    if (xWon)
+    if (result == GAME_WON)
     {
-        printf("player X has won!\n");
+        printf("player %c has won!\n",
+            playerToChar(otherPlayer(nextPlayer(&board))));
     }
-    else if (oWon)
+    else if (game.outOfTime)
     {
-        printf("player O has won!\n");
+        printf("player %c has run out of time, player %c has won!\n",
+            playerToChar(nextPlayer(&board)),
+            playerToChar(otherPlayer(nextPlayer(&board))));
+    }
+    else if (result == GAME_DEAD_DRAW)
+    {
+        printf("draw, neither player can complete a line.\n");
+        logDeadDraw();
     }
     else
     {
         printf("draw.\n");
     }
+    writePonderStatistics(stderr, computers + PLAYER_X);
+    writePonderStatistics(stderr, computers + PLAYER_O);
 
+    destroyFrameBuffer(&display.frame);
     destroyGameBoard(&board);
+    destroyComputerPlayer(computers + PLAYER_X);
+    destroyComputerPlayer(computers + PLAYER_O);
+
+    return 0;
+}
+
+
+/* Lets the user choose who plays each side. */
+static int choosePlayers(Settings* settings)
+{
+    Player player = PLAYER_X;
+    unsigned choice = 0;
+    unsigned i = 0;
+    int p = 0;
+
+    for (p = 0; p < 2; ++p)
+    {
+        player = p == 0 ? PLAYER_X : PLAYER_O;
+
+        printf("Player %c:\n", playerToChar(player));
+        for (i = 0; i < PLAYER_TYPE_COUNT; ++i)
+        {
+            printf("    %u) %s\n", i + 1u, PLAYER_TYPE_NAMES[i]);
+        }
+
+        do
+        {
+            choice = unsignedIntInput("Enter an option: ");
+            if (choice < 1 || choice > PLAYER_TYPE_COUNT)
+            {
+                fprintf(stderr, "Error: option must be >=1 and <=%u.\n",
+                    PLAYER_TYPE_COUNT);
+            }
+        } while (choice < 1 || choice > PLAYER_TYPE_COUNT);
+
+        settings->players[player] = (PlayerType)(choice - 1u);
+        printf("\n");
+    }
+
+    /* Both alpha-beta and Monte Carlo tree search players search on
+       settings->threads threads. */
+    if (settings->players[PLAYER_X] == PLAYER_TYPE_ALPHA_BETA
+        || settings->players[PLAYER_O] == PLAYER_TYPE_ALPHA_BETA
+        || settings->players[PLAYER_X] == PLAYER_TYPE_MCTS
+        || settings->players[PLAYER_O] == PLAYER_TYPE_MCTS)
+    {
+        settings->threads = unsignedIntInput(
+            "Enter number of search threads (0 for one per processor): ");
+        printf("\n");
+    }
 
     return 0;
 }
@@ -238,6 +742,10 @@ static int runGame(Settings* settings)
 static int displaySettings(Settings* settings)
 {
     writeSettings(stdout, settings);
+    printf("   Player X: %s\n", PLAYER_TYPE_NAMES[settings->players[PLAYER_X]]);
+    printf("   Player O: %s\n", PLAYER_TYPE_NAMES[settings->players[PLAYER_O]]);
+    printf("   Dead draws: %s\n",
+        settings->strictRules ? "played out" : "ended early");
 
     return 0;
 }
@@ -262,28 +770,29 @@ static int saveLogs(Settings* settings)
     char fileName[256] = {0};
     FILE* file = NULL;
     int res = 0;
+    int written = 0;
     time_t epochTime = time(NULL);
     struct tm const* time = localtime(&epochTime);
     assert(time);
 
-    res = sprintf(fileName, "MNK_%u-%u-%u_%.2i-%.2i_%.2i-%.2i.log",
+    res = sprintf(fileName, "MNK_%u-%u-%u_%.2i-%.2i_%.2i-%.2i.%s",
         settings->m, settings->n, settings->k, time->tm_hour, time->tm_min,
-        time->tm_mday, time->tm_mon + 1);
+        time->tm_mday, time->tm_mon + 1,
+        settings->logFormat == LOG_FORMAT_TEXT ? "log" : "mnkl");
     assert(res > 0);
 
     printf("Saving logs to file %s ...\n", fileName);
-    file = fopen(fileName, "w");
+    file = fopen(fileName,
+        settings->logFormat == LOG_FORMAT_TEXT ? "w" : "wb");
     if (file)
     {
-        writeSettings(file, settings);
-        fprintf(file, "\n");
-        writeGameLogs(file);
-
-        if (ferror(file))
+        /* If the logs can't be written, writeLogs() says why. */
+        written = writeLogs(file, settings);
+        if (written && ferror(file))
         {
             perror("Error writing to log file");
         }
-        else
+        else if (written)
         {
             printf("Success.\n");
         }
@@ -323,6 +832,12 @@ static int editSettings(Settings* settings)
         } while (!validateKSetting(settings->k, 1));
     } while (!validateSettingsCombo(settings, 1));
 
+    settings->gameSeconds = unsignedIntInput(
+        "Enter new T value (seconds per player, 0 for no clock): ");
+    /* Only asked for when valid, with a clock. */
+    settings->incrementSeconds = settings->gameSeconds == 0 ? 0
+        : unsignedIntInput("Enter new I value (seconds per move): ");
+
     return 0;
 }
 #endif
@@ -338,6 +853,7 @@ static int exitApplication(Settings* _)
 
 static MenuOption const menuOptions[] = {
     {"Start a new game", runGame},
+    {"Choose players", choosePlayers},
 #ifdef EDITOR_MODE
     {"Edit settings", editSettings},
 #endif
@@ -4,19 +4,46 @@
 
 #include "common.h"
 #include "linked_list.h"
+#include "settings.h"
 
 #include <assert.h>
+#include <limits.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 
 /* PRIVATE INTERFACE */
 
 
-/* Represents a player's turn in the game. */
+/* Binary game logs start with these bytes, then a byte giving the
+   LogFormat, then varints of the board's columns, rows and win requirement,
+   and of the number of games. Each game is a varint of its number of turns,
+   shifted left two bits, with bit 1 set if it ended early as a dead draw and
+   bit 0 set if its players alternate from X; then a varint per turn. A turn's
+   value is its cell's index, row * columns + column, or for LOG_FORMAT_DELTA
+   the difference from the turn before's (or 0's), zigzag encoded so small
+   steps either way are small. If the players don't alternate, each value is
+   shifted left a bit with the Player in bit 0.
+   The first byte can't start a text log, which is how the formats are told
+   apart. */
+static unsigned char const BINARY_LOG_MAGIC[] = {0x89, 'M', 'N', 'K'};
+
+/* Longest line of a text game log, including its newline and null
+   terminator. */
+#define TEXT_LOG_LINE_SIZE 256
+
+
+/* Turns a game log has room for when its first turn is logged. Doubles
+   whenever it runs out. */
+#define INITIAL_TURN_CAPACITY 16u
+
+
+/* Represents a player's turn in the game. Its number in the game is its
+   position in the game log's turns. */
 typedef struct
 {
-    unsigned long turnNum;      /* Turn number in the game, starts at 1. */
     Player player;              /* Player whose turn it was. */
     unsigned row;               /* Row the player placed a tile on. */
     unsigned column;            /* Column the player placed a tile on. */
@@ -27,26 +54,15 @@ typedef struct
 typedef struct
 {
     unsigned long gameNum;   /* Game number since program start, starts at 1. */
-    LinkedList turns;        /* List of PlayerTurn instances. */
+    PlayerTurn* turns;       /* Turns in order, in a single allocation so
+                                logging a turn rarely allocates, and freeing
+                                the game frees them all at once. */
+    size_t turnCount;
+    size_t turnCapacity;
+    int deadDraw;            /* Whether the game was ended early as a draw. */
 } GameLog;
 
 
-/* Creates a PlayerTurn instance from the given data.
-   The returned object is dynamically allocated and must be freed. */
-static PlayerTurn* createPlayerTurn(Player player, unsigned turnNum,
-    unsigned row, unsigned column)
-{
-    PlayerTurn* turn = (PlayerTurn*)malloc(sizeof(PlayerTurn));
-
-    turn->player = player;
-    turn->turnNum = turnNum;
-    turn->row = row;
-    turn->column = column;
-
-    return turn;
-}
-
-
 /* Creates a new, empty game log.
    The returned object is dynamically allocated and must be freed. */
 static GameLog* createGameLog(unsigned long gameNum)
@@ -54,7 +70,10 @@ static GameLog* createGameLog(unsigned long gameNum)
     GameLog* gameLog = (GameLog*)malloc(sizeof(GameLog));
 
     gameLog->gameNum = gameNum;
-    gameLog->turns = createLinkedList();
+    gameLog->turns = NULL;
+    gameLog->turnCount = 0;
+    gameLog->turnCapacity = 0;
+    gameLog->deadDraw = 0;
 
     return gameLog;
 }
@@ -63,7 +82,7 @@ static GameLog* createGameLog(unsigned long gameNum)
 /* Destroys/frees a GameLog and sets the pointer to it to NULL. */
 static void destroyGameLog(GameLog** gameLog)
 {
-    listFreeAndRemoveAll(&(*gameLog)->turns);
+    free((*gameLog)->turns);
     free(*gameLog);
     *gameLog = NULL;
 }
@@ -73,9 +92,21 @@ static void destroyGameLog(GameLog** gameLog)
 static void logTurnTo(GameLog* gameLog, Player player, unsigned row,
     unsigned column)
 {
-    unsigned long turnNum = gameLog->turns.size + 1ul;
-    PlayerTurn* turn = createPlayerTurn(player, turnNum, row, column);
-    listInsertLast(&gameLog->turns, turn);
+    PlayerTurn* turn = NULL;
+
+    if (gameLog->turnCount == gameLog->turnCapacity)
+    {
+        gameLog->turnCapacity = gameLog->turnCapacity > 0
+            ? gameLog->turnCapacity * 2u : INITIAL_TURN_CAPACITY;
+        gameLog->turns = realloc(gameLog->turns,
+            gameLog->turnCapacity * sizeof(PlayerTurn));
+    }
+
+    turn = gameLog->turns + gameLog->turnCount;
+    turn->player = player;
+    turn->row = row;
+    turn->column = column;
+    ++gameLog->turnCount;
 }
 
 
@@ -97,16 +128,282 @@ static void freeGameLogCallback(void** data, void* _)
 }
 
 
-/* List iteration callback for writeGameLogCallback() to write a PlayerTurn to a
-   stream. */
-static void writePlayerTurnCallback(void** data, void* stream)
+/* qsort() comparison putting game logs in ascending order of number. */
+static int compareGameLogs(void const* a, void const* b)
 {
-    PlayerTurn const* turn = *data;
+    unsigned long const numA = (*(GameLog* const*)a)->gameNum;
+    unsigned long const numB = (*(GameLog* const*)b)->gameNum;
 
-    fprintf(stream, "   Turn %lu:\n", turn->turnNum);
-    fprintf(stream, "   Player: %c\n", playerToChar(turn->player));
-    fprintf(stream, "   Location: %u,%u\n", turn->column, turn->row);
-    fprintf(stream, "\n");
+    return (numA > numB) - (numA < numB);
+}
+
+
+/* State of writeBinaryGameLogs(), passed to its list iteration callback. */
+typedef struct
+{
+    FILE* stream;
+    unsigned long columns;
+    int delta;                  /* Whether turns are written as differences. */
+} BinaryLogWriter;
+
+
+/* Checks if the players of a game log alternate, starting from X. */
+static int playersAlternate(GameLog const* gameLog)
+{
+    size_t i = 0;
+    int alternate = 1;
+
+    while (alternate && i < gameLog->turnCount)
+    {
+        alternate = gameLog->turns[i].player
+            == (i % 2u == 0 ? PLAYER_X : PLAYER_O);
+        ++i;
+    }
+
+    return alternate;
+}
+
+
+/* List iteration callback for writeBinaryGameLogs() to write a GameLog. */
+static void writeBinaryGameLogCallback(void** data, void* writer)
+{
+    GameLog const* gameLog = *data;
+    BinaryLogWriter const* const out = writer;
+    int const alternate = playersAlternate(gameLog);
+    PlayerTurn const* turn = NULL;
+    unsigned long previous = 0;
+    unsigned long index = 0;
+    unsigned long value = 0;
+    size_t i = 0;
+
+    writeVarint(out->stream, (unsigned long)gameLog->turnCount << 2
+        | (unsigned long)(gameLog->deadDraw != 0) << 1
+        | (unsigned long)alternate);
+
+    for (i = 0; i < gameLog->turnCount; ++i)
+    {
+        turn = gameLog->turns + i;
+        index = (unsigned long)turn->row * out->columns + turn->column;
+        value = index;
+        if (out->delta)
+        {
+            value = index >= previous ? (index - previous) * 2u
+                : (previous - index) * 2u - 1u;
+            previous = index;
+        }
+        if (!alternate)
+        {
+            value = value << 1 | (unsigned long)turn->player;
+        }
+
+        writeVarint(out->stream, value);
+    }
+}
+
+
+/* Reads a varint that must be positive and fit an unsigned int. */
+static int readDimension(FILE* stream, unsigned* dimension)
+{
+    unsigned long value = 0;
+    int const res = readVarint(stream, &value) && value > 0
+        && value <= UINT_MAX;
+
+    *dimension = (unsigned)value;
+
+    return res;
+}
+
+
+/* Checks if a board has at most BINARY_LOG_MAX_CELLS cells, without
+   overflowing if it doesn't. */
+static int fitsBinaryLog(unsigned columns, unsigned rows)
+{
+    return columns == 0 || rows <= BINARY_LOG_MAX_CELLS / columns;
+}
+
+
+/* Reads the games of a binary game log, after its format byte. */
+static int readBinaryGames(FILE* stream, unsigned* columns, unsigned* rows,
+    unsigned* winRequirement, int delta)
+{
+    unsigned long cells = 0;
+    unsigned long games = 0;
+    unsigned long game = 0;
+    unsigned long turns = 0;
+    unsigned long turn = 0;
+    unsigned long value = 0;
+    unsigned long index = 0;
+    Player player = PLAYER_X;
+    int alternate = 1;
+    int res = readDimension(stream, columns) && readDimension(stream, rows)
+        && readDimension(stream, winRequirement)
+        && readVarint(stream, &games);
+
+    /* A bigger board can't be written, and could make the checks on
+       differences below wrap around to a wrong cell inside the board. */
+    res = res && fitsBinaryLog(*columns, *rows);
+
+    cells = res ? (unsigned long)*columns * *rows : 0;
+    for (game = 0; res && game < games; ++game)
+    {
+        res = readVarint(stream, &value) && value >> 2 <= cells;
+        turns = value >> 2;
+        alternate = value & 1u;
+        index = 0;
+        player = PLAYER_X;
+        if (res)
+        {
+            newGameLog();
+            if (value & 2u)
+            {
+                logDeadDraw();
+            }
+        }
+
+        for (turn = 0; res && turn < turns; ++turn)
+        {
+            res = readVarint(stream, &value);
+            if (res && !alternate)
+            {
+                player = value & 1u ? PLAYER_O : PLAYER_X;
+                value >>= 1;
+            }
+            if (res && delta)
+            {
+                /* Out of range differences wrap around to too big indices. */
+                index = value % 2u == 0 ? index + value / 2u
+                    : index - (value / 2u + 1u);
+            }
+            else
+            {
+                index = value;
+            }
+
+            res = res && index < cells;
+            if (res)
+            {
+                logTurn(player, (unsigned)(index / *columns),
+                    (unsigned)(index % *columns));
+                player = alternate ? otherPlayer(player) : player;
+            }
+        }
+    }
+
+    return res && fgetc(stream) == EOF;
+}
+
+
+/* Reads a line of a text game log without its newline.
+   Returns 0 at the end of the stream, or if the line is too long, setting
+   tooLong in that case. */
+static int readLogLine(FILE* stream, char* line, int* tooLong)
+{
+    size_t length = 0;
+    int res = fgets(line, TEXT_LOG_LINE_SIZE, stream) != NULL;
+
+    if (res)
+    {
+        length = strlen(line);
+        if (length > 0 && line[length - 1u] == '\n')
+        {
+            line[length - 1u] = '\0';
+        }
+        else if (length == TEXT_LOG_LINE_SIZE - 1u)
+        {
+            *tooLong = 1;
+            res = 0;
+        }
+    }
+
+    return res;
+}
+
+
+/* Reads the games of a text game log, after its "SETTINGS:" line. */
+static int readTextGames(FILE* stream, unsigned* columns, unsigned* rows,
+    unsigned* winRequirement)
+{
+    char line[TEXT_LOG_LINE_SIZE];
+    unsigned long number = 0;
+    unsigned value = 0;
+    unsigned row = 0;
+    unsigned column = 0;
+    char option = '\0';
+    char symbol = '\0';
+    Player player = PLAYER_X;
+    int settings = 1;           /* Whether still reading the settings. */
+    int inGame = 0;
+    int havePlayer = 0;         /* Whether a turn's player has been read. */
+    int tooLong = 0;
+    int end = 0;
+    int res = 1;
+
+    *columns = 0;
+    *rows = 0;
+    *winRequirement = 0;
+
+    while (res && readLogLine(stream, line, &tooLong))
+    {
+        end = 0;
+        if (settings && line[0] == '\0')
+        {
+            settings = 0;
+            res = *columns > 0 && *rows > 0 && *winRequirement > 0;
+        }
+        else if (settings)
+        {
+            res = sscanf(line, "   %c: %u%n", &option, &value, &end) == 2
+                && line[end] == '\0';
+            *columns = option == 'M' ? value : *columns;
+            *rows = option == 'N' ? value : *rows;
+            *winRequirement = option == 'K' ? value : *winRequirement;
+        }
+        else if (sscanf(line, "GAME %lu:%n", &number, &end) == 1 && end > 0
+            && line[end] == '\0')
+        {
+            newGameLog();
+            inGame = 1;
+            havePlayer = 0;
+        }
+        else if (sscanf(line, "   Turn %lu:%n", &number, &end) == 1
+            && end > 0 && line[end] == '\0')
+        {
+            res = inGame;
+        }
+        else if (sscanf(line, "   Player: %c%n", &symbol, &end) == 1
+            && line[end] == '\0')
+        {
+            res = inGame && (symbol == 'X' || symbol == 'O');
+            player = symbol == 'X' ? PLAYER_X : PLAYER_O;
+            havePlayer = 1;
+        }
+        else if (sscanf(line, "   Location: %u,%u%n", &column, &row, &end) == 2
+            && line[end] == '\0')
+        {
+            res = havePlayer && column < *columns && row < *rows;
+            if (res)
+            {
+                logTurn(player, row, column);
+            }
+            havePlayer = 0;
+        }
+        else if (strcmp(line,
+            "   Ended early: draw, no line can be completed.") == 0)
+        {
+            res = inGame;
+            if (res)
+            {
+                logDeadDraw();
+            }
+        }
+        else
+        {
+            res = line[0] == '\0'
+                || (!inGame && strcmp(line, "<no games>") == 0);
+        }
+    }
+
+    return res && !tooLong && !settings && !havePlayer && !ferror(stream);
 }
 
 
@@ -115,9 +412,23 @@ static void writePlayerTurnCallback(void** data, void* stream)
 static void writeGameLogCallback(void** data, void* stream)
 {
     GameLog const* gameLog = *data;
+    PlayerTurn const* turn = NULL;
+    size_t i = 0;
 
     fprintf(stream, "GAME %lu:\n", gameLog->gameNum);
-    listIterateForward(&gameLog->turns, writePlayerTurnCallback, stream);
+    for (i = 0; i < gameLog->turnCount; ++i)
+    {
+        turn = gameLog->turns + i;
+        fprintf(stream, "   Turn %lu:\n", (unsigned long)i + 1u);
+        fprintf(stream, "   Player: %c\n", playerToChar(turn->player));
+        fprintf(stream, "   Location: %u,%u\n", turn->column, turn->row);
+        fprintf(stream, "\n");
+    }
+    if (gameLog->deadDraw)
+    {
+        fprintf(stream, "   Ended early: draw, no line can be completed.\n");
+        fprintf(stream, "\n");
+    }
     fprintf(stream, "\n");
 }
 
@@ -149,6 +460,111 @@ void logTurn(Player player, unsigned row, unsigned column)
 }
 
 
+void unlogTurn(void)
+{
+    GameLog* currentLog = getGameLogs()->tail->data;
+    assert(currentLog);
+    assert(currentLog->turnCount > 0);
+    --currentLog->turnCount;
+}
+
+
+void logDeadDraw(void)
+{
+    GameLog* currentLog = getGameLogs()->tail->data;
+    assert(currentLog);
+    currentLog->deadDraw = 1;
+}
+
+
+unsigned long countGameLogs(void)
+{
+    return getGameLogs()->size;
+}
+
+
+LogShard createLogShard(void)
+{
+    LogShard shard;
+
+    shard.games = createLinkedList();
+
+    return shard;
+}
+
+
+void destroyLogShard(LogShard* shard)
+{
+    listIterateReverse(&shard->games, freeGameLogCallback, NULL);
+    listRemoveAll(&shard->games);
+}
+
+
+void newShardGameLog(LogShard* shard, unsigned long index)
+{
+    /* The number is only the ordering key until merged. */
+    listInsertLast(&shard->games, createGameLog(index));
+}
+
+
+void logShardTurn(LogShard* shard, Player player, unsigned row,
+    unsigned column)
+{
+    GameLog* currentLog = shard->games.tail->data;
+    assert(currentLog);
+    logTurnTo(currentLog, player, row, column);
+}
+
+
+void logShardDeadDraw(LogShard* shard)
+{
+    GameLog* currentLog = shard->games.tail->data;
+    assert(currentLog);
+    currentLog->deadDraw = 1;
+}
+
+
+void mergeLogShards(LogShard* shards, size_t count)
+{
+    unsigned long const existing = getGameLogs()->size;
+    GameLog** gameLogs = NULL;
+    size_t total = 0;
+    size_t i = 0;
+    size_t j = 0;
+
+    for (i = 0; i < count; ++i)
+    {
+        total += shards[i].games.size;
+    }
+
+    if (total > 0)
+    {
+        gameLogs = malloc(total * sizeof(GameLog*));
+        for (i = 0; i < count; ++i)
+        {
+            while (shards[i].games.size > 0)
+            {
+                gameLogs[j] = listRemoveFirst(&shards[i].games);
+                ++j;
+            }
+        }
+
+        qsort(gameLogs, total, sizeof(GameLog*), compareGameLogs);
+        for (i = 1; i < total; ++i)
+        {
+            assert(gameLogs[i]->gameNum != gameLogs[i - 1u]->gameNum);
+        }
+        for (i = 0; i < total; ++i)
+        {
+            gameLogs[i]->gameNum = existing + i + 1u;
+            listInsertLast(getGameLogs(), gameLogs[i]);
+        }
+
+        free(gameLogs);
+    }
+}
+
+
 void writeGameLogs(FILE* stream)
 {
     if (getGameLogs()->size == 0)
@@ -160,3 +576,89 @@ void writeGameLogs(FILE* stream)
         listIterateForward(getGameLogs(), writeGameLogCallback, stream);
     }
 }
+
+
+int writeBinaryGameLogs(FILE* stream, unsigned columns, unsigned rows,
+    unsigned winRequirement, LogFormat format)
+{
+    BinaryLogWriter writer;
+    int const fits = fitsBinaryLog(columns, rows);
+
+    assert(format == LOG_FORMAT_BINARY || format == LOG_FORMAT_DELTA);
+
+    writer.stream = stream;
+    writer.columns = columns;
+    writer.delta = format == LOG_FORMAT_DELTA;
+
+    if (fits)
+    {
+        fwrite(BINARY_LOG_MAGIC, 1, sizeof BINARY_LOG_MAGIC, stream);
+        fputc((int)format, stream);
+        writeVarint(stream, columns);
+        writeVarint(stream, rows);
+        writeVarint(stream, winRequirement);
+        writeVarint(stream, getGameLogs()->size);
+        listIterateForward(getGameLogs(), writeBinaryGameLogCallback,
+            &writer);
+    }
+    else
+    {
+        fprintf(stderr, "Error: the board is too big for binary game logs, "
+            "the most cells is %lu.\n", (unsigned long)BINARY_LOG_MAX_CELLS);
+    }
+
+    return fits;
+}
+
+
+int writeLogs(FILE* stream, Settings const* settings)
+{
+    int res = 1;
+
+    if (settings->logFormat == LOG_FORMAT_TEXT)
+    {
+        writeSettings(stream, settings);
+        fprintf(stream, "\n");
+        writeGameLogs(stream);
+    }
+    else
+    {
+        res = writeBinaryGameLogs(stream, settings->m, settings->n,
+            settings->k, settings->logFormat);
+    }
+
+    return res;
+}
+
+
+int readGameLogs(FILE* stream, unsigned* columns, unsigned* rows,
+    unsigned* winRequirement, LogFormat* format)
+{
+    char line[TEXT_LOG_LINE_SIZE];
+    unsigned char magic[sizeof BINARY_LOG_MAGIC];
+    int const first = fgetc(stream);
+    int tooLong = 0;
+    int res = first != EOF && ungetc(first, stream) != EOF;
+    int c = 0;
+
+    if (res && first == BINARY_LOG_MAGIC[0])
+    {
+        res = fread(magic, 1, sizeof magic, stream) == sizeof magic
+            && memcmp(magic, BINARY_LOG_MAGIC, sizeof magic) == 0;
+        c = fgetc(stream);
+        res = res && (c == LOG_FORMAT_BINARY || c == LOG_FORMAT_DELTA);
+        *format = c == LOG_FORMAT_DELTA ? LOG_FORMAT_DELTA
+            : LOG_FORMAT_BINARY;
+        res = res && readBinaryGames(stream, columns, rows, winRequirement,
+            *format == LOG_FORMAT_DELTA);
+    }
+    else if (res)
+    {
+        *format = LOG_FORMAT_TEXT;
+        res = readLogLine(stream, line, &tooLong)
+            && strcmp(line, "SETTINGS:") == 0
+            && readTextGames(stream, columns, rows, winRequirement);
+    }
+
+    return res;
+}
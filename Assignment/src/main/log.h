@@ -4,7 +4,11 @@
 #define LOG_H
 
 #include "common.h"
+#include "linked_list.h"
+#include "settings.h"
 
+#include <limits.h>
+#include <stddef.h>
 #include <stdio.h>
 
 
@@ -14,6 +18,22 @@
     to simplify the logging process. */
 
 
+/* Most cells on a board whose games can be written in LOG_FORMAT_BINARY or
+   LOG_FORMAT_DELTA, which leaves room in an unsigned long for a cell index
+   with the sign of a difference and the player who moved. */
+#define BINARY_LOG_MAX_CELLS (ULONG_MAX / 4u)
+
+
+/* Game logs kept apart from the main game logs until merged into them, so that
+   several threads can each log games to their own shard without locking.
+   Use createLogShard to properly create it, and destroyLogShard to properly
+   destroy it. */
+typedef struct
+{
+    LinkedList games;       /* Game logs, the last being the current one. */
+} LogShard;
+
+
 /* Creates a new, empty game log and sets it as the current game log. */
 void newGameLog(void);
 
@@ -25,8 +45,65 @@ void freeGameLogs(void);
 /* Logs a player's turn to the current game log. */
 void logTurn(Player player, unsigned row, unsigned column);
 
+/* Removes the latest turn from the current game log, which must have one. */
+void unlogTurn(void);
+
+/* Records that the current game was ended early as a draw, because neither
+   player could complete a line any more. */
+void logDeadDraw(void);
+
+/* Gets the number of game logs stored. */
+unsigned long countGameLogs(void);
+
+/* Creates an empty log shard. */
+LogShard createLogShard(void);
+
+/* Destroys a log shard and any game logs in it. */
+void destroyLogShard(LogShard* shard);
+
+/* Creates a new, empty game log in a shard and sets it as the shard's current
+   game log. index orders the game among those in all shards being merged
+   together, and must be unique among them. */
+void newShardGameLog(LogShard* shard, unsigned long index);
+
+/* Logs a player's turn to a shard's current game log. */
+void logShardTurn(LogShard* shard, Player player, unsigned row,
+    unsigned column);
+
+/* Same as logDeadDraw(), for a shard's current game log. */
+void logShardDeadDraw(LogShard* shard);
+
+/* Moves the game logs of all the shards to the end of the main game logs, in
+   ascending order of index, numbering them after the existing games. The
+   shards are left empty. */
+void mergeLogShards(LogShard* shards, size_t count);
+
 /* Writes the games logs in textual form to the given stream. */
 void writeGameLogs(FILE* stream);
 
+/* Writes the game logs to the given stream in LOG_FORMAT_BINARY or
+   LOG_FORMAT_DELTA, headed by the dimensions of the board they were played
+   on, which all their moves must be within. Takes a few bytes per move,
+   rather than the text format's 40 or so.
+   If the board has more than BINARY_LOG_MAX_CELLS cells, prints an error to
+   stderr and returns 0 without writing anything, otherwise returns 1. */
+int writeBinaryGameLogs(FILE* stream, unsigned columns, unsigned rows,
+    unsigned winRequirement, LogFormat format);
+
+/* Writes the game logs to the given stream in the format in the settings,
+   headed by the settings in text logs, and the board's dimensions in binary
+   ones. The stream should be opened in binary mode for binary logs.
+   If the board is too big for a binary format, prints an error to stderr
+   and returns 0 without writing anything, otherwise returns 1. */
+int writeLogs(FILE* stream, Settings const* settings);
+
+/* Reads game logs in any LogFormat, telling which from the first byte, and
+   adds them after the stored game logs. Sets the dimensions of the board they
+   were played on, and the format they were in.
+   Returns 0 if the stream isn't a valid game log, in which case the games
+   before the problem are still added. */
+int readGameLogs(FILE* stream, unsigned* columns, unsigned* rows,
+    unsigned* winRequirement, LogFormat* format);
+
 
 #endif
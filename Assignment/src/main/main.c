@@ -1,32 +1,271 @@
 /* Program entry point. */
 
+#include "book.h"
+#include "common.h"
 #include "interface.h"
 #include "log.h"
+#include "script.h"
+#include "selfplay.h"
 #include "settings.h"
+#include "solved_db.h"
+#include "threads.h"
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 
-int validateArgs(int argc, char* argv[])
+/* Command line options, other than the settings file. */
+typedef struct
+{
+    int selfPlay;                   /* Whether to run headless self-play. */
+    unsigned long games;            /* Self-play games to play. */
+    PlayerType players[2];          /* Self-play players, indexed by Player. */
+    unsigned threads;               /* Threads to play self-play games on, or 0
+                                       for one per processor. */
+    int strict;                     /* Whether to play out dead draws. */
+    int ansi;                       /* Whether to redraw only changed cells. */
+    char const* solvedPath;         /* Solved-position database file to open,
+                                       or NULL. */
+    char const* bookPath;           /* Opening book file to open, or NULL. */
+    char const* scriptPath;         /* Script of games to play, "-" for stdin,
+                                       or NULL. */
+    char const* logPath;            /* File to write self-play or scripted
+                                       game logs to, or NULL to not log
+                                       them. */
+    LogFormat logFormat;            /* Format to save game logs in. */
+} Arguments;
+
+
+/* Prints the command line usage to stderr. */
+void printUsage(void)
+{
+    fprintf(stderr, "Usage: tictactoe <settings_file_path> [--strict] "
+        "[--ansi] [--solved <file>] [--book <file>] "
+        "[--log-format text|binary|delta] "
+        "[--selfplay <games> [<x_player> <o_player>] "
+        "[--threads <count>] [--log <file>]] "
+        "[--script <file> [--log <file>]]\n");
+    fprintf(stderr, "--strict plays drawn games on until the board is full. "
+        "--ansi keeps the board on screen in a terminal, only redrawing the "
+        "cells that change. "
+        "--solved uses a database written by tictactoe_solve for perfect play "
+        "and hints. --book uses an opening book written by tictactoe_book. "
+        "Self-play players are alphabeta, mcts or random (default random). "
+        "Self-play threads default to one per processor. Interactive games "
+        "ask for the search threads of alpha-beta and mcts players "
+        "instead.\n");
+    fprintf(stderr, "--script plays the games in a file, or stdin if it is "
+        "\"-\", one per line as column,row moves, printing only their "
+        "results. --log-format sets how game logs are saved, by --log or from "
+        "the menu: binary and delta take a few bytes per move, and "
+        "tictactoe_logconv converts them to and from text.\n");
+}
+
+
+/* Parses the options after the settings file path. */
+int parseOptions(int argc, char* argv[], Arguments* args)
+{
+    unsigned long threads = 0;
+    int res = 1;
+    int i = 2;
+
+    while (res && i < argc)
+    {
+        if (strcmp(argv[i], "--strict") == 0)
+        {
+            args->strict = 1;
+            i += 1;
+        }
+        else if (strcmp(argv[i], "--ansi") == 0)
+        {
+            args->ansi = 1;
+            i += 1;
+        }
+        else if (strcmp(argv[i], "--selfplay") == 0 && i + 1 < argc)
+        {
+            args->selfPlay = 1;
+            res = parseCount(argv[i + 1], &args->games, 1);
+            i += 2;
+
+            if (res && i + 1 < argc && argv[i][0] != '-')
+            {
+                res = parsePlayerType(argv[i], args->players + PLAYER_X)
+                    && parsePlayerType(argv[i + 1], args->players + PLAYER_O);
+                i += 2;
+            }
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            res = parseCount(argv[i + 1], &threads, 1) && threads > 0
+                && threads <= 4096u;
+            args->threads = threads;
+            i += 2;
+        }
+        else if (strcmp(argv[i], "--solved") == 0 && i + 1 < argc)
+        {
+            args->solvedPath = argv[i + 1];
+            i += 2;
+        }
+        else if (strcmp(argv[i], "--book") == 0 && i + 1 < argc)
+        {
+            args->bookPath = argv[i + 1];
+            i += 2;
+        }
+        else if (strcmp(argv[i], "--log-format") == 0 && i + 1 < argc)
+        {
+            res = parseLogFormat(argv[i + 1], &args->logFormat);
+            i += 2;
+        }
+        else if (strcmp(argv[i], "--script") == 0 && i + 1 < argc)
+        {
+            args->scriptPath = argv[i + 1];
+            i += 2;
+        }
+        else if (strcmp(argv[i], "--log") == 0 && i + 1 < argc)
+        {
+            args->logPath = argv[i + 1];
+            i += 2;
+        }
+        else
+        {
+            res = 0;
+        }
+    }
+
+    /* Threads only apply to self-play, and logs to self-play or scripts. */
+    if ((!args->selfPlay && args->threads > 0)
+        || (args->selfPlay && args->scriptPath)
+        || (!args->selfPlay && !args->scriptPath && args->logPath))
+    {
+        res = 0;
+    }
+
+    return res;
+}
+
+
+int validateArgs(int argc, char* argv[], Arguments* args)
 {
     int res = 1;
 
-    if (argc != 2)
+    args->selfPlay = 0;
+    args->games = 0;
+    args->players[PLAYER_X] = PLAYER_TYPE_RANDOM;
+    args->players[PLAYER_O] = PLAYER_TYPE_RANDOM;
+    args->threads = 0;
+    args->strict = 0;
+    args->ansi = 0;
+    args->solvedPath = NULL;
+    args->bookPath = NULL;
+    args->scriptPath = NULL;
+    args->logPath = NULL;
+    args->logFormat = LOG_FORMAT_TEXT;
+
+    if (argc < 2)
     {
-        fprintf(stderr, "Usage: tictactoe <settings_file_path>\n");
         res = 0;
     }
+    else
+    {
+        res = parseOptions(argc, argv, args);
+    }
+
+    if (!res)
+    {
+        printUsage();
+    }
 
     return res;
 }
 
 
+/* Writes the game logs to a file, in the same way as the interactive "Save
+   game logs to file" option. */
+void writeLogFile(char const* path, Settings const* settings)
+{
+    FILE* file = fopen(path,
+        settings->logFormat == LOG_FORMAT_TEXT ? "w" : "wb");
+
+    if (file)
+    {
+        if (writeLogs(file, settings) && ferror(file))
+        {
+            perror("Error writing to log file");
+        }
+        fclose(file);
+    }
+    else
+    {
+        perror("Error opening log file");
+    }
+}
+
+
+/* Runs headless self-play and prints the results. */
+void selfPlay(Settings* settings, Arguments const* args)
+{
+    SelfPlayStats stats = zeroedSelfPlayStats();
+    unsigned const threads = args->threads > 0 ? args->threads
+        : processorCount();
+
+    settings->players[PLAYER_X] = args->players[PLAYER_X];
+    settings->players[PLAYER_O] = args->players[PLAYER_O];
+
+    stats = runSelfPlay(settings, args->games, threads, (unsigned long)rand(),
+        args->logPath != NULL);
+    printSelfPlayStats(&stats);
+    destroySelfPlayStats(&stats);
+
+    if (args->logPath)
+    {
+        writeLogFile(args->logPath, settings);
+    }
+}
+
+
+/* Plays the games in a script, printing each result and a summary. */
+void playScript(Settings const* settings, Arguments const* args)
+{
+    int const useStdin = strcmp(args->scriptPath, "-") == 0;
+    FILE* file = useStdin ? stdin : fopen(args->scriptPath, "r");
+    ScriptStats stats = zeroedScriptStats();
+    int error = 0;
+
+    if (file)
+    {
+        stats = runScript(settings, file, stdout, args->logPath != NULL,
+            &error);
+        printScriptStats(&stats);
+        if (!useStdin)
+        {
+            fclose(file);
+        }
+
+        if (args->logPath)
+        {
+            writeLogFile(args->logPath, settings);
+        }
+    }
+    else
+    {
+        perror("Error opening script");
+    }
+}
+
+
 int main(int argc, char* argv[])
 {
     int error = 0;
     Settings settings = zeroedSettings();
+    SolvedDatabase solved = zeroedSolvedDatabase();
+    OpeningBook book = zeroedOpeningBook();
+    Arguments args;
+
+    srand(time(NULL));
 
-    error = !validateArgs(argc, argv);
+    error = !validateArgs(argc, argv, &args);
 
     if (!error)
     {
@@ -35,15 +274,59 @@ int main(int argc, char* argv[])
 
     if (!error)
     {
-        error = !validateSettings(&settings, 1);
+        error = !validateSettings(&settings,
+            !args.selfPlay && !args.scriptPath);
+    }
+
+    if (!error && args.solvedPath)
+    {
+        /* Mapped rather than read, so even large databases open instantly. */
+        solved = openSolvedDatabase(args.solvedPath, &error);
+        settings.solved = &solved;
+        if (!error && (solved.columns != settings.m
+            || solved.rows != settings.n || solved.winRequirement != settings.k))
+        {
+            printf("Note: the solved database is for M=%u, N=%u, K=%u, so "
+                "only applies to games with those settings.\n", solved.columns,
+                solved.rows, solved.winRequirement);
+        }
+    }
+
+    if (!error && args.bookPath)
+    {
+        book = openOpeningBook(args.bookPath, &error);
+        settings.book = &book;
+        if (!error && (book.columns != settings.m || book.rows != settings.n
+            || book.winRequirement != settings.k))
+        {
+            printf("Note: the opening book is for M=%u, N=%u, K=%u, so only "
+                "applies to games with those settings.\n", book.columns,
+                book.rows, book.winRequirement);
+        }
     }
 
     if (!error)
     {
-        mainMenu(&settings);
+        settings.strictRules = args.strict;
+        settings.ansiRedraw = args.ansi;
+        settings.logFormat = args.logFormat;
+        if (args.selfPlay)
+        {
+            selfPlay(&settings, &args);
+        }
+        else if (args.scriptPath)
+        {
+            playScript(&settings, &args);
+        }
+        else
+        {
+            mainMenu(&settings);
+        }
     }
 
     freeGameLogs();
+    destroySolvedDatabase(&solved);
+    destroyOpeningBook(&book);
 
     return 0;
 }
@@ -0,0 +1,633 @@
+/* Monte Carlo tree search, used by computer players. */
+
+/* pthreads are POSIX, not ANSI C. */
+#define _POSIX_C_SOURCE 200112L
+
+#include "mcts.h"
+
+#include "board.h"
+#include "common.h"
+#include "random.h"
+#include "threads.h"
+#include "timer.h"
+
+#include <assert.h>
+#include <math.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Default limits for computer players. */
+#define DEFAULT_MAX_SECONDS 1.0
+#define DEFAULT_MAX_NODES (1ul << 20)
+
+/* UCT exploration constant, for rewards between 0 and 1. */
+#define EXPLORATION 1.4
+
+/* Cells around the occupied cells that playouts may also play in. */
+#define PLAYOUT_MARGIN 2u
+
+/* Playouts reaching this many moves are scored as draws. */
+#define MAX_PLAYOUT_MOVES 1024u
+
+/* Deepest a thread descends into the tree. */
+#define MAX_TREE_DEPTH 256u
+
+/* Rewards, doubled so that a draw is a whole number. */
+#define REWARD_WIN 2ul
+#define REWARD_DRAW 1ul
+
+
+/* Expansion state of a node. Only changed with atomic operations. */
+enum
+{
+    NODE_LEAF,              /* No children yet. */
+    NODE_EXPANDING,         /* A thread is creating the children. */
+    NODE_EXPANDED,          /* Children are ready to use. */
+    NODE_FULL               /* Pool had no room for the children. */
+};
+
+
+/* Node of the search tree. Statistics are updated atomically by all threads
+   without locking, so reads of them may be slightly out of date. */
+typedef struct
+{
+    unsigned row;               /* Move leading to this node. */
+    unsigned column;
+    size_t firstChild;          /* Pool index of the first child. Children are
+                                   contiguous. */
+    unsigned childCount;
+    int state;                  /* Expansion state. */
+    unsigned long visits;       /* Completed playouts through this node. */
+    unsigned long reward;       /* Total doubled reward of those playouts, for
+                                   the player who made the move. */
+    unsigned long virtualLoss;  /* Playouts in progress through this node. */
+} Node;
+
+
+/* Rectangle of cells. */
+typedef struct
+{
+    unsigned minRow;
+    unsigned minColumn;
+    unsigned maxRow;
+    unsigned maxColumn;
+} Box;
+
+
+/* State shared by all threads of a search. */
+typedef struct
+{
+    GameBoard const* board;     /* Position being searched. */
+    Player rootPlayer;          /* Player to move at the root. */
+    Node* nodes;                /* Node pool. The root is the first node. */
+    size_t capacity;
+    size_t used;                /* Nodes taken from the pool (atomic). */
+    Box box;                    /* Cells that moves are chosen from. */
+    unsigned long boxEmpty;     /* Empty cells in the box at the root. */
+    double deadline;            /* monotonicSeconds() value to stop at. */
+    unsigned long maxPlayouts;
+    unsigned long started;      /* Playouts started (atomic). */
+} Tree;
+
+
+/* State private to one thread of a search. */
+typedef struct
+{
+    Tree* tree;
+    GameBoard board;            /* Private copy that moves are made on. */
+    unsigned long random;       /* Random number generator state. */
+    unsigned long playouts;     /* Playouts completed by this thread. */
+    size_t path[MAX_TREE_DEPTH + 1u];   /* Nodes visited, from the root. */
+    unsigned placed;            /* Moves made on board this playout. */
+} Worker;
+
+
+/* Checks if a cell is a candidate tree move: empty and next to an occupied
+   cell, or the centre of an empty board. */
+static int isTreeMove(GameBoard const* board, unsigned row, unsigned column)
+{
+    int candidate = 0;
+
+    if (board->occupied == 0)
+    {
+        candidate = row == board->rows / 2u && column == board->columns / 2u;
+    }
+    else
+    {
+        candidate = getBoardCell(board, row, column) == CELL_EMPTY
+            && hasNeighbour(board, row, column);
+    }
+
+    return candidate;
+}
+
+
+/* Reserves count nodes from the pool.
+   Returns non-zero and sets first to the index of the first if successful,
+   otherwise returns 0 if there is not enough room. */
+static int reserveNodes(Tree* tree, unsigned count, size_t* first)
+{
+    size_t used = 0;
+    int reserved = 0;
+    int full = 0;
+
+    while (!reserved && !full)
+    {
+        used = tree->used;
+        full = tree->capacity - used < count;
+        if (!full)
+        {
+            reserved = __sync_bool_compare_and_swap(&tree->used, used,
+                used + count);
+        }
+    }
+
+    *first = used;
+
+    return reserved;
+}
+
+
+/* Creates the children of a leaf node for the position on board, unless
+   another thread is already doing so. */
+static void expandNode(Tree* tree, Node* node, GameBoard const* board)
+{
+    Box const box = tree->box;
+    unsigned count = 0;
+    size_t first = 0;
+    Node* child = NULL;
+    unsigned i = 0;
+    unsigned j = 0;
+
+    if (__sync_bool_compare_and_swap(&node->state, NODE_LEAF, NODE_EXPANDING))
+    {
+        for (i = box.minRow; i <= box.maxRow; ++i)
+        {
+            for (j = box.minColumn; j <= box.maxColumn; ++j)
+            {
+                count += isTreeMove(board, i, j);
+            }
+        }
+
+        if (count > 0 && reserveNodes(tree, count, &first))
+        {
+            child = tree->nodes + first;
+            for (i = box.minRow; i <= box.maxRow; ++i)
+            {
+                for (j = box.minColumn; j <= box.maxColumn; ++j)
+                {
+                    if (isTreeMove(board, i, j))
+                    {
+                        child->row = i;
+                        child->column = j;
+                        child->firstChild = 0;
+                        child->childCount = 0;
+                        child->state = NODE_LEAF;
+                        child->visits = 0;
+                        child->reward = 0;
+                        child->virtualLoss = 0;
+                        ++child;
+                    }
+                }
+            }
+
+            node->firstChild = first;
+            node->childCount = count;
+            /* The builtin is a full barrier, so the children are visible to
+               other threads before the state is. */
+            __sync_bool_compare_and_swap(&node->state, NODE_EXPANDING,
+                NODE_EXPANDED);
+        }
+        else
+        {
+            __sync_bool_compare_and_swap(&node->state, NODE_EXPANDING,
+                NODE_FULL);
+        }
+    }
+}
+
+
+/* Selects the child of an expanded node with the best UCT score, counting
+   playouts in progress as losses. */
+static size_t selectChild(Tree const* tree, Node const* node)
+{
+    Node const* child = NULL;
+    unsigned long const parentVisits = node->visits + node->virtualLoss + 1u;
+    double const logParent = log((double)parentVisits);
+    double bestScore = -1.0;
+    double score = 0.0;
+    unsigned long count = 0;
+    size_t best = node->firstChild;
+    unsigned i = 0;
+    int unvisited = 0;
+
+    for (i = 0; i < node->childCount && !unvisited; ++i)
+    {
+        child = tree->nodes + node->firstChild + i;
+        count = child->visits + child->virtualLoss;
+        if (count == 0)
+        {
+            best = node->firstChild + i;
+            unvisited = 1;
+        }
+        else
+        {
+            score = child->reward / (2.0 * count)
+                + EXPLORATION * sqrt(logParent / count);
+            if (score > bestScore)
+            {
+                bestScore = score;
+                best = node->firstChild + i;
+            }
+        }
+    }
+
+    return best;
+}
+
+
+/* Makes a move on a worker's board, recording it to be undone. */
+static void placeMove(Worker* worker, unsigned row, unsigned column,
+    Player player)
+{
+    makeMove(&worker->board, row, column, playerToCell(player));
+    ++worker->placed;
+}
+
+
+/* Undoes all moves made on a worker's board this playout. */
+static void undoMoves(Worker* worker)
+{
+    while (worker->placed > 0)
+    {
+        unmakeMove(&worker->board);
+        --worker->placed;
+    }
+}
+
+
+/* Plays random moves in the box until a player wins, the box is full or the
+   playout is too long.
+   Returns the doubled reward for player X. */
+static unsigned long playout(Worker* worker, Player player,
+    unsigned long empty)
+{
+    Box const box = worker->tree->box;
+    unsigned long const height = box.maxRow - box.minRow + 1ul;
+    unsigned long const width = box.maxColumn - box.minColumn + 1ul;
+    unsigned long reward = REWARD_DRAW;
+    unsigned row = 0;
+    unsigned column = 0;
+    unsigned moves = 0;
+    int won = 0;
+
+    while (!won && empty > 0 && moves < MAX_PLAYOUT_MOVES)
+    {
+        /* Rejection sampling stays cheap while a reasonable fraction of the
+           box is empty, which is the case for the boards MCTS is used on. */
+        do
+        {
+            row = box.minRow + randomBelow(&worker->random, height);
+            column = box.minColumn + randomBelow(&worker->random, width);
+        } while (getBoardCell(&worker->board, row, column) != CELL_EMPTY);
+
+        placeMove(worker, row, column, player);
+        won = hasPlayerWonAt(&worker->board, row, column);
+        --empty;
+        ++moves;
+
+        if (won)
+        {
+            reward = player == PLAYER_X ? REWARD_WIN : 0;
+        }
+        player = otherPlayer(player);
+    }
+
+    return reward;
+}
+
+
+/* Gets the player who made the move into a node at the given depth. */
+static Player moverAtDepth(Tree const* tree, unsigned depth)
+{
+    return depth % 2u == 1u ? tree->rootPlayer : otherPlayer(tree->rootPlayer);
+}
+
+
+/* Runs one playout: selects a path through the tree, expands its leaf,
+   plays randomly from there and backs up the result. */
+static void runPlayout(Worker* worker)
+{
+    Tree* const tree = worker->tree;
+    Node* node = tree->nodes;
+    Player mover = tree->rootPlayer;
+    unsigned long empty = tree->boxEmpty;
+    unsigned long rewardX = REWARD_DRAW;
+    unsigned long reward = 0;
+    size_t child = 0;
+    unsigned depth = 0;
+    unsigned d = 0;
+    int terminal = 0;
+    int descending = 1;
+
+    worker->path[0] = 0;
+
+    while (descending)
+    {
+        if (!terminal && node->state == NODE_LEAF
+            && (node->visits > 0 || depth == 0))
+        {
+            expandNode(tree, node, &worker->board);
+        }
+
+        descending = !terminal && node->state == NODE_EXPANDED
+            && depth < MAX_TREE_DEPTH;
+        if (descending)
+        {
+            child = selectChild(tree, node);
+            node = tree->nodes + child;
+            __sync_fetch_and_add(&node->virtualLoss, 1ul);
+            ++depth;
+            worker->path[depth] = child;
+
+            mover = moverAtDepth(tree, depth);
+            placeMove(worker, node->row, node->column, mover);
+            --empty;
+
+            if (hasPlayerWonAt(&worker->board, node->row, node->column))
+            {
+                terminal = 1;
+                rewardX = mover == PLAYER_X ? REWARD_WIN : 0;
+            }
+            else if (empty == 0)
+            {
+                terminal = 1;
+                rewardX = REWARD_DRAW;
+            }
+        }
+    }
+
+    if (!terminal)
+    {
+        rewardX = playout(worker, otherPlayer(mover), empty);
+    }
+
+    for (d = 0; d <= depth; ++d)
+    {
+        node = tree->nodes + worker->path[d];
+        reward = moverAtDepth(tree, d) == PLAYER_X
+            ? rewardX : REWARD_WIN - rewardX;
+        __sync_fetch_and_add(&node->visits, 1ul);
+        __sync_fetch_and_add(&node->reward, reward);
+        if (d > 0)
+        {
+            __sync_fetch_and_sub(&node->virtualLoss, 1ul);
+        }
+    }
+
+    undoMoves(worker);
+    ++worker->playouts;
+}
+
+
+/* Checks if a search should start another playout, and if so claims it. */
+static int claimPlayout(Tree* tree)
+{
+    int claimed = monotonicSeconds() < tree->deadline;
+
+    if (claimed && tree->maxPlayouts > 0)
+    {
+        claimed = __sync_fetch_and_add(&tree->started, 1ul)
+            < tree->maxPlayouts;
+    }
+
+    return claimed;
+}
+
+
+/* Thread entry point. Runs playouts until the search's limits are reached. */
+static void* workerMain(void* arg)
+{
+    Worker* const worker = arg;
+
+    while (claimPlayout(worker->tree))
+    {
+        runPlayout(worker);
+    }
+
+    return NULL;
+}
+
+
+/* Gets the box that moves are chosen from: the occupied cells plus a margin,
+   clipped to the board. */
+static Box playoutBox(GameBoard const* board)
+{
+    Box box;
+    unsigned const margin = PLAYOUT_MARGIN;
+
+    if (!getOccupiedBounds(board, &box.minRow, &box.minColumn, &box.maxRow,
+        &box.maxColumn))
+    {
+        box.minRow = box.maxRow = board->rows / 2u;
+        box.minColumn = box.maxColumn = board->columns / 2u;
+    }
+
+    box.minRow = box.minRow > margin ? box.minRow - margin : 0;
+    box.minColumn = box.minColumn > margin ? box.minColumn - margin : 0;
+    box.maxRow = board->rows - 1u - box.maxRow > margin
+        ? box.maxRow + margin : board->rows - 1u;
+    box.maxColumn = board->columns - 1u - box.maxColumn > margin
+        ? box.maxColumn + margin : board->columns - 1u;
+
+    return box;
+}
+
+
+/* Counts the empty cells in a box. */
+static unsigned long countEmpty(GameBoard const* board, Box box)
+{
+    unsigned long empty = 0;
+    unsigned i = 0;
+    unsigned j = 0;
+
+    for (i = box.minRow; i <= box.maxRow; ++i)
+    {
+        for (j = box.minColumn; j <= box.maxColumn; ++j)
+        {
+            empty += getBoardCell(board, i, j) == CELL_EMPTY;
+        }
+    }
+
+    return empty;
+}
+
+
+/* Runs a search with the given tree using limits.threads threads, including
+   the calling thread. Returns the total playouts completed. */
+static unsigned long runWorkers(Tree* tree, unsigned threads)
+{
+    Worker* workers = malloc(threads * sizeof(Worker));
+    pthread_t* handles = malloc(threads * sizeof(pthread_t));
+    unsigned long playouts = 0;
+    unsigned i = 0;
+    int res = 0;
+
+    for (i = 0; i < threads; ++i)
+    {
+        workers[i].tree = tree;
+        workers[i].board = copyGameBoard(tree->board);
+        workers[i].random = seedRandom((unsigned long)rand() * threads + i);
+        workers[i].playouts = 0;
+        workers[i].placed = 0;
+    }
+
+    for (i = 1; i < threads; ++i)
+    {
+        res = pthread_create(handles + i, NULL, workerMain, workers + i);
+        assert(res == 0);
+    }
+    workerMain(workers);
+    for (i = 1; i < threads; ++i)
+    {
+        res = pthread_join(handles[i], NULL);
+        assert(res == 0);
+    }
+    (void)res;
+
+    for (i = 0; i < threads; ++i)
+    {
+        playouts += workers[i].playouts;
+        destroyGameBoard(&workers[i].board);
+    }
+
+    free(workers);
+    free(handles);
+
+    return playouts;
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+MctsLimits defaultMctsLimits(void)
+{
+    MctsLimits limits;
+
+    limits.threads = processorCount();
+    limits.maxSeconds = DEFAULT_MAX_SECONDS;
+    limits.maxPlayouts = 0;
+    limits.maxNodes = DEFAULT_MAX_NODES;
+
+    return limits;
+}
+
+
+MctsResult mctsBestMove(GameBoard const* board, MctsLimits limits)
+{
+    MctsResult result;
+    Tree tree;
+    Node* root = NULL;
+    Node const* child = NULL;
+    unsigned long bestVisits = 0;
+    unsigned i = 0;
+    double const start = monotonicSeconds();
+
+    assert(limits.threads > 0);
+    assert(limits.maxNodes > 0);
+
+    result.found = board->occupied
+        < (unsigned long)board->rows * board->columns;
+    result.row = 0;
+    result.column = 0;
+    result.winRate = 0.0;
+    result.playouts = 0;
+    result.nodes = 0;
+    result.threads = limits.threads;
+
+    if (result.found)
+    {
+        tree.board = board;
+        tree.rootPlayer = nextPlayer(board);
+        tree.nodes = malloc(limits.maxNodes * sizeof(Node));
+        tree.capacity = limits.maxNodes;
+        tree.used = 1;
+        tree.box = playoutBox(board);
+        tree.boxEmpty = countEmpty(board, tree.box);
+        tree.deadline = start + limits.maxSeconds;
+        tree.maxPlayouts = limits.maxPlayouts;
+        tree.started = 0;
+
+        root = tree.nodes;
+        root->row = 0;
+        root->column = 0;
+        root->firstChild = 0;
+        root->childCount = 0;
+        root->state = NODE_LEAF;
+        root->visits = 0;
+        root->reward = 0;
+        root->virtualLoss = 0;
+        expandNode(&tree, root, board);
+
+        /* Without children (only possible with a tiny pool) there is nothing
+           to choose between, so fall back to any empty cell. */
+        if (root->state == NODE_EXPANDED)
+        {
+            result.playouts = runWorkers(&tree, limits.threads);
+            for (i = 0; i < root->childCount; ++i)
+            {
+                child = tree.nodes + root->firstChild + i;
+                if (i == 0 || child->visits > bestVisits)
+                {
+                    bestVisits = child->visits;
+                    result.row = child->row;
+                    result.column = child->column;
+                    result.winRate = child->visits > 0
+                        ? child->reward / (2.0 * child->visits) : 0.0;
+                }
+            }
+        }
+        else
+        {
+            result.row = tree.box.minRow;
+            result.column = tree.box.minColumn;
+            while (getBoardCell(board, result.row, result.column)
+                != CELL_EMPTY)
+            {
+                ++result.column;
+                if (result.column > tree.box.maxColumn)
+                {
+                    result.column = tree.box.minColumn;
+                    ++result.row;
+                }
+            }
+        }
+
+        result.nodes = tree.used;
+        free(tree.nodes);
+    }
+
+    result.seconds = monotonicSeconds() - start;
+
+    return result;
+}
+
+
+void printMctsStatistics(MctsResult const* result)
+{
+    double const playoutsPerSecond = result->seconds > 0.0
+        ? result->playouts / result->seconds : 0.0;
+
+    printf("MCTS: %lu playouts on %u threads in %.2fs (%.0f playouts/s), "
+        "%lu nodes, win rate %.1f%%.\n", result->playouts, result->threads,
+        result->seconds, playoutsPerSecond, (unsigned long)result->nodes,
+        100.0 * result->winRate);
+}
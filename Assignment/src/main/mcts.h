@@ -0,0 +1,59 @@
+/* Monte Carlo tree search, used by computer players on boards too large for
+   alpha-beta search to reach a useful depth. */
+
+#ifndef MCTS_H
+#define MCTS_H
+
+#include "board.h"
+
+#include <stddef.h>
+
+
+/* Limits on how long a search runs and how much it may use. */
+typedef struct
+{
+    unsigned threads;           /* Worker threads, >0. */
+    double maxSeconds;          /* Wall-clock time after which the search
+                                   stops. */
+    unsigned long maxPlayouts;  /* Playouts after which the search stops, or 0
+                                   for no limit. */
+    size_t maxNodes;            /* Size of the node pool. Once full the tree
+                                   stops growing, but playouts continue. */
+} MctsLimits;
+
+
+/* Outcome and statistics of a search. */
+typedef struct
+{
+    int found;                  /* Whether a move was found (board not
+                                   full). */
+    unsigned row;               /* Most visited move. */
+    unsigned column;
+    double winRate;             /* Fraction of the move's playouts won by the
+                                   side to move, counting draws as half. */
+    unsigned long playouts;     /* Playouts completed. */
+    size_t nodes;               /* Tree nodes used. */
+    unsigned threads;           /* Worker threads used. */
+    double seconds;             /* Wall-clock time taken. */
+} MctsResult;
+
+
+/* Returns the limits used for computer players by default, with one thread per
+   processor. */
+MctsLimits defaultMctsLimits(void);
+
+/* Finds the best move for the player whose turn it is using Monte Carlo tree
+   search with UCT selection.
+   All threads share a single tree, taking nodes from a pool allocated up
+   front. Virtual losses steer concurrent threads down different paths.
+   Tree moves are empty cells next to an occupied cell; playouts pick random
+   cells from a box around the occupied cells, so on huge boards the search
+   stays local to the game in progress.
+   board is not modified. */
+MctsResult mctsBestMove(GameBoard const* board, MctsLimits limits);
+
+/* Prints a summary of a search's statistics to stdout. */
+void printMctsStatistics(MctsResult const* result);
+
+
+#endif
@@ -0,0 +1,358 @@
+/* Exhaustive move generation counts. */
+
+#include "perft.h"
+
+#include "board.h"
+#include "threads.h"
+#include "timer.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Initial number of entries in a PositionTable, a power of 2. */
+#define INITIAL_POSITION_CAPACITY 1024u
+
+
+/* Position visited by a perft with unique position counting. */
+typedef struct
+{
+    unsigned long key;          /* Hash of the position. */
+    unsigned long sequences;    /* Sequences from the position to the full
+                                   depth. */
+    int leaf;                   /* Whether the position is at the full
+                                   depth. */
+    int used;                   /* Whether the entry holds a position. */
+} PositionEntry;
+
+
+/* Hash table of positions, with open addressing and linear probing. */
+typedef struct
+{
+    PositionEntry* entries;
+    size_t capacity;            /* A power of 2. */
+    size_t count;
+} PositionTable;
+
+
+/* State private to one thread of a perft. */
+typedef struct
+{
+    GameBoard board;            /* Private copy that moves are made on. */
+    PositionTable positions;    /* Only used when counting unique
+                                   positions. */
+    unsigned long sequences;
+    unsigned long moves;
+} PerftWorker;
+
+
+/* State shared by all threads of a perft. */
+typedef struct
+{
+    PerftWorker* workers;       /* One per thread. */
+    unsigned long* counts;      /* Sequences of each root move, or NULL. */
+    unsigned depth;
+    int unique;
+} Perft;
+
+
+/* Creates an empty table with capacity entries, a power of 2. */
+static PositionTable createPositionTable(size_t capacity)
+{
+    PositionTable table;
+    size_t i = 0;
+
+    table.entries = malloc(capacity * sizeof(PositionEntry));
+    table.capacity = capacity;
+    table.count = 0;
+    for (i = 0; i < capacity; ++i)
+    {
+        table.entries[i].used = 0;
+    }
+
+    return table;
+}
+
+
+/* Deallocates a table's entries. */
+static void destroyPositionTable(PositionTable* table)
+{
+    free(table->entries);
+    table->entries = NULL;
+    table->capacity = 0;
+    table->count = 0;
+}
+
+
+/* Finds the entry for a key, or the unused entry where it would go. */
+static PositionEntry* findPosition(PositionTable const* table,
+    unsigned long key)
+{
+    size_t const mask = table->capacity - 1u;
+    size_t i = key & mask;
+
+    while (table->entries[i].used && table->entries[i].key != key)
+    {
+        i = (i + 1u) & mask;
+    }
+
+    return table->entries + i;
+}
+
+
+/* Adds a position that isn't in a table yet, growing the table to keep it at
+   most half full. */
+static void insertPosition(PositionTable* table, unsigned long key,
+    unsigned long sequences, int leaf)
+{
+    PositionTable grown;
+    PositionEntry* entry = NULL;
+    size_t i = 0;
+
+    if ((table->count + 1u) * 2u > table->capacity)
+    {
+        grown = createPositionTable(table->capacity * 2u);
+        for (i = 0; i < table->capacity; ++i)
+        {
+            if (table->entries[i].used)
+            {
+                *findPosition(&grown, table->entries[i].key)
+                    = table->entries[i];
+            }
+        }
+        grown.count = table->count;
+        destroyPositionTable(table);
+        *table = grown;
+    }
+
+    entry = findPosition(table, key);
+    assert(!entry->used);
+    entry->key = key;
+    entry->sequences = sequences;
+    entry->leaf = leaf;
+    entry->used = 1;
+    ++table->count;
+}
+
+
+static unsigned long countSequences(PerftWorker* worker, unsigned depth,
+    int unique);
+
+
+/* Makes a move on the worker's board, counts the sequences of depth - 1 more
+   moves after it, and undoes it. depth must be >0. */
+static unsigned long countMove(PerftWorker* worker, unsigned row,
+    unsigned column, unsigned depth, int unique)
+{
+    GameBoard* const board = &worker->board;
+    unsigned long const cells = (unsigned long)board->rows * board->columns;
+    unsigned long sequences = 0;
+
+    makeMove(board, row, column, playerToCell(nextPlayer(board)));
+    ++worker->moves;
+    /* A sequence ending with a win or a full board still counts if it is
+       already long enough. */
+    if (depth == 1u || (!hasPlayerWonAt(board, row, column)
+        && board->occupied < cells))
+    {
+        sequences = countSequences(worker, depth - 1u, unique);
+    }
+    unmakeMove(board);
+
+    return sequences;
+}
+
+
+/* Counts the sequences of depth more moves from the worker's board
+   position, reusing and storing the counts of positions if unique is
+   non-zero. */
+static unsigned long countSequences(PerftWorker* worker, unsigned depth,
+    int unique)
+{
+    GameBoard* const board = &worker->board;
+    PositionEntry const* entry = NULL;
+    unsigned long sequences = 0;
+    unsigned row = 0;
+    unsigned column = 0;
+
+    if (unique)
+    {
+        entry = findPosition(&worker->positions, board->hash);
+    }
+
+    if (entry && entry->used)
+    {
+        sequences = entry->sequences;
+    }
+    else
+    {
+        if (depth == 0)
+        {
+            sequences = 1;
+        }
+        for (row = 0; row < board->rows && depth > 0; ++row)
+        {
+            for (column = 0; column < board->columns; ++column)
+            {
+                if (getBoardCell(board, row, column) == CELL_EMPTY)
+                {
+                    sequences += countMove(worker, row, column, depth,
+                        unique);
+                }
+            }
+        }
+
+        /* Looked up again, as the search above may have moved the table's
+           entries. */
+        if (unique)
+        {
+            insertPosition(&worker->positions, board->hash, sequences,
+                depth == 0);
+        }
+    }
+
+    return sequences;
+}
+
+
+/* Task function for runWorkStealing() counting the sequences starting with
+   the move to the cell with the given index. */
+static void perftTask(unsigned long index, unsigned workerIndex,
+    void* context)
+{
+    Perft* const perft = context;
+    PerftWorker* const worker = perft->workers + workerIndex;
+    unsigned const row = index / worker->board.columns;
+    unsigned const column = index % worker->board.columns;
+    unsigned long sequences = 0;
+
+    if (getBoardCell(&worker->board, row, column) == CELL_EMPTY)
+    {
+        sequences = countMove(worker, row, column, perft->depth,
+            perft->unique);
+    }
+
+    worker->sequences += sequences;
+    if (perft->counts)
+    {
+        perft->counts[index] = sequences;
+    }
+}
+
+
+/* Counts the distinct leaf positions in all the workers' tables. */
+static unsigned long countUniqueLeaves(PerftWorker const* workers,
+    unsigned threads)
+{
+    PositionTable merged = createPositionTable(INITIAL_POSITION_CAPACITY);
+    PositionEntry const* entry = NULL;
+    unsigned long count = 0;
+    unsigned i = 0;
+    size_t j = 0;
+
+    for (i = 0; i < threads; ++i)
+    {
+        for (j = 0; j < workers[i].positions.capacity; ++j)
+        {
+            entry = workers[i].positions.entries + j;
+            if (entry->used && entry->leaf
+                && !findPosition(&merged, entry->key)->used)
+            {
+                insertPosition(&merged, entry->key, 0, 1);
+            }
+        }
+    }
+
+    count = merged.count;
+    destroyPositionTable(&merged);
+
+    return count;
+}
+
+
+/* Runs a perft, splitting the moves from the position between the threads.
+   counts may be NULL. */
+static PerftResult splitPerft(GameBoard const* board, unsigned depth, int unique,
+    unsigned threads, unsigned long* counts)
+{
+    double const start = monotonicSeconds();
+    unsigned long const cells = (unsigned long)board->rows * board->columns;
+    PerftResult result;
+    Perft perft;
+    unsigned i = 0;
+
+    assert(threads > 0);
+
+    perft.workers = malloc(threads * sizeof(PerftWorker));
+    perft.counts = counts;
+    perft.depth = depth;
+    perft.unique = unique;
+    for (i = 0; i < threads; ++i)
+    {
+        perft.workers[i].board = copyGameBoard(board);
+        perft.workers[i].positions = createPositionTable(unique
+            ? INITIAL_POSITION_CAPACITY : 1u);
+        perft.workers[i].sequences = 0;
+        perft.workers[i].moves = 0;
+    }
+
+    result.sequences = depth == 0 ? 1u : 0u;
+    result.uniquePositions = unique && depth == 0 ? 1u : 0u;
+    result.moves = 0;
+    result.threads = threads;
+
+    if (depth > 0)
+    {
+        runWorkStealing(cells, threads, perftTask, &perft, NULL);
+        if (unique)
+        {
+            result.uniquePositions = countUniqueLeaves(perft.workers,
+                threads);
+        }
+    }
+
+    for (i = 0; i < threads; ++i)
+    {
+        result.sequences += perft.workers[i].sequences;
+        result.moves += perft.workers[i].moves;
+        destroyPositionTable(&perft.workers[i].positions);
+        destroyGameBoard(&perft.workers[i].board);
+    }
+    free(perft.workers);
+
+    result.seconds = monotonicSeconds() - start;
+
+    return result;
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+PerftResult runPerft(GameBoard const* board, unsigned depth, int unique,
+    unsigned threads)
+{
+    return splitPerft(board, depth, unique, threads, NULL);
+}
+
+
+void dividePerft(GameBoard const* board, unsigned depth, unsigned threads,
+    unsigned long* counts)
+{
+    unsigned long const cells = (unsigned long)board->rows * board->columns;
+    unsigned long i = 0;
+
+    if (depth == 0)
+    {
+        for (i = 0; i < cells; ++i)
+        {
+            counts[i] = 0;
+        }
+    }
+    splitPerft(board, depth, 0, threads, counts);
+}
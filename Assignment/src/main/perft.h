@@ -0,0 +1,45 @@
+/* Exhaustive move generation counts ("perft"), for checking board backends
+   against each other and known results, and for benchmarking the board's
+   move and undo path. */
+
+#ifndef PERFT_H
+#define PERFT_H
+
+#include "board.h"
+
+
+/* Outcome and statistics of runPerft(). */
+typedef struct
+{
+    /* Legal move sequences of exactly the given depth. A sequence ends early
+       if a move wins or fills the board. */
+    unsigned long sequences;
+    /* Distinct positions those sequences reach, if counted, otherwise 0. */
+    unsigned long uniquePositions;
+    unsigned long moves;    /* Moves made with makeMove(). */
+    double seconds;         /* Wall-clock time taken. */
+    unsigned threads;       /* Threads used. */
+} PerftResult;
+
+
+/* Counts the legal move sequences of the given depth from a board position,
+   making and undoing every move on copies of the board. The moves from the
+   position are split between threads (>0).
+   If unique is non-zero, also counts the distinct positions reached, by
+   storing every position visited in a hash table. Positions reached again
+   reuse their stored sequence counts rather than being searched again, so
+   far fewer moves are made, but memory grows with the positions visited.
+   Hash collisions, which are very unlikely, could make the counts wrong.
+   board is not modified. */
+PerftResult runPerft(GameBoard const* board, unsigned depth, int unique,
+    unsigned threads);
+
+/* Counts the sequences of each move from a board position, as runPerft()
+   without unique does, into counts, indexed by row * columns + column.
+   Cells that are occupied count 0. Useful for finding which move a
+   mismatched count comes from. board is not modified. */
+void dividePerft(GameBoard const* board, unsigned depth, unsigned threads,
+    unsigned long* counts);
+
+
+#endif
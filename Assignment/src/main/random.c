@@ -0,0 +1,43 @@
+/* Fast pseudorandom number generation. */
+
+#include "random.h"
+
+#include <assert.h>
+
+
+/* PUBLIC INTERFACE */
+
+
+unsigned long seedRandom(unsigned long seed)
+{
+    /* SplitMix64, which never maps to the all-zero state xorshift can't leave
+       for the seeds used in practice. */
+    unsigned long state = seed + 0x9e3779b97f4a7c15ul;
+
+    state = (state ^ (state >> 30)) * 0xbf58476d1ce4e5b9ul;
+    state = (state ^ (state >> 27)) * 0x94d049bb133111ebul;
+    state ^= state >> 31;
+
+    return state != 0 ? state : 1u;
+}
+
+
+unsigned long nextRandom(unsigned long* state)
+{
+    /* xorshift64*. */
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+
+    return *state * 0x2545f4914f6cdd1dul;
+}
+
+
+unsigned long randomBelow(unsigned long* state, unsigned long bound)
+{
+    assert(bound > 0);
+
+    /* The high bits are the most random. The slight bias for bounds that are
+       not powers of 2 does not matter for game playing. */
+    return (nextRandom(state) >> 11) % bound;
+}
@@ -0,0 +1,19 @@
+/* Fast pseudorandom number generation.
+   Unlike rand(), the generator state is held by the caller, so each thread
+   can have its own generator. */
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+
+/* Gets a generator state from a seed. Any seed, including 0, is valid. */
+unsigned long seedRandom(unsigned long seed);
+
+/* Gets the next number from a generator. */
+unsigned long nextRandom(unsigned long* state);
+
+/* Gets a number in [0, bound) from a generator. bound must be >0. */
+unsigned long randomBelow(unsigned long* state, unsigned long bound);
+
+
+#endif
@@ -0,0 +1,368 @@
+/* Drawing boards as text. */
+
+#include "render.h"
+
+#include "board.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Characters drawn for each CellStatus. */
+static char const CELL_CHARS[] = {' ', 'X', 'O'};
+
+/* Characters each cell takes up along a line, including its left border. */
+#define CELL_WIDTH 4u
+
+
+/* Counts the decimal digits of a number. */
+static unsigned countDigits(unsigned long value)
+{
+    unsigned digits = 1;
+
+    while (value >= 10u)
+    {
+        value /= 10u;
+        ++digits;
+    }
+
+    return digits;
+}
+
+
+/* Writes a number right-aligned in width characters, without a null
+   terminator. The number must fit. */
+static void writeNumber(char* out, unsigned long value, unsigned width)
+{
+    unsigned i = width;
+
+    memset(out, ' ', width);
+    do
+    {
+        --i;
+        out[i] = (char)('0' + value % 10u);
+        value /= 10u;
+    } while (value > 0);
+}
+
+
+/* Makes sure a frame's buffer can hold size characters. Its contents are
+   lost if it has to grow.
+   Returns 0, leaving it without a buffer, if allocation fails. */
+static int reserveFrame(FrameBuffer* frame, size_t size)
+{
+    if (size > frame->capacity)
+    {
+        free(frame->text);
+        frame->text = malloc(size);
+        frame->capacity = frame->text ? size : 0;
+    }
+
+    return frame->capacity >= size;
+}
+
+
+/* Counts the characters before the grid on each line of a frame, taken by
+   the row numbers and a space. */
+static unsigned labelMargin(Viewport const* viewport, int labels)
+{
+    return labels
+        ? countDigits(viewport->firstRow + viewport->rows - 1ul) + 1u : 0;
+}
+
+
+/* Counts the lines of column numbers above the grid of a frame, one per
+   digit of the widest. */
+static unsigned labelLineCount(Viewport const* viewport, int labels)
+{
+    return labels
+        ? countDigits(viewport->firstColumn + viewport->columns - 1ul) : 0;
+}
+
+
+/* Returns the first of count cells along a side of length cells, centred on
+   centre as far as the ends allow. */
+static unsigned centredStart(unsigned centre, unsigned count, unsigned length)
+{
+    unsigned start = centre > count / 2u ? centre - count / 2u : 0;
+
+    if (start > length - count)
+    {
+        start = length - count;
+    }
+
+    return start;
+}
+
+
+/* Draws a frame for renderBoard() into a buffer already big enough. */
+static void drawFrame(FrameBuffer* frame, GameBoard const* board,
+    Viewport const* viewport, int labels)
+{
+    unsigned long const lastRow = viewport->firstRow + viewport->rows - 1ul;
+    unsigned long const lastColumn = viewport->firstColumn
+        + viewport->columns - 1ul;
+    unsigned const margin = labelMargin(viewport, labels);
+    unsigned const labelLines = labelLineCount(viewport, labels);
+    size_t const gridWidth = (size_t)viewport->columns * CELL_WIDTH + 1u;
+    /* Every line, including its newline, is this long. */
+    size_t const lineLength = margin + gridWidth + 1u;
+    char* out = NULL;
+    unsigned long place = 1;
+    unsigned long column = 0;
+    unsigned long i = 0;
+    unsigned line = 0;
+    unsigned j = 0;
+
+    assert(lastRow < board->rows && lastColumn < board->columns);
+
+    out = frame->text;
+
+    /* Column numbers, written downwards over the middle of each cell, most
+       significant digit first. */
+    for (line = 0; line < labelLines; ++line)
+    {
+        place = 1;
+        for (j = line + 1u; j < labelLines; ++j)
+        {
+            place *= 10u;
+        }
+
+        memset(out, ' ', lineLength - 1u);
+        for (j = 0; j < viewport->columns; ++j)
+        {
+            column = viewport->firstColumn + j;
+            if (column >= place || place == 1u)
+            {
+                out[margin + j * CELL_WIDTH + 2u]
+                    = (char)('0' + column / place % 10u);
+            }
+        }
+        out[lineLength - 1u] = '\n';
+        out += lineLength;
+    }
+
+    /* Top border. */
+    memset(out, ' ', margin);
+    memset(out + margin, '-', gridWidth);
+    out[lineLength - 1u] = '\n';
+    out += lineLength;
+
+    for (i = 0; i < viewport->rows; ++i)
+    {
+        if (labels)
+        {
+            writeNumber(out, viewport->firstRow + i, margin - 1u);
+            out[margin - 1u] = ' ';
+        }
+        out[margin] = '|';
+        for (j = 0; j < viewport->columns; ++j)
+        {
+            out[margin + j * CELL_WIDTH + 1u] = ' ';
+            out[margin + j * CELL_WIDTH + 2u] = renderedCellChar(getBoardCell(
+                board, viewport->firstRow + i, viewport->firstColumn + j));
+            out[margin + j * CELL_WIDTH + 3u] = ' ';
+            out[margin + j * CELL_WIDTH + 4u] = '|';
+        }
+        out[lineLength - 1u] = '\n';
+        out += lineLength;
+
+        /* Divider below the row. */
+        memset(out, ' ', margin);
+        memset(out + margin, '-', gridWidth);
+        out[lineLength - 1u] = '\n';
+        out += lineLength;
+    }
+
+    assert(out == frame->text + frame->length);
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+FrameBuffer zeroedFrameBuffer(void)
+{
+    FrameBuffer frame;
+
+    frame.text = NULL;
+    frame.length = 0;
+    frame.capacity = 0;
+
+    return frame;
+}
+
+
+void destroyFrameBuffer(FrameBuffer* frame)
+{
+    free(frame->text);
+    *frame = zeroedFrameBuffer();
+}
+
+
+Viewport fullViewport(GameBoard const* board)
+{
+    Viewport viewport;
+
+    viewport.firstRow = 0;
+    viewport.firstColumn = 0;
+    viewport.rows = board->rows;
+    viewport.columns = board->columns;
+
+    return viewport;
+}
+
+
+Viewport viewportAround(GameBoard const* board, unsigned row, unsigned column,
+    unsigned rows, unsigned columns)
+{
+    Viewport viewport;
+
+    assert(rows > 0 && columns > 0);
+
+    viewport.rows = rows < board->rows ? rows : board->rows;
+    viewport.columns = columns < board->columns ? columns : board->columns;
+    viewport.firstRow = centredStart(row, viewport.rows, board->rows);
+    viewport.firstColumn = centredStart(column, viewport.columns,
+        board->columns);
+
+    return viewport;
+}
+
+
+int isFullViewport(GameBoard const* board, Viewport const* viewport)
+{
+    return viewport->rows == board->rows
+        && viewport->columns == board->columns;
+}
+
+
+int viewportContains(Viewport const* viewport, unsigned row, unsigned column)
+{
+    return row >= viewport->firstRow
+        && row - viewport->firstRow < viewport->rows
+        && column >= viewport->firstColumn
+        && column - viewport->firstColumn < viewport->columns;
+}
+
+
+unsigned long renderedLineCount(Viewport const* viewport, int labels)
+{
+    return labelLineCount(viewport, labels) + 2ul * viewport->rows + 1u;
+}
+
+
+unsigned long renderedLineWidth(Viewport const* viewport, int labels)
+{
+    return labelMargin(viewport, labels)
+        + (unsigned long)viewport->columns * CELL_WIDTH + 1u;
+}
+
+
+unsigned long renderedFrameSize(Viewport const* viewport, int labels)
+{
+    /* Bounding each side first keeps the line count and length from
+       overflowing, and their product too. */
+    int const fits = viewport->rows < RENDER_MAX_FRAME_SIZE / 2u
+        && viewport->columns < RENDER_MAX_FRAME_SIZE / CELL_WIDTH
+        && renderedLineCount(viewport, labels) <= RENDER_MAX_FRAME_SIZE
+            / (renderedLineWidth(viewport, labels) + 1u);
+
+    return fits ? renderedLineCount(viewport, labels)
+        * (renderedLineWidth(viewport, labels) + 1u) : 0;
+}
+
+
+int fitViewport(GameBoard const* board, unsigned row, unsigned column,
+    unsigned maxRows, unsigned maxColumns, unsigned long lines,
+    unsigned long characters, Viewport* viewport, int* labels)
+{
+    Viewport fitted = fullViewport(board);
+    unsigned rows = board->rows < maxRows ? board->rows : maxRows;
+    unsigned columns = board->columns < maxColumns ? board->columns
+        : maxColumns;
+    int tall = 0;
+    int wide = 0;
+    /* A line as wide as the screen can wrap early on some terminals. */
+    int whole = board->rows <= maxRows && board->columns <= maxColumns
+        && renderedLineCount(&fitted, 0) <= lines
+        && renderedLineWidth(&fitted, 0) < characters;
+    int fits = whole;
+
+    /* Otherwise shrink a labelled viewport until it fits. */
+    while (!fits && rows > 0 && columns > 0)
+    {
+        fitted = viewportAround(board, row, column, rows, columns);
+        tall = renderedLineCount(&fitted, 1) > lines;
+        wide = renderedLineWidth(&fitted, 1) >= characters;
+        fits = !tall && !wide;
+        rows -= tall;
+        columns -= wide;
+    }
+
+    if (fits)
+    {
+        *viewport = fitted;
+        *labels = !whole;
+    }
+
+    return fits;
+}
+
+
+void renderedCellPosition(Viewport const* viewport, int labels, unsigned row,
+    unsigned column, unsigned long* line, unsigned long* character)
+{
+    assert(viewportContains(viewport, row, column));
+
+    *line = labelLineCount(viewport, labels)
+        + 2ul * (row - viewport->firstRow) + 1u;
+    *character = labelMargin(viewport, labels)
+        + (unsigned long)(column - viewport->firstColumn) * CELL_WIDTH + 2u;
+}
+
+
+char renderedCellChar(CellStatus status)
+{
+    return CELL_CHARS[status];
+}
+
+
+int renderBoard(FrameBuffer* frame, GameBoard const* board,
+    Viewport const* viewport, int labels)
+{
+    int res = 0;
+
+    assert(viewport->rows > 0 && viewport->columns > 0);
+
+    frame->length = renderedFrameSize(viewport, labels);
+    res = frame->length > 0 && reserveFrame(frame, frame->length);
+    if (res)
+    {
+        drawFrame(frame, board, viewport, labels);
+    }
+    else
+    {
+        frame->length = 0;
+    }
+
+    return res;
+}
+
+
+int writeFrame(FrameBuffer const* frame, FILE* stream)
+{
+    int res = fflush(stream) == 0;
+
+    res = res && fwrite(frame->text, 1, frame->length, stream)
+        == frame->length;
+    res = fflush(stream) == 0 && res;
+
+    return res;
+}
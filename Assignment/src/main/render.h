@@ -0,0 +1,109 @@
+/* Drawing boards as text, composed in memory and written out in one go, of
+   either the whole board or a window onto part of it. */
+
+#ifndef RENDER_H
+#define RENDER_H
+
+#include "board.h"
+
+#include <stddef.h>
+#include <stdio.h>
+
+
+/* Largest frame renderBoard() draws, in characters: 64MB, or a whole board
+   of about 2800x2800 cells. */
+#define RENDER_MAX_FRAME_SIZE (1ul << 26)
+
+
+/* Rectangle of a board's cells to draw. */
+typedef struct
+{
+    unsigned firstRow;
+    unsigned firstColumn;
+    unsigned rows;          /* >0 and within the board. */
+    unsigned columns;       /* >0 and within the board. */
+} Viewport;
+
+
+/* Text of a drawn board. The buffer is kept between frames, and only grows
+   when a frame needs more space than any before it.
+   Use zeroedFrameBuffer to create one, and destroyFrameBuffer to destroy
+   it. */
+typedef struct
+{
+    char* text;             /* Not null terminated. */
+    size_t length;
+    size_t capacity;
+} FrameBuffer;
+
+
+/* Returns a FrameBuffer with no buffer allocated yet. */
+FrameBuffer zeroedFrameBuffer(void);
+
+/* Deallocates a frame's buffer. */
+void destroyFrameBuffer(FrameBuffer* frame);
+
+/* Returns a viewport covering all of a board. */
+Viewport fullViewport(GameBoard const* board);
+
+/* Returns a viewport of at most rows * columns cells of a board, centred on
+   the given cell as far as the edges of the board allow. */
+Viewport viewportAround(GameBoard const* board, unsigned row, unsigned column,
+    unsigned rows, unsigned columns);
+
+/* Checks if a viewport covers all of a board. */
+int isFullViewport(GameBoard const* board, Viewport const* viewport);
+
+/* Checks if a cell is inside a viewport. */
+int viewportContains(Viewport const* viewport, unsigned row, unsigned column);
+
+/* Draws the cells of a board inside a viewport into a frame, replacing its
+   previous contents, in the grid format of displayGameBoard(). If labels is
+   non-zero, the grid has each column's number written downwards above it,
+   and each row's number to its left. The size of the frame is worked out
+   first, so the buffer is allocated at most once.
+   Returns 0, leaving the frame empty, if it would take more than
+   RENDER_MAX_FRAME_SIZE characters or its buffer can't be allocated. */
+int renderBoard(FrameBuffer* frame, GameBoard const* board,
+    Viewport const* viewport, int labels);
+
+/* Counts the characters of a frame drawn by renderBoard(), or returns 0 if
+   there would be more than RENDER_MAX_FRAME_SIZE. */
+unsigned long renderedFrameSize(Viewport const* viewport, int labels);
+
+/* Counts the lines of a frame drawn by renderBoard(). */
+unsigned long renderedLineCount(Viewport const* viewport, int labels);
+
+/* Counts the characters on each line of a frame drawn by renderBoard(), not
+   including the newline. */
+unsigned long renderedLineWidth(Viewport const* viewport, int labels);
+
+/* Picks how to draw a board on a screen of the given size, so the frame
+   neither scrolls nor wraps: the whole board without labels if it has at
+   most maxRows * maxColumns cells and fits, otherwise, with labels, the
+   biggest viewport centred on the given cell, of at most maxRows *
+   maxColumns cells, that fits.
+   Returns 0, setting neither viewport nor labels, if not even one cell
+   fits. */
+int fitViewport(GameBoard const* board, unsigned row, unsigned column,
+    unsigned maxRows, unsigned maxColumns, unsigned long lines,
+    unsigned long characters, Viewport* viewport, int* labels);
+
+/* Gets where the character showing a cell is in a frame drawn by
+   renderBoard(), as a line and a character along it, both counted from 0.
+   The cell must be inside the viewport. Lets a frame on screen be updated
+   in place. */
+void renderedCellPosition(Viewport const* viewport, int labels, unsigned row,
+    unsigned column, unsigned long* line, unsigned long* character);
+
+/* Returns the character renderBoard() shows a cell with the given status
+   as. */
+char renderedCellChar(CellStatus status);
+
+/* Writes a frame to a stream with a single fwrite(), after flushing what was
+   written to the stream before it.
+   Returns 0 if writing failed. */
+int writeFrame(FrameBuffer const* frame, FILE* stream);
+
+
+#endif
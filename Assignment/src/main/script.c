@@ -0,0 +1,439 @@
+/* Scripted games. */
+
+#include "script.h"
+
+#include "board.h"
+#include "common.h"
+#include "game.h"
+#include "log.h"
+#include "settings.h"
+#include "timer.h"
+
+#include <limits.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Bytes of a script read at a time. */
+#define SCRIPT_CHUNK_SIZE 65536u
+
+/* Initial capacity of the moves read from a line. */
+#define INITIAL_MOVE_CAPACITY 64u
+
+
+/* Where the parser is along a line of a script. */
+typedef enum
+{
+    PARSE_SPACE,        /* Between moves. */
+    PARSE_COLUMN,       /* In a move's column. */
+    PARSE_COMMA,        /* After a move's column, before its comma. */
+    PARSE_ROW_START,    /* After a move's comma, before its row. */
+    PARSE_ROW,          /* In a move's row. */
+    PARSE_COMMENT,      /* After a '#'. */
+    PARSE_ERROR         /* After a malformed move, skipping the rest of the
+                           line. */
+} ParseState;
+
+
+/* Move read from a script. Coordinates too big for any board are kept as
+   UINT_MAX. */
+typedef struct
+{
+    unsigned long row;
+    unsigned long column;
+} ScriptMove;
+
+
+/* State of a run of scripted games, kept from one chunk of the script to the
+   next. */
+typedef struct
+{
+    GameBoard board;            /* Empty between games. */
+    ScriptMove* moves;          /* Moves read from the current line. */
+    size_t count;
+    size_t capacity;
+    size_t played;              /* Moves of the current line played. */
+    size_t inBounds;            /* Moves of the current line before the first
+                                   out of bounds. */
+    char const* problem;        /* Why the current line's game is invalid, or
+                                   NULL. */
+    ParseState state;
+    unsigned long number;       /* Coordinate being read. */
+    unsigned long column;       /* Column of the move being read, once its
+                                   row has been started. */
+    unsigned long line;         /* Line being read, from 1. */
+    FILE* out;
+    int logGames;
+    ScriptStats stats;
+} ScriptRun;
+
+
+/* Adds a digit to the coordinate being read. */
+static void addDigit(ScriptRun* run, char digit)
+{
+    run->number = run->number < UINT_MAX / 10u
+        ? run->number * 10u + (unsigned long)(digit - '0') : UINT_MAX;
+}
+
+
+/* Adds the move just read to the current line's moves. */
+static void addMove(ScriptRun* run)
+{
+    if (run->count == run->capacity)
+    {
+        run->capacity *= 2u;
+        run->moves = realloc(run->moves, run->capacity * sizeof(ScriptMove));
+    }
+
+    run->moves[run->count].column = run->column;
+    run->moves[run->count].row = run->number;
+    ++run->count;
+}
+
+
+/* Adds a valid game on the board to the game logs. */
+static void logScriptGame(GameBoard const* board, int deadDraw)
+{
+    size_t i = 0;
+
+    newGameLog();
+    for (i = 0; i < board->moveCount; ++i)
+    {
+        logTurn(i % 2u == 0 ? PLAYER_X : PLAYER_O, board->moves[i].row,
+            board->moves[i].column);
+    }
+    if (deadDraw)
+    {
+        logDeadDraw();
+    }
+}
+
+
+/* GameHooks::move hook of a scripted game. Takes the next move read from the
+   current line, stopping the game when they run out or the move is invalid. */
+static TurnInput scriptMove(void* context, GameBoard* board, Player _,
+    unsigned* row, unsigned* column)
+{
+    ScriptRun* const run = context;
+    ScriptMove const* const move = run->moves + run->played;
+    TurnInput input = TURN_STOP;
+
+    /* The game is unfinished if the moves have run out. */
+    if (run->played < run->count)
+    {
+        if (run->played == run->inBounds)
+        {
+            run->problem = "is out of bounds";
+        }
+        else if (getBoardCell(board, move->row, move->column) != CELL_EMPTY)
+        {
+            run->problem = "is on an occupied cell";
+        }
+        else
+        {
+            *row = move->row;
+            *column = move->column;
+            ++run->played;
+            input = TURN_MOVE;
+        }
+    }
+
+    return input;
+}
+
+
+/* Plays the moves read from the current line on the board, writes the
+   result, adds it to the run's results, and empties the board again.
+   malformed is non-zero if the line had a malformed move after those read. */
+static void playScriptGame(ScriptRun* run, int malformed)
+{
+    GameBoard* const board = &run->board;
+    GameHooks hooks = zeroedGameHooks();
+    GameResult result = GAME_DRAWN;
+
+    hooks.move = scriptMove;
+    hooks.context = run;
+    run->played = 0;
+    run->problem = NULL;
+
+    /* All the moves are checked against the bounds before any are made. */
+    run->inBounds = 0;
+    while (run->inBounds < run->count
+        && run->moves[run->inBounds].row < board->rows
+        && run->moves[run->inBounds].column < board->columns)
+    {
+        ++run->inBounds;
+    }
+
+    result = playGame(board, &hooks);
+
+    if (!run->problem && run->played < run->count)
+    {
+        run->problem = "is after the end of the game";
+    }
+    else if (!run->problem && malformed)
+    {
+        run->problem = "is malformed";
+    }
+
+    ++run->stats.games;
+    if (run->problem)
+    {
+        ++run->stats.invalid;
+        fprintf(run->out, "%lu: invalid, move %lu %s\n", run->line,
+            (unsigned long)run->played + 1u, run->problem);
+    }
+    else
+    {
+        run->stats.moves += board->moveCount;
+        if (result == GAME_WON)
+        {
+            ++run->stats.wins[otherPlayer(nextPlayer(board))];
+            fprintf(run->out, "%lu: %c won in %lu moves\n", run->line,
+                playerToChar(otherPlayer(nextPlayer(board))),
+                (unsigned long)board->moveCount);
+        }
+        else if (result == GAME_STOPPED)
+        {
+            ++run->stats.unfinished;
+            fprintf(run->out, "%lu: unfinished after %lu moves\n", run->line,
+                (unsigned long)board->moveCount);
+        }
+        else
+        {
+            ++run->stats.draws;
+            run->stats.deadDraws += result == GAME_DEAD_DRAW;
+            fprintf(run->out, "%lu: %s in %lu moves\n", run->line,
+                result == GAME_DEAD_DRAW ? "dead draw" : "draw",
+                (unsigned long)board->moveCount);
+        }
+
+        if (run->logGames)
+        {
+            logScriptGame(board, result == GAME_DEAD_DRAW);
+        }
+    }
+
+    while (board->moveCount > 0)
+    {
+        unmakeMove(board);
+    }
+}
+
+
+/* Ends the current line, playing its game if it had any moves. */
+static void endLine(ScriptRun* run)
+{
+    /* A move cut off by the end of the line is malformed. */
+    int const malformed = run->state == PARSE_COLUMN
+        || run->state == PARSE_COMMA || run->state == PARSE_ROW_START
+        || run->state == PARSE_ERROR;
+
+    if (run->state == PARSE_ROW)
+    {
+        addMove(run);
+    }
+    if (run->count > 0 || malformed)
+    {
+        playScriptGame(run, malformed);
+    }
+
+    run->count = 0;
+    run->state = PARSE_SPACE;
+    ++run->line;
+}
+
+
+/* Reads the next character of a script. */
+static void parseChar(ScriptRun* run, char c)
+{
+    int const digit = c >= '0' && c <= '9';
+    int const space = c == ' ' || c == '\t' || c == '\r';
+
+    switch (run->state)
+    {
+        case PARSE_SPACE:
+            if (digit)
+            {
+                run->number = 0;
+                addDigit(run, c);
+                run->state = PARSE_COLUMN;
+            }
+            else if (c == '#')
+            {
+                run->state = PARSE_COMMENT;
+            }
+            else if (!space)
+            {
+                run->state = PARSE_ERROR;
+            }
+            break;
+        case PARSE_COLUMN:
+            if (digit)
+            {
+                addDigit(run, c);
+            }
+            else if (c == ',' || space)
+            {
+                run->column = run->number;
+                run->state = c == ',' ? PARSE_ROW_START : PARSE_COMMA;
+            }
+            else
+            {
+                run->state = PARSE_ERROR;
+            }
+            break;
+        case PARSE_COMMA:
+            if (c == ',')
+            {
+                run->state = PARSE_ROW_START;
+            }
+            else if (!space)
+            {
+                run->state = PARSE_ERROR;
+            }
+            break;
+        case PARSE_ROW_START:
+            if (digit)
+            {
+                run->number = 0;
+                addDigit(run, c);
+                run->state = PARSE_ROW;
+            }
+            else if (!space)
+            {
+                run->state = PARSE_ERROR;
+            }
+            break;
+        case PARSE_ROW:
+            if (digit)
+            {
+                addDigit(run, c);
+            }
+            else if (space || c == '#')
+            {
+                addMove(run);
+                run->state = space ? PARSE_SPACE : PARSE_COMMENT;
+            }
+            else
+            {
+                run->state = PARSE_ERROR;
+            }
+            break;
+        case PARSE_COMMENT:
+        case PARSE_ERROR:
+            break;
+    }
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+ScriptStats zeroedScriptStats(void)
+{
+    ScriptStats stats;
+
+    stats.games = 0;
+    stats.moves = 0;
+    stats.wins[PLAYER_X] = 0;
+    stats.wins[PLAYER_O] = 0;
+    stats.draws = 0;
+    stats.deadDraws = 0;
+    stats.unfinished = 0;
+    stats.invalid = 0;
+    stats.seconds = 0.0;
+
+    return stats;
+}
+
+
+ScriptStats runScript(Settings const* settings, FILE* in, FILE* out,
+    int logGames, int* error)
+{
+    double const start = monotonicSeconds();
+    char* const chunk = malloc(SCRIPT_CHUNK_SIZE);
+    ScriptRun run;
+    size_t length = 0;
+    size_t i = 0;
+
+    run.board = createGameBoard(settings->n, settings->m, settings->k);
+    if (!settings->strictRules)
+    {
+        enableSmallWindowCounts(&run.board);
+    }
+    run.capacity = INITIAL_MOVE_CAPACITY;
+    run.moves = malloc(run.capacity * sizeof(ScriptMove));
+    run.count = 0;
+    run.played = 0;
+    run.inBounds = 0;
+    run.problem = NULL;
+    run.state = PARSE_SPACE;
+    run.number = 0;
+    run.column = 0;
+    run.line = 1;
+    run.out = out;
+    run.logGames = logGames;
+    run.stats = zeroedScriptStats();
+
+    /* fread() only comes up short at the end of the script or on an
+       error. */
+    do
+    {
+        length = fread(chunk, 1, SCRIPT_CHUNK_SIZE, in);
+        for (i = 0; i < length; ++i)
+        {
+            if (chunk[i] == '\n')
+            {
+                endLine(&run);
+            }
+            else
+            {
+                parseChar(&run, chunk[i]);
+            }
+        }
+    } while (length == SCRIPT_CHUNK_SIZE);
+
+    if (ferror(in))
+    {
+        perror("Error reading script");
+        *error = 1;
+    }
+    else
+    {
+        /* The last line needn't end with a newline. */
+        endLine(&run);
+    }
+
+    run.stats.seconds = monotonicSeconds() - start;
+
+    free(chunk);
+    free(run.moves);
+    destroyGameBoard(&run.board);
+
+    return run.stats;
+}
+
+
+void printScriptStats(ScriptStats const* stats)
+{
+    double const seconds = stats->seconds > 0.0 ? stats->seconds : 1.0;
+
+    printf("Script: %lu games, %lu moves in %.3fs.\n", stats->games,
+        stats->moves, stats->seconds);
+    printf("   Throughput: %.1f games/s, %.0f moves/s.\n",
+        stats->games / seconds, stats->moves / seconds);
+    printf("   Results: X won %lu, O won %lu, drawn %lu, unfinished %lu, "
+        "invalid %lu.\n", stats->wins[PLAYER_X], stats->wins[PLAYER_O],
+        stats->draws, stats->unfinished, stats->invalid);
+    if (stats->deadDraws > 0)
+    {
+        printf("   %lu drawn games were ended early, when neither player could "
+            "complete a line.\n", stats->deadDraws);
+    }
+}
@@ -0,0 +1,54 @@
+/* Games played from a script of moves rather than entered at prompts, for
+   batch runs and replaying recorded games.
+   Each line of a script is one game: its moves in order, X moving first,
+   each written column,row as at the move prompt, separated by spaces or tabs.
+   Blank lines, and anything after a '#' on a line, are ignored. */
+
+#ifndef SCRIPT_H
+#define SCRIPT_H
+
+#include "settings.h"
+
+#include <stdio.h>
+
+
+/* Results of a run of scripted games. */
+typedef struct
+{
+    unsigned long games;        /* Games read, including invalid ones. */
+    unsigned long moves;        /* Moves played, over all valid games. */
+    unsigned long wins[2];      /* Games won by each player, indexed by
+                                   Player. */
+    unsigned long draws;        /* Games drawn, including those ended
+                                   early. */
+    unsigned long deadDraws;    /* Games ended early as neither player could
+                                   complete a line any more. */
+    unsigned long unfinished;   /* Games whose moves ran out before the
+                                   end. */
+    unsigned long invalid;      /* Games with a malformed, out of bounds or
+                                   illegal move, or moves after the end. */
+    double seconds;             /* Wall-clock time taken. */
+} ScriptStats;
+
+
+/* Returns a ScriptStats object with all members zeroed out. */
+ScriptStats zeroedScriptStats(void);
+
+/* Plays every game in a script read from in, on a board with the dimensions
+   in settings, with the same rules as interactive games. The script is read
+   in large chunks, and each game's moves are checked against the board's
+   bounds before it is played. Nothing is prompted for or drawn: only a line
+   with the result of each game, headed by its line number in the script, is
+   written to out.
+   If logGames is non-zero, valid games are added to the game logs.
+   If reading fails, prints an error to stderr and sets error to 1, but still
+   returns the results of the games before the failure. */
+ScriptStats runScript(Settings const* settings, FILE* in, FILE* out,
+    int logGames, int* error);
+
+/* Prints a summary of the results and throughput of scripted games to
+   stdout. */
+void printScriptStats(ScriptStats const* stats);
+
+
+#endif
@@ -0,0 +1,806 @@
+/* Alpha-beta game tree search, used by computer players. */
+
+/* pthreads are POSIX, not ANSI C. */
+#define _POSIX_C_SOURCE 200112L
+
+#include "search.h"
+
+#include "board.h"
+#include "common.h"
+#include "threads.h"
+#include "timer.h"
+#include "transposition.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Larger than any score. */
+#define INFINITE_SCORE (WIN_SCORE + 1)
+
+/* How many nodes are visited between checks of the clock. */
+#define TIME_CHECK_INTERVAL 1024ul
+
+/* Boards with more cells than this are searched without window counts. Each
+   thread's copy of the board would need its own, at 32 bytes per cell, built
+   again every move. */
+#define SEARCH_WINDOW_COUNTS_MAX_CELLS (1ul << 16)
+
+/* Default limits for computer players. */
+#define DEFAULT_MAX_DEPTH MAX_SEARCH_DEPTH
+#define DEFAULT_MAX_SECONDS 1.0
+
+
+/* Rectangle containing all occupied cells. */
+typedef struct
+{
+    int any;                /* Whether any cells are occupied. */
+    unsigned minRow;
+    unsigned minColumn;
+    unsigned maxRow;
+    unsigned maxColumn;
+} Bounds;
+
+
+/* Candidate move along with its move ordering priority. */
+typedef struct
+{
+    unsigned row;
+    unsigned column;
+    long order;             /* Higher is searched first. */
+} Move;
+
+
+/* State of one thread's search in progress. */
+typedef struct
+{
+    GameBoard board;        /* Private copy that moves are made on. */
+    /* Copy of the caller's table, sharing its entries. */
+    TranspositionTable table;
+    unsigned long cells;    /* Total cells on the board. */
+    unsigned long nodes;
+    double softDeadline;    /* monotonicSeconds() value to start no new
+                               iteration after. */
+    double deadline;        /* monotonicSeconds() value to stop at. */
+    /* Set by the main thread once its search is over, to stop the helper
+       threads, or for the main thread the caller's stop flag. */
+    volatile int const* stop;
+    int aborted;            /* Set once the deadline has passed or stop is
+                               set. */
+    unsigned bestRow;       /* Best root move of the current iteration. */
+    unsigned bestColumn;
+} Search;
+
+
+/* Helper thread of a Lazy SMP search. */
+typedef struct
+{
+    Search search;
+    Bounds bounds;
+    unsigned firstDepth;    /* Iteration to start from. */
+    unsigned maxDepth;
+    pthread_t handle;
+} Helper;
+
+
+/* Row and column steps of the four line directions. Each goes down or along
+   a row, so a line's first cell has its lowest row. */
+static int const ROW_STEPS[4] = {0, 1, 1, 1};
+static int const COLUMN_STEPS[4] = {1, 0, 1, -1};
+
+
+/* Grows bounds to include a cell. */
+static Bounds includeCell(Bounds bounds, unsigned row, unsigned column)
+{
+    if (!bounds.any)
+    {
+        bounds.minRow = bounds.maxRow = row;
+        bounds.minColumn = bounds.maxColumn = column;
+        bounds.any = 1;
+    }
+    else
+    {
+        bounds.minRow = row < bounds.minRow ? row : bounds.minRow;
+        bounds.maxRow = row > bounds.maxRow ? row : bounds.maxRow;
+        bounds.minColumn = column < bounds.minColumn
+            ? column : bounds.minColumn;
+        bounds.maxColumn = column > bounds.maxColumn
+            ? column : bounds.maxColumn;
+    }
+
+    return bounds;
+}
+
+
+/* Gets bounds grown by margin on every side, clipped to the board. */
+static Bounds expandBounds(GameBoard const* board, Bounds bounds,
+    unsigned margin)
+{
+    bounds.minRow = bounds.minRow > margin ? bounds.minRow - margin : 0;
+    bounds.minColumn = bounds.minColumn > margin
+        ? bounds.minColumn - margin : 0;
+    bounds.maxRow = board->rows - 1u - bounds.maxRow > margin
+        ? bounds.maxRow + margin : board->rows - 1u;
+    bounds.maxColumn = board->columns - 1u - bounds.maxColumn > margin
+        ? bounds.maxColumn + margin : board->columns - 1u;
+
+    return bounds;
+}
+
+
+/* Gets the move ordering priority of placing status at an empty cell.
+   Cells that extend the mover's lines, or block the opponent's, come first. */
+static long moveOrder(GameBoard const* board, unsigned row, unsigned column,
+    CellStatus own, CellStatus opponent)
+{
+    unsigned const limit = board->winRequirement - 1u;
+    long order = 0;
+    unsigned ownRun = 0;
+    unsigned opponentRun = 0;
+    unsigned d = 0;
+
+    for (d = 0; d < 4; ++d)
+    {
+        ownRun = countBoardRun(board, row, column, own, ROW_STEPS[d],
+            COLUMN_STEPS[d], limit);
+        ownRun += countBoardRun(board, row, column, own, -ROW_STEPS[d],
+            -COLUMN_STEPS[d], limit - ownRun);
+        opponentRun = countBoardRun(board, row, column, opponent,
+            ROW_STEPS[d], COLUMN_STEPS[d], limit);
+        opponentRun += countBoardRun(board, row, column, opponent,
+            -ROW_STEPS[d], -COLUMN_STEPS[d], limit - opponentRun);
+
+        if (ownRun >= limit)
+        {
+            /* Immediate win. */
+            order += 1l << 28;
+        }
+        else if (opponentRun >= limit)
+        {
+            /* Blocks an immediate loss. */
+            order += 1l << 26;
+        }
+        else
+        {
+            order += (1l << (2u * (ownRun < 10u ? ownRun : 10u))) * 2l;
+            order += 1l << (2u * (opponentRun < 10u ? opponentRun : 10u));
+        }
+    }
+
+    return order;
+}
+
+
+/* qsort() comparison putting moves in descending order of priority. */
+static int compareMoves(void const* a, void const* b)
+{
+    long const orderA = ((Move const*)a)->order;
+    long const orderB = ((Move const*)b)->order;
+
+    return (orderA < orderB) - (orderA > orderB);
+}
+
+
+/* Generates the candidate moves for the side to move, in the order they
+   should be searched.
+   The returned array is dynamically allocated and must be freed. */
+static Move* generateMoves(GameBoard const* board, Bounds bounds,
+    size_t* count)
+{
+    CellStatus const own = playerToCell(nextPlayer(board));
+    CellStatus const opponent = playerToCell(otherPlayer(nextPlayer(board)));
+    Move* moves = NULL;
+    Bounds area;
+    unsigned i = 0;
+    unsigned j = 0;
+
+    *count = 0;
+
+    if (!bounds.any)
+    {
+        /* First move of the game, take the centre. */
+        moves = malloc(sizeof(Move));
+        moves[0].row = board->rows / 2u;
+        moves[0].column = board->columns / 2u;
+        moves[0].order = 0;
+        *count = 1;
+    }
+    else
+    {
+        area = expandBounds(board, bounds, 1);
+        moves = malloc((size_t)(area.maxRow - area.minRow + 1u)
+            * (area.maxColumn - area.minColumn + 1u) * sizeof(Move));
+
+        for (i = area.minRow; i <= area.maxRow; ++i)
+        {
+            for (j = area.minColumn; j <= area.maxColumn; ++j)
+            {
+                if (getBoardCell(board, i, j) == CELL_EMPTY
+                    && hasNeighbour(board, i, j))
+                {
+                    moves[*count].row = i;
+                    moves[*count].column = j;
+                    moves[*count].order = moveOrder(board, i, j, own,
+                        opponent);
+                    ++*count;
+                }
+            }
+        }
+
+        qsort(moves, *count, sizeof(Move), compareMoves);
+    }
+
+    return moves;
+}
+
+
+/* Moves a table move to the front of a move list, if it is in the list. */
+static void promoteMove(Move* moves, size_t count, unsigned row,
+    unsigned column)
+{
+    Move promoted;
+    size_t i = 0;
+    int found = 0;
+
+    for (i = 0; i < count && !found; ++i)
+    {
+        found = moves[i].row == row && moves[i].column == column;
+    }
+
+    if (found)
+    {
+        promoted = moves[i - 1u];
+        for (--i; i > 0; --i)
+        {
+            moves[i] = moves[i - 1u];
+        }
+        moves[0] = promoted;
+    }
+}
+
+
+/* Gets the evaluation weight of a line window holding count of one player's
+   cells and none of the other's. */
+static long windowWeight(unsigned count, unsigned winRequirement)
+{
+    unsigned const missing = winRequirement - count;
+    long weight = 0;
+
+    if (count > 0)
+    {
+        weight = missing >= 5u ? 1l : 1l << (3u * (5u - missing));
+    }
+
+    return weight;
+}
+
+
+/* Sums the weights of every window from a board's window counts. */
+static long evaluateWindowCounts(GameBoard const* board)
+{
+    WindowCounts const* const windows = &board->windows;
+    long score = 0;
+    unsigned count = 0;
+
+    for (count = 1; count <= windows->maxCount; ++count)
+    {
+        score += windowWeight(count, board->winRequirement)
+            * ((long)countOpenWindows(windows, PLAYER_X, count)
+                - (long)countOpenWindows(windows, PLAYER_O, count));
+    }
+
+    return score;
+}
+
+
+/* Sums the weights of every window containing occupied cells by scanning
+   them. */
+static long evaluateScan(GameBoard const* board, Bounds bounds)
+{
+    unsigned const k = board->winRequirement;
+    long score = 0;
+    Bounds area;
+    unsigned i = 0;
+    unsigned j = 0;
+    unsigned d = 0;
+    unsigned step = 0;
+    unsigned xCount = 0;
+    unsigned oCount = 0;
+    long lastRow = 0;
+    long lastColumn = 0;
+    CellStatus status;
+
+    /* Any window containing an occupied cell starts within this area. */
+    area = expandBounds(board, bounds, k - 1u);
+    area.maxRow = bounds.maxRow;
+
+    for (i = area.minRow; i <= area.maxRow; ++i)
+    {
+        for (j = area.minColumn; j <= area.maxColumn; ++j)
+        {
+            for (d = 0; d < 4; ++d)
+            {
+                lastRow = i + (long)ROW_STEPS[d] * (k - 1u);
+                lastColumn = j + (long)COLUMN_STEPS[d] * (k - 1u);
+                if (lastColumn >= 0
+                    && inBoardBounds(board, lastRow, lastColumn))
+                {
+                    xCount = 0;
+                    oCount = 0;
+                    for (step = 0; step < k; ++step)
+                    {
+                        status = getBoardCell(board, i + ROW_STEPS[d] * step,
+                            j + COLUMN_STEPS[d] * (long)step);
+                        xCount += status == CELL_X;
+                        oCount += status == CELL_O;
+                    }
+
+                    if (oCount == 0)
+                    {
+                        score += windowWeight(xCount, k);
+                    }
+                    else if (xCount == 0)
+                    {
+                        score -= windowWeight(oCount, k);
+                    }
+                }
+            }
+        }
+    }
+
+    return score;
+}
+
+
+/* Statically evaluates a position for the side to move, by scoring every
+   winRequirement long window that contains occupied cells. */
+static int evaluate(GameBoard const* board, Bounds bounds)
+{
+    long score = 0;
+
+    if (hasWindowCounts(board))
+    {
+        score = evaluateWindowCounts(board);
+    }
+    else
+    {
+        score = evaluateScan(board, bounds);
+    }
+
+    if (nextPlayer(board) == PLAYER_O)
+    {
+        score = -score;
+    }
+    if (score >= FORCED_SCORE)
+    {
+        score = FORCED_SCORE - 1;
+    }
+    else if (score <= -FORCED_SCORE)
+    {
+        score = -FORCED_SCORE + 1;
+    }
+
+    return score;
+}
+
+
+/* Converts a forced score relative to the root, whose distance to the end of
+   the game counts from the root, to one relative to the current node, ply
+   moves from the root, for storing in the transposition table. The stored
+   score then holds wherever else the position is reached. */
+static int toTableScore(int score, unsigned ply)
+{
+    if (score >= FORCED_SCORE)
+    {
+        score += ply;
+    }
+    else if (score <= -FORCED_SCORE)
+    {
+        score -= ply;
+    }
+
+    return score;
+}
+
+
+/* Converts a forced score relative to the current node, as stored in the
+   transposition table, back to one relative to the root. Reverses
+   toTableScore(). */
+static int fromTableScore(int score, unsigned ply)
+{
+    if (score >= FORCED_SCORE)
+    {
+        score -= ply;
+    }
+    else if (score <= -FORCED_SCORE)
+    {
+        score += ply;
+    }
+
+    return score;
+}
+
+
+/* Applies the transposition table entry for the current position, narrowing
+   alpha and beta with any stored bound.
+   Returns non-zero if the stored result is enough to give the position's
+   score, which is then stored in score. */
+static int probeScore(unsigned depth, unsigned ply, int* alpha, int* beta,
+    TableEntry const* entry, int* score)
+{
+    int done = 0;
+
+    if (entry->depth >= depth && ply > 0)
+    {
+        *score = fromTableScore(entry->score, ply);
+        if (entry->bound == BOUND_EXACT)
+        {
+            done = 1;
+        }
+        else if (entry->bound == BOUND_LOWER && *score > *alpha)
+        {
+            *alpha = *score;
+        }
+        else if (entry->bound == BOUND_UPPER && *score < *beta)
+        {
+            *beta = *score;
+        }
+        done = done || *alpha >= *beta;
+    }
+
+    return done;
+}
+
+
+/* Stores the result of searching the current position. */
+static void storeScore(Search* search, unsigned depth, unsigned ply,
+    int originalAlpha, int beta, int best, unsigned bestRow,
+    unsigned bestColumn)
+{
+    GameBoard const* const board = &search->board;
+    unsigned const symmetry = canonicalSymmetry(board);
+    TableEntry entry;
+
+    /* Equivalent positions share an entry, with the move stored as it is in
+       the canonical image. */
+    transformCell(board, symmetry, &bestRow, &bestColumn);
+    entry.key = board->symmetryHashes[symmetry];
+    entry.score = toTableScore(best, ply);
+    entry.depth = depth;
+    entry.hasMove = 1;
+    entry.row = bestRow;
+    entry.column = bestColumn;
+    if (best <= originalAlpha)
+    {
+        entry.bound = BOUND_UPPER;
+    }
+    else if (best >= beta)
+    {
+        entry.bound = BOUND_LOWER;
+    }
+    else
+    {
+        entry.bound = BOUND_EXACT;
+    }
+
+    storeTable(&search->table, &entry);
+}
+
+
+/* Negamax search with alpha-beta pruning.
+   Returns the score of the current position for the side to move. At the
+   root (ply 0), also sets the search's best move. lastRow and lastColumn are
+   the previous move, used to detect the game being over. */
+static int negamax(Search* search, unsigned depth, int alpha, int beta,
+    unsigned ply, Bounds bounds, unsigned lastRow, unsigned lastColumn)
+{
+    GameBoard* const board = &search->board;
+    CellStatus const own = playerToCell(nextPlayer(board));
+    int const originalAlpha = alpha;
+    int best = -INFINITE_SCORE;
+    int score = 0;
+    int done = 0;
+    TableEntry entry;
+    unsigned symmetry = 0;
+    int haveEntry = 0;
+    Move* moves = NULL;
+    size_t moveCount = 0;
+    size_t i = 0;
+    unsigned bestRow = 0;
+    unsigned bestColumn = 0;
+
+    ++search->nodes;
+    if (*search->stop || (search->nodes % TIME_CHECK_INTERVAL == 0
+        && monotonicSeconds() >= search->deadline))
+    {
+        search->aborted = 1;
+    }
+
+    if (search->aborted)
+    {
+        /* Result is discarded. */
+        best = 0;
+        done = 1;
+    }
+    else if (ply > 0 && hasPlayerWonAt(board, lastRow, lastColumn))
+    {
+        /* The previous move ended the game. */
+        best = -(WIN_SCORE - (int)ply);
+        done = 1;
+    }
+    else if (board->occupied == search->cells)
+    {
+        best = 0;
+        done = 1;
+    }
+    else if (depth == 0)
+    {
+        best = evaluate(board, bounds);
+        done = 1;
+    }
+
+    if (!done)
+    {
+        symmetry = canonicalSymmetry(board);
+        haveEntry = probeTable(&search->table, board->symmetryHashes[symmetry],
+            &entry);
+        done = haveEntry && probeScore(depth, ply, &alpha, &beta, &entry,
+            &best);
+    }
+
+    if (!done)
+    {
+        moves = generateMoves(board, bounds, &moveCount);
+        if (haveEntry && entry.hasMove)
+        {
+            untransformCell(board, symmetry, &entry.row, &entry.column);
+            promoteMove(moves, moveCount, entry.row, entry.column);
+        }
+
+        for (i = 0; i < moveCount && alpha < beta && !search->aborted; ++i)
+        {
+            makeMove(board, moves[i].row, moves[i].column, own);
+            score = -negamax(search, depth - 1u, -beta, -alpha, ply + 1u,
+                includeCell(bounds, moves[i].row, moves[i].column),
+                moves[i].row, moves[i].column);
+            unmakeMove(board);
+
+            if (score > best)
+            {
+                best = score;
+                bestRow = moves[i].row;
+                bestColumn = moves[i].column;
+            }
+            if (best > alpha)
+            {
+                alpha = best;
+            }
+        }
+
+        free(moves);
+
+        if (!search->aborted)
+        {
+            storeScore(search, depth, ply, originalAlpha, beta, best, bestRow,
+                bestColumn);
+            if (ply == 0)
+            {
+                search->bestRow = bestRow;
+                search->bestColumn = bestColumn;
+            }
+        }
+    }
+
+    return best;
+}
+
+
+
+/* Sets up a thread's search of a board, with its own copy of the board and
+   table. */
+static Search createSearch(GameBoard const* board, TranspositionTable* table,
+    double softDeadline, double deadline, volatile int const* stop)
+{
+    Search search;
+
+    search.cells = (unsigned long)board->rows * board->columns;
+    /* The counts make evaluation O(winRequirement). Larger boards are
+       evaluated by scanning the windows near the occupied cells instead. */
+    if (search.cells <= SEARCH_WINDOW_COUNTS_MAX_CELLS)
+    {
+        search.board = copyGameBoard(board);
+        enableSmallWindowCounts(&search.board);
+    }
+    else
+    {
+        search.board = copyGameBoardWithoutWindowCounts(board);
+    }
+    search.table = *table;
+    search.nodes = 0;
+    search.softDeadline = softDeadline;
+    search.deadline = deadline;
+    search.stop = stop;
+    search.aborted = 0;
+    search.bestRow = 0;
+    search.bestColumn = 0;
+
+    return search;
+}
+
+
+/* Runs iterations of a search from firstDepth until maxDepth, the result is
+   forced, every cell is filled, the soft deadline has passed or the search is
+   aborted. Each completed
+   iteration's best move, score and depth are stored in result. */
+static void iterativeDeepening(Search* search, Bounds bounds,
+    unsigned firstDepth, unsigned maxDepth, SearchResult* result)
+{
+    unsigned long const empty = search->cells - search->board.occupied;
+    unsigned depth = 0;
+    int score = 0;
+    int finished = 0;
+
+    for (depth = firstDepth; depth <= maxDepth && !finished; ++depth)
+    {
+        score = negamax(search, depth, -INFINITE_SCORE, INFINITE_SCORE, 0,
+            bounds, 0, 0);
+        if (search->aborted)
+        {
+            finished = 1;
+        }
+        else
+        {
+            result->row = search->bestRow;
+            result->column = search->bestColumn;
+            result->score = score;
+            result->depth = depth;
+
+            /* Deeper searches can't change a forced result, nor see any
+               further once every cell is filled. */
+            finished = score >= FORCED_SCORE || score <= -FORCED_SCORE
+                || depth >= empty
+                || monotonicSeconds() >= search->softDeadline;
+        }
+    }
+}
+
+
+/* Thread entry point of a Lazy SMP helper. Its results only reach the main
+   thread through the shared table. */
+static void* helperMain(void* arg)
+{
+    Helper* const helper = arg;
+    SearchResult ignored;
+
+    iterativeDeepening(&helper->search, helper->bounds, helper->firstDepth,
+        helper->maxDepth, &ignored);
+
+    return NULL;
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+SearchLimits defaultSearchLimits(void)
+{
+    SearchLimits limits;
+
+    limits.maxDepth = DEFAULT_MAX_DEPTH;
+    limits.softSeconds = DEFAULT_MAX_SECONDS;
+    limits.maxSeconds = DEFAULT_MAX_SECONDS;
+    limits.threads = processorCount();
+    limits.stop = NULL;
+
+    return limits;
+}
+
+
+SearchResult searchBestMove(GameBoard const* board, TranspositionTable* table,
+    SearchLimits limits)
+{
+    SearchResult result;
+    Search search;
+    Helper* helpers = NULL;
+    Bounds bounds;
+    Move* moves = NULL;
+    size_t moveCount = 0;
+    unsigned i = 0;
+    int res = 0;
+    volatile int stop = 0;
+    double const start = monotonicSeconds();
+
+    assert(limits.maxDepth <= MAX_SEARCH_DEPTH);
+    assert(limits.threads > 0);
+
+    newTableSearch(table);
+    /* The helpers stop when the main thread does. */
+    search = createSearch(board, table, start + limits.softSeconds,
+        start + limits.maxSeconds, limits.stop ? limits.stop : &stop);
+
+    bounds.any = getOccupiedBounds(board, &bounds.minRow, &bounds.minColumn,
+        &bounds.maxRow, &bounds.maxColumn);
+
+    result.found = search.cells > board->occupied;
+    result.row = 0;
+    result.column = 0;
+    result.score = 0;
+    result.depth = 0;
+    result.threads = limits.threads;
+
+    if (result.found)
+    {
+        /* Fall back to the best ordered move in case not even the first
+           iteration completes. */
+        moves = generateMoves(board, bounds, &moveCount);
+        assert(moveCount > 0);
+        result.row = moves[0].row;
+        result.column = moves[0].column;
+        free(moves);
+
+        /* Lazy SMP: helpers search the same position, sharing the table, and
+           the odd ones a ply ahead of the others so that they finish
+           iterations at different times and fill in different entries. The
+           main thread's iterations are the result. */
+        helpers = malloc((limits.threads - 1u) * sizeof(Helper));
+        for (i = 0; i + 1u < limits.threads; ++i)
+        {
+            helpers[i].search = createSearch(board, table, search.deadline,
+                search.deadline, &stop);
+            helpers[i].bounds = bounds;
+            helpers[i].firstDepth = 1u + i % 2u;
+            helpers[i].maxDepth = limits.maxDepth;
+            res = pthread_create(&helpers[i].handle, NULL, helperMain,
+                helpers + i);
+            assert(res == 0);
+        }
+
+        iterativeDeepening(&search, bounds, 1, limits.maxDepth, &result);
+
+        stop = 1;
+        for (i = 0; i + 1u < limits.threads; ++i)
+        {
+            res = pthread_join(helpers[i].handle, NULL);
+            assert(res == 0);
+            search.nodes += helpers[i].search.nodes;
+            search.table.probes += helpers[i].search.table.probes;
+            search.table.hits += helpers[i].search.table.hits;
+            destroyGameBoard(&helpers[i].search.board);
+        }
+        (void)res;
+        free(helpers);
+    }
+
+    table->probes = search.table.probes;
+    table->hits = search.table.hits;
+
+    result.nodes = search.nodes;
+    result.ttProbes = table->probes;
+    result.ttHits = table->hits;
+    result.seconds = monotonicSeconds() - start;
+
+    destroyGameBoard(&search.board);
+
+    return result;
+}
+
+
+void printSearchStatistics(SearchResult const* result)
+{
+    double const nodesPerSecond = result->seconds > 0.0
+        ? result->nodes / result->seconds : 0.0;
+    double const hitRate = result->ttProbes > 0
+        ? 100.0 * result->ttHits / result->ttProbes : 0.0;
+
+    printf("Search: depth %u, %lu nodes on %u thread%s in %.2fs "
+        "(%.0f nodes/s), TT hit rate %.1f%%.\n", result->depth, result->nodes,
+        result->threads, result->threads == 1 ? "" : "s", result->seconds,
+        nodesPerSecond, hitRate);
+}
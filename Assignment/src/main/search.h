@@ -0,0 +1,77 @@
+/* Alpha-beta game tree search, used by computer players. */
+
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include "board.h"
+#include "transposition.h"
+
+
+/* Score of a position where the side to move has already won. Wins found
+   deeper in the tree score less, so quicker wins are preferred. */
+#define WIN_SCORE 1000000
+
+/* Scores at least this large in magnitude are forced wins or losses. */
+#define FORCED_SCORE (WIN_SCORE - 1000)
+
+/* Deepest iteration a search can run to. */
+#define MAX_SEARCH_DEPTH 64u
+
+
+/* Limits on how long a search runs. */
+typedef struct
+{
+    unsigned maxDepth;      /* Deepest iteration, at most MAX_SEARCH_DEPTH. */
+    /* Wall-clock time after which no new iteration is started, so the
+       search ends with the best move of the iteration in progress. */
+    double softSeconds;
+    double maxSeconds;      /* Wall-clock time after which the search stops,
+                               even in the middle of an iteration. */
+    unsigned threads;       /* Threads searching, >0. */
+    /* Set to non-zero from another thread to stop the search early, or
+       NULL. */
+    volatile int const* stop;
+} SearchLimits;
+
+
+/* Outcome and statistics of a search. */
+typedef struct
+{
+    int found;              /* Whether a move was found (board not full). */
+    unsigned row;           /* Best move found. */
+    unsigned column;
+    int score;              /* Score of the move for the side to move. */
+    unsigned depth;         /* Deepest iteration that completed. */
+    unsigned long nodes;    /* Positions visited. */
+    unsigned long ttProbes; /* Transposition table lookups. */
+    unsigned long ttHits;   /* Transposition table lookups that found an
+                               entry. */
+    double seconds;         /* Wall-clock time taken. */
+    unsigned threads;       /* Threads used. */
+} SearchResult;
+
+
+/* Returns the limits used for computer players by default, which use one
+   thread per processor and can't be stopped early. */
+SearchLimits defaultSearchLimits(void);
+
+/* Finds the best move for the player whose turn it is, using iterative
+   deepening negamax with alpha-beta pruning.
+   Always returns the best move of the deepest completed iteration. No
+   iteration starts after limits.softSeconds, and if limits.maxSeconds runs
+   out during an iteration that iteration's results are discarded.
+   Candidate moves are empty cells next to an occupied cell, so on huge boards
+   the search stays local to the game in progress.
+   With more than one thread, runs a Lazy SMP search: the other threads search
+   the same position to varied depths at the same time, and share their
+   results through the table, so the calling thread's iterations go faster.
+   board is not modified. table is used to store results between positions
+   and searches. */
+SearchResult searchBestMove(GameBoard const* board, TranspositionTable* table,
+    SearchLimits limits);
+
+/* Prints a summary of a search's statistics to stdout. */
+void printSearchStatistics(SearchResult const* result);
+
+
+#endif
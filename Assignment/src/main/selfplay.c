@@ -0,0 +1,328 @@
+/* Headless games between computer players. */
+
+#include "selfplay.h"
+
+#include "board.h"
+#include "common.h"
+#include "computer.h"
+#include "log.h"
+#include "random.h"
+#include "settings.h"
+#include "threads.h"
+#include "timer.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Games reaching this many moves are stopped and counted as draws. Random
+   players would otherwise take practically forever on huge boards. */
+#define MAX_GAME_MOVES (1ul << 20)
+
+
+/* State private to one thread of a self-play run. */
+typedef struct
+{
+    GameBoard board;
+    ComputerPlayer computers[2];    /* Indexed by Player. */
+    LogShard shard;
+    SelfPlayStats stats;            /* Results of this thread's games. */
+    double finished;                /* Seconds from the start of the run to
+                                       the end of this thread's last game. */
+} Worker;
+
+
+/* State shared by all threads of a self-play run. */
+typedef struct
+{
+    Worker* workers;                /* One per thread. */
+    unsigned long seed;
+    int logGames;
+    double start;                   /* monotonicSeconds() at the start. */
+} SelfPlay;
+
+
+/* Plays one game on an empty board, adding its results to stats, and logging
+   it to shard if it is not NULL. */
+static void playSelfPlayGame(GameBoard* board, ComputerPlayer* computers,
+    SelfPlayStats* stats, LogShard* shard)
+{
+    unsigned long const cells = (unsigned long)board->rows * board->columns;
+    Player player = PLAYER_X;
+    unsigned long placed = 0;
+    unsigned row = 0;
+    unsigned column = 0;
+    int won = 0;
+    int fullWon = 0;
+    int deadDraw = hasWindowCounts(board) && isDeadDraw(board);
+    double start = 0.0;
+
+    while (placed < cells && placed < MAX_GAME_MOVES && !won && !deadDraw)
+    {
+        player = nextPlayer(board);
+        computerPlayerMove(computers + player, board, &row, &column, 0);
+        setBoardCell(board, row, column, playerToCell(player));
+        ++placed;
+        if (shard)
+        {
+            logShardTurn(shard, player, row, column);
+        }
+
+        start = monotonicSeconds();
+        won = hasPlayerWonAt(board, row, column);
+        addLatencySample(&stats->turnChecks, monotonicSeconds() - start);
+
+        /* Every line is blocked on a full board, so a draw is only dead if
+           it ends the game early. */
+        deadDraw = !won && placed < cells && hasWindowCounts(board)
+            && isDeadDraw(board);
+    }
+
+    /* The full scan must agree with the per-turn checks. */
+    start = monotonicSeconds();
+    fullWon = hasPlayerWon(board, player);
+    addLatencySample(&stats->fullChecks, monotonicSeconds() - start);
+    assert(fullWon == won);
+    (void)fullWon;
+
+    ++stats->games;
+    stats->moves += placed;
+    if (won)
+    {
+        ++stats->wins[player];
+    }
+    else
+    {
+        ++stats->draws;
+        if (deadDraw)
+        {
+            ++stats->deadDraws;
+            if (shard)
+            {
+                logShardDeadDraw(shard);
+            }
+        }
+        else
+        {
+            stats->cutShort += placed < cells;
+        }
+    }
+}
+
+
+/* Task function for runWorkStealing() playing the game with the given
+   number. */
+static void playGameTask(unsigned long index, unsigned worker, void* context)
+{
+    SelfPlay* const selfPlay = context;
+    Worker* const own = selfPlay->workers + worker;
+    unsigned long const seed = selfPlay->seed ^ (index * 0x9e3779b97f4a7c15ul);
+
+    clearBoardCells(&own->board);
+    own->computers[PLAYER_X].random = seedRandom(seed * 2u);
+    own->computers[PLAYER_O].random = seedRandom(seed * 2u + 1u);
+
+    if (selfPlay->logGames)
+    {
+        newShardGameLog(&own->shard, index);
+    }
+    playSelfPlayGame(&own->board, own->computers, &own->stats,
+        selfPlay->logGames ? &own->shard : NULL);
+
+    own->finished = monotonicSeconds() - selfPlay->start;
+}
+
+
+/* Adds the results of one thread's games to the totals. */
+static void addWorkerStats(SelfPlayStats* stats, Worker const* worker)
+{
+    stats->games += worker->stats.games;
+    stats->moves += worker->stats.moves;
+    stats->wins[PLAYER_X] += worker->stats.wins[PLAYER_X];
+    stats->wins[PLAYER_O] += worker->stats.wins[PLAYER_O];
+    stats->draws += worker->stats.draws;
+    stats->deadDraws += worker->stats.deadDraws;
+    stats->cutShort += worker->stats.cutShort;
+    mergeLatencySamples(&stats->turnChecks, &worker->stats.turnChecks);
+    mergeLatencySamples(&stats->fullChecks, &worker->stats.fullChecks);
+}
+
+
+/* Prints the work done by each thread. */
+static void printThreadStats(SelfPlayStats const* stats)
+{
+    SelfPlayThreadStats const* thread = NULL;
+    double seconds = 0.0;
+    unsigned i = 0;
+
+    printf("   %6s %10s %12s %10s %12s %7s\n", "thread", "games", "moves",
+        "games/s", "moves/s", "steals");
+    for (i = 0; i < stats->threads; ++i)
+    {
+        thread = stats->threadStats + i;
+        seconds = thread->seconds > 0.0 ? thread->seconds : 1.0;
+        printf("   %6u %10lu %12lu %10.1f %12.0f %7lu\n", i, thread->games,
+            thread->moves, thread->games / seconds, thread->moves / seconds,
+            thread->steals);
+    }
+}
+
+
+/* Prints the percentiles of a collection of samples in microseconds. */
+static void printLatencies(char const* name, LatencySamples* latencies)
+{
+    printf("   %-16s p50 %.3f  p90 %.3f  p99 %.3f  p99.9 %.3f  max %.3f us\n",
+        name, latencyPercentile(latencies, 50.0) * 1e6,
+        latencyPercentile(latencies, 90.0) * 1e6,
+        latencyPercentile(latencies, 99.0) * 1e6,
+        latencyPercentile(latencies, 99.9) * 1e6,
+        latencyPercentile(latencies, 100.0) * 1e6);
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+SelfPlayStats zeroedSelfPlayStats(void)
+{
+    SelfPlayStats stats;
+
+    stats.games = 0;
+    stats.moves = 0;
+    stats.wins[PLAYER_X] = 0;
+    stats.wins[PLAYER_O] = 0;
+    stats.draws = 0;
+    stats.deadDraws = 0;
+    stats.cutShort = 0;
+    stats.seconds = 0.0;
+    stats.turnChecks = zeroedLatencySamples();
+    stats.fullChecks = zeroedLatencySamples();
+    stats.threads = 0;
+    stats.threadStats = NULL;
+
+    return stats;
+}
+
+
+void destroySelfPlayStats(SelfPlayStats* stats)
+{
+    destroyLatencySamples(&stats->turnChecks);
+    destroyLatencySamples(&stats->fullChecks);
+    free(stats->threadStats);
+    *stats = zeroedSelfPlayStats();
+}
+
+
+SelfPlayStats runSelfPlay(Settings const* settings, unsigned long games,
+    unsigned threads, unsigned long seed, int logGames)
+{
+    SelfPlayStats stats = zeroedSelfPlayStats();
+    Settings playerSettings = *settings;
+    SelfPlay selfPlay;
+    LogShard* shards = NULL;
+    unsigned long* steals = malloc(threads * sizeof(unsigned long));
+    Worker* own = NULL;
+    unsigned i = 0;
+
+    assert(threads > 0);
+
+    /* Searches in every game thread would otherwise each use every
+       processor. */
+    if (playerSettings.threads == 0 && threads > 1)
+    {
+        playerSettings.threads = 1;
+    }
+
+    selfPlay.workers = malloc(threads * sizeof(Worker));
+    selfPlay.seed = seed;
+    selfPlay.logGames = logGames;
+    for (i = 0; i < threads; ++i)
+    {
+        own = selfPlay.workers + i;
+        own->board = createGameBoard(settings->n, settings->m, settings->k);
+        if (!settings->strictRules)
+        {
+            enableSmallWindowCounts(&own->board);
+        }
+        own->computers[PLAYER_X] = createComputerPlayer(
+            settings->players[PLAYER_X], &playerSettings, 0);
+        own->computers[PLAYER_O] = createComputerPlayer(
+            settings->players[PLAYER_O], &playerSettings, 0);
+        own->shard = createLogShard();
+        own->stats = zeroedSelfPlayStats();
+        own->finished = 0.0;
+    }
+
+    selfPlay.start = monotonicSeconds();
+    runWorkStealing(games, threads, playGameTask, &selfPlay, steals);
+    stats.seconds = monotonicSeconds() - selfPlay.start;
+
+    stats.threads = threads;
+    stats.threadStats = malloc(threads * sizeof(SelfPlayThreadStats));
+    shards = malloc(threads * sizeof(LogShard));
+    for (i = 0; i < threads; ++i)
+    {
+        own = selfPlay.workers + i;
+        addWorkerStats(&stats, own);
+        stats.threadStats[i].games = own->stats.games;
+        stats.threadStats[i].moves = own->stats.moves;
+        stats.threadStats[i].steals = steals[i];
+        stats.threadStats[i].seconds = own->finished;
+        shards[i] = own->shard;
+    }
+
+    mergeLogShards(shards, threads);
+
+    for (i = 0; i < threads; ++i)
+    {
+        own = selfPlay.workers + i;
+        destroyComputerPlayer(own->computers + PLAYER_X);
+        destroyComputerPlayer(own->computers + PLAYER_O);
+        destroyGameBoard(&own->board);
+        destroyLogShard(shards + i);
+        destroySelfPlayStats(&own->stats);
+    }
+
+    free(shards);
+    free(selfPlay.workers);
+    free(steals);
+
+    return stats;
+}
+
+
+void printSelfPlayStats(SelfPlayStats* stats)
+{
+    double const games = stats->games > 0 ? (double)stats->games : 1.0;
+    double const seconds = stats->seconds > 0.0 ? stats->seconds : 1.0;
+
+    printf("Self-play: %lu games, %lu moves in %.3fs on %u threads.\n",
+        stats->games, stats->moves, stats->seconds, stats->threads);
+    printf("   Aggregate throughput: %.1f games/s, %.0f moves/s.\n",
+        stats->games / seconds, stats->moves / seconds);
+    printf("   Results: X won %lu (%.1f%%), O won %lu (%.1f%%), "
+        "drawn %lu (%.1f%%).\n", stats->wins[PLAYER_X],
+        100.0 * stats->wins[PLAYER_X] / games, stats->wins[PLAYER_O],
+        100.0 * stats->wins[PLAYER_O] / games, stats->draws,
+        100.0 * stats->draws / games);
+    if (stats->deadDraws > 0)
+    {
+        printf("   %lu drawn games were ended early, when neither player could "
+            "complete a line.\n", stats->deadDraws);
+    }
+    if (stats->cutShort > 0)
+    {
+        printf("   %lu drawn games were stopped at the %lu move limit.\n",
+            stats->cutShort, MAX_GAME_MOVES);
+    }
+    printThreadStats(stats);
+    printf("   Win check latency:\n");
+    printLatencies("hasPlayerWonAt()", &stats->turnChecks);
+    printLatencies("hasPlayerWon()", &stats->fullChecks);
+}
@@ -0,0 +1,74 @@
+/* Headless games between computer players, for stress testing the engines and
+   measuring their throughput. */
+
+#ifndef SELFPLAY_H
+#define SELFPLAY_H
+
+#include "settings.h"
+#include "timer.h"
+
+
+/* Work done by one thread during self-play. */
+typedef struct
+{
+    unsigned long games;        /* Games played. */
+    unsigned long moves;        /* Moves played, over all games. */
+    unsigned long steals;       /* Times games were stolen from another
+                                   thread. */
+    double seconds;             /* Wall-clock time until the thread finished
+                                   its last game. */
+} SelfPlayThreadStats;
+
+
+/* Results and timings of a run of self-play games.
+   Use zeroedSelfPlayStats to properly create it, and destroySelfPlayStats to
+   properly destroy it. */
+typedef struct
+{
+    unsigned long games;        /* Games played. */
+    unsigned long moves;        /* Moves played, over all games. */
+    unsigned long wins[2];      /* Games won by each player, indexed by
+                                   Player. */
+    unsigned long draws;        /* Games drawn, including those ended early
+                                   or cut short. */
+    unsigned long deadDraws;    /* Games ended early as neither player could
+                                   complete a line any more. */
+    unsigned long cutShort;     /* Games stopped at the move limit. */
+    double seconds;             /* Wall-clock time taken. */
+    LatencySamples turnChecks;  /* Durations of the hasPlayerWonAt() check
+                                   after each move. */
+    LatencySamples fullChecks;  /* Durations of the hasPlayerWon() check of
+                                   each final position. */
+    unsigned threads;           /* Threads games were played on. */
+    SelfPlayThreadStats* threadStats;   /* Work done by each thread. */
+} SelfPlayStats;
+
+
+/* Returns a SelfPlayStats object with all members zeroed out. */
+SelfPlayStats zeroedSelfPlayStats(void);
+
+/* Destroys self-play statistics (deallocates resources, etc.). */
+void destroySelfPlayStats(SelfPlayStats* stats);
+
+/* Plays the given number of games between settings->players, using the board
+   dimensions in settings. Neither player may be PLAYER_TYPE_HUMAN.
+   Games are spread over the given number of threads by a work-stealing
+   scheduler. Each thread has its own board and players, so nothing is shared
+   between games. Unless settings->threads is set, Monte Carlo tree search
+   players use a single thread each when more than one game thread is used.
+   Each game's random choices are seeded from seed and the game's number, so
+   don't depend on which thread plays it.
+   If logGames is non-zero, each thread logs its games to its own log shard, and
+   the shards are merged into the main game logs in game order at the end.
+   Unless settings->strictRules is set, games on boards small enough for window
+   counts end as soon as neither player can complete a line.
+   Nothing is displayed while games are played. */
+SelfPlayStats runSelfPlay(Settings const* settings, unsigned long games,
+    unsigned threads, unsigned long seed, int logGames);
+
+/* Prints a summary of self-play results and throughput, overall and per
+   thread, to stdout. The samples in stats are sorted. */
+void printSelfPlayStats(SelfPlayStats* stats);
+
+
+#endif
@@ -14,6 +14,11 @@
    assumed to be invalid format. */
 #define LINE_LEN_MAX 1024
 
+/* Number of options in a settings file, and how many of them, from the
+   start of the list in readSettings(), must be given. */
+#define OPTION_COUNT 5u
+#define REQUIRED_OPTION_COUNT 3u
+
 
 /* PRIVATE INTERFACE */
 
@@ -153,6 +158,16 @@ Settings zeroedSettings(void)
     settings.n = 0;
     settings.m = 0;
     settings.k = 0;
+    settings.gameSeconds = 0;
+    settings.incrementSeconds = 0;
+    settings.players[PLAYER_X] = PLAYER_TYPE_HUMAN;
+    settings.players[PLAYER_O] = PLAYER_TYPE_HUMAN;
+    settings.threads = 0;
+    settings.strictRules = 0;
+    settings.ansiRedraw = 0;
+    settings.solved = NULL;
+    settings.book = NULL;
+    settings.logFormat = LOG_FORMAT_TEXT;
 
     return settings;
 }
@@ -167,7 +182,9 @@ Settings readSettings(char const* filePath, int* error)
         /* Note: other members automatically init to 0. */
         {'M'},
         {'N'},
-        {'K'}
+        {'K'},
+        {'T'},
+        {'I'}
     };
     unsigned i = 0;
 
@@ -178,7 +195,8 @@ Settings readSettings(char const* filePath, int* error)
            user all the errors. */
         while (!feof(file) && !ferror(file))
         {
-            readSettingsLine(file, options, 3, &lineCount, error);
+            readSettingsLine(file, options, OPTION_COUNT, &lineCount,
+                error);
         }
 
         if (ferror(file))
@@ -189,7 +207,7 @@ Settings readSettings(char const* filePath, int* error)
         }
         else
         {
-            for (i = 0; i < 3; ++i)
+            for (i = 0; i < REQUIRED_OPTION_COUNT; ++i)
             {
                 if (!options[i].beenRead)
                 {
@@ -209,6 +227,8 @@ Settings readSettings(char const* filePath, int* error)
             settings.m = options[0].value;
             settings.n = options[1].value;
             settings.k = options[2].value;
+            settings.gameSeconds = options[3].value;
+            settings.incrementSeconds = options[4].value;
         }
     }
     else
@@ -269,6 +289,20 @@ int validateKSetting(unsigned k, int warnings)
 }
 
 
+int validateTimeSettings(unsigned gameSeconds, unsigned incrementSeconds)
+{
+    int result = 1;
+
+    if (gameSeconds == 0 && incrementSeconds > 0)
+    {
+        fprintf(stderr, "Invalid setting: I needs a game time T.\n");
+        result = 0;
+    }
+
+    return result;
+}
+
+
 int validateSettingsCombo(Settings const* settings, int warnings)
 {
     int result = 1;
@@ -299,16 +333,79 @@ int validateSettings(Settings const* settings, int warnings)
     result &= validateNSetting(n);
     /* Don't show warnings if settings are already invalid. */
     result &= validateKSetting(k, result);
+    result &= validateTimeSettings(settings->gameSeconds,
+        settings->incrementSeconds);
     result &= validateSettingsCombo(settings, result);
 
     return result;
 }
 
 
+int parsePlayerType(char const* name, PlayerType* type)
+{
+    int valid = 1;
+
+    if (strcmp(name, "alphabeta") == 0)
+    {
+        *type = PLAYER_TYPE_ALPHA_BETA;
+    }
+    else if (strcmp(name, "mcts") == 0)
+    {
+        *type = PLAYER_TYPE_MCTS;
+    }
+    else if (strcmp(name, "random") == 0)
+    {
+        *type = PLAYER_TYPE_RANDOM;
+    }
+    else
+    {
+        fprintf(stderr, "Error: unknown player type \"%s\" (expected "
+            "alphabeta, mcts or random).\n", name);
+        valid = 0;
+    }
+
+    return valid;
+}
+
+
+int parseLogFormat(char const* name, LogFormat* format)
+{
+    int valid = 1;
+
+    if (strcmp(name, "text") == 0)
+    {
+        *format = LOG_FORMAT_TEXT;
+    }
+    else if (strcmp(name, "binary") == 0)
+    {
+        *format = LOG_FORMAT_BINARY;
+    }
+    else if (strcmp(name, "delta") == 0)
+    {
+        *format = LOG_FORMAT_DELTA;
+    }
+    else
+    {
+        fprintf(stderr, "Error: unknown log format \"%s\" (expected text, "
+            "binary or delta).\n", name);
+        valid = 0;
+    }
+
+    return valid;
+}
+
+
 void writeSettings(FILE* stream, Settings const* settings)
 {
     fprintf(stream, "SETTINGS:\n");
     fprintf(stream, "   M: %u\n", settings->m);
     fprintf(stream, "   N: %u\n", settings->n);
     fprintf(stream, "   K: %u\n", settings->k);
+    /* Settings without a time control are written as they always were. */
+    if (settings->gameSeconds > 0)
+    {
+        fprintf(stream, "   T: %u\n", settings->gameSeconds);
+        fprintf(stream, "   I: %u\n", settings->incrementSeconds);
+    }
 }
+
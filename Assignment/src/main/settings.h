@@ -6,12 +6,68 @@
 #include <stdio.h>
 
 
+/* Defined in book.h and solved_db.h, which only users of them include. */
+struct OpeningBook;
+struct SolvedDatabase;
+
+
+/* Identifies who or what chooses a player's moves. */
+typedef enum
+{
+    PLAYER_TYPE_HUMAN,          /* Moves are entered by the user. */
+    PLAYER_TYPE_ALPHA_BETA,     /* Moves are chosen by alpha-beta search. */
+    PLAYER_TYPE_MCTS,           /* Moves are chosen by Monte Carlo tree
+                                   search. */
+    PLAYER_TYPE_RANDOM          /* Moves are chosen at random. */
+} PlayerType;
+
+
+/* Formats game logs can be saved in. */
+typedef enum
+{
+    LOG_FORMAT_TEXT,        /* Readable text, as written by writeSettings()
+                               and writeGameLogs(). */
+    LOG_FORMAT_BINARY,      /* Varints of the cell index of each move. */
+    LOG_FORMAT_DELTA        /* Varints of the difference between the cell
+                               index of each move and the one before. */
+} LogFormat;
+
+
 /* Stores the program/game settings. */
 typedef struct
 {
     unsigned m;         /* Width of the board (number of columns). */
     unsigned n;         /* Height of the board (number of rows). */
     unsigned k;         /* Number of consecutive cells to win. */
+    /* Seconds on each player's clock for the whole game ('T'), or 0 to give
+       computer players a fixed time per move and human players unlimited
+       time. Optional in the settings file. */
+    unsigned gameSeconds;
+    /* Seconds added to a player's clock after each of their moves ('I').
+       Optional in the settings file. */
+    unsigned incrementSeconds;
+    /* Who plays each side, indexed by Player. Not read from the settings
+       file. */
+    PlayerType players[2];
+    /* Threads used by each alpha-beta and Monte Carlo tree search player, or 0
+       for one per processor. Not read from the settings file. */
+    unsigned threads;
+    /* Non-zero to play drawn games on until the board is full, rather than
+       ending them once neither player can complete a line. Not read from the
+       settings file. */
+    int strictRules;
+    /* Non-zero to draw the board once per game and then only redraw the
+       cells that change, using ANSI escape codes, when stdout is a terminal.
+       Not read from the settings file. */
+    int ansiRedraw;
+    /* Solved-position database used by computer players and for hints when
+       it matches the board, or NULL. Not read from the settings file. */
+    struct SolvedDatabase const* solved;
+    /* Opening book used by computer players when it matches the board, or
+       NULL. Not read from the settings file. */
+    struct OpeningBook const* book;
+    /* Format game logs are saved in. Not read from the settings file. */
+    LogFormat logFormat;
 } Settings;
 
 
@@ -42,6 +98,11 @@ int validateNSetting(unsigned n);
    If it's valid, returns 1. */
 int validateKSetting(unsigned k, int warnings);
 
+/* Validates the given time control settings, 'T' and 'I'.
+   If they're invalid, prints an error to stderr and returns 0.
+   If they're valid, returns 1. */
+int validateTimeSettings(unsigned gameSeconds, unsigned incrementSeconds);
+
 /* Validates the given combination of settings.
    The individual settings's values are assumed to be valid.
    If warnings is non-zero, additional warning messages will be printed to
@@ -57,6 +118,18 @@ int validateSettingsCombo(Settings const* settings, int warnings);
    If all settings are valid, returns 1. */
 int validateSettings(Settings const* settings, int warnings);
 
+/* Parses the command line name of a computer player type: "alphabeta",
+   "mcts" or "random".
+   If the name is valid, sets type and returns 1, otherwise prints an error to
+   stderr and returns 0. */
+int parsePlayerType(char const* name, PlayerType* type);
+
+/* Parses the command line name of a game log format: "text", "binary" or
+   "delta".
+   If the name is valid, sets format and returns 1, otherwise prints an error
+   to stderr and returns 0. */
+int parseLogFormat(char const* name, LogFormat* format);
+
 /* Writes the given settings in textual form to the given stream. */
 void writeSettings(FILE* stream, Settings const* settings);
 
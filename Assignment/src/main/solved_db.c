@@ -0,0 +1,703 @@
+/* Solved-position database for small boards. */
+
+/* mmap() and the file descriptor functions are POSIX, not ANSI C. */
+#define _POSIX_C_SOURCE 200112L
+
+#include "solved_db.h"
+
+#include "board.h"
+#include "common.h"
+
+#include <assert.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Identifies database files, and their format version. */
+static char const FILE_MAGIC[8] = {'M', 'N', 'K', 'S', 'O', 'L', 'V', '1'};
+
+/* Bytes in a database file before the packed values: the magic, the rows,
+   columns, win requirement and entry bits as 4 byte little-endian integers,
+   and the number of positions as an 8 byte little-endian integer. */
+#define FILE_HEADER_SIZE 32u
+
+
+/* Gets the number of bits needed to hold values up to max. */
+static unsigned bitsFor(unsigned max)
+{
+    unsigned bits = 0;
+
+    while (max > 0)
+    {
+        ++bits;
+        max >>= 1;
+    }
+
+    return bits;
+}
+
+
+/* Gets C(n, r). n and r must be at most the board's cell count. */
+static unsigned long binomial(SolvedDatabase const* database, unsigned n,
+    unsigned r)
+{
+    unsigned const cells = database->rows * database->columns;
+
+    return database->binomials[n * (cells + 1u) + r];
+}
+
+
+/* Gets the number of X and O cells after a number of moves. */
+static void layerCounts(unsigned occupied, unsigned* xCount, unsigned* oCount)
+{
+    *xCount = (occupied + 1u) / 2u;
+    *oCount = occupied / 2u;
+}
+
+
+/* Gets the number of bytes of packed values, including a byte of padding so
+   every value can be read as two bytes. Divides first so huge databases
+   can't overflow. */
+static size_t packedSize(unsigned long positions, unsigned entryBits)
+{
+    return (size_t)(positions / 8u) * entryBits
+        + ((positions % 8u) * entryBits + 7u) / 8u + 1u;
+}
+
+
+/* Gets the byte and bit offset of a packed value. */
+static void entryOffset(unsigned long rank, unsigned entryBits, size_t* byte,
+    unsigned* shift)
+{
+    *byte = (size_t)(rank / 8u) * entryBits
+        + (rank % 8u) * entryBits / 8u;
+    *shift = (rank % 8u) * entryBits % 8u;
+}
+
+
+/* Reads the packed value of a position. */
+static SolvedValue getEntry(SolvedDatabase const* database,
+    unsigned long rank)
+{
+    SolvedValue value;
+    size_t byte = 0;
+    unsigned shift = 0;
+    unsigned entry = 0;
+
+    entryOffset(rank, database->entryBits, &byte, &shift);
+    entry = (database->entries[byte]
+        | (unsigned)database->entries[byte + 1u] << 8) >> shift;
+    entry &= (1u << database->entryBits) - 1u;
+
+    value.outcome = (SolvedOutcome)(entry & 3u);
+    value.distance = entry >> 2;
+
+    return value;
+}
+
+
+/* Writes the packed value of a position, which must not have been written
+   before. */
+static void setEntry(SolvedDatabase* database, unsigned long rank,
+    SolvedValue value)
+{
+    size_t byte = 0;
+    unsigned shift = 0;
+    unsigned entry = 0;
+
+    assert(value.distance < 1u << (database->entryBits - 2u));
+
+    entryOffset(rank, database->entryBits, &byte, &shift);
+    entry = ((unsigned)value.outcome | value.distance << 2) << shift;
+    database->ownedEntries[byte] |= entry & 0xffu;
+    database->ownedEntries[byte + 1u] |= entry >> 8;
+}
+
+
+/* Sets up the ranking tables of an empty database for the given board.
+   Returns a zeroed database if the board is too big. */
+static SolvedDatabase createIndex(unsigned rows, unsigned columns,
+    unsigned winRequirement)
+{
+    SolvedDatabase database = zeroedSolvedDatabase();
+    unsigned cells = 0;
+    unsigned n = 0;
+    unsigned r = 0;
+    unsigned xCount = 0;
+    unsigned oCount = 0;
+
+    if (rows > 0 && columns > 0 && winRequirement > 0
+        && rows <= SOLVED_DB_MAX_CELLS / columns)
+    {
+        cells = rows * columns;
+        database.rows = rows;
+        database.columns = columns;
+        database.winRequirement = winRequirement;
+        database.entryBits = 2u + bitsFor(cells);
+
+        database.binomials = malloc((cells + 1u) * (cells + 1u)
+            * sizeof(unsigned long));
+        for (n = 0; n <= cells; ++n)
+        {
+            for (r = 0; r <= cells; ++r)
+            {
+                database.binomials[n * (cells + 1u) + r] = r == 0 ? 1
+                    : n == 0 ? 0
+                    : binomial(&database, n - 1u, r - 1u)
+                        + binomial(&database, n - 1u, r);
+            }
+        }
+
+        /* Each layer holds every way to place its X cells, then its O cells
+           among the rest. */
+        database.layerOffsets = malloc((cells + 2u) * sizeof(unsigned long));
+        database.layerOffsets[0] = 0;
+        for (n = 0; n <= cells; ++n)
+        {
+            layerCounts(n, &xCount, &oCount);
+            database.layerOffsets[n + 1u] = database.layerOffsets[n]
+                + binomial(&database, cells, xCount)
+                * binomial(&database, cells - xCount, oCount);
+        }
+        database.positions = database.layerOffsets[cells + 1u];
+    }
+
+    return database;
+}
+
+
+/* Gets the rank of a position given as row-major cell statuses.
+   Sets occupied to the number of occupied cells, and returns 0 if X and O
+   have numbers of cells that can't arise in a game. */
+static int rankCells(SolvedDatabase const* database,
+    CellStatus const* statuses, unsigned* occupied, unsigned long* rank)
+{
+    unsigned const cells = database->rows * database->columns;
+    unsigned long xRank = 0;
+    unsigned long oRank = 0;
+    unsigned xCount = 0;
+    unsigned oCount = 0;
+    unsigned nonX = 0;
+    unsigned i = 0;
+    int valid = 0;
+
+    /* Colexicographic ranks of the X cells among all cells, and of the O
+       cells among the cells without an X. */
+    for (i = 0; i < cells; ++i)
+    {
+        if (statuses[i] == CELL_X)
+        {
+            ++xCount;
+            xRank += binomial(database, i, xCount);
+        }
+        else
+        {
+            if (statuses[i] == CELL_O)
+            {
+                ++oCount;
+                oRank += binomial(database, nonX, oCount);
+            }
+            ++nonX;
+        }
+    }
+
+    *occupied = xCount + oCount;
+    valid = xCount == oCount || xCount == oCount + 1u;
+    if (valid)
+    {
+        *rank = database->layerOffsets[*occupied]
+            + xRank * binomial(database, cells - xCount, oCount) + oRank;
+    }
+
+    return valid;
+}
+
+
+/* Sets row-major cell statuses to the position with the given rank within
+   the layer with the given number of occupied cells. */
+static void unrankCells(SolvedDatabase const* database, unsigned occupied,
+    unsigned long index, CellStatus* statuses)
+{
+    unsigned const cells = database->rows * database->columns;
+    unsigned xCount = 0;
+    unsigned oCount = 0;
+    unsigned long oPlacements = 0;
+    unsigned long rank = 0;
+    unsigned nonX = 0;
+    unsigned i = 0;
+
+    layerCounts(occupied, &xCount, &oCount);
+    oPlacements = binomial(database, cells - xCount, oCount);
+
+    for (i = 0; i < cells; ++i)
+    {
+        statuses[i] = CELL_EMPTY;
+    }
+
+    /* The largest cell with a binomial not above the remaining rank is the
+       last one chosen, and so on down. */
+    rank = index / oPlacements;
+    for (i = cells; i > 0 && xCount > 0; --i)
+    {
+        if (binomial(database, i - 1u, xCount) <= rank)
+        {
+            rank -= binomial(database, i - 1u, xCount);
+            statuses[i - 1u] = CELL_X;
+            --xCount;
+        }
+    }
+
+    rank = index % oPlacements;
+    nonX = cells - (occupied + 1u) / 2u;
+    for (i = cells; i > 0 && oCount > 0; --i)
+    {
+        if (statuses[i - 1u] != CELL_X)
+        {
+            --nonX;
+            if (binomial(database, nonX, oCount) <= rank)
+            {
+                rank -= binomial(database, nonX, oCount);
+                statuses[i - 1u] = CELL_O;
+                --oCount;
+            }
+        }
+    }
+}
+
+
+/* Gets the value of a position given as row-major cell statuses. */
+static SolvedValue lookupCells(SolvedDatabase const* database,
+    CellStatus const* statuses)
+{
+    SolvedValue value;
+    unsigned long rank = 0;
+    unsigned occupied = 0;
+
+    value.outcome = SOLVED_UNKNOWN;
+    value.distance = 0;
+
+    if (rankCells(database, statuses, &occupied, &rank))
+    {
+        value = getEntry(database, rank);
+    }
+
+    return value;
+}
+
+
+/* Checks if a value is better for the player to move than another. */
+static int betterValue(SolvedValue value, SolvedValue other)
+{
+    int better = 0;
+
+    if (value.outcome != other.outcome)
+    {
+        /* SolvedOutcome is ordered from worst to best. */
+        better = value.outcome > other.outcome;
+    }
+    else if (value.outcome == SOLVED_WIN)
+    {
+        better = value.distance < other.distance;
+    }
+    else if (value.outcome == SOLVED_LOSS)
+    {
+        better = value.distance > other.distance;
+    }
+
+    return better;
+}
+
+
+/* Finds the best move from a position that isn't over, by looking up the
+   positions after each move. statuses holds the position, and is restored
+   before returning. Sets bestCell to the row-major index of the move, and
+   returns the value of the position. */
+static SolvedValue bestChildValue(SolvedDatabase const* database,
+    CellStatus* statuses, unsigned occupied, unsigned* bestCell)
+{
+    unsigned const cells = database->rows * database->columns;
+    CellStatus const mover = occupied % 2u == 0 ? CELL_X : CELL_O;
+    SolvedValue best;
+    SolvedValue child;
+    SolvedValue value;
+    unsigned i = 0;
+
+    best.outcome = SOLVED_UNKNOWN;
+    best.distance = 0;
+
+    for (i = 0; i < cells; ++i)
+    {
+        if (statuses[i] == CELL_EMPTY)
+        {
+            statuses[i] = mover;
+            child = lookupCells(database, statuses);
+            statuses[i] = CELL_EMPTY;
+
+            /* The child's value is for the opponent. */
+            value.distance = child.distance + 1u;
+            switch (child.outcome)
+            {
+                case SOLVED_LOSS:
+                    value.outcome = SOLVED_WIN;
+                    break;
+                case SOLVED_WIN:
+                    value.outcome = SOLVED_LOSS;
+                    break;
+                default:
+                    value.outcome = child.outcome;
+            }
+
+            if (best.outcome == SOLVED_UNKNOWN || betterValue(value, best))
+            {
+                best = value;
+                *bestCell = i;
+            }
+        }
+    }
+
+    return best;
+}
+
+
+/* Updates a board to hold the given row-major cell statuses, setting only
+   the cells that differ. */
+static void syncBoard(GameBoard* board, CellStatus const* statuses)
+{
+    unsigned row = 0;
+    unsigned column = 0;
+    CellStatus const* status = statuses;
+
+    for (row = 0; row < board->rows; ++row)
+    {
+        for (column = 0; column < board->columns; ++column)
+        {
+            if (getBoardCell(board, row, column) != *status)
+            {
+                setBoardCell(board, row, column, *status);
+            }
+            ++status;
+        }
+    }
+}
+
+
+/* Gets the row-major cell statuses of a board. */
+static void boardCells(GameBoard const* board, CellStatus* statuses)
+{
+    unsigned row = 0;
+    unsigned column = 0;
+
+    for (row = 0; row < board->rows; ++row)
+    {
+        for (column = 0; column < board->columns; ++column)
+        {
+            *statuses = getBoardCell(board, row, column);
+            ++statuses;
+        }
+    }
+}
+
+
+/* Works out the value of a position from the values of the positions after
+   each move, which must already be in the database. board and statuses
+   both hold the position. */
+static SolvedValue solvePosition(SolvedDatabase const* database,
+    GameBoard const* board, CellStatus* statuses, unsigned occupied)
+{
+    Player const mover = occupied % 2u == 0 ? PLAYER_X : PLAYER_O;
+    SolvedValue value;
+    unsigned bestCell = 0;
+
+    value.outcome = SOLVED_UNKNOWN;
+    value.distance = 0;
+
+    if (occupied > 0 && hasPlayerWon(board, otherPlayer(mover)))
+    {
+        value.outcome = SOLVED_LOSS;
+    }
+    else if (hasPlayerWon(board, mover))
+    {
+        /* The game would have ended before the other player's move. */
+        value.outcome = SOLVED_UNKNOWN;
+    }
+    else if (occupied == board->rows * board->columns)
+    {
+        value.outcome = SOLVED_DRAW;
+    }
+    else
+    {
+        value = bestChildValue(database, statuses, occupied, &bestCell);
+    }
+
+    return value;
+}
+
+
+/* Checks a mapped database file's header and size, and sets up a database
+   for it. Returns a zeroed database if the file isn't valid. */
+static SolvedDatabase readHeader(unsigned char const* data, size_t size)
+{
+    SolvedDatabase database = zeroedSolvedDatabase();
+    unsigned long rows = 0;
+    unsigned long columns = 0;
+    unsigned long winRequirement = 0;
+
+    if (size >= FILE_HEADER_SIZE
+        && memcmp(data, FILE_MAGIC, sizeof FILE_MAGIC) == 0)
+    {
+        rows = readLittleEndian(data + 8, 4);
+        columns = readLittleEndian(data + 12, 4);
+        winRequirement = readLittleEndian(data + 16, 4);
+        if (rows <= SOLVED_DB_MAX_CELLS && columns <= SOLVED_DB_MAX_CELLS
+            && winRequirement <= SOLVED_DB_MAX_CELLS)
+        {
+            database = createIndex(rows, columns, winRequirement);
+        }
+    }
+
+    if (database.binomials
+        && (readLittleEndian(data + 20, 4) != database.entryBits
+            || readLittleEndian(data + 24, 8) != database.positions
+            || size - FILE_HEADER_SIZE
+                != packedSize(database.positions, database.entryBits)))
+    {
+        destroySolvedDatabase(&database);
+    }
+
+    return database;
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+SolvedDatabase zeroedSolvedDatabase(void)
+{
+    SolvedDatabase database;
+
+    database.rows = 0;
+    database.columns = 0;
+    database.winRequirement = 0;
+    database.entryBits = 0;
+    database.positions = 0;
+    database.binomials = NULL;
+    database.layerOffsets = NULL;
+    database.entries = NULL;
+    database.ownedEntries = NULL;
+    database.mapping = NULL;
+    database.mappingSize = 0;
+
+    return database;
+}
+
+
+SolvedDatabase solveDatabase(unsigned rows, unsigned columns,
+    unsigned winRequirement, int verbose)
+{
+    SolvedDatabase database = createIndex(rows, columns, winRequirement);
+    unsigned const cells = rows * columns;
+    GameBoard board = createGameBoard(rows, columns, winRequirement);
+    CellStatus statuses[SOLVED_DB_MAX_CELLS];
+    unsigned long index = 0;
+    unsigned long layerSize = 0;
+    unsigned occupied = 0;
+
+    assert(database.binomials);
+
+    database.ownedEntries = calloc(packedSize(database.positions,
+        database.entryBits), 1);
+    database.entries = database.ownedEntries;
+    enableWindowCounts(&board);
+
+    /* Every move fills a cell, so positions only depend on those with more
+       cells occupied. */
+    for (occupied = cells + 1u; occupied > 0; --occupied)
+    {
+        layerSize = database.layerOffsets[occupied]
+            - database.layerOffsets[occupied - 1u];
+        for (index = 0; index < layerSize; ++index)
+        {
+            unrankCells(&database, occupied - 1u, index, statuses);
+            syncBoard(&board, statuses);
+            setEntry(&database, database.layerOffsets[occupied - 1u] + index,
+                solvePosition(&database, &board, statuses, occupied - 1u));
+        }
+
+        if (verbose)
+        {
+            printf("Solved positions with %u cells occupied: %lu.\n",
+                occupied - 1u, layerSize);
+        }
+    }
+
+    destroyGameBoard(&board);
+
+    return database;
+}
+
+
+void writeSolvedDatabase(FILE* stream, SolvedDatabase const* database)
+{
+    fwrite(FILE_MAGIC, 1, sizeof FILE_MAGIC, stream);
+    writeLittleEndian(stream, database->rows, 4);
+    writeLittleEndian(stream, database->columns, 4);
+    writeLittleEndian(stream, database->winRequirement, 4);
+    writeLittleEndian(stream, database->entryBits, 4);
+    writeLittleEndian(stream, database->positions, 8);
+    fwrite(database->entries, 1,
+        packedSize(database->positions, database->entryBits), stream);
+}
+
+
+SolvedDatabase openSolvedDatabase(char const* filePath, int* error)
+{
+    SolvedDatabase database = zeroedSolvedDatabase();
+    struct stat status;
+    void* mapping = MAP_FAILED;
+    int file = open(filePath, O_RDONLY);
+
+    if (file < 0 || fstat(file, &status) != 0 || status.st_size == 0)
+    {
+        fprintf(stderr, "Error: could not open solved database \"%s\".\n",
+            filePath);
+        *error = 1;
+    }
+    else
+    {
+        mapping = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_SHARED,
+            file, 0);
+        if (mapping == MAP_FAILED)
+        {
+            fprintf(stderr, "Error: could not map solved database \"%s\".\n",
+                filePath);
+            *error = 1;
+        }
+    }
+
+    if (mapping != MAP_FAILED)
+    {
+        database = readHeader(mapping, (size_t)status.st_size);
+        if (database.binomials)
+        {
+            database.mapping = mapping;
+            database.mappingSize = (size_t)status.st_size;
+            database.entries = (unsigned char const*)mapping
+                + FILE_HEADER_SIZE;
+        }
+        else
+        {
+            fprintf(stderr, "Error: \"%s\" is not a valid solved database.\n",
+                filePath);
+            *error = 1;
+            munmap(mapping, (size_t)status.st_size);
+        }
+    }
+
+    /* The mapping stays valid after the file is closed. */
+    if (file >= 0)
+    {
+        close(file);
+    }
+
+    return database;
+}
+
+
+void destroySolvedDatabase(SolvedDatabase* database)
+{
+    if (database->mapping)
+    {
+        munmap(database->mapping, database->mappingSize);
+    }
+    free(database->ownedEntries);
+    free(database->binomials);
+    free(database->layerOffsets);
+    *database = zeroedSolvedDatabase();
+}
+
+
+int solvedDatabaseMatches(SolvedDatabase const* database,
+    GameBoard const* board)
+{
+    return database->entries && database->rows == board->rows
+        && database->columns == board->columns
+        && database->winRequirement == board->winRequirement;
+}
+
+
+SolvedValue lookupSolvedPosition(SolvedDatabase const* database,
+    GameBoard const* board)
+{
+    CellStatus statuses[SOLVED_DB_MAX_CELLS];
+
+    assert(solvedDatabaseMatches(database, board));
+
+    boardCells(board, statuses);
+
+    return lookupCells(database, statuses);
+}
+
+
+int solvedBestMove(SolvedDatabase const* database, GameBoard const* board,
+    unsigned* row, unsigned* column, SolvedValue* value)
+{
+    CellStatus statuses[SOLVED_DB_MAX_CELLS];
+    SolvedValue current;
+    unsigned bestCell = 0;
+    int found = 0;
+
+    assert(solvedDatabaseMatches(database, board));
+
+    boardCells(board, statuses);
+    current = lookupCells(database, statuses);
+
+    /* Every position that isn't over has at least one move left. */
+    found = current.outcome != SOLVED_UNKNOWN && current.distance > 0;
+    if (found)
+    {
+        *value = bestChildValue(database, statuses, board->occupied,
+            &bestCell);
+        *row = bestCell / board->columns;
+        *column = bestCell % board->columns;
+    }
+
+    return found;
+}
+
+
+void writeSolvedValue(FILE* stream, SolvedValue value)
+{
+    switch (value.outcome)
+    {
+        case SOLVED_WIN:
+            fprintf(stream, "win in %u move%s", value.distance,
+                value.distance == 1 ? "" : "s");
+            break;
+        case SOLVED_LOSS:
+            if (value.distance == 0)
+            {
+                fprintf(stream, "lost");
+            }
+            else
+            {
+                fprintf(stream, "loss in %u move%s", value.distance,
+                    value.distance == 1 ? "" : "s");
+            }
+            break;
+        case SOLVED_DRAW:
+            fprintf(stream, "draw");
+            break;
+        default:
+            fprintf(stream, "unknown");
+    }
+}
@@ -0,0 +1,111 @@
+/* Solved-position database for small boards.
+   Holds the game-theoretic value of every position that can arise from an
+   empty board with X moving first, indexed by a perfect ranking of the
+   positions. Values are bit-packed, a few bits per position, and databases
+   are written to files which are memory mapped when opened, so loading one
+   costs no time and lookups cost O(cells). */
+
+#ifndef SOLVED_DB_H
+#define SOLVED_DB_H
+
+#include "board.h"
+
+#include <stddef.h>
+#include <stdio.h>
+
+
+/* Most cells a board can have to be solved. Above this the database would
+   not fit in memory (and would take days to solve). */
+#define SOLVED_DB_MAX_CELLS 20u
+
+
+/* Game-theoretic outcome of a position for the player to move. */
+typedef enum
+{
+    SOLVED_UNKNOWN,     /* Position can't arise in a game. */
+    SOLVED_LOSS,
+    SOLVED_DRAW,
+    SOLVED_WIN
+} SolvedOutcome;
+
+
+/* Value of a position for the player to move. */
+typedef struct
+{
+    SolvedOutcome outcome;
+    /* Moves until the game ends with perfect play: the winner wins as soon as
+       possible and the loser loses as late as possible. Draws play on until
+       the board is full. */
+    unsigned distance;
+} SolvedValue;
+
+
+/* Solved-position database.
+   Use solveDatabase or openSolvedDatabase to properly create it, and
+   destroySolvedDatabase to properly destroy it. */
+typedef struct SolvedDatabase
+{
+    unsigned rows;                  /* Height of the board. */
+    unsigned columns;               /* Width of the board. */
+    unsigned winRequirement;        /* Number of consecutive cells to win. */
+    unsigned entryBits;             /* Bits per packed position value. */
+    unsigned long positions;        /* Number of ranked positions. */
+    /* Binomial coefficients C(n, r), indexed by n * (cells + 1) + r. */
+    unsigned long* binomials;
+    /* Rank of the first position with each number of occupied cells, plus
+       the total number of positions at the end. */
+    unsigned long* layerOffsets;
+    unsigned char const* entries;   /* Packed values, indexed by rank. */
+    unsigned char* ownedEntries;    /* entries, if allocated rather than
+                                       mapped. */
+    void* mapping;                  /* Mapped file, or NULL. */
+    size_t mappingSize;
+} SolvedDatabase;
+
+
+/* Returns a SolvedDatabase object with all members zeroed out. */
+SolvedDatabase zeroedSolvedDatabase(void);
+
+/* Solves every position of a board with the given dimensions, working back
+   from full boards one number of occupied cells at a time.
+   rows * columns must be at most SOLVED_DB_MAX_CELLS. Memory and time
+   required grow by roughly 3 times per cell. If verbose is non-zero, prints
+   progress to stdout. */
+SolvedDatabase solveDatabase(unsigned rows, unsigned columns,
+    unsigned winRequirement, int verbose);
+
+/* Writes a database to a stream in the format read by openSolvedDatabase. */
+void writeSolvedDatabase(FILE* stream, SolvedDatabase const* database);
+
+/* Opens a database file by mapping it into memory.
+   If an error occurs, prints info to stderr, sets error to 1, and returns a
+   zeroed SolvedDatabase object. */
+SolvedDatabase openSolvedDatabase(char const* filePath, int* error);
+
+/* Destroys a database (unmaps or deallocates resources, etc.). */
+void destroySolvedDatabase(SolvedDatabase* database);
+
+/* Checks if a database was solved for boards with the dimensions and win
+   requirement of the given board. */
+int solvedDatabaseMatches(SolvedDatabase const* database,
+    GameBoard const* board);
+
+/* Looks up the value of a board position for the player to move.
+   The database must match the board. Returns SOLVED_UNKNOWN for positions
+   that can't arise in a game. */
+SolvedValue lookupSolvedPosition(SolvedDatabase const* database,
+    GameBoard const* board);
+
+/* Finds a best move for the player to move: the fastest win, otherwise a
+   draw, otherwise the slowest loss. The database must match the board.
+   If the position is known and not over, sets row, column and value (the
+   value of the position before the move) and returns 1, otherwise returns
+   0. */
+int solvedBestMove(SolvedDatabase const* database, GameBoard const* board,
+    unsigned* row, unsigned* column, SolvedValue* value);
+
+/* Prints a value as e.g. "win in 3" to a stream. */
+void writeSolvedValue(FILE* stream, SolvedValue value);
+
+
+#endif
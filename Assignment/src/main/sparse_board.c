@@ -0,0 +1,210 @@
+/* Sparse storage for the game board. */
+
+#include "sparse_board.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Number of slots in a newly created table. Must be a power of 2. */
+#define INITIAL_CAPACITY 64u
+
+
+/* Hashes a cell's coordinates to a slot index. */
+static size_t slotFor(SparseBoard const* sparse, unsigned row, unsigned column)
+{
+    unsigned long hash = row * 0x9E3779B1ul ^ column;
+
+    /* Mix the high bits down so nearby cells spread across the table. */
+    hash ^= hash >> 16;
+    hash *= 0x45D9F3Bul;
+    hash ^= hash >> 16;
+
+    return hash & (sparse->capacity - 1u);
+}
+
+
+/* Finds the slot holding the given cell, or the empty slot that ends its probe
+   sequence if it isn't stored. */
+static size_t findSlot(SparseBoard const* sparse, unsigned row,
+    unsigned column)
+{
+    size_t slot = slotFor(sparse, row, column);
+    SparseCell const* cell = sparse->slots + slot;
+
+    while (cell->value != 0 && (cell->row != row || cell->column != column))
+    {
+        slot = (slot + 1u) & (sparse->capacity - 1u);
+        cell = sparse->slots + slot;
+    }
+
+    return slot;
+}
+
+
+/* Allocates a table with the given number of slots, all unused. */
+static SparseCell* allocateSlots(size_t capacity)
+{
+    SparseCell* slots = malloc(capacity * sizeof(SparseCell));
+    size_t i = 0;
+
+    for (i = 0; i < capacity; ++i)
+    {
+        slots[i].value = 0;
+    }
+
+    return slots;
+}
+
+
+/* Doubles the capacity of the table and reinserts all cells. */
+static void grow(SparseBoard* sparse)
+{
+    SparseCell* const oldSlots = sparse->slots;
+    size_t const oldCapacity = sparse->capacity;
+    size_t i = 0;
+
+    sparse->capacity = oldCapacity * 2u;
+    sparse->slots = allocateSlots(sparse->capacity);
+
+    for (i = 0; i < oldCapacity; ++i)
+    {
+        if (oldSlots[i].value != 0)
+        {
+            sparse->slots[findSlot(sparse, oldSlots[i].row,
+                oldSlots[i].column)] = oldSlots[i];
+        }
+    }
+
+    free(oldSlots);
+}
+
+
+/* Removes the cell in a slot, shifting later cells in the same probe sequence
+   back so that no lookups are broken by the gap. */
+static void removeSlot(SparseBoard* sparse, size_t slot)
+{
+    size_t const mask = sparse->capacity - 1u;
+    size_t gap = slot;
+    size_t next = (slot + 1u) & mask;
+    size_t home = 0;
+
+    while (sparse->slots[next].value != 0)
+    {
+        home = slotFor(sparse, sparse->slots[next].row,
+            sparse->slots[next].column);
+        /* The cell can fill the gap if the gap lies between its home slot and
+           its current slot (cyclically). */
+        if (((next - home) & mask) >= ((next - gap) & mask))
+        {
+            sparse->slots[gap] = sparse->slots[next];
+            gap = next;
+        }
+        next = (next + 1u) & mask;
+    }
+
+    sparse->slots[gap].value = 0;
+    --sparse->count;
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+SparseBoard zeroedSparseBoard(void)
+{
+    SparseBoard sparse;
+
+    sparse.capacity = 0;
+    sparse.count = 0;
+    sparse.slots = NULL;
+
+    return sparse;
+}
+
+
+SparseBoard createSparseBoard(void)
+{
+    SparseBoard sparse = zeroedSparseBoard();
+
+    sparse.capacity = INITIAL_CAPACITY;
+    sparse.slots = allocateSlots(sparse.capacity);
+
+    return sparse;
+}
+
+
+SparseBoard copySparseBoard(SparseBoard const* sparse)
+{
+    SparseBoard copy = *sparse;
+
+    copy.slots = malloc(sparse->capacity * sizeof(SparseCell));
+    memcpy(copy.slots, sparse->slots, sparse->capacity * sizeof(SparseCell));
+
+    return copy;
+}
+
+
+void destroySparseBoard(SparseBoard* sparse)
+{
+    free(sparse->slots);
+    *sparse = zeroedSparseBoard();
+}
+
+
+void clearSparseBoard(SparseBoard* sparse)
+{
+    size_t i = 0;
+
+    for (i = 0; i < sparse->capacity; ++i)
+    {
+        sparse->slots[i].value = 0;
+    }
+    sparse->count = 0;
+}
+
+
+void setSparseCell(SparseBoard* sparse, unsigned row, unsigned column,
+    unsigned char value)
+{
+    size_t slot = findSlot(sparse, row, column);
+    SparseCell* cell = sparse->slots + slot;
+
+    if (cell->value != 0)
+    {
+        if (value == 0)
+        {
+            removeSlot(sparse, slot);
+        }
+        else
+        {
+            cell->value = value;
+        }
+    }
+    else if (value != 0)
+    {
+        /* Keep the load factor at most 1/2 so probe sequences stay short. */
+        if ((sparse->count + 1u) * 2u > sparse->capacity)
+        {
+            grow(sparse);
+            cell = sparse->slots + findSlot(sparse, row, column);
+        }
+
+        cell->row = row;
+        cell->column = column;
+        cell->value = value;
+        ++sparse->count;
+    }
+}
+
+
+unsigned char getSparseCell(SparseBoard const* sparse, unsigned row,
+    unsigned column)
+{
+    return sparse->slots[findSlot(sparse, row, column)].value;
+}
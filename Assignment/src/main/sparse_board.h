@@ -0,0 +1,56 @@
+/* Sparse storage for the game board.
+   Only occupied cells are stored, in an open-addressing hash table keyed by
+   (row, column), so memory use depends on the number of moves played rather
+   than the size of the board. */
+
+#ifndef SPARSE_BOARD_H
+#define SPARSE_BOARD_H
+
+#include <stddef.h>
+
+
+/* A slot in the hash table. A value of 0 marks an unused slot. */
+typedef struct
+{
+    unsigned row;
+    unsigned column;
+    unsigned char value;
+} SparseCell;
+
+
+/* Sparse board data.
+   Use createSparseBoard to properly create it, and destroySparseBoard to
+   properly destroy it. */
+typedef struct
+{
+    size_t capacity;        /* Number of slots, always a power of 2. */
+    size_t count;           /* Number of slots in use. */
+    SparseCell* slots;      /* Hash table using linear probing. */
+} SparseBoard;
+
+
+/* Returns a SparseBoard object with all members zeroed out. */
+SparseBoard zeroedSparseBoard(void);
+
+/* Creates an empty sparse board. */
+SparseBoard createSparseBoard(void);
+
+/* Creates an independent copy of a sparse board. */
+SparseBoard copySparseBoard(SparseBoard const* sparse);
+
+/* Destroys a sparse board (deallocates resources, etc.). */
+void destroySparseBoard(SparseBoard* sparse);
+
+/* Removes all stored cells. */
+void clearSparseBoard(SparseBoard* sparse);
+
+/* Sets the value stored for a cell. A value of 0 removes the cell. */
+void setSparseCell(SparseBoard* sparse, unsigned row, unsigned column,
+    unsigned char value);
+
+/* Gets the value stored for a cell, or 0 if the cell is not stored. */
+unsigned char getSparseCell(SparseBoard const* sparse, unsigned row,
+    unsigned column);
+
+
+#endif
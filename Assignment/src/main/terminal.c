@@ -0,0 +1,70 @@
+/* ANSI terminal control. */
+
+/* isatty() and fileno() are POSIX, not ANSI C, and ioctl() isn't either. */
+#define _POSIX_C_SOURCE 200112L
+
+#include "terminal.h"
+
+#include <stdio.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Starts every ANSI control sequence. */
+#define CONTROL_SEQUENCE "\033["
+
+
+
+/* PUBLIC INTERFACE */
+
+
+int isTerminal(FILE* stream)
+{
+    return isatty(fileno(stream));
+}
+
+
+int terminalSize(FILE* stream, unsigned long* lines,
+    unsigned long* characters)
+{
+    int res = 0;
+#ifdef TIOCGWINSZ
+    struct winsize size;
+
+    res = ioctl(fileno(stream), TIOCGWINSZ, &size) == 0 && size.ws_row > 0
+        && size.ws_col > 0;
+    if (res)
+    {
+        *lines = size.ws_row;
+        *characters = size.ws_col;
+    }
+#else
+    (void)stream;
+    (void)lines;
+    (void)characters;
+#endif
+
+    return res;
+}
+
+
+void clearScreen(FILE* stream)
+{
+    fprintf(stream, CONTROL_SEQUENCE "2J" CONTROL_SEQUENCE "H");
+}
+
+
+void moveCursor(FILE* stream, unsigned long line, unsigned long character)
+{
+    /* The terminal counts from 1. */
+    fprintf(stream, CONTROL_SEQUENCE "%lu;%luH", line + 1u, character + 1u);
+}
+
+
+void clearToScreenEnd(FILE* stream)
+{
+    fprintf(stream, CONTROL_SEQUENCE "J");
+}
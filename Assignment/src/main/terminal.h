@@ -0,0 +1,31 @@
+/* ANSI terminal control, for updating text already on screen in place rather
+   than printing it again. */
+
+#ifndef TERMINAL_H
+#define TERMINAL_H
+
+#include <stdio.h>
+
+
+/* Checks if a stream is written to a terminal, rather than a file or
+   pipe. */
+int isTerminal(FILE* stream);
+
+/* Gets the size of the terminal a stream is written to, in lines and
+   characters per line.
+   Returns 0 if it isn't a terminal or its size can't be read. */
+int terminalSize(FILE* stream, unsigned long* lines,
+    unsigned long* characters);
+
+/* Clears a terminal's screen and moves its cursor to the top left. */
+void clearScreen(FILE* stream);
+
+/* Moves a terminal's cursor to a line and a character along it, both counted
+   from 0 at the top left of the screen. */
+void moveCursor(FILE* stream, unsigned long line, unsigned long character);
+
+/* Clears a terminal's screen from its cursor to the end. */
+void clearToScreenEnd(FILE* stream);
+
+
+#endif
@@ -0,0 +1,201 @@
+/* Threading utilities. */
+
+/* sysconf() and pthreads are POSIX, not ANSI C. */
+#define _POSIX_C_SOURCE 200112L
+
+#include "threads.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Tasks not yet started by one thread of runWorkStealing(). */
+typedef struct
+{
+    pthread_mutex_t lock;       /* Guards next and end. */
+    unsigned long next;         /* Next task to run. */
+    unsigned long end;          /* One past the last task to run. */
+    unsigned long steals;       /* Times this thread has stolen tasks. */
+} TaskRange;
+
+
+/* State shared by all threads of runWorkStealing(). */
+typedef struct
+{
+    TaskRange* ranges;          /* One per thread. */
+    unsigned threads;
+    TaskFunction task;
+    void* context;
+} Scheduler;
+
+
+/* Thread entry point argument for runWorkStealing(). */
+typedef struct
+{
+    Scheduler* scheduler;
+    unsigned worker;
+} WorkerArgs;
+
+
+/* Takes the next task from a thread's own range.
+   Returns non-zero and sets index if there was one. */
+static int takeTask(TaskRange* range, unsigned long* index)
+{
+    int taken = 0;
+
+    pthread_mutex_lock(&range->lock);
+    if (range->next < range->end)
+    {
+        *index = range->next;
+        ++range->next;
+        taken = 1;
+    }
+    pthread_mutex_unlock(&range->lock);
+
+    return taken;
+}
+
+
+/* Moves the upper half of another thread's remaining tasks into a thread's own
+   range, which must be empty.
+   Returns non-zero if any tasks were stolen. */
+static int stealTasks(Scheduler* scheduler, unsigned thief)
+{
+    TaskRange* const own = scheduler->ranges + thief;
+    TaskRange* victim = NULL;
+    unsigned long remaining = 0;
+    unsigned long begin = 0;
+    unsigned long end = 0;
+    unsigned i = 0;
+    int stolen = 0;
+
+    for (i = 1; i < scheduler->threads && !stolen; ++i)
+    {
+        victim = scheduler->ranges + (thief + i) % scheduler->threads;
+
+        pthread_mutex_lock(&victim->lock);
+        remaining = victim->end - victim->next;
+        if (remaining > 0)
+        {
+            end = victim->end;
+            begin = end - (remaining + 1u) / 2u;
+            victim->end = begin;
+            stolen = 1;
+        }
+        pthread_mutex_unlock(&victim->lock);
+    }
+
+    if (stolen)
+    {
+        pthread_mutex_lock(&own->lock);
+        own->next = begin;
+        own->end = end;
+        ++own->steals;
+        pthread_mutex_unlock(&own->lock);
+    }
+
+    return stolen;
+}
+
+
+/* Thread entry point. Runs tasks until none are left to run or steal.
+   Tasks in transit between threads are run by the thief, so a thread that
+   finds every range empty can safely finish. */
+static void* workerMain(void* arg)
+{
+    WorkerArgs const* const args = arg;
+    Scheduler* const scheduler = args->scheduler;
+    TaskRange* const own = scheduler->ranges + args->worker;
+    unsigned long index = 0;
+    int working = 1;
+
+    while (working)
+    {
+        if (takeTask(own, &index))
+        {
+            scheduler->task(index, args->worker, scheduler->context);
+        }
+        else
+        {
+            working = stealTasks(scheduler, args->worker);
+        }
+    }
+
+    return NULL;
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+unsigned processorCount(void)
+{
+    long const count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return count > 0 ? (unsigned)count : 1u;
+}
+
+
+void runWorkStealing(unsigned long tasks, unsigned threads, TaskFunction task,
+    void* context, unsigned long* steals)
+{
+    Scheduler scheduler;
+    WorkerArgs* args = malloc(threads * sizeof(WorkerArgs));
+    pthread_t* handles = malloc(threads * sizeof(pthread_t));
+    unsigned i = 0;
+    int res = 0;
+
+    assert(threads > 0);
+
+    scheduler.ranges = malloc(threads * sizeof(TaskRange));
+    scheduler.threads = threads;
+    scheduler.task = task;
+    scheduler.context = context;
+
+    for (i = 0; i < threads; ++i)
+    {
+        res = pthread_mutex_init(&scheduler.ranges[i].lock, NULL);
+        assert(res == 0);
+        scheduler.ranges[i].next = tasks / threads * i
+            + (i < tasks % threads ? i : tasks % threads);
+        scheduler.ranges[i].end = scheduler.ranges[i].next + tasks / threads
+            + (i < tasks % threads);
+        scheduler.ranges[i].steals = 0;
+        args[i].scheduler = &scheduler;
+        args[i].worker = i;
+    }
+
+    for (i = 1; i < threads; ++i)
+    {
+        res = pthread_create(handles + i, NULL, workerMain, args + i);
+        assert(res == 0);
+    }
+    workerMain(args);
+    for (i = 1; i < threads; ++i)
+    {
+        res = pthread_join(handles[i], NULL);
+        assert(res == 0);
+    }
+
+    for (i = 0; i < threads; ++i)
+    {
+        if (steals)
+        {
+            steals[i] = scheduler.ranges[i].steals;
+        }
+        res = pthread_mutex_destroy(&scheduler.ranges[i].lock);
+        assert(res == 0);
+    }
+    (void)res;
+
+    free(scheduler.ranges);
+    free(args);
+    free(handles);
+}
@@ -0,0 +1,27 @@
+/* Threading utilities. */
+
+#ifndef THREADS_H
+#define THREADS_H
+
+
+/* Function run for each task by runWorkStealing(). index is the task's index
+   and worker is the index of the thread running it. */
+typedef void (*TaskFunction)(unsigned long index, unsigned worker,
+    void* context);
+
+
+/* Returns the number of processors currently online, at least 1. */
+unsigned processorCount(void);
+
+/* Runs task for every index in [0, tasks) using the given number of threads,
+   one of which is the calling thread. Returns once all tasks are complete.
+   Each thread starts with an equal contiguous range of indices, which it runs
+   in ascending order. A thread that runs out of tasks steals the upper half of
+   the remaining range of another thread.
+   If steals is not NULL, it must have room for threads elements, and receives
+   the number of times each thread stole tasks. */
+void runWorkStealing(unsigned long tasks, unsigned threads, TaskFunction task,
+    void* context, unsigned long* steals);
+
+
+#endif
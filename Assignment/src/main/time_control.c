@@ -0,0 +1,89 @@
+/* Game clocks and move time budgeting. */
+
+#include "time_control.h"
+
+#include "board.h"
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Seconds kept back from every move for the work around the search, such as
+   printing the board, so it can't run the clock out. */
+#define SAFETY_SECONDS 0.05
+
+/* Most moves the remaining time is spread over. Games rarely last until the
+   board is full, so on large boards the time is budgeted for this many more
+   moves. */
+#define MOVES_TO_GO_MAX 30ul
+
+/* Hard limit as a multiple of the soft one, so an iteration that is nearly
+   done when the soft limit passes can still finish. */
+#define HARD_FACTOR 4.0
+
+
+
+/* PUBLIC INTERFACE */
+
+
+GameClock createGameClock(double gameSeconds, double incrementSeconds)
+{
+    GameClock clock;
+
+    clock.remaining[PLAYER_X] = gameSeconds;
+    clock.remaining[PLAYER_O] = gameSeconds;
+    clock.increment = incrementSeconds;
+
+    return clock;
+}
+
+
+void moveTimeBudget(GameClock const* clock, GameBoard const* board,
+    double* softSeconds, double* hardSeconds)
+{
+    unsigned long const empty = (unsigned long)board->rows * board->columns
+        - board->occupied;
+    /* The player to move makes the first of every two moves left. */
+    unsigned long movesToGo = (empty + 1u) / 2u;
+    double available = clock->remaining[nextPlayer(board)] - SAFETY_SECONDS;
+
+    if (movesToGo > MOVES_TO_GO_MAX)
+    {
+        movesToGo = MOVES_TO_GO_MAX;
+    }
+    if (movesToGo == 0)
+    {
+        movesToGo = 1;
+    }
+    if (available < 0.0)
+    {
+        available = 0.0;
+    }
+
+    /* The increment only arrives after the move, so it can be spent on every
+       move but can't extend the hard limit past the time left. */
+    *softSeconds = available / movesToGo + clock->increment;
+    *hardSeconds = *softSeconds * HARD_FACTOR;
+    if (*hardSeconds > available)
+    {
+        *hardSeconds = available;
+    }
+    if (*softSeconds > *hardSeconds)
+    {
+        *softSeconds = *hardSeconds;
+    }
+}
+
+
+int chargeGameClock(GameClock* clock, Player player, double seconds)
+{
+    int const inTime = seconds <= clock->remaining[player];
+
+    clock->remaining[player] -= seconds;
+    if (inTime)
+    {
+        clock->remaining[player] += clock->increment;
+    }
+
+    return inTime;
+}
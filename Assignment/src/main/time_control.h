@@ -0,0 +1,37 @@
+/* Game clocks, for games where each player has a total time for all their
+   moves plus an increment per move, and budgeting that time between moves. */
+
+#ifndef TIME_CONTROL_H
+#define TIME_CONTROL_H
+
+#include "board.h"
+
+
+/* Time left for each player in a game. */
+typedef struct
+{
+    double remaining[2];    /* Seconds left, indexed by Player. Negative once
+                               a player has run out. */
+    double increment;       /* Seconds added after each move. */
+} GameClock;
+
+
+/* Creates a clock giving each player gameSeconds for the game, plus
+   incrementSeconds after each of their moves. */
+GameClock createGameClock(double gameSeconds, double incrementSeconds);
+
+/* Works out how long the player whose turn it is on board should spend on
+   their move: softSeconds is the time to aim for, and hardSeconds is the most
+   the move can take without running the clock out, less a safety margin. The
+   remaining time is spread over the player's moves that are likely still to
+   come. softSeconds is at most hardSeconds. */
+void moveTimeBudget(GameClock const* clock, GameBoard const* board,
+    double* softSeconds, double* hardSeconds);
+
+/* Takes the time a move took off the player's clock, then adds the
+   increment.
+   Returns 0 if the player ran out of time during the move, otherwise 1. */
+int chargeGameClock(GameClock* clock, Player player, double seconds);
+
+
+#endif
@@ -0,0 +1,127 @@
+/* Wall-clock timing. */
+
+/* clock_gettime() is POSIX, not ANSI C. */
+#define _POSIX_C_SOURCE 199309L
+
+#include "timer.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <time.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Initial capacity of a collection of samples. */
+#define INITIAL_SAMPLE_CAPACITY 1024u
+
+
+/* qsort() comparison putting durations in ascending order. */
+static int compareSamples(void const* a, void const* b)
+{
+    double const sampleA = *(double const*)a;
+    double const sampleB = *(double const*)b;
+
+    return (sampleA > sampleB) - (sampleA < sampleB);
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+double monotonicSeconds(void)
+{
+    struct timespec now;
+    int res = clock_gettime(CLOCK_MONOTONIC, &now);
+    assert(res == 0);
+    (void)res;
+
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+
+LatencySamples zeroedLatencySamples(void)
+{
+    LatencySamples latencies;
+
+    latencies.samples = NULL;
+    latencies.count = 0;
+    latencies.capacity = 0;
+    latencies.sorted = 1;
+
+    return latencies;
+}
+
+
+void destroyLatencySamples(LatencySamples* latencies)
+{
+    free(latencies->samples);
+    *latencies = zeroedLatencySamples();
+}
+
+
+void addLatencySample(LatencySamples* latencies, double seconds)
+{
+    if (latencies->count == latencies->capacity)
+    {
+        latencies->capacity = latencies->capacity > 0
+            ? latencies->capacity * 2u : INITIAL_SAMPLE_CAPACITY;
+        latencies->samples = realloc(latencies->samples,
+            latencies->capacity * sizeof(double));
+        assert(latencies->samples);
+    }
+
+    latencies->samples[latencies->count] = seconds;
+    ++latencies->count;
+    latencies->sorted = 0;
+}
+
+
+void mergeLatencySamples(LatencySamples* dest, LatencySamples const* source)
+{
+    size_t i = 0;
+
+    for (i = 0; i < source->count; ++i)
+    {
+        addLatencySample(dest, source->samples[i]);
+    }
+}
+
+
+double latencyPercentile(LatencySamples* latencies, double percent)
+{
+    double result = 0.0;
+    double rank = 0.0;
+    size_t index = 0;
+
+    assert(percent >= 0.0 && percent <= 100.0);
+
+    if (latencies->count > 0)
+    {
+        if (!latencies->sorted)
+        {
+            qsort(latencies->samples, latencies->count, sizeof(double),
+                compareSamples);
+            latencies->sorted = 1;
+        }
+
+        /* Nearest rank: the smallest sample that at least percent of samples
+           are less than or equal to. */
+        rank = percent / 100.0 * latencies->count;
+        index = (size_t)rank;
+        if (index == rank && index > 0)
+        {
+            --index;
+        }
+        if (index >= latencies->count)
+        {
+            index = latencies->count - 1u;
+        }
+        result = latencies->samples[index];
+    }
+
+    return result;
+}
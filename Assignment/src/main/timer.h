@@ -0,0 +1,43 @@
+/* Wall-clock timing. */
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <stddef.h>
+
+
+/* Collection of measured durations, for computing percentiles.
+   Use zeroedLatencySamples to properly create it, and destroyLatencySamples to
+   properly destroy it. */
+typedef struct
+{
+    double* samples;        /* Durations in seconds. */
+    size_t count;
+    size_t capacity;
+    int sorted;             /* Whether samples is in ascending order. */
+} LatencySamples;
+
+
+/* Returns the time in seconds since an arbitrary fixed point, from a clock that
+   is not affected by changes to the system time. Only differences between
+   results are meaningful. */
+double monotonicSeconds(void);
+
+/* Returns an empty LatencySamples object. */
+LatencySamples zeroedLatencySamples(void);
+
+/* Destroys a collection of samples (deallocates resources, etc.). */
+void destroyLatencySamples(LatencySamples* latencies);
+
+/* Adds a duration in seconds to a collection of samples. */
+void addLatencySample(LatencySamples* latencies, double seconds);
+
+/* Adds all the samples of source to dest. */
+void mergeLatencySamples(LatencySamples* dest, LatencySamples const* source);
+
+/* Gets the duration in seconds that the given percentage (0 to 100) of samples
+   are at most. Returns 0 if there are no samples. */
+double latencyPercentile(LatencySamples* latencies, double percent);
+
+
+#endif
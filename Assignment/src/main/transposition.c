@@ -0,0 +1,242 @@
+/* Transposition table for game tree search. */
+
+#include "transposition.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Subtracted from the keep priority of entries from older searches. Larger
+   than any depth, so they are always replaced first. */
+#define STALE_PENALTY 65536l
+
+/* Positions of the fields packed into TableSlot.info. The score takes the low
+   32 bits, as two's complement. */
+#define DEPTH_SHIFT 32u
+#define GENERATION_SHIFT 48u
+#define BOUND_SHIFT 56u
+#define HAS_MOVE_SHIFT 58u
+
+/* Position of the column packed into TableSlot.move, above the row. */
+#define COLUMN_SHIFT 32u
+
+#define LOW_32_BITS 0xfffffffful
+
+
+/* Entry fields, other than the key, as read from a slot. */
+typedef struct
+{
+    unsigned long info;
+    unsigned long move;
+    int matches;                /* Whether the slot holds the key's entry. */
+} SlotContents;
+
+
+/* Gets the first entry of the bucket a key maps to. */
+static TableSlot volatile* bucketFor(TranspositionTable const* table,
+    unsigned long key)
+{
+    /* Zobrist keys are already uniformly distributed. */
+    return table->entries
+        + (key & (table->bucketCount - 1u)) * TABLE_BUCKET_SIZE;
+}
+
+
+/* Gets a packed field of TableSlot.info. */
+static unsigned infoField(unsigned long info, unsigned shift,
+    unsigned long mask)
+{
+    return (unsigned)(info >> shift & mask);
+}
+
+
+/* Reads a slot once, which other threads may be writing to, and checks it
+   against a key. */
+static SlotContents readSlot(TableSlot volatile const* slot,
+    unsigned long key)
+{
+    SlotContents contents;
+    unsigned long const check = slot->check;
+
+    contents.info = slot->info;
+    contents.move = slot->move;
+    contents.matches = (check ^ contents.info ^ contents.move) == key
+        && infoField(contents.info, BOUND_SHIFT, 3ul) != BOUND_NONE;
+
+    return contents;
+}
+
+
+/* Ranks how valuable an entry is to keep, lower is replaced first. */
+static long keepPriority(TranspositionTable const* table, unsigned long info)
+{
+    long priority = infoField(info, DEPTH_SHIFT, 0xfffful);
+
+    if (infoField(info, BOUND_SHIFT, 3ul) == BOUND_NONE)
+    {
+        priority = -2l * STALE_PENALTY;
+    }
+    else if (infoField(info, GENERATION_SHIFT, 0xfful) != table->generation)
+    {
+        priority -= STALE_PENALTY;
+    }
+
+    return priority;
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+TranspositionTable zeroedTranspositionTable(void)
+{
+    TranspositionTable table;
+
+    table.bucketCount = 0;
+    table.entries = NULL;
+    table.generation = 0;
+    table.probes = 0;
+    table.hits = 0;
+
+    return table;
+}
+
+
+TranspositionTable createTranspositionTable(size_t maxEntries)
+{
+    TranspositionTable table = zeroedTranspositionTable();
+
+    assert(maxEntries >= TABLE_BUCKET_SIZE);
+    /* Slots pack an int and two unsigneds into two words. */
+    assert(sizeof(unsigned long) * CHAR_BIT >= 64u);
+
+    table.bucketCount = 1;
+    while (table.bucketCount * 2u * TABLE_BUCKET_SIZE <= maxEntries)
+    {
+        table.bucketCount *= 2u;
+    }
+
+    table.entries = malloc(table.bucketCount * TABLE_BUCKET_SIZE
+        * sizeof(TableSlot));
+    clearTranspositionTable(&table);
+
+    return table;
+}
+
+
+void destroyTranspositionTable(TranspositionTable* table)
+{
+    free(table->entries);
+    *table = zeroedTranspositionTable();
+}
+
+
+void clearTranspositionTable(TranspositionTable* table)
+{
+    size_t const count = table->bucketCount * TABLE_BUCKET_SIZE;
+    size_t i = 0;
+
+    for (i = 0; i < count; ++i)
+    {
+        table->entries[i].check = 0;
+        table->entries[i].info = 0;
+        table->entries[i].move = 0;
+    }
+    table->probes = 0;
+    table->hits = 0;
+}
+
+
+void newTableSearch(TranspositionTable* table)
+{
+    ++table->generation;
+    table->probes = 0;
+    table->hits = 0;
+}
+
+
+int probeTable(TranspositionTable* table, unsigned long key, TableEntry* entry)
+{
+    TableSlot volatile const* bucket = bucketFor(table, key);
+    SlotContents contents;
+    unsigned long raw = 0;
+    int found = 0;
+    unsigned i = 0;
+
+    ++table->probes;
+
+    for (i = 0; i < TABLE_BUCKET_SIZE && !found; ++i)
+    {
+        contents = readSlot(bucket + i, key);
+        found = contents.matches;
+    }
+
+    if (found)
+    {
+        raw = contents.info & LOW_32_BITS;
+        entry->key = key;
+        entry->score = raw > (unsigned long)INT_MAX
+            ? -(int)(LOW_32_BITS - raw) - 1 : (int)raw;
+        entry->depth = infoField(contents.info, DEPTH_SHIFT, 0xfffful);
+        entry->generation = infoField(contents.info, GENERATION_SHIFT,
+            0xfful);
+        entry->bound = infoField(contents.info, BOUND_SHIFT, 3ul);
+        entry->hasMove = infoField(contents.info, HAS_MOVE_SHIFT, 1ul);
+        entry->row = contents.move & LOW_32_BITS;
+        entry->column = contents.move >> COLUMN_SHIFT & LOW_32_BITS;
+        ++table->hits;
+    }
+
+    return found;
+}
+
+
+void storeTable(TranspositionTable* table, TableEntry const* entry)
+{
+    TableSlot volatile* bucket = bucketFor(table, entry->key);
+    TableSlot volatile* victim = NULL;
+    unsigned long info = 0;
+    unsigned long move = 0;
+    unsigned i = 0;
+
+    for (i = 0; i < TABLE_BUCKET_SIZE && !victim; ++i)
+    {
+        if (readSlot(bucket + i, entry->key).matches)
+        {
+            victim = bucket + i;
+        }
+    }
+
+    if (!victim)
+    {
+        victim = bucket;
+        for (i = 1; i < TABLE_BUCKET_SIZE; ++i)
+        {
+            if (keepPriority(table, bucket[i].info)
+                < keepPriority(table, victim->info))
+            {
+                victim = bucket + i;
+            }
+        }
+    }
+
+    info = ((unsigned long)(unsigned)entry->score & LOW_32_BITS)
+        | (unsigned long)entry->depth << DEPTH_SHIFT
+        | (unsigned long)table->generation << GENERATION_SHIFT
+        | (unsigned long)(entry->bound & 3u) << BOUND_SHIFT
+        | (unsigned long)(entry->hasMove != 0) << HAS_MOVE_SHIFT;
+    move = (entry->row & LOW_32_BITS)
+        | (entry->column & LOW_32_BITS) << COLUMN_SHIFT;
+
+    /* Another thread may write the same slot in between these, but then the
+       check won't match both words. */
+    victim->info = info;
+    victim->move = move;
+    victim->check = entry->key ^ info ^ move;
+}
@@ -0,0 +1,97 @@
+/* Transposition table for game tree search.
+   Several threads can probe and store entries at the same time without locks,
+   each through its own copy of the TranspositionTable object. */
+
+#ifndef TRANSPOSITION_H
+#define TRANSPOSITION_H
+
+#include <stddef.h>
+
+
+/* Indicates how a stored score relates to the true score of a position. */
+typedef enum
+{
+    BOUND_NONE,         /* Entry is unused. */
+    BOUND_EXACT,        /* Score is exact. */
+    BOUND_LOWER,        /* True score is at least the stored score. */
+    BOUND_UPPER         /* True score is at most the stored score. */
+} ScoreBound;
+
+
+/* Search result stored for a position. */
+typedef struct
+{
+    unsigned long key;          /* Zobrist hash of the position. */
+    int score;                  /* Score for the side to move. */
+    unsigned short depth;       /* Remaining depth the score was searched to. */
+    unsigned char bound;        /* ScoreBound of the score. */
+    unsigned char generation;   /* Search that stored the entry. */
+    unsigned char hasMove;      /* Whether row and column hold a best move. */
+    unsigned row;               /* Best move found, if any. */
+    unsigned column;
+} TableEntry;
+
+
+/* TableEntry as stored in a table, with its fields packed into two words.
+   The key is stored XORed with both, so an entry torn by concurrent writes
+   from several threads fails to match any key rather than giving mixed up
+   data. */
+typedef struct
+{
+    unsigned long check;        /* key ^ info ^ move. */
+    unsigned long info;         /* Score, depth, bound, generation and
+                                   hasMove. */
+    unsigned long move;         /* Row and column. */
+} TableSlot;
+
+
+/* Fixed-size hash table of TableEntry, grouped into buckets.
+   Use createTranspositionTable to properly create it, and
+   destroyTranspositionTable to properly destroy it.
+   Copies of the object share the entries, but have their own generation and
+   statistics. */
+typedef struct
+{
+    size_t bucketCount;         /* Number of buckets, a power of 2. */
+    TableSlot* entries;         /* TABLE_BUCKET_SIZE entries per bucket. */
+    unsigned char generation;   /* Incremented by newTableSearch(). */
+    unsigned long probes;       /* probeTable() calls since newTableSearch(). */
+    unsigned long hits;         /* Successful probes since newTableSearch(). */
+} TranspositionTable;
+
+
+/* Number of entries in each bucket of a transposition table. A position may be
+   stored in any entry of the bucket its key maps to. */
+#define TABLE_BUCKET_SIZE 4u
+
+
+/* Returns a TranspositionTable object with all members zeroed out. */
+TranspositionTable zeroedTranspositionTable(void);
+
+/* Creates an empty transposition table with at most the given number of
+   entries (rounded down to whole, power of 2 many buckets). */
+TranspositionTable createTranspositionTable(size_t maxEntries);
+
+/* Destroys a transposition table (deallocates resources, etc.). */
+void destroyTranspositionTable(TranspositionTable* table);
+
+/* Removes all entries from a transposition table. Must not run at the same
+   time as other operations on the table. */
+void clearTranspositionTable(TranspositionTable* table);
+
+/* Marks the start of a new search. Entries from earlier searches are kept, but
+   are replaced before any entries from the new search. Resets the probe and
+   hit counts. */
+void newTableSearch(TranspositionTable* table);
+
+/* Looks up the entry for a position.
+   If found, copies it to entry and returns 1, otherwise returns 0. */
+int probeTable(TranspositionTable* table, unsigned long key, TableEntry* entry);
+
+/* Stores an entry, keyed by entry->key, with the table's current generation.
+   Replaces any existing entry for the same key, otherwise an entry from an
+   older search, otherwise the entry with the smallest depth in the bucket. */
+void storeTable(TranspositionTable* table, TableEntry const* entry);
+
+
+#endif
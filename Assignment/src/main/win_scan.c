@@ -0,0 +1,438 @@
+/* Vectorised full-board win scans. */
+
+#include "win_scan.h"
+
+#include "board.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stdlib.h>
+
+/* The kernels use GCC's intrinsics, target attributes and processor feature
+   checks, so only exist in x86 builds by GCC compatible compilers. */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define WIN_SCAN_X86
+#include <immintrin.h>
+#endif
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Cells gathered into each bit mask by the row kernels. */
+#define MASK_CELLS 32u
+
+
+/* Kernel set by selectWinScanKernel(). */
+static WinScanKernel selectedKernel = WIN_SCAN_AUTO;
+
+
+#ifdef WIN_SCAN_X86
+
+/* Run lengths of matching cells ending at each cell of the row above the one
+   being scanned, and at each cell of that row once scanned. The diagonal runs
+   are indexed by column + 1, so the entries either side of the board stay 0
+   and the kernels can read one column past each edge. */
+typedef struct
+{
+    unsigned* columns;      /* Down each column, updated in place. */
+    unsigned* falling;      /* Down and right, ending in the row above. */
+    unsigned* nextFalling;  /* Down and right, ending in the scanned row. */
+    unsigned* rising;       /* Down and left, ending in the row above. */
+    unsigned* nextRising;   /* Down and left, ending in the scanned row. */
+} LineRuns;
+
+
+/* Gathers which of the MASK_CELLS cells from cells match status into a bit
+   mask, the first cell in bit 0, four cells at a time. */
+static __attribute__((target("sse2"))) unsigned long sse2MatchMask(
+    CellStatus const* cells, CellStatus status)
+{
+    __m128i const wanted = _mm_set1_epi32((int)status);
+    __m128i match;
+    unsigned long mask = 0;
+    unsigned i = 0;
+
+    for (i = 0; i < MASK_CELLS; i += 4u)
+    {
+        match = _mm_cmpeq_epi32(_mm_loadu_si128((__m128i const*)(cells + i)),
+            wanted);
+        mask |= (unsigned long)_mm_movemask_ps(_mm_castsi128_ps(match)) << i;
+    }
+
+    return mask;
+}
+
+
+/* Same as sse2MatchMask(), eight cells at a time. */
+static __attribute__((target("avx2"))) unsigned long avx2MatchMask(
+    CellStatus const* cells, CellStatus status)
+{
+    __m256i const wanted = _mm256_set1_epi32((int)status);
+    __m256i match;
+    unsigned long mask = 0;
+    unsigned i = 0;
+
+    for (i = 0; i < MASK_CELLS; i += 8u)
+    {
+        match = _mm256_cmpeq_epi32(
+            _mm256_loadu_si256((__m256i const*)(cells + i)), wanted);
+        mask |= (unsigned long)_mm256_movemask_ps(_mm256_castsi256_ps(match))
+            << i;
+    }
+
+    return mask;
+}
+
+
+/* Same as sse2MatchMask(), for the count (<MASK_CELLS) cells at the end of a
+   row. */
+static unsigned long scalarMatchMask(CellStatus const* cells, unsigned count,
+    CellStatus status)
+{
+    unsigned long mask = 0;
+    unsigned i = 0;
+
+    for (i = 0; i < count; ++i)
+    {
+        if (cells[i] == status)
+        {
+            mask |= 1ul << i;
+        }
+    }
+
+    return mask;
+}
+
+
+/* Checks if a bit mask has k (1-MASK_CELLS) consecutive set bits. Each step
+   doubles the run every remaining bit is known to start, so only O(log k)
+   steps are needed. */
+static int maskHasRun(unsigned long mask, unsigned k)
+{
+    unsigned long runs = mask;
+    unsigned length = 1;    /* Bits of runs are set where a run of this
+                               many starts. */
+
+    while (length * 2u <= k)
+    {
+        runs &= runs >> length;
+        length *= 2u;
+    }
+    /* The two runs overlap, as length > k / 2. */
+    runs &= runs >> (k - length);
+
+    return runs != 0;
+}
+
+
+/* Counts the set bits at the bottom of a mask that isn't all ones. */
+static unsigned lowRun(unsigned long mask)
+{
+    return (unsigned)__builtin_ctzl(~mask);
+}
+
+
+/* Counts the set bits at the top of the low count bits of a mask, given
+   those count bits aren't all set. */
+static unsigned highRun(unsigned long mask, unsigned long full, unsigned count)
+{
+    unsigned const highestClear = sizeof(unsigned long) * CHAR_BIT - 1u
+        - (unsigned)__builtin_clzl(~mask & full);
+
+    return count - 1u - highestClear;
+}
+
+
+/* Checks if the given status occurs consecutively enough along any row to be
+   a win, gathering the row's matches into bit masks with the kernel. */
+static int rowsHaveWon(GameBoard const* board, CellStatus status,
+    WinScanKernel kernel)
+{
+    unsigned const k = board->winRequirement;
+    CellStatus const* row = NULL;
+    unsigned long i = 0;
+    unsigned j = 0;
+    unsigned count = 0;
+    unsigned consecutive = 0;
+    unsigned long mask = 0;
+    unsigned long full = 0;
+    int win = 0;
+
+    for (i = 0; i < board->rows && !win; ++i)
+    {
+        row = board->cells + i * board->columns;
+        consecutive = 0;
+        for (j = 0; j < board->columns && !win; j += count)
+        {
+            count = board->columns - j < MASK_CELLS
+                ? board->columns - j : MASK_CELLS;
+            mask = count < MASK_CELLS ? scalarMatchMask(row + j, count, status)
+                : kernel == WIN_SCAN_AVX2 ? avx2MatchMask(row + j, status)
+                : sse2MatchMask(row + j, status);
+            /* Shifted twice, as shifting by the width of the type is
+               undefined. */
+            full = ((1ul << (count - 1u)) << 1u) - 1u;
+
+            if (mask == full)
+            {
+                consecutive += count;
+            }
+            else
+            {
+                /* The run carried over from the previous masks ends here. */
+                win = consecutive + lowRun(mask) >= k
+                    || (k <= count && maskHasRun(mask, k));
+                consecutive = highRun(mask, full, count);
+            }
+            win = win || consecutive >= k;
+        }
+    }
+
+    return win;
+}
+
+
+/* Updates the runs for the first count (a multiple of 4) cells of a row, four
+   columns at a time, the run lengths being masked to 0 where cells don't
+   match. Returns non-zero if any run reaches k. */
+static __attribute__((target("sse2"))) int sse2UpdateRuns(
+    CellStatus const* row, unsigned count, CellStatus status, unsigned k,
+    LineRuns const* runs)
+{
+    __m128i const wanted = _mm_set1_epi32((int)status);
+    __m128i const one = _mm_set1_epi32(1);
+    __m128i const shortest = _mm_set1_epi32((int)k - 1);
+    __m128i won = _mm_setzero_si128();
+    __m128i match;
+    __m128i column;
+    __m128i falling;
+    __m128i rising;
+    unsigned j = 0;
+
+    for (j = 0; j < count; j += 4u)
+    {
+        match = _mm_cmpeq_epi32(_mm_loadu_si128((__m128i const*)(row + j)),
+            wanted);
+        column = _mm_and_si128(match, _mm_add_epi32(one,
+            _mm_loadu_si128((__m128i const*)(runs->columns + j))));
+        falling = _mm_and_si128(match, _mm_add_epi32(one,
+            _mm_loadu_si128((__m128i const*)(runs->falling + j))));
+        rising = _mm_and_si128(match, _mm_add_epi32(one,
+            _mm_loadu_si128((__m128i const*)(runs->rising + j + 2u))));
+
+        _mm_storeu_si128((__m128i*)(runs->columns + j), column);
+        _mm_storeu_si128((__m128i*)(runs->nextFalling + j + 1u), falling);
+        _mm_storeu_si128((__m128i*)(runs->nextRising + j + 1u), rising);
+
+        won = _mm_or_si128(won, _mm_or_si128(_mm_cmpgt_epi32(column, shortest),
+            _mm_or_si128(_mm_cmpgt_epi32(falling, shortest),
+                _mm_cmpgt_epi32(rising, shortest))));
+    }
+
+    return _mm_movemask_epi8(won) != 0;
+}
+
+
+/* Same as sse2UpdateRuns(), eight columns at a time, with count a multiple of
+   8. */
+static __attribute__((target("avx2"))) int avx2UpdateRuns(
+    CellStatus const* row, unsigned count, CellStatus status, unsigned k,
+    LineRuns const* runs)
+{
+    __m256i const wanted = _mm256_set1_epi32((int)status);
+    __m256i const one = _mm256_set1_epi32(1);
+    __m256i const shortest = _mm256_set1_epi32((int)k - 1);
+    __m256i won = _mm256_setzero_si256();
+    __m256i match;
+    __m256i column;
+    __m256i falling;
+    __m256i rising;
+    unsigned j = 0;
+
+    for (j = 0; j < count; j += 8u)
+    {
+        match = _mm256_cmpeq_epi32(
+            _mm256_loadu_si256((__m256i const*)(row + j)), wanted);
+        column = _mm256_and_si256(match, _mm256_add_epi32(one,
+            _mm256_loadu_si256((__m256i const*)(runs->columns + j))));
+        falling = _mm256_and_si256(match, _mm256_add_epi32(one,
+            _mm256_loadu_si256((__m256i const*)(runs->falling + j))));
+        rising = _mm256_and_si256(match, _mm256_add_epi32(one,
+            _mm256_loadu_si256((__m256i const*)(runs->rising + j + 2u))));
+
+        _mm256_storeu_si256((__m256i*)(runs->columns + j), column);
+        _mm256_storeu_si256((__m256i*)(runs->nextFalling + j + 1u), falling);
+        _mm256_storeu_si256((__m256i*)(runs->nextRising + j + 1u), rising);
+
+        won = _mm256_or_si256(won, _mm256_or_si256(
+            _mm256_cmpgt_epi32(column, shortest),
+            _mm256_or_si256(_mm256_cmpgt_epi32(falling, shortest),
+                _mm256_cmpgt_epi32(rising, shortest))));
+    }
+
+    return !_mm256_testz_si256(won, won);
+}
+
+
+/* Same as sse2UpdateRuns(), one column at a time, for the columns from first
+   to the end of the row that don't fill a whole vector. */
+static int scalarUpdateRuns(CellStatus const* row, unsigned first,
+    unsigned columns, CellStatus status, unsigned k, LineRuns const* runs)
+{
+    unsigned j = 0;
+    int match = 0;
+    int win = 0;
+
+    for (j = first; j < columns; ++j)
+    {
+        match = row[j] == status;
+        runs->columns[j] = match ? runs->columns[j] + 1u : 0;
+        runs->nextFalling[j + 1u] = match ? runs->falling[j] + 1u : 0;
+        runs->nextRising[j + 1u] = match ? runs->rising[j + 2u] + 1u : 0;
+
+        win = win || runs->columns[j] >= k || runs->nextFalling[j + 1u] >= k
+            || runs->nextRising[j + 1u] >= k;
+    }
+
+    return win;
+}
+
+
+/* Checks if the given status occurs consecutively enough down any column or
+   diagonal to be a win, following every column at once with the kernel. */
+static int linesHaveWon(GameBoard const* board, CellStatus status,
+    WinScanKernel kernel)
+{
+    size_t const width = board->columns + 2u;
+    unsigned* const buffer = calloc(5u * width, sizeof(unsigned));
+    unsigned const lanes = kernel == WIN_SCAN_AVX2 ? 8u : 4u;
+    unsigned const vectorColumns = board->columns - board->columns % lanes;
+    unsigned const k = board->winRequirement;
+    CellStatus const* row = NULL;
+    unsigned* swap = NULL;
+    LineRuns runs;
+    unsigned long i = 0;
+    int win = 0;
+
+    runs.columns = buffer;
+    runs.falling = buffer + width;
+    runs.nextFalling = runs.falling + width;
+    runs.rising = runs.nextFalling + width;
+    runs.nextRising = runs.rising + width;
+
+    for (i = 0; i < board->rows && !win; ++i)
+    {
+        row = board->cells + i * board->columns;
+        win = kernel == WIN_SCAN_AVX2
+            ? avx2UpdateRuns(row, vectorColumns, status, k, &runs)
+            : sse2UpdateRuns(row, vectorColumns, status, k, &runs);
+        win = scalarUpdateRuns(row, vectorColumns, board->columns, status, k,
+            &runs) || win;
+
+        swap = runs.falling;
+        runs.falling = runs.nextFalling;
+        runs.nextFalling = swap;
+        swap = runs.rising;
+        runs.rising = runs.nextRising;
+        runs.nextRising = swap;
+    }
+
+    free(buffer);
+
+    return win;
+}
+
+#endif
+
+
+
+/* PUBLIC INTERFACE */
+
+
+int winScanKernelSupported(WinScanKernel kernel)
+{
+    int supported = kernel == WIN_SCAN_AUTO || kernel == WIN_SCAN_SCALAR;
+
+#ifdef WIN_SCAN_X86
+    /* The kernels compare cells as 32 bit integers. */
+    if (sizeof(CellStatus) == 4u)
+    {
+        supported = supported
+            || (kernel == WIN_SCAN_SSE2 && __builtin_cpu_supports("sse2"))
+            || (kernel == WIN_SCAN_AVX2 && __builtin_cpu_supports("avx2"));
+    }
+#endif
+
+    return supported;
+}
+
+
+int selectWinScanKernel(WinScanKernel kernel)
+{
+    int const supported = winScanKernelSupported(kernel);
+
+    if (supported)
+    {
+        selectedKernel = kernel;
+    }
+
+    return supported;
+}
+
+
+WinScanKernel activeWinScanKernel(void)
+{
+    WinScanKernel kernel = selectedKernel;
+
+    if (kernel == WIN_SCAN_AUTO)
+    {
+        kernel = winScanKernelSupported(WIN_SCAN_AVX2) ? WIN_SCAN_AVX2
+            : winScanKernelSupported(WIN_SCAN_SSE2) ? WIN_SCAN_SSE2
+            : WIN_SCAN_SCALAR;
+    }
+
+    return kernel;
+}
+
+
+char const* winScanKernelName(WinScanKernel kernel)
+{
+    char const* name = NULL;
+
+    switch (kernel)
+    {
+        case WIN_SCAN_AUTO:
+            name = "auto";
+            break;
+        case WIN_SCAN_SCALAR:
+            name = "scalar";
+            break;
+        case WIN_SCAN_SSE2:
+            name = "sse2";
+            break;
+        case WIN_SCAN_AVX2:
+            name = "avx2";
+            break;
+    }
+
+    return name;
+}
+
+
+int vectorHasWon(GameBoard const* board, CellStatus status,
+    WinScanKernel kernel)
+{
+    int win = 0;
+
+    assert(board->backend == BOARD_BACKEND_ARRAY);
+    assert((kernel == WIN_SCAN_SSE2 || kernel == WIN_SCAN_AVX2)
+        && winScanKernelSupported(kernel));
+
+#ifdef WIN_SCAN_X86
+    win = rowsHaveWon(board, status, kernel)
+        || linesHaveWon(board, status, kernel);
+#endif
+
+    return win;
+}
@@ -0,0 +1,50 @@
+/* Vectorised full-board win scans for boards using BOARD_BACKEND_ARRAY, which
+   compare several cells per instruction with SSE2 or AVX2 where the processor
+   supports them. */
+
+#ifndef WIN_SCAN_H
+#define WIN_SCAN_H
+
+#include "board.h"
+
+
+/* Selects the code used to scan a board's cells for wins. */
+typedef enum
+{
+    WIN_SCAN_AUTO,      /* The fastest kernel the processor supports. */
+    WIN_SCAN_SCALAR,    /* One cell at a time, with no SIMD instructions. */
+    WIN_SCAN_SSE2,      /* Four cells per instruction. */
+    WIN_SCAN_AVX2       /* Eight cells per instruction. */
+} WinScanKernel;
+
+
+/* Checks if the program was built with a kernel and the processor it is
+   running on can execute it. WIN_SCAN_AUTO and WIN_SCAN_SCALAR are always
+   supported. */
+int winScanKernelSupported(WinScanKernel kernel);
+
+/* Sets the kernel hasPlayerWon() scans boards using BOARD_BACKEND_ARRAY with,
+   for every board. WIN_SCAN_AUTO is the default. Not thread safe; meant to be
+   called before any boards are scanned, such as by tests and benchmarks.
+   Returns 0, changing nothing, if the kernel isn't supported. */
+int selectWinScanKernel(WinScanKernel kernel);
+
+/* Returns the kernel set by selectWinScanKernel(), with WIN_SCAN_AUTO
+   resolved to the fastest supported kernel. */
+WinScanKernel activeWinScanKernel(void);
+
+/* Returns the name of a kernel, such as "avx2". */
+char const* winScanKernelName(WinScanKernel kernel);
+
+/* Checks if the given status has a win on a board using BOARD_BACKEND_ARRAY,
+   with a vector kernel, WIN_SCAN_SSE2 or WIN_SCAN_AVX2, which must be
+   supported.
+   Rows are compared into bit masks of matching cells, which are searched for
+   runs of winRequirement set bits. Columns and both diagonals are followed
+   down the board for every column at once, keeping the run lengths ending at
+   each cell of the row above. */
+int vectorHasWon(GameBoard const* board, CellStatus status,
+    WinScanKernel kernel);
+
+
+#endif
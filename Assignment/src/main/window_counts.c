@@ -0,0 +1,281 @@
+/* Per-window cell counts for the game board. */
+
+#include "window_counts.h"
+
+#include "common.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Row and column steps of the four window directions. Each goes down or along
+   a row, so a window's first cell has its lowest row. */
+static int const ROW_STEPS[4] = {0, 1, 1, 1};
+static int const COLUMN_STEPS[4] = {1, 0, 1, -1};
+
+
+/* Gets the number of window start positions along one axis of the board.
+   step is that axis' step of the direction (-1, 0 or 1). */
+static unsigned long windowStarts(unsigned size, int step,
+    unsigned winRequirement)
+{
+    unsigned long starts = size;
+
+    if (step != 0)
+    {
+        starts = winRequirement <= size ? size - winRequirement + 1ul : 0;
+    }
+
+    return starts;
+}
+
+
+/* Narrows [*first, *last], the positions within a window that a cell may
+   have, to those where the whole window fits along one axis of the board.
+   position is the cell's position along the axis, and step is the axis' step
+   of the direction. */
+static void limitWindowOffsets(unsigned position, int step, unsigned size,
+    unsigned winRequirement, long* first, long* last)
+{
+    long lowest = 0;
+    long highest = 0;
+
+    if (step > 0)
+    {
+        /* The window must start at or after 0 and end before size. */
+        lowest = (long)position + winRequirement - size;
+        highest = position;
+    }
+    else if (step < 0)
+    {
+        /* The window must start before size and end at or after 0. */
+        lowest = (long)winRequirement - 1l - position;
+        highest = (long)size - 1l - position;
+    }
+    else
+    {
+        lowest = *first;
+        highest = *last;
+    }
+
+    if (lowest > *first)
+    {
+        *first = lowest;
+    }
+    if (highest < *last)
+    {
+        *last = highest;
+    }
+}
+
+
+/* Adds delta to the number of windows in the state given by a window's X and
+   O counts. */
+static void countWindowState(WindowCounts* windows, unsigned xCount,
+    unsigned oCount, long delta)
+{
+    if (xCount > 0 && oCount > 0)
+    {
+        windows->dead += delta;
+    }
+    else if (xCount > 0)
+    {
+        windows->open[PLAYER_X][xCount] += delta;
+    }
+    else if (oCount > 0)
+    {
+        windows->open[PLAYER_O][oCount] += delta;
+    }
+    else
+    {
+        windows->empty += delta;
+    }
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+WindowCounts zeroedWindowCounts(void)
+{
+    WindowCounts windows;
+
+    windows.rows = 0;
+    windows.columns = 0;
+    windows.winRequirement = 0;
+    windows.maxCount = 0;
+    windows.counts = NULL;
+    windows.open[PLAYER_X] = NULL;
+    windows.open[PLAYER_O] = NULL;
+    windows.empty = 0;
+    windows.dead = 0;
+    windows.total = 0;
+
+    return windows;
+}
+
+
+WindowCounts createWindowCounts(unsigned rows, unsigned columns,
+    unsigned winRequirement)
+{
+    WindowCounts windows = zeroedWindowCounts();
+    size_t const cells = (size_t)rows * columns;
+    unsigned d = 0;
+
+    assert(rows > 0);
+    assert(columns > 0);
+    assert(winRequirement > 0);
+    assert(rows <= (size_t)-1 / columns / (8u * sizeof(unsigned)));
+
+    windows.rows = rows;
+    windows.columns = columns;
+    windows.winRequirement = winRequirement;
+
+    for (d = 0; d < 4; ++d)
+    {
+        windows.total += windowStarts(rows, ROW_STEPS[d], winRequirement)
+            * windowStarts(columns, COLUMN_STEPS[d], winRequirement);
+    }
+    windows.maxCount = windows.total > 0 ? winRequirement : 0;
+
+    windows.counts = malloc(cells * 8u * sizeof(unsigned));
+    windows.open[PLAYER_X] = malloc((windows.maxCount + 1ul)
+        * sizeof(unsigned long));
+    windows.open[PLAYER_O] = malloc((windows.maxCount + 1ul)
+        * sizeof(unsigned long));
+
+    clearWindowCounts(&windows);
+
+    return windows;
+}
+
+
+WindowCounts copyWindowCounts(WindowCounts const* windows)
+{
+    WindowCounts copy = *windows;
+    size_t const countsSize = (size_t)windows->rows * windows->columns * 8u
+        * sizeof(unsigned);
+    size_t const openSize = (windows->maxCount + 1ul) * sizeof(unsigned long);
+
+    copy.counts = malloc(countsSize);
+    memcpy(copy.counts, windows->counts, countsSize);
+    copy.open[PLAYER_X] = malloc(openSize);
+    memcpy(copy.open[PLAYER_X], windows->open[PLAYER_X], openSize);
+    copy.open[PLAYER_O] = malloc(openSize);
+    memcpy(copy.open[PLAYER_O], windows->open[PLAYER_O], openSize);
+
+    return copy;
+}
+
+
+void destroyWindowCounts(WindowCounts* windows)
+{
+    free(windows->counts);
+    free(windows->open[PLAYER_X]);
+    free(windows->open[PLAYER_O]);
+    *windows = zeroedWindowCounts();
+}
+
+
+void clearWindowCounts(WindowCounts* windows)
+{
+    size_t const cells = (size_t)windows->rows * windows->columns;
+    unsigned i = 0;
+
+    memset(windows->counts, 0, cells * 8u * sizeof(unsigned));
+    for (i = 0; i <= windows->maxCount; ++i)
+    {
+        windows->open[PLAYER_X][i] = 0;
+        windows->open[PLAYER_O][i] = 0;
+    }
+    windows->empty = windows->total;
+    windows->dead = 0;
+}
+
+
+void updateWindowCounts(WindowCounts* windows, Player player, unsigned row,
+    unsigned column, int added)
+{
+    size_t const cells = (size_t)windows->rows * windows->columns;
+    unsigned* count = NULL;
+    size_t start = 0;
+    long first = 0;
+    long last = 0;
+    long offset = 0;
+    unsigned d = 0;
+
+    assert(row < windows->rows && column < windows->columns);
+
+    for (d = 0; d < 4; ++d)
+    {
+        /* Offsets of the cell within the windows containing it. */
+        first = 0;
+        last = (long)windows->winRequirement - 1l;
+        limitWindowOffsets(row, ROW_STEPS[d], windows->rows,
+            windows->winRequirement, &first, &last);
+        limitWindowOffsets(column, COLUMN_STEPS[d], windows->columns,
+            windows->winRequirement, &first, &last);
+
+        for (offset = first; offset <= last; ++offset)
+        {
+            start = (size_t)(row - ROW_STEPS[d] * offset) * windows->columns
+                + (size_t)(column - COLUMN_STEPS[d] * offset);
+            count = windows->counts + 2u * (d * cells + start);
+
+            countWindowState(windows, count[PLAYER_X], count[PLAYER_O], -1l);
+            if (added)
+            {
+                ++count[player];
+            }
+            else
+            {
+                assert(count[player] > 0);
+                --count[player];
+            }
+            countWindowState(windows, count[PLAYER_X], count[PLAYER_O], 1l);
+        }
+    }
+}
+
+
+unsigned long countOpenWindows(WindowCounts const* windows, Player player,
+    unsigned count)
+{
+    unsigned long open = 0;
+
+    if (count == 0)
+    {
+        open = windows->empty;
+    }
+    else if (count <= windows->maxCount)
+    {
+        open = windows->open[player][count];
+    }
+
+    return open;
+}
+
+
+unsigned long countDeadWindows(WindowCounts const* windows)
+{
+    return windows->dead;
+}
+
+
+int windowCountsHasWon(WindowCounts const* windows, Player player)
+{
+    return windows->maxCount > 0
+        && windows->open[player][windows->maxCount] > 0;
+}
+
+
+int windowCountsAllDead(WindowCounts const* windows)
+{
+    return windows->dead == windows->total;
+}
@@ -0,0 +1,80 @@
+/* Per-window cell counts for the game board.
+   A window is any winRequirement long run of cells along a row, column or
+   diagonal. For each window the number of X and O cells in it is kept, along
+   with how many windows are in each state, so wins and threats can be queried
+   in O(1) instead of rescanning the board. Each cell update costs
+   O(winRequirement) per direction. */
+
+#ifndef WINDOW_COUNTS_H
+#define WINDOW_COUNTS_H
+
+#include "common.h"
+
+#include <stddef.h>
+
+
+/* Window count data.
+   Use createWindowCounts to properly create it, and destroyWindowCounts to
+   properly destroy it. */
+typedef struct
+{
+    unsigned rows;              /* Height of the board. */
+    unsigned columns;           /* Width of the board. */
+    unsigned winRequirement;    /* Length of each window. */
+    unsigned maxCount;          /* Most cells a window can hold (0 if no
+                                   windows fit on the board). */
+    /* X and O counts of the window starting at each cell, in each direction.
+       Windows are indexed by direction, then row-major start cell, then
+       Player. Entries for windows that don't fit on the board are unused. */
+    unsigned* counts;
+    unsigned long* open[2];     /* Number of windows holding each count
+                                   (1 to maxCount) of a player's cells and none
+                                   of the other's, indexed by Player. */
+    unsigned long empty;        /* Windows with no cells occupied. */
+    unsigned long dead;         /* Windows holding cells of both players. */
+    unsigned long total;        /* Windows on the board. */
+} WindowCounts;
+
+
+/* Returns a WindowCounts object with all members zeroed out. */
+WindowCounts zeroedWindowCounts(void);
+
+/* Creates window counts for an empty board with the given dimensions.
+   rows, columns and winRequirement must all be >0. Memory required is
+   proportional to rows * columns. */
+WindowCounts createWindowCounts(unsigned rows, unsigned columns,
+    unsigned winRequirement);
+
+/* Creates an independent copy of window counts. */
+WindowCounts copyWindowCounts(WindowCounts const* windows);
+
+/* Destroys window counts (deallocates resources, etc.). */
+void destroyWindowCounts(WindowCounts* windows);
+
+/* Resets the counts to those of an empty board. */
+void clearWindowCounts(WindowCounts* windows);
+
+/* Adds (if added is non-zero) or removes a player's cell, updating every
+   window containing it. A removed cell must have been added before.
+   row and column must be within the bounds of the board. */
+void updateWindowCounts(WindowCounts* windows, Player player, unsigned row,
+    unsigned column, int added);
+
+/* Gets the number of windows holding exactly count of a player's cells and
+   none of the other player's. A count of 0 gives the empty windows. */
+unsigned long countOpenWindows(WindowCounts const* windows, Player player,
+    unsigned count);
+
+/* Gets the number of windows holding cells of both players, which can never
+   be won. */
+unsigned long countDeadWindows(WindowCounts const* windows);
+
+/* Checks if any window is filled by the given player. */
+int windowCountsHasWon(WindowCounts const* windows, Player player);
+
+/* Checks if every window holds cells of both players, so neither can ever
+   win. Also true if no windows fit on the board. */
+int windowCountsAllDead(WindowCounts const* windows);
+
+
+#endif
@@ -0,0 +1,214 @@
+/* Unit tests for the bitboard module. */
+
+#include "bitboard_test.h"
+
+#include "common.h"
+#include "../main/bitboard.h"
+#include "../main/common.h"
+#include "../main/threads.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+
+/* Controls the maximum dimensions of the bitboard when testing. */
+#define TEST_SIZE 70u
+
+/* Checks run by concurrentHasWonTest(), spread over its threads. */
+#define CONCURRENT_CHECKS 4000ul
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Tests zeroedBitBoard(). */
+static void zeroedBitBoardTest(void)
+{
+    BitBoard bits = zeroedBitBoard();
+    assert(bits.rows == 0);
+    assert(bits.columns == 0);
+    assert(bits.planes[PLAYER_X] == NULL);
+    assert(bits.planes[PLAYER_O] == NULL);
+}
+
+
+/* Tests createBitBoard(), setBitBoardBit(), getBitBoardBit(),
+   clearBitBoard() and destroyBitBoard(). */
+static void setGetBitTest(void)
+{
+    BitBoard bits = zeroedBitBoard();
+    unsigned rows = 0;
+    unsigned columns = 0;
+    unsigned i = 0;
+    unsigned j = 0;
+
+    /* Sizes either side of word boundaries. */
+    for (rows = 1u; rows < TEST_SIZE; rows += 3u)
+    {
+        for (columns = 1u; columns < TEST_SIZE; ++columns)
+        {
+            bits = createBitBoard(rows, columns);
+            assert(bits.stride == columns + 1u);
+
+            for (i = 0; i < rows; ++i)
+            {
+                for (j = 0; j < columns; ++j)
+                {
+                    assert(!getBitBoardBit(&bits, PLAYER_X, i, j));
+                    assert(!getBitBoardBit(&bits, PLAYER_O, i, j));
+                    setBitBoardBit(&bits, (i + j) % 2u ? PLAYER_X : PLAYER_O,
+                        i, j, 1);
+                }
+            }
+
+            for (i = 0; i < rows; ++i)
+            {
+                for (j = 0; j < columns; ++j)
+                {
+                    assert(getBitBoardBit(&bits, PLAYER_X, i, j)
+                        == ((i + j) % 2u == 1u));
+                    assert(getBitBoardBit(&bits, PLAYER_O, i, j)
+                        == ((i + j) % 2u == 0u));
+                    setBitBoardBit(&bits, PLAYER_X, i, j, 0);
+                    assert(!getBitBoardBit(&bits, PLAYER_X, i, j));
+                }
+            }
+
+            clearBitBoard(&bits);
+            for (i = 0; i < rows; ++i)
+            {
+                for (j = 0; j < columns; ++j)
+                {
+                    assert(!getBitBoardBit(&bits, PLAYER_O, i, j));
+                }
+            }
+
+            destroyBitBoard(&bits);
+            assert(bits.planes[PLAYER_X] == NULL);
+        }
+    }
+}
+
+
+/* Tests bitBoardHasWon(). */
+static void bitBoardHasWonTest(void)
+{
+    BitBoard bits = zeroedBitBoard();
+    unsigned i = 0;
+
+    /* Empty. */
+    bits = createBitBoard(5, 5);
+    assert(!bitBoardHasWon(&bits, PLAYER_X, 1));
+    assert(!bitBoardHasWon(&bits, PLAYER_O, 3));
+    destroyBitBoard(&bits);
+
+    /* Run along a row crossing a word boundary. */
+    bits = createBitBoard(3, 100);
+    for (i = 60; i < 70; ++i)
+    {
+        setBitBoardBit(&bits, PLAYER_X, 1, i, 1);
+    }
+    assert(bitBoardHasWon(&bits, PLAYER_X, 10));
+    assert(!bitBoardHasWon(&bits, PLAYER_X, 11));
+    assert(!bitBoardHasWon(&bits, PLAYER_O, 1));
+    destroyBitBoard(&bits);
+
+    /* Run wrapping from the end of one row to the start of the next must not
+       count. */
+    bits = createBitBoard(4, 5);
+    setBitBoardBit(&bits, PLAYER_O, 0, 3, 1);
+    setBitBoardBit(&bits, PLAYER_O, 0, 4, 1);
+    setBitBoardBit(&bits, PLAYER_O, 1, 0, 1);
+    setBitBoardBit(&bits, PLAYER_O, 1, 1, 1);
+    assert(!bitBoardHasWon(&bits, PLAYER_O, 3));
+    assert(bitBoardHasWon(&bits, PLAYER_O, 2));
+    destroyBitBoard(&bits);
+
+    /* Column spanning many words. */
+    bits = createBitBoard(40, 90);
+    for (i = 5; i < 35; ++i)
+    {
+        setBitBoardBit(&bits, PLAYER_O, i, 89, 1);
+    }
+    assert(bitBoardHasWon(&bits, PLAYER_O, 30));
+    assert(!bitBoardHasWon(&bits, PLAYER_O, 31));
+    destroyBitBoard(&bits);
+
+    /* Rising diagonal touching the left edge, with a cell that would continue
+       it if the run wrapped onto the previous row. */
+    bits = createBitBoard(6, 6);
+    setBitBoardBit(&bits, PLAYER_X, 3, 0, 1);
+    setBitBoardBit(&bits, PLAYER_X, 2, 1, 1);
+    setBitBoardBit(&bits, PLAYER_X, 1, 2, 1);
+    setBitBoardBit(&bits, PLAYER_X, 3, 5, 1);
+    assert(bitBoardHasWon(&bits, PLAYER_X, 3));
+    assert(!bitBoardHasWon(&bits, PLAYER_X, 4));
+    destroyBitBoard(&bits);
+
+    /* Falling diagonal touching the right edge. */
+    bits = createBitBoard(6, 6);
+    setBitBoardBit(&bits, PLAYER_X, 2, 3, 1);
+    setBitBoardBit(&bits, PLAYER_X, 3, 4, 1);
+    setBitBoardBit(&bits, PLAYER_X, 4, 5, 1);
+    setBitBoardBit(&bits, PLAYER_X, 5, 0, 1);
+    assert(bitBoardHasWon(&bits, PLAYER_X, 3));
+    assert(!bitBoardHasWon(&bits, PLAYER_X, 4));
+    destroyBitBoard(&bits);
+
+    /* Single column board. */
+    bits = createBitBoard(4, 1);
+    setBitBoardBit(&bits, PLAYER_X, 1, 0, 1);
+    setBitBoardBit(&bits, PLAYER_X, 2, 0, 1);
+    assert(bitBoardHasWon(&bits, PLAYER_X, 2));
+    assert(!bitBoardHasWon(&bits, PLAYER_X, 3));
+    destroyBitBoard(&bits);
+}
+
+
+
+/* Task for concurrentHasWonTest(): checks the shared bitboard for either
+   player's win. */
+static void concurrentHasWonTask(unsigned long index, unsigned _,
+    void* context)
+{
+    BitBoard const* const bits = context;
+    Player const player = index % 2u == 0 ? PLAYER_X : PLAYER_O;
+
+    /* Only X has a line. */
+    assert(bitBoardHasWon(bits, player, 5) == (player == PLAYER_X));
+}
+
+
+/* Tests bitBoardHasWon() on the same const bitboard from several threads at
+   once. */
+static void concurrentHasWonTest(void)
+{
+    BitBoard bits = createBitBoard(64, 64);
+    unsigned i = 0;
+
+    for (i = 0; i < 5; ++i)
+    {
+        setBitBoardBit(&bits, PLAYER_X, 40, 10u + i, 1);
+        setBitBoardBit(&bits, PLAYER_O, i * 2u, i * 3u, 1);
+    }
+
+    runWorkStealing(CONCURRENT_CHECKS, 4, concurrentHasWonTask, &bits, NULL);
+
+    destroyBitBoard(&bits);
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+void bitBoardTest(void)
+{
+    moduleTestHeader("bitboard");
+
+    runUnitTest("zeroedBitBoard()", zeroedBitBoardTest);
+    runUnitTest("setBitBoardBit() and getBitBoardBit()", setGetBitTest);
+    runUnitTest("bitBoardHasWon()", bitBoardHasWonTest);
+    runUnitTest("bitBoardHasWon() from several threads",
+        concurrentHasWonTest);
+}
@@ -0,0 +1,11 @@
+/* Unit tests for the bitboard module. */
+
+#ifndef TESTS_BITBOARD_TEST_H
+#define TESTS_BITBOARD_TEST_H
+
+
+/* Runs the tests for the bitboard module. */
+void bitBoardTest(void);
+
+
+#endif
@@ -7,6 +7,7 @@
 #include "../main/common.h"
 
 #include <assert.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -401,6 +402,853 @@ static void hasPlayerWonTest(void)
 }
 
 
+/* Tests hasPlayerWonAt() against specific positions. */
+static void hasPlayerWonAtTest(void)
+{
+    GameBoard board = zeroedGameBoard();
+
+    /* Empty cell. */
+    board = createGameBoard(3, 3, 1);
+    assert(!hasPlayerWonAt(&board, 1, 1));
+    destroyGameBoard(&board);
+
+    /* K=1 */
+    board = createGameBoard(4, 3, 1);
+    setBoardCell(&board, 3, 2, CELL_X);
+    assert(hasPlayerWonAt(&board, 3, 2));
+    destroyGameBoard(&board);
+
+    /* Horizontal win, checked from each cell of the line. */
+    board = createGameBoard(4, 7, 4);
+    setBoardCell(&board, 2, 2, CELL_O);
+    setBoardCell(&board, 2, 3, CELL_O);
+    setBoardCell(&board, 2, 4, CELL_O);
+    setBoardCell(&board, 2, 5, CELL_O);
+    setBoardCell(&board, 2, 6, CELL_X);
+    assert(hasPlayerWonAt(&board, 2, 2));
+    assert(hasPlayerWonAt(&board, 2, 3));
+    assert(hasPlayerWonAt(&board, 2, 4));
+    assert(hasPlayerWonAt(&board, 2, 5));
+    assert(!hasPlayerWonAt(&board, 2, 6));
+    destroyGameBoard(&board);
+
+    /* Vertical win (edge). */
+    board = createGameBoard(10, 7, 4);
+    setBoardCell(&board, 6, 6, CELL_X);
+    setBoardCell(&board, 7, 6, CELL_X);
+    setBoardCell(&board, 8, 6, CELL_X);
+    setBoardCell(&board, 9, 6, CELL_X);
+    assert(hasPlayerWonAt(&board, 9, 6));
+    assert(hasPlayerWonAt(&board, 7, 6));
+    destroyGameBoard(&board);
+
+    /* Rising diagonal win, placed in the middle of the line. */
+    board = createGameBoard(7, 7, 4);
+    setBoardCell(&board, 5, 2, CELL_X);
+    setBoardCell(&board, 4, 3, CELL_X);
+    setBoardCell(&board, 3, 4, CELL_X);
+    setBoardCell(&board, 2, 5, CELL_X);
+    assert(hasPlayerWonAt(&board, 4, 3));
+    destroyGameBoard(&board);
+
+    /* Falling diagonal win from corner. */
+    board = createGameBoard(8, 10, 4);
+    setBoardCell(&board, 0, 0, CELL_O);
+    setBoardCell(&board, 1, 1, CELL_O);
+    setBoardCell(&board, 2, 2, CELL_O);
+    setBoardCell(&board, 3, 3, CELL_O);
+    assert(hasPlayerWonAt(&board, 0, 0));
+    assert(hasPlayerWonAt(&board, 3, 3));
+    destroyGameBoard(&board);
+
+    /* Line broken by the other player. */
+    board = createGameBoard(3, 5, 3);
+    setBoardCell(&board, 1, 0, CELL_X);
+    setBoardCell(&board, 1, 1, CELL_X);
+    setBoardCell(&board, 1, 2, CELL_O);
+    setBoardCell(&board, 1, 3, CELL_X);
+    assert(!hasPlayerWonAt(&board, 1, 1));
+    assert(!hasPlayerWonAt(&board, 1, 3));
+    destroyGameBoard(&board);
+
+    /* K>M>=N */
+    board = createGameBoard(4, 3, 5);
+    setBoardCell(&board, 0, 1, CELL_O);
+    setBoardCell(&board, 1, 1, CELL_O);
+    setBoardCell(&board, 2, 1, CELL_O);
+    setBoardCell(&board, 3, 1, CELL_O);
+    assert(!hasPlayerWonAt(&board, 3, 1));
+    destroyGameBoard(&board);
+}
+
+
+/* Verification mode for hasPlayerWonAt(): plays random games and checks after
+   every move that it agrees with the full board scan of hasPlayerWon(). */
+static void hasPlayerWonAtVerificationTest(void)
+{
+    GameBoard board = zeroedGameBoard();
+    unsigned rows = 0;
+    unsigned columns = 0;
+    unsigned winRequirement = 0;
+    unsigned row = 0;
+    unsigned column = 0;
+    unsigned long placed = 0;
+    int won = 0;
+    Player player = PLAYER_X;
+
+    for (rows = 1u; rows < TEST_SIZE / 2u; rows += 2u)
+    {
+        for (columns = 1u; columns < TEST_SIZE / 2u; columns += 2u)
+        {
+            for (winRequirement = 1u; winRequirement < 7u; ++winRequirement)
+            {
+                board = createGameBoard(rows, columns, winRequirement);
+                player = PLAYER_X;
+                won = 0;
+
+                for (placed = 0; placed < rows * columns && !won; ++placed)
+                {
+                    do
+                    {
+                        row = rand() % rows;
+                        column = rand() % columns;
+                    } while (getBoardCell(&board, row, column) != CELL_EMPTY);
+
+                    setBoardCell(&board, row, column, playerToCell(player));
+                    won = hasPlayerWonAt(&board, row, column);
+                    assert(won == hasPlayerWon(&board, player));
+
+                    player = player == PLAYER_X ? PLAYER_O : PLAYER_X;
+                }
+
+                destroyGameBoard(&board);
+            }
+        }
+    }
+}
+
+
+/* Checks that boards with the given backend behave the same as
+   BOARD_BACKEND_ARRAY boards, by filling both with the same random cells. */
+static void crossCheckBackend(BoardBackend backend)
+{
+    GameBoard arrayBoard = zeroedGameBoard();
+    GameBoard otherBoard = zeroedGameBoard();
+    unsigned rows = 0;
+    unsigned columns = 0;
+    unsigned winRequirement = 0;
+    unsigned i = 0;
+    unsigned j = 0;
+    CellStatus status;
+
+    for (rows = 1u; rows < TEST_SIZE / 2u; ++rows)
+    {
+        for (columns = 1u; columns < TEST_SIZE / 2u; ++columns)
+        {
+            for (winRequirement = 1u; winRequirement < 6u; ++winRequirement)
+            {
+                arrayBoard = createGameBoard(rows, columns, winRequirement);
+                otherBoard = createGameBoardWithBackend(rows, columns,
+                    winRequirement, backend);
+                assert(otherBoard.backend == backend);
+
+                for (i = 0; i < rows; ++i)
+                {
+                    for (j = 0; j < columns; ++j)
+                    {
+                        switch (rand() % 3u)
+                        {
+                            case 0: status = CELL_EMPTY; break;
+                            case 1: status = CELL_X; break;
+                            case 2: status = CELL_O; break;
+                            default: assert(0);
+                        }
+
+                        setBoardCell(&arrayBoard, i, j, status);
+                        setBoardCell(&otherBoard, i, j, status);
+                        assert(getBoardCell(&otherBoard, i, j) == status);
+                    }
+                }
+
+                assert(hasPlayerWon(&otherBoard, PLAYER_X)
+                    == hasPlayerWon(&arrayBoard, PLAYER_X));
+                assert(hasPlayerWon(&otherBoard, PLAYER_O)
+                    == hasPlayerWon(&arrayBoard, PLAYER_O));
+
+                clearBoardCells(&otherBoard);
+                for (i = 0; i < rows; ++i)
+                {
+                    for (j = 0; j < columns; ++j)
+                    {
+                        assert(getBoardCell(&otherBoard, i, j) == CELL_EMPTY);
+                    }
+                }
+                assert(!hasPlayerWon(&otherBoard, PLAYER_X));
+                assert(!hasPlayerWon(&otherBoard, PLAYER_O));
+
+                destroyGameBoard(&arrayBoard);
+                destroyGameBoard(&otherBoard);
+            }
+        }
+    }
+}
+
+
+/* Tests the BOARD_BACKEND_BITBOARD backend. */
+static void bitBoardBackendTest(void)
+{
+    crossCheckBackend(BOARD_BACKEND_BITBOARD);
+}
+
+
+/* Tests the BOARD_BACKEND_SPARSE backend. */
+static void sparseBackendTest(void)
+{
+    GameBoard board = zeroedGameBoard();
+    unsigned const max = UINT_MAX;
+
+    crossCheckBackend(BOARD_BACKEND_SPARSE);
+
+    /* Small boards stay as arrays. */
+    board = createGameBoard(100, 100, 3);
+    assert(board.backend == BOARD_BACKEND_ARRAY);
+    destroyGameBoard(&board);
+
+    /* Boards too large to allocate as arrays are chosen automatically. */
+    board = createGameBoard(max, max, 4);
+    assert(board.backend == BOARD_BACKEND_SPARSE);
+    assert(getBoardCell(&board, max - 1u, max - 1u) == CELL_EMPTY);
+    setBoardCell(&board, max - 1u, max - 1u, CELL_X);
+    setBoardCell(&board, max - 2u, max - 2u, CELL_X);
+    setBoardCell(&board, max - 3u, max - 3u, CELL_X);
+    setBoardCell(&board, 0, 0, CELL_O);
+    setBoardCell(&board, 0, max - 1u, CELL_O);
+    assert(!hasPlayerWon(&board, PLAYER_X));
+    assert(!hasPlayerWonAt(&board, max - 3u, max - 3u));
+    setBoardCell(&board, max - 4u, max - 4u, CELL_X);
+    assert(hasPlayerWon(&board, PLAYER_X));
+    assert(hasPlayerWonAt(&board, max - 4u, max - 4u));
+    assert(!hasPlayerWon(&board, PLAYER_O));
+    assert(getBoardCell(&board, 0, max - 1u) == CELL_O);
+    assert(getBoardCell(&board, max - 1u, 0) == CELL_EMPTY);
+    destroyGameBoard(&board);
+    assert(board.sparse.slots == NULL);
+}
+
+
+/* Tests hasPlayerWonParallel() against hasPlayerWon() on random boards tall
+   enough to be split into several bands, and on lines across the boundary
+   between the first two bands. */
+static void hasPlayerWonParallelTest(void)
+{
+    static unsigned const ROWS[] = {1, 63, 64, 65, 130, 200};
+    static unsigned const COLUMNS[] = {1, 6, 37};
+    static int const ROW_STEPS[] = {0, 1, 1, 1};
+    static int const COLUMN_STEPS[] = {1, 0, 1, -1};
+    GameBoard board = zeroedGameBoard();
+    unsigned r = 0;
+    unsigned c = 0;
+    unsigned winRequirement = 0;
+    unsigned threads = 0;
+    unsigned i = 0;
+    unsigned j = 0;
+    unsigned d = 0;
+
+    for (r = 0; r < sizeof ROWS / sizeof ROWS[0]; ++r)
+    {
+        for (c = 0; c < sizeof COLUMNS / sizeof COLUMNS[0]; ++c)
+        {
+            for (winRequirement = 1; winRequirement < 7u; ++winRequirement)
+            {
+                board = createGameBoard(ROWS[r], COLUMNS[c], winRequirement);
+                for (i = 0; i < board.rows; ++i)
+                {
+                    for (j = 0; j < board.columns; ++j)
+                    {
+                        /* Mostly X, so that longer wins happen sometimes. */
+                        setBoardCell(&board, i, j,
+                            rand() % 5u == 0 ? CELL_O : CELL_X);
+                    }
+                }
+
+                for (threads = 1; threads <= 4u; ++threads)
+                {
+                    assert(hasPlayerWonParallel(&board, PLAYER_X, threads)
+                        == hasPlayerWon(&board, PLAYER_X));
+                    assert(hasPlayerWonParallel(&board, PLAYER_O, threads)
+                        == hasPlayerWon(&board, PLAYER_O));
+                }
+                destroyGameBoard(&board);
+            }
+        }
+    }
+
+    /* A line in each direction from row 60, which is in the first band. All
+       but the row end in the second band. */
+    for (d = 0; d < 4u; ++d)
+    {
+        board = createGameBoard(150, 20, 5);
+        for (i = 0; i < 5u; ++i)
+        {
+            setBoardCell(&board, 60l + (long)i * ROW_STEPS[d],
+                10l + (long)i * COLUMN_STEPS[d], CELL_O);
+        }
+        assert(hasPlayerWonParallel(&board, PLAYER_O, 3));
+        assert(!hasPlayerWonParallel(&board, PLAYER_X, 3));
+        setBoardCell(&board, 60l + 4l * ROW_STEPS[d],
+            10l + 4l * COLUMN_STEPS[d], CELL_EMPTY);
+        assert(!hasPlayerWonParallel(&board, PLAYER_O, 3));
+        destroyGameBoard(&board);
+    }
+}
+
+
+/* Tests the position hash and occupied count maintained by setBoardCell(),
+   and nextPlayer(). */
+static void hashOccupiedTest(void)
+{
+    BoardBackend const backends[] = {BOARD_BACKEND_ARRAY,
+        BOARD_BACKEND_BITBOARD, BOARD_BACKEND_SPARSE};
+    GameBoard board = zeroedGameBoard();
+    unsigned long hash = 0;
+    unsigned i = 0;
+
+    for (i = 0; i < sizeof backends / sizeof backends[0]; ++i)
+    {
+        board = createGameBoardWithBackend(10, 12, 4, backends[i]);
+        assert(board.hash == 0);
+        assert(board.occupied == 0);
+        assert(nextPlayer(&board) == PLAYER_X);
+
+        setBoardCell(&board, 3, 4, CELL_X);
+        assert(board.hash == cellHashKey(3, 4, CELL_X));
+        assert(board.occupied == 1);
+        assert(nextPlayer(&board) == PLAYER_O);
+
+        setBoardCell(&board, 9, 11, CELL_O);
+        hash = board.hash;
+        assert(hash
+            == (cellHashKey(3, 4, CELL_X) ^ cellHashKey(9, 11, CELL_O)));
+        assert(board.occupied == 2);
+        assert(nextPlayer(&board) == PLAYER_X);
+
+        /* Overwriting replaces the cell's key without changing the count. */
+        setBoardCell(&board, 3, 4, CELL_O);
+        assert(board.hash
+            == (cellHashKey(3, 4, CELL_O) ^ cellHashKey(9, 11, CELL_O)));
+        assert(board.occupied == 2);
+        setBoardCell(&board, 3, 4, CELL_X);
+        assert(board.hash == hash);
+
+        setBoardCell(&board, 3, 4, CELL_EMPTY);
+        setBoardCell(&board, 9, 11, CELL_EMPTY);
+        assert(board.hash == 0);
+        assert(board.occupied == 0);
+
+        setBoardCell(&board, 0, 0, CELL_X);
+        clearBoardCells(&board);
+        assert(board.hash == 0);
+        assert(board.occupied == 0);
+
+        destroyGameBoard(&board);
+        assert(board.hash == 0);
+        assert(board.occupied == 0);
+    }
+
+    assert(cellHashKey(0, 0, CELL_EMPTY) == 0);
+    assert(cellHashKey(0, 0, CELL_X) != cellHashKey(0, 0, CELL_O));
+    assert(cellHashKey(0, 1, CELL_X) != cellHashKey(1, 0, CELL_X));
+}
+
+
+/* Asserts that a board's window counts match those found by scanning every
+   window of the board. */
+static void assertWindowCounts(GameBoard const* board)
+{
+    static int const ROW_STEPS[4] = {0, 1, 1, 1};
+    static int const COLUMN_STEPS[4] = {1, 0, 1, -1};
+    unsigned const k = board->winRequirement;
+    unsigned long open[2][6] = {{0}};
+    unsigned long empty = 0;
+    unsigned long dead = 0;
+    unsigned counts[3] = {0};
+    long lastRow = 0;
+    long lastColumn = 0;
+    unsigned i = 0;
+    unsigned j = 0;
+    unsigned d = 0;
+    unsigned step = 0;
+
+    for (i = 0; i < board->rows; ++i)
+    {
+        for (j = 0; j < board->columns; ++j)
+        {
+            for (d = 0; d < 4; ++d)
+            {
+                lastRow = i + ROW_STEPS[d] * ((long)k - 1);
+                lastColumn = j + COLUMN_STEPS[d] * ((long)k - 1);
+                if (lastColumn >= 0
+                    && inBoardBounds(board, lastRow, lastColumn))
+                {
+                    counts[CELL_X] = 0;
+                    counts[CELL_O] = 0;
+                    for (step = 0; step < k; ++step)
+                    {
+                        ++counts[getBoardCell(board, i + ROW_STEPS[d] * step,
+                            j + COLUMN_STEPS[d] * (long)step)];
+                    }
+
+                    if (counts[CELL_X] > 0 && counts[CELL_O] > 0)
+                    {
+                        ++dead;
+                    }
+                    else if (counts[CELL_X] > 0)
+                    {
+                        ++open[PLAYER_X][counts[CELL_X]];
+                    }
+                    else if (counts[CELL_O] > 0)
+                    {
+                        ++open[PLAYER_O][counts[CELL_O]];
+                    }
+                    else
+                    {
+                        ++empty;
+                    }
+                }
+            }
+        }
+    }
+
+    assert(countOpenWindows(&board->windows, PLAYER_X, 0) == empty);
+    assert(countDeadWindows(&board->windows) == dead);
+    for (i = 1; i <= k; ++i)
+    {
+        assert(countOpenWindows(&board->windows, PLAYER_X, i)
+            == open[PLAYER_X][i]);
+        assert(countOpenWindows(&board->windows, PLAYER_O, i)
+            == open[PLAYER_O][i]);
+    }
+}
+
+
+/* Tests enableWindowCounts() and the window counts kept by setBoardCell(). */
+static void windowCountsTest(void)
+{
+    BoardBackend const backends[] = {BOARD_BACKEND_ARRAY,
+        BOARD_BACKEND_BITBOARD};
+    GameBoard board = zeroedGameBoard();
+    GameBoard copy = zeroedGameBoard();
+    unsigned rows = 0;
+    unsigned columns = 0;
+    unsigned winRequirement = 0;
+    unsigned b = 0;
+    unsigned i = 0;
+    unsigned row = 0;
+    unsigned column = 0;
+    int won[2] = {0};
+
+    for (b = 0; b < sizeof backends / sizeof backends[0]; ++b)
+    {
+        for (rows = 1u; rows < 9u; ++rows)
+        {
+            for (columns = 1u; columns < 9u; ++columns)
+            {
+                for (winRequirement = 1u; winRequirement < 6u;
+                    ++winRequirement)
+                {
+                    board = createGameBoardWithBackend(rows, columns,
+                        winRequirement, backends[b]);
+                    assert(!hasWindowCounts(&board));
+
+                    /* Counts built from existing cells, then kept up to date
+                       through overwrites and removals. */
+                    setBoardCell(&board, rows / 2u, columns / 2u, CELL_X);
+                    enableWindowCounts(&board);
+                    assert(hasWindowCounts(&board));
+                    assertWindowCounts(&board);
+
+                    for (i = 0; i < 2u * rows * columns; ++i)
+                    {
+                        row = (unsigned)rand() % rows;
+                        column = (unsigned)rand() % columns;
+                        setBoardCell(&board, row, column,
+                            (CellStatus)((unsigned)rand() % 3u));
+                        assertWindowCounts(&board);
+                    }
+
+                    /* Wins agree with the usual scan, made on a copy that
+                       doesn't have the counts. */
+                    won[PLAYER_X] = hasPlayerWon(&board, PLAYER_X);
+                    won[PLAYER_O] = hasPlayerWon(&board, PLAYER_O);
+                    copy = copyGameBoard(&board);
+                    assert(hasWindowCounts(&copy));
+                    destroyWindowCounts(&copy.windows);
+                    assert(!hasWindowCounts(&copy));
+                    assert(won[PLAYER_X] == hasPlayerWon(&copy, PLAYER_X));
+                    assert(won[PLAYER_O] == hasPlayerWon(&copy, PLAYER_O));
+                    destroyGameBoard(&copy);
+
+                    clearBoardCells(&board);
+                    assertWindowCounts(&board);
+                    assert(!hasPlayerWon(&board, PLAYER_X));
+
+                    destroyGameBoard(&board);
+                    assert(!hasWindowCounts(&board));
+                }
+            }
+        }
+    }
+}
+
+
+/* Tests enableSmallWindowCounts() and isDeadDraw(). */
+static void deadDrawTest(void)
+{
+    GameBoard board = createGameBoard(3, 3, 3);
+
+    assert(enableSmallWindowCounts(&board));
+    assert(enableSmallWindowCounts(&board));
+    assert(!isDeadDraw(&board));
+
+    /* X O X
+       X O O
+       O . .  */
+    setBoardCell(&board, 0, 0, CELL_X);
+    setBoardCell(&board, 0, 1, CELL_O);
+    setBoardCell(&board, 0, 2, CELL_X);
+    setBoardCell(&board, 1, 0, CELL_X);
+    setBoardCell(&board, 1, 1, CELL_O);
+    setBoardCell(&board, 1, 2, CELL_O);
+    setBoardCell(&board, 2, 0, CELL_O);
+    assert(!isDeadDraw(&board));
+
+    /* Every line now has both players in it, with a cell still empty. */
+    setBoardCell(&board, 2, 1, CELL_X);
+    assert(isDeadDraw(&board));
+    setBoardCell(&board, 2, 1, CELL_EMPTY);
+    assert(!isDeadDraw(&board));
+    destroyGameBoard(&board);
+
+    /* No line fits at all. */
+    board = createGameBoard(3, 3, 4);
+    assert(enableSmallWindowCounts(&board));
+    assert(isDeadDraw(&board));
+    destroyGameBoard(&board);
+
+    /* Too large for counts. */
+    board = createGameBoard(WINDOW_COUNTS_MAX_CELLS / 4u + 1u, 4, 3);
+    assert(!enableSmallWindowCounts(&board));
+    destroyGameBoard(&board);
+    board = createGameBoardWithBackend(5, 5, 3, BOARD_BACKEND_SPARSE);
+    assert(!enableSmallWindowCounts(&board));
+    destroyGameBoard(&board);
+}
+
+
+/* Tests makeMove() and unmakeMove(). */
+static void makeUnmakeMoveTest(void)
+{
+    BoardBackend const backends[] = {BOARD_BACKEND_ARRAY,
+        BOARD_BACKEND_BITBOARD, BOARD_BACKEND_SPARSE};
+    unsigned long hashes[200] = {0};
+    GameBoard board = zeroedGameBoard();
+    GameBoard copy = zeroedGameBoard();
+    BoardMove move;
+    unsigned b = 0;
+    unsigned i = 0;
+    unsigned row = 0;
+    unsigned column = 0;
+    CellStatus status = CELL_EMPTY;
+
+    for (b = 0; b < sizeof backends / sizeof backends[0]; ++b)
+    {
+        board = createGameBoardWithBackend(8, 9, 4, backends[b]);
+        if (backends[b] != BOARD_BACKEND_SPARSE)
+        {
+            enableWindowCounts(&board);
+        }
+        setBoardCell(&board, 4, 4, CELL_X);
+        assert(board.moveCount == 0);
+
+        /* Random moves, including overwrites and clearing cells. */
+        for (i = 0; i < 200u; ++i)
+        {
+            hashes[i] = board.hash;
+            row = (unsigned)rand() % 8u;
+            column = (unsigned)rand() % 9u;
+            status = (CellStatus)((unsigned)rand() % 3u);
+            makeMove(&board, row, column, status);
+            assert(getBoardCell(&board, row, column) == status);
+            assert(board.moveCount == i + 1u);
+        }
+
+        copy = copyGameBoard(&board);
+        assert(copy.moveCount == 200);
+
+        for (i = 200u; i > 0; --i)
+        {
+            move = unmakeMove(&board);
+            assert(board.hash == hashes[i - 1u]);
+            assert(getBoardCell(&board, move.row, move.column)
+                == move.previous);
+            if (hasWindowCounts(&board))
+            {
+                assertWindowCounts(&board);
+            }
+        }
+        assert(board.moveCount == 0);
+        assert(board.occupied == 1);
+        assert(board.hash == cellHashKey(4, 4, CELL_X));
+        assert(getBoardCell(&board, 4, 4) == CELL_X);
+
+        /* The copy has its own move stack. */
+        move = unmakeMove(&copy);
+        assert(copy.hash == hashes[199]);
+        assert(copy.moveCount == 199);
+
+        makeMove(&copy, 0, 0, CELL_O);
+        clearBoardCells(&copy);
+        assert(copy.moveCount == 0);
+
+        destroyGameBoard(&copy);
+        destroyGameBoard(&board);
+        assert(board.moves == NULL);
+        assert(board.moveCount == 0);
+    }
+}
+
+
+/* Checks that each symmetric image of a board hashes the same as building
+   that image cell by cell. */
+static void assertSymmetryHashes(GameBoard const* board)
+{
+    GameBoard image = zeroedGameBoard();
+    unsigned const symmetries = countBoardSymmetries(board);
+    unsigned s = 0;
+    unsigned row = 0;
+    unsigned column = 0;
+    unsigned imageRow = 0;
+    unsigned imageColumn = 0;
+
+    assert(board->symmetryHashes[0] == board->hash);
+
+    for (s = 0; s < symmetries; ++s)
+    {
+        image = createGameBoard(board->rows, board->columns,
+            board->winRequirement);
+        for (row = 0; row < board->rows; ++row)
+        {
+            for (column = 0; column < board->columns; ++column)
+            {
+                imageRow = row;
+                imageColumn = column;
+                transformCell(board, s, &imageRow, &imageColumn);
+                setBoardCell(&image, imageRow, imageColumn,
+                    getBoardCell(board, row, column));
+            }
+        }
+        assert(image.hash == board->symmetryHashes[s]);
+        assert(canonicalHash(&image) == canonicalHash(board));
+        destroyGameBoard(&image);
+    }
+}
+
+
+/* Tests the symmetric image hashes and cell transforms. */
+static void symmetryTest(void)
+{
+    unsigned const sizes[][2] = {{5, 5}, {4, 7}, {1, 1}};
+    unsigned long hashes[50][BOARD_SYMMETRIES];
+    unsigned long cornerHash = 0;
+    GameBoard board = zeroedGameBoard();
+    unsigned i = 0;
+    unsigned s = 0;
+    unsigned row = 0;
+    unsigned column = 0;
+    unsigned r = 0;
+    unsigned c = 0;
+
+    for (i = 0; i < sizeof sizes / sizeof sizes[0]; ++i)
+    {
+        board = createGameBoard(sizes[i][0], sizes[i][1], 3);
+        assert(countBoardSymmetries(&board)
+            == (sizes[i][0] == sizes[i][1] ? 8u : 4u));
+
+        /* Transforms are permutations, undone by untransformCell(). */
+        for (s = 0; s < countBoardSymmetries(&board); ++s)
+        {
+            for (r = 0; r < board.rows; ++r)
+            {
+                for (c = 0; c < board.columns; ++c)
+                {
+                    row = r;
+                    column = c;
+                    transformCell(&board, s, &row, &column);
+                    assert(inBoardBounds(&board, row, column));
+                    untransformCell(&board, s, &row, &column);
+                    assert(row == r && column == c);
+                }
+            }
+        }
+
+        assertSymmetryHashes(&board);
+        destroyGameBoard(&board);
+    }
+
+    /* Random positions, then taking the moves back. */
+    board = createGameBoard(6, 6, 4);
+    for (i = 0; i < 50u; ++i)
+    {
+        for (s = 0; s < BOARD_SYMMETRIES; ++s)
+        {
+            hashes[i][s] = board.symmetryHashes[s];
+        }
+        makeMove(&board, (unsigned)rand() % 6u, (unsigned)rand() % 6u,
+            (CellStatus)((unsigned)rand() % 3u));
+        assertSymmetryHashes(&board);
+    }
+    for (i = 50u; i > 0; --i)
+    {
+        unmakeMove(&board);
+        for (s = 0; s < BOARD_SYMMETRIES; ++s)
+        {
+            assert(board.symmetryHashes[s] == hashes[i - 1u][s]);
+        }
+    }
+    assert(canonicalHash(&board) == 0);
+
+    /* A corner opening is the same position from every corner. */
+    setBoardCell(&board, 0, 0, CELL_X);
+    cornerHash = canonicalHash(&board);
+    for (i = 1; i < 4u; ++i)
+    {
+        clearBoardCells(&board);
+        setBoardCell(&board, i & 1u ? 5 : 0, i & 2u ? 5 : 0, CELL_X);
+        assert(canonicalHash(&board) == cornerHash);
+    }
+    setBoardCell(&board, 2, 3, CELL_O);
+    assert(canonicalHash(&board) != cornerHash);
+    destroyGameBoard(&board);
+}
+
+
+/* Tests copyGameBoard() and copyGameBoardWithoutWindowCounts(). */
+static void copyGameBoardTest(void)
+{
+    BoardBackend const backends[] = {BOARD_BACKEND_ARRAY,
+        BOARD_BACKEND_BITBOARD, BOARD_BACKEND_SPARSE};
+    GameBoard board = zeroedGameBoard();
+    GameBoard copy = zeroedGameBoard();
+    unsigned i = 0;
+
+    for (i = 0; i < sizeof backends / sizeof backends[0]; ++i)
+    {
+        board = createGameBoardWithBackend(6, 7, 3, backends[i]);
+        setBoardCell(&board, 1, 2, CELL_X);
+        setBoardCell(&board, 5, 6, CELL_O);
+
+        copy = copyGameBoard(&board);
+        assert(copy.backend == board.backend);
+        assert(copy.rows == 6 && copy.columns == 7);
+        assert(copy.winRequirement == 3);
+        assert(copy.hash == board.hash);
+        assert(copy.occupied == 2);
+        assert(getBoardCell(&copy, 1, 2) == CELL_X);
+        assert(getBoardCell(&copy, 5, 6) == CELL_O);
+
+        /* The copy is independent of the original. */
+        setBoardCell(&copy, 0, 0, CELL_X);
+        assert(getBoardCell(&board, 0, 0) == CELL_EMPTY);
+        assert(board.occupied == 2);
+        setBoardCell(&board, 4, 4, CELL_O);
+        assert(getBoardCell(&copy, 4, 4) == CELL_EMPTY);
+
+        destroyGameBoard(&copy);
+        destroyGameBoard(&board);
+    }
+
+    /* Window counts are copied too, unless left out. */
+    board = createGameBoard(6, 7, 3);
+    enableWindowCounts(&board);
+    setBoardCell(&board, 1, 2, CELL_X);
+    copy = copyGameBoard(&board);
+    assert(hasWindowCounts(&copy));
+    destroyGameBoard(&copy);
+    copy = copyGameBoardWithoutWindowCounts(&board);
+    assert(!hasWindowCounts(&copy) && hasWindowCounts(&board));
+    assert(getBoardCell(&copy, 1, 2) == CELL_X && copy.occupied == 1);
+    destroyGameBoard(&copy);
+    destroyGameBoard(&board);
+}
+
+
+/* Tests getOccupiedBounds(). */
+static void getOccupiedBoundsTest(void)
+{
+    GameBoard board = zeroedGameBoard();
+    unsigned minRow = 0;
+    unsigned minColumn = 0;
+    unsigned maxRow = 0;
+    unsigned maxColumn = 0;
+
+    board = createGameBoard(20, 30, 3);
+    assert(!getOccupiedBounds(&board, &minRow, &minColumn, &maxRow,
+        &maxColumn));
+
+    setBoardCell(&board, 7, 11, CELL_X);
+    assert(getOccupiedBounds(&board, &minRow, &minColumn, &maxRow,
+        &maxColumn));
+    assert(minRow == 7 && maxRow == 7);
+    assert(minColumn == 11 && maxColumn == 11);
+
+    setBoardCell(&board, 2, 25, CELL_O);
+    setBoardCell(&board, 15, 3, CELL_X);
+    assert(getOccupiedBounds(&board, &minRow, &minColumn, &maxRow,
+        &maxColumn));
+    assert(minRow == 2 && maxRow == 15);
+    assert(minColumn == 3 && maxColumn == 25);
+    destroyGameBoard(&board);
+
+    board = createGameBoard(UINT_MAX, UINT_MAX, 3);
+    setBoardCell(&board, UINT_MAX - 1u, 5, CELL_X);
+    setBoardCell(&board, 9, UINT_MAX - 2u, CELL_O);
+    assert(getOccupiedBounds(&board, &minRow, &minColumn, &maxRow,
+        &maxColumn));
+    assert(minRow == 9 && maxRow == UINT_MAX - 1u);
+    assert(minColumn == 5 && maxColumn == UINT_MAX - 2u);
+    destroyGameBoard(&board);
+}
+
+
+/* Tests hasNeighbour(), including at the edges of the board. */
+static void hasNeighbourTest(void)
+{
+    GameBoard board = createGameBoard(4, 5, 3);
+
+    assert(!hasNeighbour(&board, 0, 0));
+    setBoardCell(&board, 1, 1, CELL_X);
+    assert(hasNeighbour(&board, 0, 0));
+    assert(hasNeighbour(&board, 2, 2));
+    assert(hasNeighbour(&board, 0, 2));
+    assert(!hasNeighbour(&board, 1, 1));
+    assert(!hasNeighbour(&board, 3, 3));
+    assert(!hasNeighbour(&board, 1, 3));
+
+    setBoardCell(&board, 3, 4, CELL_O);
+    assert(hasNeighbour(&board, 2, 3));
+    assert(hasNeighbour(&board, 3, 3));
+    assert(!hasNeighbour(&board, 3, 4));
+    destroyGameBoard(&board);
+
+    board = createGameBoard(UINT_MAX, UINT_MAX, 3);
+    setBoardCell(&board, UINT_MAX - 1u, UINT_MAX - 1u, CELL_X);
+    assert(hasNeighbour(&board, UINT_MAX - 2u, UINT_MAX - 2u));
+    assert(!hasNeighbour(&board, UINT_MAX - 1u, UINT_MAX - 1u));
+    assert(!hasNeighbour(&board, 0, 0));
+    destroyGameBoard(&board);
+}
+
+
 /* Tests displayGameBoard(). */
 static void displayGameBoardTest(void)
 {
@@ -409,14 +1257,14 @@ static void displayGameBoardTest(void)
     printf("1x1 board:\n");
     board = createGameBoard(1, 1, 1);
     setBoardCell(&board, 0, 0, CELL_X);
-    displayGameBoard(&board);
+    assert(displayGameBoard(&board));
     destroyGameBoard(&board);
     printf("\n");
 
     printf("1x2 board:\n");
     board = createGameBoard(1, 2, 2);
     setBoardCell(&board, 0, 1, CELL_O);
-    displayGameBoard(&board);
+    assert(displayGameBoard(&board));
     destroyGameBoard(&board);
     printf("\n");
 
@@ -424,7 +1272,7 @@ static void displayGameBoardTest(void)
     board = createGameBoard(2, 1, 2);
     setBoardCell(&board, 1, 0, CELL_O);
     setBoardCell(&board, 0, 0, CELL_X);
-    displayGameBoard(&board);
+    assert(displayGameBoard(&board));
     destroyGameBoard(&board);
     printf("\n");
 
@@ -432,7 +1280,7 @@ static void displayGameBoardTest(void)
     board = createGameBoard(2, 2, 2);
     setBoardCell(&board, 0, 0, CELL_O);
     setBoardCell(&board, 1, 0, CELL_X);
-    displayGameBoard(&board);
+    assert(displayGameBoard(&board));
     destroyGameBoard(&board);
     printf("\n");
 
@@ -443,7 +1291,16 @@ static void displayGameBoardTest(void)
     setBoardCell(&board, 1, 1, CELL_X);
     setBoardCell(&board, 3, 6, CELL_X);
     setBoardCell(&board, 4, 6, CELL_O);
-    displayGameBoard(&board);
+    assert(displayGameBoard(&board));
+    destroyGameBoard(&board);
+    printf("\n");
+
+    /* Too big to print whole, so only the part around the moves is. */
+    printf("Huge board:\n");
+    board = createGameBoard(UINT_MAX, UINT_MAX, 5);
+    setBoardCell(&board, 3000000000u, 3000000000u, CELL_X);
+    setBoardCell(&board, 3000000004u, 3000000002u, CELL_O);
+    assert(displayGameBoard(&board));
     destroyGameBoard(&board);
     printf("\n");
 }
@@ -472,6 +1329,21 @@ void boardTest(void)
     runUnitTest("setBoardCell() and getBoardCell()", setGetBoardCellTest);
     runUnitTest("clearBoardCells()", clearBoardCellsTest);
     runUnitTest("hasPlayerWon()", hasPlayerWonTest);
+    runUnitTest("hasPlayerWonAt()", hasPlayerWonAtTest);
+    runUnitTest("hasPlayerWonAt() verification against hasPlayerWon()",
+        hasPlayerWonAtVerificationTest);
+    runUnitTest("Bitboard backend", bitBoardBackendTest);
+    runUnitTest("Sparse backend", sparseBackendTest);
+    runUnitTest("hasPlayerWonParallel()", hasPlayerWonParallelTest);
+    runUnitTest("Position hash, occupied count and nextPlayer()",
+        hashOccupiedTest);
+    runUnitTest("Window counts", windowCountsTest);
+    runUnitTest("Dead draw detection", deadDrawTest);
+    runUnitTest("makeMove() and unmakeMove()", makeUnmakeMoveTest);
+    runUnitTest("Symmetric position hashes", symmetryTest);
+    runUnitTest("copyGameBoard()", copyGameBoardTest);
+    runUnitTest("getOccupiedBounds()", getOccupiedBoundsTest);
+    runUnitTest("hasNeighbour()", hasNeighbourTest);
     runUnitTest("displayGameBoard()", displayGameBoardTest);
     runUnitTest("playerToCell()", playerToCellTest);
 }
@@ -0,0 +1,207 @@
+/* Unit tests for the opening book module. */
+
+#include "book_test.h"
+
+#include "common.h"
+#include "../main/board.h"
+#include "../main/book.h"
+#include "../main/search.h"
+
+#include <assert.h>
+#include <stdio.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Book file written by the tests, then removed. */
+#define TEST_FILE_PATH "book_test.tmp"
+
+
+/* Tests zeroedOpeningBook(). */
+static void zeroedOpeningBookTest(void)
+{
+    OpeningBook book = zeroedOpeningBook();
+
+    assert(book.count == 0);
+    assert(book.entries == NULL);
+    assert(book.ownedEntries == NULL);
+    assert(book.mapping == NULL);
+
+    /* Destroying a zeroed book is fine. */
+    destroyOpeningBook(&book);
+}
+
+
+/* Tests addBookMove() and bookMove() on positions equivalent under
+   symmetries. */
+static void symmetryTest(void)
+{
+    OpeningBook book = createOpeningBook(4, 4, 3);
+    GameBoard board = createGameBoard(4, 4, 3);
+    GameBoard other = createGameBoard(3, 4, 3);
+    unsigned row = 0;
+    unsigned column = 0;
+
+    assert(openingBookMatches(&book, &board));
+    assert(!openingBookMatches(&book, &other));
+    assert(!bookMove(&book, &board, &row, &column));
+
+    setBoardCell(&board, 0, 1, CELL_X);
+    addBookMove(&book, &board, 0, 2);
+    assert(book.count == 1);
+    assert(bookMove(&book, &board, &row, &column));
+    assert(row == 0 && column == 2);
+
+    /* Reflected in the main diagonal. */
+    clearBoardCells(&board);
+    setBoardCell(&board, 1, 0, CELL_X);
+    assert(bookMove(&book, &board, &row, &column));
+    assert(row == 2 && column == 0);
+
+    /* Reflected left to right. */
+    clearBoardCells(&board);
+    setBoardCell(&board, 0, 2, CELL_X);
+    assert(bookMove(&book, &board, &row, &column));
+    assert(row == 0 && column == 1);
+
+    /* Not equivalent. */
+    clearBoardCells(&board);
+    setBoardCell(&board, 1, 1, CELL_X);
+    assert(!bookMove(&book, &board, &row, &column));
+
+    /* Adding an equivalent position replaces the move. */
+    clearBoardCells(&board);
+    setBoardCell(&board, 3, 2, CELL_X);
+    addBookMove(&book, &board, 2, 2);
+    assert(book.count == 1);
+    clearBoardCells(&board);
+    setBoardCell(&board, 0, 1, CELL_X);
+    assert(bookMove(&book, &board, &row, &column));
+    assert(row == 1 && column == 1);
+
+    destroyOpeningBook(&book);
+    book = createOpeningBook(3, 4, 3);
+
+    /* Boards that aren't square only have 4 symmetries. */
+    setBoardCell(&other, 0, 0, CELL_X);
+    addBookMove(&book, &other, 1, 1);
+    clearBoardCells(&other);
+    setBoardCell(&other, 2, 3, CELL_X);
+    assert(bookMove(&book, &other, &row, &column));
+    assert(row == 1 && column == 2);
+
+    destroyGameBoard(&other);
+    destroyGameBoard(&board);
+    destroyOpeningBook(&book);
+}
+
+
+/* Tests buildOpeningBook(). */
+static void buildOpeningBookTest(void)
+{
+    SearchLimits limits = defaultSearchLimits();
+    OpeningBook book = zeroedOpeningBook();
+    GameBoard board = createGameBoard(3, 3, 3);
+    unsigned row = 0;
+    unsigned column = 0;
+
+    limits.softSeconds = 10.0;
+    limits.maxSeconds = 10.0;
+
+    /* The empty board, then a corner, edge or centre. */
+    book = buildOpeningBook(3, 3, 3, 2, limits, 0);
+    assert(book.count == 4);
+    assert(bookMove(&book, &board, &row, &column));
+    assert(row < 3 && column < 3);
+
+    setBoardCell(&board, 1, 1, CELL_X);
+    assert(bookMove(&book, &board, &row, &column));
+    assert(getBoardCell(&board, row, column) == CELL_EMPTY);
+    /* O has to take a corner to draw. */
+    assert(row != 1 && column != 1);
+
+    setBoardCell(&board, row, column, CELL_O);
+    assert(!bookMove(&book, &board, &row, &column));
+
+    destroyGameBoard(&board);
+    destroyOpeningBook(&book);
+}
+
+
+/* Tests writeOpeningBook() and openOpeningBook(). */
+static void fileTest(void)
+{
+    OpeningBook built = buildOpeningBook(4, 4, 3, 2, defaultSearchLimits(),
+        0);
+    OpeningBook opened = zeroedOpeningBook();
+    GameBoard board = createGameBoard(4, 4, 3);
+    unsigned builtRow = 0;
+    unsigned builtColumn = 0;
+    unsigned row = 0;
+    unsigned column = 0;
+    FILE* file = fopen(TEST_FILE_PATH, "wb");
+    int error = 0;
+
+    assert(file);
+    writeOpeningBook(file, &built);
+    assert(!ferror(file));
+    fclose(file);
+
+    opened = openOpeningBook(TEST_FILE_PATH, &error);
+    assert(!error);
+    assert(opened.mapping != NULL);
+    assert(opened.ownedEntries == NULL);
+    assert(opened.count == built.count);
+    assert(openingBookMatches(&opened, &board));
+
+    for (row = 0; row < 4u; ++row)
+    {
+        for (column = 0; column < 4u; ++column)
+        {
+            setBoardCell(&board, row, column, CELL_X);
+            assert(bookMove(&built, &board, &builtRow, &builtColumn));
+            assert(bookMove(&opened, &board, &builtRow, &builtColumn));
+            setBoardCell(&board, row, column, CELL_EMPTY);
+        }
+    }
+
+    destroyOpeningBook(&opened);
+    assert(opened.mapping == NULL);
+
+    /* Wrong size for the number of entries. */
+    file = fopen(TEST_FILE_PATH, "wb");
+    assert(file);
+    writeOpeningBook(file, &built);
+    fputc(0, file);
+    fclose(file);
+    printf("Invalid book (should print an error):\n");
+    opened = openOpeningBook(TEST_FILE_PATH, &error);
+    assert(error);
+    assert(opened.entries == NULL);
+
+    remove(TEST_FILE_PATH);
+    error = 0;
+    printf("Missing book (should print an error):\n");
+    opened = openOpeningBook(TEST_FILE_PATH, &error);
+    assert(error);
+    assert(opened.entries == NULL);
+
+    destroyGameBoard(&board);
+    destroyOpeningBook(&built);
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+void openingBookTest(void)
+{
+    moduleTestHeader("book");
+
+    runUnitTest("zeroedOpeningBook()", zeroedOpeningBookTest);
+    runUnitTest("addBookMove() and bookMove()", symmetryTest);
+    runUnitTest("buildOpeningBook()", buildOpeningBookTest);
+    runUnitTest("writeOpeningBook() and openOpeningBook()", fileTest);
+}
@@ -0,0 +1,11 @@
+/* Unit tests for the opening book module. */
+
+#ifndef TESTS_BOOK_TEST_H
+#define TESTS_BOOK_TEST_H
+
+
+/* Runs the tests for the opening book module. */
+void openingBookTest(void);
+
+
+#endif
@@ -7,6 +7,8 @@
 
 #include <assert.h>
 #include <ctype.h>
+#include <limits.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -24,6 +26,9 @@
 #define MULTIPLE_DELIM TEST_FILE_DIR "multiple_delim.txt"
 #define NO_DELIM TEST_FILE_DIR "no_delim.txt"
 
+/* Binary file written by the tests, then removed. */
+#define TEST_FILE_PATH "common_test.tmp"
+
 
 /* Tests playerToChar(). */
 static void playerToCharTest(void)
@@ -79,6 +84,27 @@ static void isWhitespaceTest(void)
 }
 
 
+/* Tests parseCount(). */
+static void parseCountTest(void)
+{
+    unsigned long count = 0;
+
+    assert(parseCount("0", &count, 1) && count == 0);
+    assert(parseCount("42", &count, 1) && count == 42);
+    assert(parseCount("42", &count, 0) && count == 42);
+    assert(parseCount("007", &count, 1) && count == 7);
+
+    assert(!parseCount("0", &count, 0));
+    assert(!parseCount("007", &count, 0));
+    assert(!parseCount("", &count, 1));
+    assert(!parseCount(" 1", &count, 1));
+    assert(!parseCount("+1", &count, 1));
+    assert(!parseCount("-1", &count, 1));
+    assert(!parseCount("1x", &count, 1));
+    assert(!parseCount("99999999999999999999999", &count, 1));
+}
+
+
 /* Reads up to bufSize - 1 characters from file into buf, and sets null
    terminator. Returns the number of characters read. */
 static size_t readTextFile(char* buf, size_t bufSize, FILE* file)
@@ -205,6 +231,95 @@ static void readUntilTest(void)
 }
 
 
+/* Tests writeLittleEndian(), storeLittleEndian() and readLittleEndian(). */
+static void littleEndianTest(void)
+{
+    unsigned char const expected[] = {0x04, 0x03, 0x02, 0x01, 0xff, 0x34,
+        0x12, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+    unsigned char data[sizeof expected + 1];
+    FILE* file = fopen(TEST_FILE_PATH, "wb");
+
+    assert(file);
+    writeLittleEndian(file, 0x01020304ul, 4);
+    writeLittleEndian(file, 0x123456fful, 1);
+    writeLittleEndian(file, 0x1234ul, 9);
+    fclose(file);
+
+    file = fopen(TEST_FILE_PATH, "rb");
+    assert(file);
+    assert(fread(data, 1, sizeof data, file) == sizeof expected);
+    fclose(file);
+    remove(TEST_FILE_PATH);
+
+    assert(memcmp(data, expected, sizeof expected) == 0);
+    assert(readLittleEndian(data, 4) == 0x01020304ul);
+    assert(readLittleEndian(data + 4, 1) == 0xfful);
+    assert(readLittleEndian(data + 5, 8) == 0x1234ul);
+    assert(readLittleEndian(data, 0) == 0);
+
+    /* Stored in memory the same as written to a file. */
+    memset(data, 0xaa, sizeof data);
+    storeLittleEndian(data, 0x01020304ul, 4);
+    storeLittleEndian(data + 4, 0x123456fful, 1);
+    storeLittleEndian(data + 5, 0x1234ul, 9);
+    assert(memcmp(data, expected, sizeof expected) == 0);
+    assert(data[sizeof expected] == 0xaa);
+}
+
+
+/* Tests writeVarint() and readVarint(). */
+static void varintTest(void)
+{
+    unsigned char const expected[] = {0x00, 0x7f, 0x80, 0x01, 0xac, 0x02};
+    unsigned long const values[] = {0, 0x7f, 0x80, 300, ULONG_MAX};
+    unsigned char data[sizeof expected + 1];
+    unsigned long value = 0;
+    size_t i = 0;
+    FILE* file = fopen(TEST_FILE_PATH, "wb");
+
+    assert(file);
+    writeVarint(file, 0);
+    writeVarint(file, 0x7f);
+    writeVarint(file, 0x80);
+    writeVarint(file, 300);
+    fclose(file);
+
+    file = fopen(TEST_FILE_PATH, "rb");
+    assert(file);
+    assert(fread(data, 1, sizeof data, file) == sizeof expected);
+    fclose(file);
+    assert(memcmp(data, expected, sizeof expected) == 0);
+
+    file = fopen(TEST_FILE_PATH, "w+b");
+    assert(file);
+    for (i = 0; i < sizeof values / sizeof values[0]; ++i)
+    {
+        writeVarint(file, values[i]);
+    }
+    /* Cut off, then too long for an unsigned long. */
+    fputc(0x80, file);
+    rewind(file);
+    for (i = 0; i < sizeof values / sizeof values[0]; ++i)
+    {
+        assert(readVarint(file, &value));
+        assert(value == values[i]);
+    }
+    assert(!readVarint(file, &value));
+
+    rewind(file);
+    for (i = 0; i <= sizeof(unsigned long) * CHAR_BIT / 7u; ++i)
+    {
+        fputc(0xff, file);
+    }
+    fputc(0x01, file);
+    rewind(file);
+    assert(!readVarint(file, &value));
+
+    fclose(file);
+    remove(TEST_FILE_PATH);
+}
+
+
 
 /* PUBLIC INTERFACE */
 
@@ -215,5 +330,9 @@ void commonTest(void)
 
     runUnitTest("playerToChar()", playerToCharTest);
     runUnitTest("isWhitespace()", isWhitespaceTest);
+    runUnitTest("parseCount()", parseCountTest);
     runUnitTest("readUntil()", readUntilTest);
+    runUnitTest("writeLittleEndian(), storeLittleEndian() and "
+        "readLittleEndian()", littleEndianTest);
+    runUnitTest("writeVarint() and readVarint()", varintTest);
 }
@@ -0,0 +1,231 @@
+/* Unit tests for the computer player module. */
+
+#include "computer_test.h"
+
+#include "common.h"
+#include "../main/board.h"
+#include "../main/common.h"
+#include "../main/computer.h"
+#include "../main/settings.h"
+#include "../main/transposition.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Tests createComputerPlayer() and destroyComputerPlayer(). */
+static void createDestroyComputerPlayerTest(void)
+{
+    Settings settings = zeroedSettings();
+    ComputerPlayer player = zeroedComputerPlayer();
+
+    assert(player.table.entries == NULL);
+
+    player = createComputerPlayer(PLAYER_TYPE_ALPHA_BETA, &settings, 1);
+    assert(player.type == PLAYER_TYPE_ALPHA_BETA);
+    assert(player.table.entries != NULL);
+    destroyComputerPlayer(&player);
+    assert(player.table.entries == NULL);
+
+    settings.threads = 3;
+    player = createComputerPlayer(PLAYER_TYPE_ALPHA_BETA, &settings, 1);
+    assert(player.searchLimits.threads == 3);
+    destroyComputerPlayer(&player);
+
+    player = createComputerPlayer(PLAYER_TYPE_MCTS, &settings, 1);
+    assert(player.type == PLAYER_TYPE_MCTS);
+    assert(player.table.entries == NULL);
+    assert(player.mctsLimits.threads == 3);
+    destroyComputerPlayer(&player);
+}
+
+
+/* Tests that random players fill a board with legal moves, including once
+   only a few cells remain empty. */
+static void randomMoveTest(void)
+{
+    Settings settings = zeroedSettings();
+    ComputerPlayer player = createComputerPlayer(PLAYER_TYPE_RANDOM,
+        &settings, 7);
+    GameBoard board = createGameBoard(13, 17, 20);
+    unsigned row = 0;
+    unsigned column = 0;
+    unsigned long i = 0;
+
+    for (i = 0; i < 13ul * 17ul; ++i)
+    {
+        computerPlayerMove(&player, &board, &row, &column, 0);
+        assert(inBoardBounds(&board, row, column));
+        assert(getBoardCell(&board, row, column) == CELL_EMPTY);
+        setBoardCell(&board, row, column, playerToCell(nextPlayer(&board)));
+    }
+    assert(board.occupied == 13ul * 17ul);
+    destroyGameBoard(&board);
+
+    board = createGameBoard(UINT_MAX, UINT_MAX, 5);
+    computerPlayerMove(&player, &board, &row, &column, 0);
+    assert(getBoardCell(&board, row, column) == CELL_EMPTY);
+    destroyGameBoard(&board);
+
+    destroyComputerPlayer(&player);
+}
+
+
+/* Tests that the search players make legal moves. */
+static void searchMoveTest(void)
+{
+    Settings settings = zeroedSettings();
+    ComputerPlayer players[2];
+    GameBoard board = createGameBoard(3, 3, 3);
+    unsigned row = 0;
+    unsigned column = 0;
+    Player player = PLAYER_X;
+    int won = 0;
+
+    settings.threads = 1;
+    players[PLAYER_X] = createComputerPlayer(PLAYER_TYPE_ALPHA_BETA,
+        &settings, 1);
+    players[PLAYER_O] = createComputerPlayer(PLAYER_TYPE_MCTS, &settings, 2);
+    players[PLAYER_O].mctsLimits.maxPlayouts = 2000;
+
+    while (board.occupied < 9u && !won)
+    {
+        player = nextPlayer(&board);
+        computerPlayerMove(players + player, &board, &row, &column, 0);
+        assert(getBoardCell(&board, row, column) == CELL_EMPTY);
+        setBoardCell(&board, row, column, playerToCell(player));
+        won = hasPlayerWonAt(&board, row, column);
+    }
+
+    /* Alpha-beta search plays 3x3 perfectly, so can't lose. */
+    assert(!won || player == PLAYER_X);
+
+    destroyComputerPlayer(players + PLAYER_X);
+    destroyComputerPlayer(players + PLAYER_O);
+    destroyGameBoard(&board);
+}
+
+
+
+/* Gets the reply to the latest move that an alpha-beta player expects, as
+   startPondering() finds it. */
+static void expectedReply(ComputerPlayer* player, GameBoard const* board,
+    unsigned* row, unsigned* column)
+{
+    unsigned const symmetry = canonicalSymmetry(board);
+    TableEntry entry;
+    int found = 0;
+
+    found = probeTable(&player->table, board->symmetryHashes[symmetry],
+        &entry);
+    assert(found && entry.hasMove);
+    (void)found;
+    untransformCell(board, symmetry, &entry.row, &entry.column);
+    *row = entry.row;
+    *column = entry.column;
+}
+
+
+/* Checks the text writePonderStatistics() writes for a player. */
+static void assertPonderStatistics(ComputerPlayer const* player,
+    char const* expected)
+{
+    FILE* file = tmpfile();
+    char text[128] = {0};
+    size_t length = 0;
+
+    assert(file);
+    writePonderStatistics(file, player);
+    rewind(file);
+    length = fread(text, 1, sizeof text - 1u, file);
+    assert(length == strlen(expected));
+    assert(memcmp(text, expected, length) == 0);
+    fclose(file);
+}
+
+
+/* Tests pondering on expected replies that are and aren't played. */
+static void ponderTest(void)
+{
+    Settings settings = zeroedSettings();
+    ComputerPlayer player;
+    GameBoard board = createGameBoard(5, 5, 4);
+    unsigned row = 0;
+    unsigned column = 0;
+    unsigned replyRow = 0;
+    unsigned replyColumn = 0;
+
+    settings.threads = 1;
+    player = createComputerPlayer(PLAYER_TYPE_ALPHA_BETA, &settings, 1);
+    setComputerMoveTime(&player, 0.2, 0.2);
+
+    /* Only alpha-beta players that expect a reply ponder. */
+    startPondering(&player, &board);
+    assert(player.ponder == NULL && player.predictions == 0);
+    assertPonderStatistics(&player, "");
+
+    /* Hit: the search carries on into the player's next move. */
+    computerPlayerMove(&player, &board, &row, &column, 0);
+    makeMove(&board, row, column, CELL_X);
+    startPondering(&player, &board);
+    assert(player.ponder != NULL && player.predictions == 1);
+    expectedReply(&player, &board, &replyRow, &replyColumn);
+    makeMove(&board, replyRow, replyColumn, CELL_O);
+    computerPlayerMove(&player, &board, &row, &column, 0);
+    assert(player.ponder == NULL && player.ponderHits == 1);
+    assert(getBoardCell(&board, row, column) == CELL_EMPTY);
+
+    /* Miss: another reply is played, and the search is discarded. */
+    makeMove(&board, row, column, CELL_X);
+    startPondering(&player, &board);
+    assert(player.predictions == 2);
+    expectedReply(&player, &board, &replyRow, &replyColumn);
+    row = replyRow == 0 ? 4 : 0;
+    column = 0;
+    while (getBoardCell(&board, row, column) != CELL_EMPTY)
+    {
+        ++column;
+    }
+    makeMove(&board, row, column, CELL_O);
+    computerPlayerMove(&player, &board, &row, &column, 0);
+    assert(player.ponder == NULL && player.ponderHits == 1);
+    assert(getBoardCell(&board, row, column) == CELL_EMPTY);
+
+    /* One of two expected replies was played. */
+    assertPonderStatistics(&player,
+        "Pondering: 1 of 2 expected replies played (50% ponder hits).\n");
+
+    /* Stopped without moving. */
+    makeMove(&board, row, column, CELL_X);
+    startPondering(&player, &board);
+    assert(player.ponder != NULL);
+    stopPondering(&player);
+    assert(player.ponder == NULL);
+    startPondering(&player, &board);
+    destroyComputerPlayer(&player);
+    assert(player.ponder == NULL);
+
+    destroyGameBoard(&board);
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+void computerTest(void)
+{
+    moduleTestHeader("computer");
+
+    runUnitTest("createComputerPlayer() and destroyComputerPlayer()",
+        createDestroyComputerPlayerTest);
+    runUnitTest("computerPlayerMove() random player", randomMoveTest);
+    runUnitTest("computerPlayerMove() search players", searchMoveTest);
+    runUnitTest("Pondering", ponderTest);
+}
@@ -0,0 +1,11 @@
+/* Unit tests for the computer player module. */
+
+#ifndef TESTS_COMPUTER_TEST_H
+#define TESTS_COMPUTER_TEST_H
+
+
+/* Runs the tests for the computer player module. */
+void computerTest(void);
+
+
+#endif
@@ -0,0 +1,196 @@
+/* Unit tests for the proof-number search module. */
+
+#include "dfpn_test.h"
+
+#include "common.h"
+#include "../main/board.h"
+#include "../main/dfpn.h"
+#include "../main/solved_db.h"
+
+#include <assert.h>
+#include <signal.h>
+#include <stdio.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Checkpoint file written by the tests, then removed. */
+#define TEST_FILE_PATH "dfpn_test.tmp"
+
+
+/* Options with a small table, so the tests run quickly. */
+static DfpnOptions testOptions(void)
+{
+    DfpnOptions options = defaultDfpnOptions();
+
+    options.tableBytes = 1ul << 20;
+
+    return options;
+}
+
+
+/* Tests defaultDfpnOptions(). */
+static void defaultDfpnOptionsTest(void)
+{
+    DfpnOptions const options = defaultDfpnOptions();
+
+    assert(options.tableBytes > 0);
+    assert(options.maxNodes == 0);
+    assert(options.checkpointPath == NULL);
+    assert(options.checkpointSeconds > 0.0);
+    assert(!options.resume);
+    assert(options.stop == NULL);
+}
+
+
+/* Tests proveFirstPlayerWin() on boards with known results. */
+static void knownResultsTest(void)
+{
+    DfpnOptions const options = testOptions();
+    DfpnResult result;
+
+    /* Tic-tac-toe is a draw. */
+    result = proveFirstPlayerWin(3, 3, 3, &options);
+    assert(result.outcome == DFPN_DISPROVEN);
+    assert(result.proof == DFPN_INFINITY && result.disproof == 0);
+    assert(!result.error);
+    assert(result.nodes > 0);
+    assert(result.tableFill > 0.0 && result.tableFill <= 1.0);
+
+    /* Won with one more column. */
+    result = proveFirstPlayerWin(3, 4, 3, &options);
+    assert(result.outcome == DFPN_PROVEN);
+    assert(result.proof == 0 && result.disproof == DFPN_INFINITY);
+
+    /* Known without expanding anything. */
+    result = proveFirstPlayerWin(1, 1, 1, &options);
+    assert(result.outcome == DFPN_PROVEN);
+    assert(result.nodes == 0);
+    result = proveFirstPlayerWin(2, 2, 3, &options);
+    assert(result.outcome == DFPN_DISPROVEN);
+
+    /* 4,4,4 is a draw. */
+    result = proveFirstPlayerWin(4, 4, 4, &options);
+    assert(result.outcome == DFPN_DISPROVEN);
+}
+
+
+/* Tests that proveFirstPlayerWin() can set up a search of the biggest board
+   allowed. */
+static void biggestBoardTest(void)
+{
+    DfpnOptions options = testOptions();
+    DfpnResult result;
+    volatile sig_atomic_t stop = 1;
+
+    options.stop = &stop;
+    result = proveFirstPlayerWin(32, DFPN_MAX_CELLS / 32u, 5, &options);
+    assert(result.outcome == DFPN_UNKNOWN);
+    assert(!result.error);
+    assert(result.nodes == 0);
+}
+
+
+/* Tests proveFirstPlayerWin() against solved databases. */
+static void solvedDatabaseComparisonTest(void)
+{
+    unsigned const settings[][3] = {{2, 2, 2}, {2, 3, 3}, {3, 3, 2},
+        {4, 3, 3}, {3, 4, 4}, {2, 5, 2}, {1, 5, 3}};
+    DfpnOptions options = testOptions();
+    SolvedDatabase database = zeroedSolvedDatabase();
+    GameBoard board = zeroedGameBoard();
+    DfpnResult result;
+    unsigned i = 0;
+
+    /* A table too small to hold the whole tree still gets the answer. */
+    options.tableBytes = 1u << 10;
+
+    for (i = 0; i < sizeof settings / sizeof settings[0]; ++i)
+    {
+        database = solveDatabase(settings[i][0], settings[i][1],
+            settings[i][2], 0);
+        board = createGameBoard(settings[i][0], settings[i][1],
+            settings[i][2]);
+
+        result = proveFirstPlayerWin(settings[i][0], settings[i][1],
+            settings[i][2], &options);
+        assert((result.outcome == DFPN_PROVEN)
+            == (lookupSolvedPosition(&database, &board).outcome
+                == SOLVED_WIN));
+        assert(result.outcome != DFPN_UNKNOWN);
+
+        destroyGameBoard(&board);
+        destroySolvedDatabase(&database);
+    }
+}
+
+
+/* Tests stopping and resuming a search from a checkpoint. */
+static void checkpointTest(void)
+{
+    DfpnOptions options = testOptions();
+    DfpnResult first;
+    DfpnResult resumed;
+    DfpnResult whole;
+    volatile sig_atomic_t stop = 1;
+
+    whole = proveFirstPlayerWin(4, 4, 4, &options);
+
+    /* Stopped by the node limit. */
+    options.checkpointPath = TEST_FILE_PATH;
+    options.maxNodes = whole.nodes / 2u;
+    first = proveFirstPlayerWin(4, 4, 4, &options);
+    assert(first.outcome == DFPN_UNKNOWN);
+    assert(!first.error);
+    assert(first.proof > 0 && first.disproof > 0);
+    assert(first.nodes >= options.maxNodes);
+
+    options.maxNodes = 0;
+    options.resume = 1;
+    resumed = proveFirstPlayerWin(4, 4, 4, &options);
+    assert(resumed.outcome == whole.outcome);
+    assert(resumed.nodes > first.nodes);
+
+    /* Resuming a finished search gives the result at once. */
+    first = resumed;
+    resumed = proveFirstPlayerWin(4, 4, 4, &options);
+    assert(resumed.outcome == whole.outcome);
+    assert(resumed.nodes == first.nodes);
+
+    /* Stopped by the stop flag. */
+    options.resume = 0;
+    options.stop = &stop;
+    first = proveFirstPlayerWin(4, 4, 4, &options);
+    assert(first.outcome == DFPN_UNKNOWN);
+
+    /* Checkpoint for a different board. */
+    options.resume = 1;
+    options.stop = NULL;
+    printf("Mismatched checkpoint (should print an error):\n");
+    first = proveFirstPlayerWin(4, 4, 3, &options);
+    assert(first.error);
+    assert(first.outcome == DFPN_UNKNOWN);
+
+    remove(TEST_FILE_PATH);
+    printf("Missing checkpoint (should print an error):\n");
+    first = proveFirstPlayerWin(4, 4, 4, &options);
+    assert(first.error);
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+void dfpnTest(void)
+{
+    moduleTestHeader("dfpn");
+
+    runUnitTest("defaultDfpnOptions()", defaultDfpnOptionsTest);
+    runUnitTest("Known results", knownResultsTest);
+    runUnitTest("Biggest board", biggestBoardTest);
+    runUnitTest("Comparison with solved databases",
+        solvedDatabaseComparisonTest);
+    runUnitTest("Checkpoints", checkpointTest);
+}
@@ -0,0 +1,11 @@
+/* Unit tests for the proof-number search module. */
+
+#ifndef TESTS_DFPN_TEST_H
+#define TESTS_DFPN_TEST_H
+
+
+/* Runs the tests for the proof-number search module. */
+void dfpnTest(void);
+
+
+#endif
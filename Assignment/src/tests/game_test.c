@@ -0,0 +1,208 @@
+/* Unit tests for the game module. */
+
+#include "game_test.h"
+
+#include "common.h"
+#include "../main/board.h"
+#include "../main/game.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* TestGame::undoAt of a game that takes nothing back. */
+#define NO_UNDO ((size_t)-1)
+
+
+/* Moves given to playGame() by the test hooks, and what the hooks saw. */
+typedef struct
+{
+    unsigned const* moves;      /* Column and row of each move in turn. */
+    size_t count;
+    size_t next;
+    size_t undoAt;              /* Turn on which to take back a move instead,
+                                   or NO_UNDO. */
+    unsigned movedCalls;
+    unsigned turnEndedCalls;
+    int lastWon;
+} TestGame;
+
+
+/* GameHooks::move hook playing the test game's moves, then stopping. */
+static TurnInput testMove(void* context, GameBoard* board, Player player,
+    unsigned* row, unsigned* column)
+{
+    TestGame* const game = context;
+    TurnInput input = TURN_STOP;
+
+    assert(player == nextPlayer(board));
+    if (game->next == game->undoAt)
+    {
+        unmakeMove(board);
+        game->undoAt = NO_UNDO;
+        input = TURN_UNDONE;
+    }
+    else if (game->next < game->count)
+    {
+        *column = game->moves[game->next * 2u];
+        *row = game->moves[game->next * 2u + 1u];
+        ++game->next;
+        input = TURN_MOVE;
+    }
+
+    return input;
+}
+
+
+/* GameHooks::moved hook recording its calls. */
+static void testMoved(void* context, GameBoard const* board, Player player,
+    unsigned row, unsigned column, int won)
+{
+    TestGame* const game = context;
+
+    assert(getBoardCell(board, row, column) == playerToCell(player));
+    ++game->movedCalls;
+    game->lastWon = won;
+}
+
+
+/* GameHooks::turnEnded hook recording its calls. */
+static void testTurnEnded(void* context, GameBoard const* _)
+{
+    TestGame* const game = context;
+
+    ++game->turnEndedCalls;
+}
+
+
+/* Plays the given moves on a board with playGame() and the test hooks. */
+static GameResult playTestGame(GameBoard* board, TestGame* game,
+    unsigned const* moves, size_t count, size_t undoAt)
+{
+    GameHooks hooks = zeroedGameHooks();
+
+    game->moves = moves;
+    game->count = count;
+    game->next = 0;
+    game->undoAt = undoAt;
+    game->movedCalls = 0;
+    game->turnEndedCalls = 0;
+    game->lastWon = 0;
+    hooks.move = testMove;
+    hooks.moved = testMoved;
+    hooks.turnEnded = testTurnEnded;
+    hooks.context = game;
+
+    return playGame(board, &hooks);
+}
+
+
+/* Tests playGame() ending in a win, with moves left over. */
+static void winTest(void)
+{
+    /* X takes the top row. */
+    unsigned const moves[] = {0,0, 0,1, 1,0, 1,1, 2,0, 2,2};
+    GameBoard board = createGameBoard(3, 3, 3);
+    TestGame game;
+
+    assert(playTestGame(&board, &game, moves, 6, NO_UNDO) == GAME_WON);
+    assert(game.next == 5 && board.moveCount == 5);
+    assert(game.movedCalls == 5 && game.turnEndedCalls == 5);
+    assert(game.lastWon);
+    assert(nextPlayer(&board) == PLAYER_O);
+
+    destroyGameBoard(&board);
+}
+
+
+/* Tests playGame() ending in a draw on a full board. */
+static void drawTest(void)
+{
+    unsigned const moves[] = {0,0, 1,0, 2,0, 1,1, 0,1, 0,2, 2,1, 2,2, 1,2};
+    unsigned const liveMoves[] = {0,0, 1,0, 2,0, 0,1, 1,1, 0,2, 2,1, 2,2,
+        1,2};
+    GameBoard board = createGameBoard(3, 3, 3);
+    TestGame game;
+
+    assert(playTestGame(&board, &game, moves, 9, NO_UNDO) == GAME_DRAWN);
+    assert(board.occupied == 9 && !game.lastWon);
+    assert(game.movedCalls == 9 && game.turnEndedCalls == 9);
+    destroyGameBoard(&board);
+
+    /* Every line is blocked once the board is full, but a game still live
+       until its last move isn't a dead draw. */
+    board = createGameBoard(3, 3, 3);
+    enableWindowCounts(&board);
+    assert(playTestGame(&board, &game, liveMoves, 9, NO_UNDO) == GAME_DRAWN);
+    assert(board.occupied == 9 && isDeadDraw(&board));
+    destroyGameBoard(&board);
+}
+
+
+/* Tests playGame() ending in a dead draw, even before any turns, only with
+   window counts. */
+static void deadDrawTest(void)
+{
+    unsigned const moves[] = {0,0, 1,0, 0,1, 2,1, 1,1};
+    GameBoard board = createGameBoard(2, 2, 3);
+    TestGame game;
+
+    /* No line of 3 fits at all. */
+    enableWindowCounts(&board);
+    assert(playTestGame(&board, &game, moves, 5, NO_UNDO) == GAME_DEAD_DRAW);
+    assert(game.next == 0 && game.turnEndedCalls == 0);
+    destroyGameBoard(&board);
+
+    /* Both rows of 3 are blocked after four moves. */
+    board = createGameBoard(2, 3, 3);
+    enableWindowCounts(&board);
+    assert(playTestGame(&board, &game, moves, 5, NO_UNDO) == GAME_DEAD_DRAW);
+    assert(game.next == 4 && board.occupied == 4);
+    destroyGameBoard(&board);
+
+    board = createGameBoard(2, 3, 3);
+    assert(playTestGame(&board, &game, moves, 5, NO_UNDO) == GAME_STOPPED);
+    assert(game.next == 5);
+    destroyGameBoard(&board);
+}
+
+
+/* Tests a move hook stopping a game, and taking back moves. */
+static void stopAndUndoTest(void)
+{
+    unsigned const moves[] = {0,0, 1,1, 2,2};
+    GameBoard board = createGameBoard(3, 3, 3);
+    TestGame game;
+
+    assert(playTestGame(&board, &game, moves, 3, NO_UNDO) == GAME_STOPPED);
+    assert(board.moveCount == 3);
+    assert(game.movedCalls == 3 && game.turnEndedCalls == 3);
+    destroyGameBoard(&board);
+
+    /* The second move is taken back, so O plays the third. */
+    board = createGameBoard(3, 3, 3);
+    assert(playTestGame(&board, &game, moves, 3, 2) == GAME_STOPPED);
+    assert(board.moveCount == 2);
+    assert(getBoardCell(&board, 1, 1) == CELL_EMPTY);
+    assert(getBoardCell(&board, 2, 2) == CELL_O);
+    assert(game.movedCalls == 3 && game.turnEndedCalls == 4);
+    destroyGameBoard(&board);
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+void gameTest(void)
+{
+    moduleTestHeader("game");
+
+    runUnitTest("playGame() won", winTest);
+    runUnitTest("playGame() drawn", drawTest);
+    runUnitTest("playGame() dead draw", deadDrawTest);
+    runUnitTest("playGame() stopped and undone", stopAndUndoTest);
+}
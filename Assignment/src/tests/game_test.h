@@ -0,0 +1,11 @@
+/* Unit tests for the game module. */
+
+#ifndef TESTS_GAME_TEST_H
+#define TESTS_GAME_TEST_H
+
+
+/* Runs the tests for the game module. */
+void gameTest(void);
+
+
+#endif
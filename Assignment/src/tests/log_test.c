@@ -3,9 +3,332 @@
 #include "log_test.h"
 
 #include "common.h"
+#include "../main/common.h"
 #include "../main/log.h"
 
+#include <assert.h>
+#include <limits.h>
+#include <stddef.h>
 #include <stdio.h>
+#include <string.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Size of the buffers logs are read back into. */
+#define LOG_TEXT_SIZE 4096u
+
+
+/* Logs games using every feature of the formats: players that don't
+   alternate, dead draws, moves in both directions and empty games. */
+static void logTestGames(void)
+{
+    newGameLog();
+    logTurn(PLAYER_X, 2, 3);
+    logTurn(PLAYER_O, 0, 0);
+    logTurn(PLAYER_X, 6, 6);
+    logTurn(PLAYER_O, 6, 5);
+    logDeadDraw();
+    newGameLog();
+    newGameLog();
+    logTurn(PLAYER_O, 1, 2);
+    logTurn(PLAYER_O, 4, 0);
+    logTurn(PLAYER_X, 0, 6);
+}
+
+
+/* Writes the game logs as text into a buffer of LOG_TEXT_SIZE characters. */
+static void writeGameLogsText(char* text)
+{
+    FILE* file = tmpfile();
+    size_t length = 0;
+
+    assert(file);
+    writeGameLogs(file);
+    rewind(file);
+    length = fread(text, 1, LOG_TEXT_SIZE - 1u, file);
+    text[length] = '\0';
+    fclose(file);
+}
+
+
+/* Reads game logs from a stream holding the given bytes. */
+static int readGameLogsFrom(void const* data, size_t size, LogFormat* format)
+{
+    FILE* file = tmpfile();
+    unsigned columns = 0;
+    unsigned rows = 0;
+    unsigned winRequirement = 0;
+    int res = 0;
+
+    assert(file);
+    fwrite(data, 1, size, file);
+    rewind(file);
+    res = readGameLogs(file, &columns, &rows, &winRequirement, format);
+    fclose(file);
+
+    return res;
+}
+
+
+/* Tests the text written for a game ended early as a dead draw, which must
+   follow its turns. */
+static void deadDrawLogTest(void)
+{
+    char text[LOG_TEXT_SIZE];
+
+    writeGameLogsText(text);
+    assert(strcmp(text, "GAME 1:\n"
+        "   Turn 1:\n   Player: X\n   Location: 1,1\n\n"
+        "   Ended early: draw, no line can be completed.\n\n\n") == 0);
+}
+
+
+/* Tests writeBinaryGameLogs() and reading its logs with readGameLogs(). */
+static void binaryLogTest(void)
+{
+    /* A game of X at 0,0 then O at 2,1 on a 3x2 board, in each format. */
+    unsigned char const binary[] = {0x89, 'M', 'N', 'K', LOG_FORMAT_BINARY,
+        3, 2, 3, 1, 9, 0, 5};
+    unsigned char const delta[] = {0x89, 'M', 'N', 'K', LOG_FORMAT_DELTA,
+        3, 2, 3, 1, 9, 0, 10};
+    unsigned char data[sizeof binary];
+    unsigned char trailing[sizeof binary + 1u];
+    char expected[LOG_TEXT_SIZE];
+    char text[LOG_TEXT_SIZE];
+    LogFormat const formats[] = {LOG_FORMAT_BINARY, LOG_FORMAT_DELTA};
+    LogFormat format = LOG_FORMAT_TEXT;
+    FILE* file = NULL;
+    unsigned columns = 0;
+    unsigned rows = 0;
+    unsigned winRequirement = 0;
+    size_t i = 0;
+
+    newGameLog();
+    logTurn(PLAYER_X, 0, 0);
+    logTurn(PLAYER_O, 1, 2);
+    writeGameLogsText(expected);
+    file = tmpfile();
+    assert(file);
+    writeBinaryGameLogs(file, 3, 2, 3, LOG_FORMAT_BINARY);
+    rewind(file);
+    assert(fread(data, 1, sizeof data, file) == sizeof binary);
+    assert(memcmp(data, binary, sizeof binary) == 0);
+    fclose(file);
+    freeGameLogs();
+
+    assert(readGameLogsFrom(delta, sizeof delta, &format));
+    assert(format == LOG_FORMAT_DELTA);
+    writeGameLogsText(text);
+    assert(strcmp(text, expected) == 0);
+    freeGameLogs();
+
+    /* Round trips. */
+    logTestGames();
+    writeGameLogsText(expected);
+    for (i = 0; i < sizeof formats / sizeof formats[0]; ++i)
+    {
+        file = tmpfile();
+        assert(file);
+        writeBinaryGameLogs(file, 7, 8, 4, formats[i]);
+        rewind(file);
+        freeGameLogs();
+
+        assert(readGameLogs(file, &columns, &rows, &winRequirement,
+            &format));
+        assert(format == formats[i]);
+        assert(columns == 7 && rows == 8 && winRequirement == 4);
+        writeGameLogsText(text);
+        assert(strcmp(text, expected) == 0);
+        fclose(file);
+    }
+    freeGameLogs();
+
+    /* Cut off, moves out of bounds, bytes after the end, and a difference
+       before the first cell. */
+    assert(!readGameLogsFrom(binary, sizeof binary - 1u, &format));
+    assert(countGameLogs() == 1);
+    freeGameLogs();
+    memcpy(data, binary, sizeof binary);
+    data[11] = 6;
+    assert(!readGameLogsFrom(data, sizeof data, &format));
+    freeGameLogs();
+    memcpy(trailing, binary, sizeof binary);
+    trailing[sizeof binary] = 0;
+    assert(!readGameLogsFrom(trailing, sizeof trailing, &format));
+    freeGameLogs();
+    memcpy(data, delta, sizeof delta);
+    data[11] = 1;
+    assert(!readGameLogsFrom(data, sizeof data, &format));
+    freeGameLogs();
+    assert(!readGameLogsFrom("", 0, &format));
+}
+
+
+/* Tests binary logs of the biggest boards they allow, and that bigger boards
+   are rejected rather than written with differences that overflow. */
+static void bigBoardBinaryLogTest(void)
+{
+    unsigned const maxRows = (unsigned)(BINARY_LOG_MAX_CELLS / UINT_MAX);
+    unsigned char const magic[] = {0x89, 'M', 'N', 'K'};
+    LogFormat const formats[] = {LOG_FORMAT_BINARY, LOG_FORMAT_DELTA};
+    LogFormat format = LOG_FORMAT_TEXT;
+    char expected[LOG_TEXT_SIZE];
+    char text[LOG_TEXT_SIZE];
+    FILE* file = NULL;
+    unsigned columns = 0;
+    unsigned rows = 0;
+    unsigned winRequirement = 0;
+    size_t i = 0;
+
+    /* Players that don't alternate, so each move also holds its player, and
+       the longest differences there are in each direction. An unsigned long
+       as long as an unsigned has no room for such a board. */
+    for (i = 0; maxRows > 0 && i < sizeof formats / sizeof formats[0]; ++i)
+    {
+        newGameLog();
+        logTurn(PLAYER_O, maxRows - 1u, UINT_MAX - 1u);
+        logTurn(PLAYER_O, 0, 0);
+        logTurn(PLAYER_X, maxRows - 1u, UINT_MAX - 1u);
+        writeGameLogsText(expected);
+        file = tmpfile();
+        assert(file);
+        assert(writeBinaryGameLogs(file, UINT_MAX, maxRows, 5, formats[i]));
+        rewind(file);
+        freeGameLogs();
+
+        assert(readGameLogs(file, &columns, &rows, &winRequirement,
+            &format));
+        assert(columns == UINT_MAX && rows == maxRows);
+        writeGameLogsText(text);
+        assert(strcmp(text, expected) == 0);
+        freeGameLogs();
+        fclose(file);
+    }
+
+    /* One more row is too many to write or read. */
+    newGameLog();
+    logTurn(PLAYER_X, 0, 0);
+    for (i = 0; i < sizeof formats / sizeof formats[0]; ++i)
+    {
+        file = tmpfile();
+        assert(file);
+        assert(!writeBinaryGameLogs(file, UINT_MAX, maxRows + 1u, 5,
+            formats[i]));
+        assert(ftell(file) == 0);
+
+        fwrite(magic, 1, sizeof magic, file);
+        fputc((int)formats[i], file);
+        writeVarint(file, UINT_MAX);
+        writeVarint(file, maxRows + 1u);
+        writeVarint(file, 5);
+        writeVarint(file, 0);
+        rewind(file);
+        assert(!readGameLogs(file, &columns, &rows, &winRequirement,
+            &format));
+        fclose(file);
+    }
+    freeGameLogs();
+}
+
+
+/* Tests reading text logs with readGameLogs(). */
+static void textLogTest(void)
+{
+    char const* const header = "SETTINGS:\n   M: 7\n   N: 8\n   K: 4\n"
+        "   T: 60\n   I: 1\n\n";
+    char const* const invalid[] = {
+        "SETTINGS:\n   M: 3\n   N: 3\n\n<no games>\n",
+        "SETTINGS:\n   M: 3\n   N: 3\n   K: 3\n\nGAME 1:\n   Turn 1:\n"
+            "   Player: X\n   Location: 3,0\n\n",
+        "SETTINGS:\n   M: 3\n   N: 3\n   K: 3\n\nGAME 1:\n   Turn 1:\n"
+            "   Player: Y\n   Location: 0,0\n\n",
+        "SETTINGS:\n   M: 3\n   N: 3\n   K: 3\n\n   Player: X\n",
+        "SETTINGS:\n   M: 3\n   N: 3\n   K: 3\n\nGAME 1:\n   Oops\n",
+        "SETTINGS:\n   M: 3\n   N: 3\n   K: 3\n"
+    };
+    char log[LOG_TEXT_SIZE];
+    char expected[LOG_TEXT_SIZE];
+    char text[LOG_TEXT_SIZE];
+    LogFormat format = LOG_FORMAT_BINARY;
+    size_t i = 0;
+
+    logTestGames();
+    writeGameLogsText(expected);
+    freeGameLogs();
+    strcpy(log, header);
+    strcat(log, expected);
+
+    assert(readGameLogsFrom(log, strlen(log), &format));
+    assert(format == LOG_FORMAT_TEXT);
+    assert(countGameLogs() == 3);
+    writeGameLogsText(text);
+    assert(strcmp(text, expected) == 0);
+    freeGameLogs();
+
+    strcpy(log, header);
+    strcat(log, "<no games>\n");
+    assert(readGameLogsFrom(log, strlen(log), &format));
+    assert(countGameLogs() == 0);
+
+    for (i = 0; i < sizeof invalid / sizeof invalid[0]; ++i)
+    {
+        assert(!readGameLogsFrom(invalid[i], strlen(invalid[i]), &format));
+        freeGameLogs();
+    }
+}
+
+
+/* Tests log shards and merging them into the main game logs. */
+static void logShardTest(void)
+{
+    LogShard shards[3];
+    unsigned i = 0;
+
+    for (i = 0; i < 3; ++i)
+    {
+        shards[i] = createLogShard();
+    }
+
+    /* Games out of order within and between shards. */
+    newShardGameLog(shards + 1, 3);
+    logShardTurn(shards + 1, PLAYER_X, 3, 3);
+    newShardGameLog(shards + 0, 1);
+    logShardTurn(shards + 0, PLAYER_X, 1, 1);
+    logShardTurn(shards + 0, PLAYER_O, 1, 2);
+    logShardDeadDraw(shards + 0);
+    newShardGameLog(shards + 1, 0);
+    logShardTurn(shards + 1, PLAYER_X, 0, 0);
+    newShardGameLog(shards + 0, 2);
+    logShardTurn(shards + 0, PLAYER_X, 2, 2);
+
+    newGameLog();
+    logTurn(PLAYER_X, 9, 9);
+
+    printf("Merged shards (games 2-5 should have turns at 0, 1, 2, 3, and "
+        "game 3 should end early):\n");
+    mergeLogShards(shards, 3);
+    assert(countGameLogs() == 5);
+    for (i = 0; i < 3; ++i)
+    {
+        assert(shards[i].games.size == 0);
+    }
+    writeGameLogs(stdout);
+    printf("\n");
+
+    /* Destroying a shard with logs in it. */
+    newShardGameLog(shards + 2, 0);
+    logShardTurn(shards + 2, PLAYER_O, 4, 4);
+    for (i = 0; i < 3; ++i)
+    {
+        destroyLogShard(shards + i);
+    }
+
+    freeGameLogs();
+    assert(countGameLogs() == 0);
+}
+
 
 
 /* PUBLIC INTERFACE */
@@ -45,4 +368,28 @@ void logTest(void)
     printf("\n");
 
     freeGameLogs();
+
+    printf("Turn taken back (should have turns at 0,0 and 2,2):\n");
+    newGameLog();
+    logTurn(PLAYER_X, 0, 0);
+    logTurn(PLAYER_O, 1, 1);
+    unlogTurn();
+    logTurn(PLAYER_O, 2, 2);
+    writeGameLogs(stdout);
+    printf("\n");
+    freeGameLogs();
+
+    printf("Game ended early as a dead draw:\n");
+    newGameLog();
+    logTurn(PLAYER_X, 1, 1);
+    logDeadDraw();
+    writeGameLogs(stdout);
+    printf("\n");
+    deadDrawLogTest();
+
+    freeGameLogs();
+    logShardTest();
+    binaryLogTest();
+    bigBoardBinaryLogTest();
+    textLogTest();
 }
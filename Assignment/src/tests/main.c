@@ -1,10 +1,31 @@
 /* Unit test entry point. */
 
+#include "bitboard_test.h"
 #include "board_test.h"
+#include "book_test.h"
 #include "common_test.h"
+#include "computer_test.h"
+#include "dfpn_test.h"
+#include "game_test.h"
 #include "linked_list_test.h"
 #include "log_test.h"
+#include "mcts_test.h"
+#include "perft_test.h"
+#include "random_test.h"
+#include "render_test.h"
+#include "search_test.h"
+#include "script_test.h"
+#include "selfplay_test.h"
 #include "settings_test.h"
+#include "solved_db_test.h"
+#include "sparse_board_test.h"
+#include "terminal_test.h"
+#include "threads_test.h"
+#include "time_control_test.h"
+#include "timer_test.h"
+#include "transposition_test.h"
+#include "win_scan_test.h"
+#include "window_counts_test.h"
 
 #include <stdlib.h>
 #include <time.h>
@@ -14,11 +35,32 @@ int main(void)
 {
     srand(time(NULL));
 
+    bitBoardTest();
     boardTest();
+    openingBookTest();
     commonTest();
+    computerTest();
+    dfpnTest();
+    gameTest();
     linkedListTest();
     logTest();
+    mctsTest();
+    perftTest();
+    randomTest();
+    renderTest();
+    searchTest();
+    scriptTest();
+    selfPlayTest();
     settingsTest();
+    solvedDatabaseTest();
+    sparseBoardTest();
+    terminalTest();
+    threadsTest();
+    timeControlTest();
+    timerTest();
+    transpositionTest();
+    winScanTest();
+    windowCountsTest();
 
     return 0;
 }
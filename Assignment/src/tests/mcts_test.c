@@ -0,0 +1,154 @@
+/* Unit tests for the Monte Carlo tree search module. */
+
+#include "mcts_test.h"
+
+#include "common.h"
+#include "../main/board.h"
+#include "../main/common.h"
+#include "../main/mcts.h"
+
+#include <assert.h>
+#include <limits.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Limits used for test searches. Playout counts rather than time bound the
+   searches, so results do not depend on machine speed. */
+static MctsLimits testLimits(unsigned threads, unsigned long playouts)
+{
+    MctsLimits limits = defaultMctsLimits();
+
+    limits.threads = threads;
+    limits.maxSeconds = 60.0;
+    limits.maxPlayouts = playouts;
+    limits.maxNodes = 1ul << 16;
+
+    return limits;
+}
+
+
+/* Tests defaultMctsLimits(). */
+static void defaultMctsLimitsTest(void)
+{
+    MctsLimits const limits = defaultMctsLimits();
+    assert(limits.threads > 0);
+    assert(limits.maxSeconds > 0.0);
+    assert(limits.maxNodes > 0);
+}
+
+
+/* Tests that the search plays an immediate win, with one and several
+   threads. */
+static void immediateWinTest(void)
+{
+    GameBoard board = createGameBoard(9, 9, 4);
+    MctsResult result;
+    unsigned threads = 1;
+
+    /* X to move with an open three. */
+    setBoardCell(&board, 4, 3, CELL_X);
+    setBoardCell(&board, 0, 0, CELL_O);
+    setBoardCell(&board, 4, 4, CELL_X);
+    setBoardCell(&board, 8, 8, CELL_O);
+    setBoardCell(&board, 4, 5, CELL_X);
+    setBoardCell(&board, 3, 4, CELL_O);
+
+    for (threads = 1; threads <= 4; threads *= 2)
+    {
+        result = mctsBestMove(&board, testLimits(threads, 20000));
+        assert(result.found);
+        assert(result.threads == threads);
+        assert(result.playouts == 20000);
+        assert(result.nodes > 1);
+        assert(result.row == 4);
+        assert(result.column == 2 || result.column == 6);
+        assert(result.winRate > 0.9);
+    }
+
+    destroyGameBoard(&board);
+}
+
+
+/* Tests that the search blocks an immediate loss. */
+static void blockLossTest(void)
+{
+    GameBoard board = createGameBoard(7, 7, 4);
+    MctsResult result;
+
+    /* O to move; X threatens (2,5) after a three closed on the left. */
+    setBoardCell(&board, 2, 2, CELL_X);
+    setBoardCell(&board, 2, 1, CELL_O);
+    setBoardCell(&board, 2, 3, CELL_X);
+    setBoardCell(&board, 6, 6, CELL_O);
+    setBoardCell(&board, 2, 4, CELL_X);
+    assert(nextPlayer(&board) == PLAYER_O);
+
+    result = mctsBestMove(&board, testLimits(2, 20000));
+    assert(result.found);
+    assert(result.row == 2 && result.column == 5);
+
+    destroyGameBoard(&board);
+}
+
+
+/* Tests searching with a node pool too small for the tree, and on full and
+   huge boards. */
+static void limitsTest(void)
+{
+    GameBoard board = createGameBoard(3, 3, 3);
+    MctsLimits limits = testLimits(2, 1000);
+    MctsResult result;
+    unsigned i = 0;
+
+    /* Pool only has room for the root and its children. */
+    setBoardCell(&board, 1, 1, CELL_X);
+    limits.maxNodes = 9;
+    result = mctsBestMove(&board, limits);
+    assert(result.found);
+    assert(result.nodes <= 9);
+    assert(getBoardCell(&board, result.row, result.column) == CELL_EMPTY);
+
+    /* Pool too small for even the root's children. */
+    limits.maxNodes = 1;
+    result = mctsBestMove(&board, limits);
+    assert(result.found);
+    assert(getBoardCell(&board, result.row, result.column) == CELL_EMPTY);
+
+    for (i = 0; i < 9; ++i)
+    {
+        setBoardCell(&board, i / 3u, i % 3u, i % 2u ? CELL_O : CELL_X);
+    }
+    result = mctsBestMove(&board, testLimits(2, 1000));
+    assert(!result.found);
+    destroyGameBoard(&board);
+
+    board = createGameBoard(UINT_MAX, UINT_MAX, 5);
+    result = mctsBestMove(&board, testLimits(2, 1000));
+    assert(result.found);
+    assert(result.row == UINT_MAX / 2u && result.column == UINT_MAX / 2u);
+    setBoardCell(&board, result.row, result.column, CELL_X);
+    result = mctsBestMove(&board, testLimits(2, 1000));
+    assert(result.found);
+    assert(result.row + 1u >= UINT_MAX / 2u
+        && result.row <= UINT_MAX / 2u + 1u);
+    assert(result.column + 1u >= UINT_MAX / 2u
+        && result.column <= UINT_MAX / 2u + 1u);
+    destroyGameBoard(&board);
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+void mctsTest(void)
+{
+    moduleTestHeader("mcts");
+
+    runUnitTest("defaultMctsLimits()", defaultMctsLimitsTest);
+    runUnitTest("mctsBestMove() plays an immediate win", immediateWinTest);
+    runUnitTest("mctsBestMove() blocks an immediate loss", blockLossTest);
+    runUnitTest("mctsBestMove() limits", limitsTest);
+}
@@ -0,0 +1,11 @@
+/* Unit tests for the Monte Carlo tree search module. */
+
+#ifndef TESTS_MCTS_TEST_H
+#define TESTS_MCTS_TEST_H
+
+
+/* Runs the tests for the Monte Carlo tree search module. */
+void mctsTest(void);
+
+
+#endif
@@ -0,0 +1,125 @@
+/* Unit tests for the perft module. */
+
+#include "perft_test.h"
+
+#include "common.h"
+#include "../main/board.h"
+#include "../main/perft.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Sequences of each length in 3x3 tic-tac-toe, from 0 moves. */
+static unsigned long const TICTACTOE_SEQUENCES[] = {
+    1, 9, 72, 504, 3024, 15120, 54720, 148176, 200448, 127872
+};
+
+/* Distinct positions after each number of moves in 3x3 tic-tac-toe, 5478 in
+   all. */
+static unsigned long const TICTACTOE_POSITIONS[] = {
+    1, 9, 72, 252, 756, 1260, 1520, 1140, 390, 78
+};
+
+
+/* Tests runPerft() against the known counts for tic-tac-toe. */
+static void tictactoePerftTest(void)
+{
+    GameBoard board = createGameBoard(3, 3, 3);
+    PerftResult result;
+    unsigned depth = 0;
+
+    for (depth = 0; depth <= 9; ++depth)
+    {
+        result = runPerft(&board, depth, 0, 2);
+        assert(result.sequences == TICTACTOE_SEQUENCES[depth]);
+        assert(result.uniquePositions == 0);
+        assert(result.threads == 2);
+
+        result = runPerft(&board, depth, 1, 3);
+        assert(result.sequences == TICTACTOE_SEQUENCES[depth]);
+        assert(result.uniquePositions == TICTACTOE_POSITIONS[depth]);
+    }
+
+    /* Nothing to play on a full board. */
+    result = runPerft(&board, 10, 0, 1);
+    assert(result.sequences == 0);
+
+    destroyGameBoard(&board);
+}
+
+
+/* Tests that every board backend gives the same counts, for any number of
+   threads, and that counting unique positions makes fewer moves. */
+static void backendPerftTest(void)
+{
+    BoardBackend const backends[] = {
+        BOARD_BACKEND_ARRAY, BOARD_BACKEND_BITBOARD, BOARD_BACKEND_SPARSE
+    };
+    GameBoard board = createGameBoard(4, 5, 3);
+    PerftResult expected = runPerft(&board, 5, 0, 1);
+    PerftResult unique = runPerft(&board, 5, 1, 1);
+    PerftResult result;
+    unsigned i = 0;
+
+    assert(unique.sequences == expected.sequences);
+    assert(unique.moves < expected.moves);
+    destroyGameBoard(&board);
+
+    for (i = 0; i < sizeof backends / sizeof backends[0]; ++i)
+    {
+        board = createGameBoardWithBackend(4, 5, 3, backends[i]);
+        setBoardCell(&board, 0, 0, CELL_X);
+        setBoardCell(&board, 0, 1, CELL_X);
+        setBoardCell(&board, 3, 4, CELL_O);
+        if (i == 0)
+        {
+            expected = runPerft(&board, 5, 1, 1);
+        }
+        result = runPerft(&board, 5, 1, 4);
+        assert(result.sequences == expected.sequences);
+        assert(result.uniquePositions == expected.uniquePositions);
+        destroyGameBoard(&board);
+    }
+}
+
+
+/* Tests that dividePerft() splits the total between the moves. */
+static void dividePerftTest(void)
+{
+    GameBoard board = createGameBoard(3, 3, 3);
+    unsigned long counts[9];
+    unsigned long total = 0;
+    unsigned i = 0;
+
+    setBoardCell(&board, 1, 1, CELL_X);
+    dividePerft(&board, 3, 2, counts);
+    assert(counts[4] == 0);
+    for (i = 0; i < 9; ++i)
+    {
+        total += counts[i];
+    }
+    assert(total == runPerft(&board, 3, 0, 1).sequences);
+    /* Corners are alike, as are edges. */
+    assert(counts[0] == counts[8] && counts[1] == counts[7]);
+    assert(counts[0] == 7ul * 6ul);
+
+    destroyGameBoard(&board);
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+void perftTest(void)
+{
+    moduleTestHeader("perft");
+
+    runUnitTest("runPerft() tic-tac-toe counts", tictactoePerftTest);
+    runUnitTest("runPerft() board backends", backendPerftTest);
+    runUnitTest("dividePerft()", dividePerftTest);
+}
@@ -0,0 +1,11 @@
+/* Unit tests for the perft module. */
+
+#ifndef TESTS_PERFT_TEST_H
+#define TESTS_PERFT_TEST_H
+
+
+/* Runs the tests for the perft module. */
+void perftTest(void);
+
+
+#endif
@@ -0,0 +1,71 @@
+/* Unit tests for the random number module. */
+
+#include "random_test.h"
+
+#include "common.h"
+#include "../main/random.h"
+
+#include <assert.h>
+
+
+/* Number of numbers generated when testing. */
+#define TEST_SIZE 100000ul
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Tests seedRandom() and nextRandom(). */
+static void seedNextRandomTest(void)
+{
+    unsigned long a = seedRandom(0);
+    unsigned long b = seedRandom(0);
+    unsigned long c = seedRandom(1);
+    unsigned long i = 0;
+
+    assert(a != 0);
+    assert(a == b);
+    assert(a != c);
+
+    /* Same seed, same sequence. */
+    for (i = 0; i < 100; ++i)
+    {
+        assert(nextRandom(&a) == nextRandom(&b));
+    }
+    assert(nextRandom(&a) != nextRandom(&c));
+}
+
+
+/* Tests randomBelow(). */
+static void randomBelowTest(void)
+{
+    unsigned long state = seedRandom(42);
+    unsigned long counts[10] = {0};
+    unsigned long i = 0;
+
+    for (i = 0; i < TEST_SIZE; ++i)
+    {
+        assert(randomBelow(&state, 1) == 0);
+        ++counts[randomBelow(&state, 10)];
+    }
+
+    /* Roughly uniform. */
+    for (i = 0; i < 10; ++i)
+    {
+        assert(counts[i] > TEST_SIZE / 10u * 9u / 10u);
+        assert(counts[i] < TEST_SIZE / 10u * 11u / 10u);
+    }
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+void randomTest(void)
+{
+    moduleTestHeader("random");
+
+    runUnitTest("seedRandom() and nextRandom()", seedNextRandomTest);
+    runUnitTest("randomBelow()", randomBelowTest);
+}
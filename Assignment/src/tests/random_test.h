@@ -0,0 +1,11 @@
+/* Unit tests for the random number module. */
+
+#ifndef TESTS_RANDOM_TEST_H
+#define TESTS_RANDOM_TEST_H
+
+
+/* Runs the tests for the random number module. */
+void randomTest(void);
+
+
+#endif
@@ -0,0 +1,302 @@
+/* Unit tests for the render module. */
+
+#include "render_test.h"
+
+#include "common.h"
+#include "../main/board.h"
+#include "../main/render.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Checks that a frame holds exactly the given text. */
+static void assertFrame(FrameBuffer const* frame, char const* expected)
+{
+    assert(frame->length == strlen(expected));
+    assert(memcmp(frame->text, expected, frame->length) == 0);
+}
+
+
+/* Tests renderBoard() on a whole board, without labels. */
+static void renderFullBoardTest(void)
+{
+    GameBoard board = createGameBoard(2, 3, 2);
+    FrameBuffer frame = zeroedFrameBuffer();
+    Viewport viewport = fullViewport(&board);
+
+    renderBoard(&frame, &board, &viewport, 0);
+    assertFrame(&frame,
+        "-------------\n"
+        "|   |   |   |\n"
+        "-------------\n"
+        "|   |   |   |\n"
+        "-------------\n");
+
+    setBoardCell(&board, 0, 2, CELL_X);
+    setBoardCell(&board, 1, 0, CELL_O);
+    renderBoard(&frame, &board, &viewport, 0);
+    assertFrame(&frame,
+        "-------------\n"
+        "|   |   | X |\n"
+        "-------------\n"
+        "| O |   |   |\n"
+        "-------------\n");
+
+    destroyFrameBuffer(&frame);
+    destroyGameBoard(&board);
+}
+
+
+/* Tests renderBoard() on part of a board, with labels. */
+static void renderViewportTest(void)
+{
+    GameBoard board = createGameBoard(30, 30, 5);
+    FrameBuffer frame = zeroedFrameBuffer();
+    Viewport viewport;
+    size_t capacity = 0;
+
+    setBoardCell(&board, 9, 10, CELL_X);
+    setBoardCell(&board, 10, 8, CELL_O);
+    viewport = viewportAround(&board, 9, 9, 2, 3);
+    assert(viewport.firstRow == 8 && viewport.rows == 2);
+    assert(viewport.firstColumn == 8 && viewport.columns == 3);
+
+    /* Column numbers are written downwards, row numbers to the left. */
+    renderBoard(&frame, &board, &viewport, 1);
+    assertFrame(&frame,
+        "            1  \n"
+        "    8   9   0  \n"
+        "  -------------\n"
+        "8 |   |   |   |\n"
+        "  -------------\n"
+        "9 |   |   | X |\n"
+        "  -------------\n");
+    capacity = frame.capacity;
+
+    /* Smaller frames reuse the buffer. */
+    viewport = fullViewport(&board);
+    viewport.rows = 1;
+    viewport.columns = 1;
+    renderBoard(&frame, &board, &viewport, 0);
+    assertFrame(&frame, "-----\n|   |\n-----\n");
+    assert(frame.capacity == capacity);
+
+    destroyFrameBuffer(&frame);
+    destroyGameBoard(&board);
+}
+
+
+/* Tests that renderBoard() refuses frames bigger than RENDER_MAX_FRAME_SIZE,
+   whose sizes could overflow. */
+static void renderTooBigTest(void)
+{
+    GameBoard board = createGameBoard(UINT_MAX, UINT_MAX, 5);
+    FrameBuffer frame = zeroedFrameBuffer();
+    Viewport viewport = viewportAround(&board, 0, 0, 2, 3);
+
+    assert(renderBoard(&frame, &board, &viewport, 1));
+    assert(frame.length == renderedFrameSize(&viewport, 1));
+    assert(frame.length == renderedLineCount(&viewport, 1)
+        * (renderedLineWidth(&viewport, 1) + 1u));
+
+    viewport = fullViewport(&board);
+    assert(renderedFrameSize(&viewport, 0) == 0);
+    assert(!renderBoard(&frame, &board, &viewport, 0));
+    assert(frame.length == 0);
+    assert(writeFrame(&frame, stdout));
+
+    /* Just over the limit in either direction. */
+    viewport = viewportAround(&board, 0, 0, 2, RENDER_MAX_FRAME_SIZE / 8u);
+    assert(renderedFrameSize(&viewport, 0) == 0);
+    assert(!renderBoard(&frame, &board, &viewport, 0));
+    viewport = viewportAround(&board, 0, 0, RENDER_MAX_FRAME_SIZE / 16u, 2);
+    assert(renderedFrameSize(&viewport, 1) == 0);
+    assert(!renderBoard(&frame, &board, &viewport, 1));
+    viewport = viewportAround(&board, 0, 0, 2, RENDER_MAX_FRAME_SIZE / 32u);
+    assert(renderedFrameSize(&viewport, 0) > 0);
+
+    destroyFrameBuffer(&frame);
+    destroyGameBoard(&board);
+}
+
+
+/* Tests viewportAround() and isFullViewport(). */
+static void viewportAroundTest(void)
+{
+    GameBoard board = createGameBoard(50, 40, 5);
+    Viewport viewport = viewportAround(&board, 25, 20, 10, 10);
+
+    assert(viewport.firstRow == 20 && viewport.firstColumn == 15);
+    assert(viewport.rows == 10 && viewport.columns == 10);
+    assert(!isFullViewport(&board, &viewport));
+
+    /* Kept inside the board near the edges. */
+    viewport = viewportAround(&board, 1, 39, 10, 10);
+    assert(viewport.firstRow == 0 && viewport.firstColumn == 30);
+    viewport = viewportAround(&board, 49, 0, 10, 10);
+    assert(viewport.firstRow == 40 && viewport.firstColumn == 0);
+
+    /* Never bigger than the board. */
+    viewport = viewportAround(&board, 3, 3, 100, 100);
+    assert(viewport.firstRow == 0 && viewport.firstColumn == 0);
+    assert(viewport.rows == 50 && viewport.columns == 40);
+    assert(isFullViewport(&board, &viewport));
+
+    destroyGameBoard(&board);
+}
+
+
+/* Tests renderedCellPosition() and renderedLineCount() against the text of
+   frames, with and without labels. */
+static void renderedCellPositionTest(void)
+{
+    GameBoard board = createGameBoard(120, 130, 5);
+    FrameBuffer frame = zeroedFrameBuffer();
+    Viewport viewport = viewportAround(&board, 100, 110, 15, 12);
+    unsigned long line = 0;
+    unsigned long character = 0;
+    unsigned long lineLength = 0;
+    unsigned i = 0;
+    unsigned j = 0;
+    int labels = 0;
+
+    for (i = 0; i < board.rows; ++i)
+    {
+        for (j = 0; j < board.columns; ++j)
+        {
+            setBoardCell(&board, i, j, (i + j) % 3u == 0 ? CELL_X : CELL_O);
+        }
+    }
+    assert(viewportContains(&viewport, 100, 110));
+    assert(!viewportContains(&viewport, 100, 0));
+    assert(!viewportContains(&viewport, 0, 110));
+
+    for (labels = 0; labels < 2; ++labels)
+    {
+        renderBoard(&frame, &board, &viewport, labels);
+        lineLength = frame.length / renderedLineCount(&viewport, labels);
+        assert(lineLength * renderedLineCount(&viewport, labels)
+            == frame.length);
+        assert(frame.text[lineLength - 1u] == '\n');
+
+        for (i = 0; i < viewport.rows; ++i)
+        {
+            for (j = 0; j < viewport.columns; ++j)
+            {
+                renderedCellPosition(&viewport, labels,
+                    viewport.firstRow + i, viewport.firstColumn + j, &line,
+                    &character);
+                assert(character < lineLength - 1u);
+                assert(frame.text[line * lineLength + character]
+                    == renderedCellChar(getBoardCell(&board,
+                        viewport.firstRow + i, viewport.firstColumn + j)));
+            }
+        }
+    }
+
+    destroyFrameBuffer(&frame);
+    destroyGameBoard(&board);
+}
+
+
+/* Tests fitViewport() on an 80x24 screen, and that it falls back when not
+   even one cell fits. */
+static void fitViewportTest(void)
+{
+    GameBoard small = createGameBoard(3, 3, 3);
+    GameBoard tall = createGameBoard(12, 12, 5);
+    GameBoard wide = createGameBoard(20, 20, 5);
+    GameBoard huge = createGameBoard(1000, 1000, 5);
+    Viewport viewport = fullViewport(&small);
+    int labels = 1;
+
+    /* Small boards are shown whole. */
+    assert(fitViewport(&small, 1, 1, 20, 20, 24, 80, &viewport, &labels));
+    assert(!labels && isFullViewport(&small, &viewport));
+
+    /* 12 rows take 25 lines, so fewer are shown, with labels. */
+    assert(renderedLineCount(&viewport, 0) <= 24);
+    viewport = fullViewport(&tall);
+    assert(renderedLineCount(&viewport, 0) > 24);
+    assert(fitViewport(&tall, 11, 11, 20, 20, 24, 80, &viewport, &labels));
+    assert(labels && viewport.columns == 12 && viewport.rows < 12);
+    assert(renderedLineCount(&viewport, 1) <= 24);
+    assert(viewportContains(&viewport, 11, 11));
+
+    /* 20 columns take 81 characters, so fewer are shown. */
+    viewport = fullViewport(&wide);
+    assert(renderedLineWidth(&viewport, 0) >= 80);
+    assert(fitViewport(&wide, 0, 19, 20, 20, 100, 80, &viewport, &labels));
+    assert(labels && viewport.rows == 20 && viewport.columns < 20);
+    assert(renderedLineWidth(&viewport, 1) < 80);
+    assert(viewportContains(&viewport, 0, 19));
+
+    /* Never more than the maximum viewport. */
+    assert(fitViewport(&huge, 500, 500, 20, 20, 1000, 1000, &viewport,
+        &labels));
+    assert(labels && viewport.rows == 20 && viewport.columns == 20);
+
+    /* Nothing fits, so nothing is set. */
+    viewport = fullViewport(&small);
+    labels = 0;
+    assert(!fitViewport(&huge, 500, 500, 20, 20, 3, 80, &viewport, &labels));
+    assert(!fitViewport(&huge, 500, 500, 20, 20, 24, 8, &viewport, &labels));
+    assert(!labels && isFullViewport(&small, &viewport));
+
+    destroyGameBoard(&small);
+    destroyGameBoard(&tall);
+    destroyGameBoard(&wide);
+    destroyGameBoard(&huge);
+}
+
+
+/* Tests writeFrame(). */
+static void writeFrameTest(void)
+{
+    GameBoard board = createGameBoard(3, 3, 3);
+    FrameBuffer frame = zeroedFrameBuffer();
+    Viewport const viewport = fullViewport(&board);
+    FILE* file = tmpfile();
+    char text[256] = {0};
+    size_t length = 0;
+
+    assert(file);
+    setBoardCell(&board, 1, 1, CELL_X);
+    renderBoard(&frame, &board, &viewport, 1);
+
+    fprintf(file, "before\n");
+    assert(writeFrame(&frame, file));
+    rewind(file);
+    length = fread(text, 1, sizeof text - 1u, file);
+    assert(length == 7u + frame.length);
+    assert(strncmp(text, "before\n", 7) == 0);
+    assert(memcmp(text + 7, frame.text, frame.length) == 0);
+
+    fclose(file);
+    destroyFrameBuffer(&frame);
+    destroyGameBoard(&board);
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+void renderTest(void)
+{
+    moduleTestHeader("render");
+
+    runUnitTest("renderBoard() on a whole board", renderFullBoardTest);
+    runUnitTest("renderBoard() on a viewport", renderViewportTest);
+    runUnitTest("renderBoard() on too big a frame", renderTooBigTest);
+    runUnitTest("viewportAround()", viewportAroundTest);
+    runUnitTest("renderedCellPosition()", renderedCellPositionTest);
+    runUnitTest("fitViewport()", fitViewportTest);
+    runUnitTest("writeFrame()", writeFrameTest);
+}
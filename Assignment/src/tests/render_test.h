@@ -0,0 +1,11 @@
+/* Unit tests for the render module. */
+
+#ifndef TESTS_RENDER_TEST_H
+#define TESTS_RENDER_TEST_H
+
+
+/* Runs the tests for the render module. */
+void renderTest(void);
+
+
+#endif
@@ -0,0 +1,248 @@
+/* Unit tests for the script module. */
+
+#include "script_test.h"
+
+#include "common.h"
+#include "../main/common.h"
+#include "../main/log.h"
+#include "../main/script.h"
+#include "../main/settings.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Size of the buffer the results of a script are read back into. */
+#define RESULTS_SIZE 1024u
+
+
+/* Makes settings for an m by n board needing k in a row. */
+static Settings testSettings(unsigned m, unsigned n, unsigned k)
+{
+    Settings settings = zeroedSettings();
+
+    settings.m = m;
+    settings.n = n;
+    settings.k = k;
+
+    return settings;
+}
+
+
+/* Runs a script given as text, reading what it writes back into results,
+   which holds RESULTS_SIZE characters. */
+static ScriptStats runScriptText(Settings const* settings, char const* text,
+    char* results, int logGames)
+{
+    FILE* in = tmpfile();
+    FILE* out = tmpfile();
+    ScriptStats stats = zeroedScriptStats();
+    size_t length = 0;
+    int error = 0;
+
+    assert(in && out);
+    fputs(text, in);
+    rewind(in);
+
+    stats = runScript(settings, in, out, logGames, &error);
+    assert(!error);
+
+    rewind(out);
+    length = fread(results, 1, RESULTS_SIZE - 1u, out);
+    results[length] = '\0';
+
+    fclose(in);
+    fclose(out);
+
+    return stats;
+}
+
+
+/* Checks that the single game log doesn't record a dead draw, then frees the
+   logs. */
+static void assertNoDeadDrawLogged(void)
+{
+    FILE* file = tmpfile();
+    char text[RESULTS_SIZE];
+    size_t length = 0;
+
+    assert(file);
+    assert(countGameLogs() == 1);
+    writeGameLogs(file);
+    rewind(file);
+    length = fread(text, 1, sizeof text - 1u, file);
+    text[length] = '\0';
+    assert(strstr(text, "Turn 9:") != NULL);
+    assert(strstr(text, "Ended early") == NULL);
+    fclose(file);
+    freeGameLogs();
+}
+
+
+/* Tests zeroedScriptStats(). */
+static void zeroedScriptStatsTest(void)
+{
+    ScriptStats const stats = zeroedScriptStats();
+    assert(stats.games == 0);
+    assert(stats.moves == 0);
+    assert(stats.wins[PLAYER_X] == 0 && stats.wins[PLAYER_O] == 0);
+    assert(stats.draws == 0 && stats.deadDraws == 0);
+    assert(stats.unfinished == 0 && stats.invalid == 0);
+}
+
+
+/* Tests runScript() with valid games, comments and blank lines. */
+static void validScriptTest(void)
+{
+    Settings settings = testSettings(3, 3, 3);
+    char results[RESULTS_SIZE];
+    ScriptStats stats = zeroedScriptStats();
+
+    settings.strictRules = 1;
+    stats = runScriptText(&settings,
+        "# Games on a 3x3 board.\n"
+        "0,0 1,0 0,1 1,1 0,2\n"
+        "\n"
+        "1,1 0,0 2,2 2,0 1,0 1,2 0,2 0,1 2,1 # A draw.\n"
+        "1,1\t0,0  2 , 2\r\n"
+        "0,0 2,0 1,0 2,1 0,2 2,2", results, 1);
+
+    assert(stats.games == 4);
+    assert(stats.wins[PLAYER_X] == 1 && stats.wins[PLAYER_O] == 1);
+    assert(stats.draws == 1 && stats.deadDraws == 0);
+    assert(stats.unfinished == 1 && stats.invalid == 0);
+    assert(stats.moves == 5 + 9 + 3 + 6);
+    assert(strcmp(results,
+        "2: X won in 5 moves\n"
+        "4: draw in 9 moves\n"
+        "5: unfinished after 3 moves\n"
+        "6: O won in 6 moves\n") == 0);
+
+    /* Every valid game is logged. */
+    assert(countGameLogs() == 4);
+    freeGameLogs();
+
+    printScriptStats(&stats);
+}
+
+
+/* Tests that runScript() ends dead drawn games unless playing by strict
+   rules. */
+static void deadDrawScriptTest(void)
+{
+    Settings settings = testSettings(3, 3, 3);
+    char const* const script = "1,1 0,0 2,2 2,0 1,0 1,2 0,2 0,1 2,1\n";
+    char results[RESULTS_SIZE];
+    ScriptStats stats = zeroedScriptStats();
+
+    /* Neither player can win after the eighth move, so the last is after the
+       end of the game. */
+    stats = runScriptText(&settings, script, results, 0);
+    assert(stats.invalid == 1);
+    assert(strcmp(results, "1: invalid, move 9 is after the end of the game\n")
+        == 0);
+
+    stats = runScriptText(&settings, "1,1 0,0 2,2 2,0 1,0 1,2 0,2 0,1\n",
+        results, 0);
+    assert(stats.draws == 1 && stats.deadDraws == 1);
+    assert(strcmp(results, "1: dead draw in 8 moves\n") == 0);
+
+    /* O can still complete the bottom row until X fills the board, which
+       doesn't make it a dead draw. */
+    stats = runScriptText(&settings, "0,0 1,0 2,0 0,1 1,1 0,2 2,1 2,2 1,2\n",
+        results, 1);
+    assert(stats.draws == 1 && stats.deadDraws == 0);
+    assert(strcmp(results, "1: draw in 9 moves\n") == 0);
+    assertNoDeadDrawLogged();
+}
+
+
+/* Tests runScript() with invalid games, which are reported and skipped
+   without stopping the games after them. */
+static void invalidScriptTest(void)
+{
+    Settings settings = testSettings(3, 3, 3);
+    char results[RESULTS_SIZE];
+    ScriptStats stats = zeroedScriptStats();
+
+    settings.strictRules = 1;
+    stats = runScriptText(&settings,
+        "0,0 3,0\n"
+        "0,0 1,1 0,0\n"
+        "0,0 1,0 0,1 1,1 0,2 2,2\n"
+        "0,0 1,x 0,1\n"
+        "0,0 1,\n"
+        "0,0 99999999999999999999,0\n"
+        "0,0 1,1\n", results, 1);
+
+    assert(stats.games == 7);
+    assert(stats.invalid == 6);
+    assert(stats.unfinished == 1);
+    assert(stats.moves == 2);
+    assert(strcmp(results,
+        "1: invalid, move 2 is out of bounds\n"
+        "2: invalid, move 3 is on an occupied cell\n"
+        "3: invalid, move 6 is after the end of the game\n"
+        "4: invalid, move 2 is malformed\n"
+        "5: invalid, move 2 is malformed\n"
+        "6: invalid, move 2 is out of bounds\n"
+        "7: unfinished after 2 moves\n") == 0);
+
+    /* Only the valid game is logged. */
+    assert(countGameLogs() == 1);
+    freeGameLogs();
+}
+
+
+/* Tests runScript() with a script spanning several of the chunks it is read
+   in, with a game across the boundary of each. */
+static void longScriptTest(void)
+{
+    Settings settings = testSettings(3, 3, 3);
+    char const* const game = "0,0 1,0 0,1 1,1 0,2   # X wins.\n";
+    unsigned long const games = 200000ul / strlen(game) + 1u;
+    FILE* in = tmpfile();
+    FILE* out = tmpfile();
+    ScriptStats stats = zeroedScriptStats();
+    unsigned long i = 0;
+    int error = 0;
+
+    assert(in && out);
+    for (i = 0; i < games; ++i)
+    {
+        fputs(game, in);
+    }
+    rewind(in);
+
+    settings.strictRules = 1;
+    stats = runScript(&settings, in, out, 0, &error);
+    assert(!error);
+    assert(stats.games == games);
+    assert(stats.wins[PLAYER_X] == games);
+    assert(stats.invalid == 0);
+    assert(stats.moves == games * 5u);
+
+    fclose(in);
+    fclose(out);
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+void scriptTest(void)
+{
+    moduleTestHeader("script");
+
+    runUnitTest("zeroedScriptStats()", zeroedScriptStatsTest);
+    runUnitTest("runScript() valid games", validScriptTest);
+    runUnitTest("runScript() dead draws", deadDrawScriptTest);
+    runUnitTest("runScript() invalid games", invalidScriptTest);
+    runUnitTest("runScript() long scripts", longScriptTest);
+}
@@ -0,0 +1,11 @@
+/* Unit tests for the script module. */
+
+#ifndef TESTS_SCRIPT_TEST_H
+#define TESTS_SCRIPT_TEST_H
+
+
+/* Runs the tests for the script module. */
+void scriptTest(void);
+
+
+#endif
@@ -0,0 +1,227 @@
+/* Unit tests for the search module. */
+
+#include "search_test.h"
+
+#include "common.h"
+#include "../main/board.h"
+#include "../main/search.h"
+#include "../main/transposition.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stddef.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Limits used for test searches. Large enough to never be hit by the small
+   positions tested, so results do not depend on machine speed. */
+static SearchLimits testLimits(unsigned maxDepth)
+{
+    SearchLimits limits = defaultSearchLimits();
+
+    limits.maxDepth = maxDepth;
+    limits.softSeconds = 60.0;
+    limits.maxSeconds = 60.0;
+
+    return limits;
+}
+
+
+/* Tests defaultSearchLimits(). */
+static void defaultSearchLimitsTest(void)
+{
+    SearchLimits const limits = defaultSearchLimits();
+    assert(limits.maxDepth > 0 && limits.maxDepth <= MAX_SEARCH_DEPTH);
+    assert(limits.softSeconds > 0.0);
+    assert(limits.softSeconds <= limits.maxSeconds);
+    assert(limits.maxSeconds > 0.0);
+    assert(limits.threads > 0);
+}
+
+
+/* Tests that the search plays an immediate win. */
+static void immediateWinTest(void)
+{
+    GameBoard board = createGameBoard(7, 7, 4);
+    TranspositionTable table = createTranspositionTable(1ul << 12);
+    SearchResult result;
+
+    /* X to move with three in a row, blocked on the left. */
+    setBoardCell(&board, 3, 1, CELL_X);
+    setBoardCell(&board, 3, 0, CELL_O);
+    setBoardCell(&board, 3, 2, CELL_X);
+    setBoardCell(&board, 0, 0, CELL_O);
+    setBoardCell(&board, 3, 3, CELL_X);
+    setBoardCell(&board, 6, 6, CELL_O);
+
+    result = searchBestMove(&board, &table, testLimits(3));
+    assert(result.found);
+    assert(result.row == 3 && result.column == 4);
+    assert(result.score >= FORCED_SCORE);
+    assert(result.nodes > 0);
+
+    destroyTranspositionTable(&table);
+    destroyGameBoard(&board);
+}
+
+
+/* Tests that the search blocks an immediate loss. */
+static void blockLossTest(void)
+{
+    GameBoard board = createGameBoard(6, 6, 3);
+    TranspositionTable table = createTranspositionTable(1ul << 12);
+    SearchResult result;
+
+    /* O to move; X threatens to complete the column at (1,4) or (4,4). */
+    setBoardCell(&board, 2, 4, CELL_X);
+    setBoardCell(&board, 0, 0, CELL_O);
+    setBoardCell(&board, 3, 4, CELL_X);
+    setBoardCell(&board, 5, 0, CELL_O);
+    setBoardCell(&board, 5, 3, CELL_X);
+    assert(nextPlayer(&board) == PLAYER_O);
+
+    result = searchBestMove(&board, &table, testLimits(2));
+    assert(result.found);
+    assert(result.column == 4);
+    assert(result.row == 1 || result.row == 4);
+
+    destroyTranspositionTable(&table);
+    destroyGameBoard(&board);
+}
+
+
+/* Tests that perfect play on 3x3 tic-tac-toe is a draw, and that the table
+   is reused between searches. */
+static void tictactoeTest(void)
+{
+    GameBoard board = createGameBoard(3, 3, 3);
+    TranspositionTable table = createTranspositionTable(1ul << 14);
+    SearchResult result;
+    int won = 0;
+
+    while (board.occupied < 9u && !won)
+    {
+        result = searchBestMove(&board, &table, testLimits(9));
+        assert(result.found);
+        assert(result.score > -FORCED_SCORE && result.score < FORCED_SCORE);
+        assert(getBoardCell(&board, result.row, result.column) == CELL_EMPTY);
+        setBoardCell(&board, result.row, result.column,
+            playerToCell(nextPlayer(&board)));
+        won = hasPlayerWonAt(&board, result.row, result.column);
+    }
+    assert(!won);
+
+    /* Board is full, so there is no move. */
+    result = searchBestMove(&board, &table, testLimits(9));
+    assert(!result.found);
+
+    destroyTranspositionTable(&table);
+    destroyGameBoard(&board);
+}
+
+
+/* Tests searching on a huge sparse board stays local to the stones. */
+static void sparseBoardSearchTest(void)
+{
+    GameBoard board = createGameBoard(UINT_MAX, UINT_MAX, 5);
+    TranspositionTable table = createTranspositionTable(1ul << 12);
+    SearchResult result;
+    unsigned firstRow = 0;
+    unsigned firstColumn = 0;
+
+    result = searchBestMove(&board, &table, testLimits(1));
+    assert(result.found);
+    firstRow = result.row;
+    firstColumn = result.column;
+    setBoardCell(&board, firstRow, firstColumn, CELL_X);
+
+    /* The reply is next to the only stone. */
+    result = searchBestMove(&board, &table, testLimits(2));
+    assert(result.found);
+    assert(getBoardCell(&board, result.row, result.column) == CELL_EMPTY);
+    assert(result.row + 1u >= firstRow && result.row <= firstRow + 1u);
+    assert(result.column + 1u >= firstColumn
+        && result.column <= firstColumn + 1u);
+
+    destroyTranspositionTable(&table);
+    destroyGameBoard(&board);
+}
+
+
+
+/* Tests that Lazy SMP searches with several threads find the same forced
+   results as single threaded ones. */
+static void lazySmpTest(void)
+{
+    GameBoard board = createGameBoard(4, 4, 3);
+    TranspositionTable table = createTranspositionTable(1ul << 14);
+    SearchLimits limits = testLimits(16);
+    SearchResult single;
+    SearchResult result;
+
+    /* X wins 4x4 with k=3 by force. */
+    limits.threads = 1;
+    single = searchBestMove(&board, &table, limits);
+    assert(single.score >= FORCED_SCORE);
+    assert(single.threads == 1);
+
+    clearTranspositionTable(&table);
+    limits.threads = 4;
+    result = searchBestMove(&board, &table, limits);
+    assert(result.found);
+    assert(result.threads == 4);
+    assert(result.score == single.score);
+    assert(result.ttProbes > 0);
+
+    /* Tic-tac-toe is still a draw. */
+    destroyGameBoard(&board);
+    board = createGameBoard(3, 3, 3);
+    clearTranspositionTable(&table);
+    result = searchBestMove(&board, &table, limits);
+    assert(result.score > -FORCED_SCORE && result.score < FORCED_SCORE);
+    assert(result.depth == 9);
+
+    destroyTranspositionTable(&table);
+    destroyGameBoard(&board);
+}
+
+
+
+/* Tests that no iteration starts after the soft time limit, while the one in
+   progress completes. */
+static void softTimeLimitTest(void)
+{
+    GameBoard board = createGameBoard(7, 7, 4);
+    TranspositionTable table = createTranspositionTable(1ul << 12);
+    SearchLimits limits = testLimits(MAX_SEARCH_DEPTH);
+    SearchResult result;
+
+    limits.threads = 1;
+    limits.softSeconds = 0.0;
+    setBoardCell(&board, 3, 3, CELL_X);
+    result = searchBestMove(&board, &table, limits);
+    assert(result.found);
+    assert(result.depth == 1);
+
+    destroyTranspositionTable(&table);
+    destroyGameBoard(&board);
+}
+
+
+/* PUBLIC INTERFACE */
+
+
+void searchTest(void)
+{
+    moduleTestHeader("search");
+
+    runUnitTest("defaultSearchLimits()", defaultSearchLimitsTest);
+    runUnitTest("searchBestMove() plays an immediate win", immediateWinTest);
+    runUnitTest("searchBestMove() blocks an immediate loss", blockLossTest);
+    runUnitTest("searchBestMove() draws 3x3 tic-tac-toe", tictactoeTest);
+    runUnitTest("searchBestMove() on a huge board", sparseBoardSearchTest);
+    runUnitTest("Lazy SMP searches", lazySmpTest);
+    runUnitTest("Soft time limit", softTimeLimitTest);
+}
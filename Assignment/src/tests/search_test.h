@@ -0,0 +1,11 @@
+/* Unit tests for the search module. */
+
+#ifndef TESTS_SEARCH_TEST_H
+#define TESTS_SEARCH_TEST_H
+
+
+/* Runs the tests for the search module. */
+void searchTest(void);
+
+
+#endif
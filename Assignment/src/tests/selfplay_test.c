@@ -0,0 +1,193 @@
+/* Unit tests for the self-play module. */
+
+#include "selfplay_test.h"
+
+#include "common.h"
+#include "../main/common.h"
+#include "../main/log.h"
+#include "../main/selfplay.h"
+#include "../main/settings.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdio.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Makes settings for self-play between the given players. */
+static Settings testSettings(unsigned m, unsigned n, unsigned k,
+    PlayerType x, PlayerType o)
+{
+    Settings settings = zeroedSettings();
+
+    settings.m = m;
+    settings.n = n;
+    settings.k = k;
+    settings.players[PLAYER_X] = x;
+    settings.players[PLAYER_O] = o;
+    settings.threads = 1;
+
+    return settings;
+}
+
+
+/* Tests zeroedSelfPlayStats() and destroySelfPlayStats(). */
+static void zeroedDestroySelfPlayStatsTest(void)
+{
+    SelfPlayStats stats = zeroedSelfPlayStats();
+    assert(stats.games == 0);
+    assert(stats.moves == 0);
+    assert(stats.turnChecks.samples == NULL);
+
+    addLatencySample(&stats.turnChecks, 1.0);
+    destroySelfPlayStats(&stats);
+    assert(stats.turnChecks.samples == NULL);
+}
+
+
+/* Tests runSelfPlay() between random players. */
+static void randomSelfPlayTest(void)
+{
+    Settings const settings = testSettings(7, 6, 4, PLAYER_TYPE_RANDOM,
+        PLAYER_TYPE_RANDOM);
+    SelfPlayStats stats = runSelfPlay(&settings, 500, 1, 1, 0);
+
+    assert(stats.games == 500);
+    assert(stats.wins[PLAYER_X] + stats.wins[PLAYER_O] + stats.draws == 500);
+    assert(stats.cutShort == 0);
+    assert(stats.moves >= 500ul * 7u);
+    assert(stats.moves <= 500ul * 42u);
+    assert(stats.turnChecks.count == stats.moves);
+    assert(stats.fullChecks.count == 500);
+    /* Random play on this board almost always has a winner, and X moves
+       first so usually wins. */
+    assert(stats.wins[PLAYER_X] > stats.wins[PLAYER_O]);
+    assert(stats.wins[PLAYER_O] > 0);
+
+    printSelfPlayStats(&stats);
+    destroySelfPlayStats(&stats);
+}
+
+
+/* Tests runSelfPlay() on a board that can only be drawn, and with a search
+   player. */
+static void drawnSelfPlayTest(void)
+{
+    Settings settings = testSettings(3, 3, 4, PLAYER_TYPE_RANDOM,
+        PLAYER_TYPE_RANDOM);
+    SelfPlayStats stats = zeroedSelfPlayStats();
+
+    settings.strictRules = 1;
+    stats = runSelfPlay(&settings, 10, 1, 2, 0);
+    assert(stats.games == 10);
+    assert(stats.draws == 10);
+    assert(stats.deadDraws == 0);
+    assert(stats.moves == 90);
+    destroySelfPlayStats(&stats);
+
+    /* No line fits, so the games are dead from the start. */
+    settings.strictRules = 0;
+    stats = runSelfPlay(&settings, 10, 1, 2, 0);
+    assert(stats.games == 10);
+    assert(stats.draws == 10);
+    assert(stats.deadDraws == 10);
+    assert(stats.moves == 0);
+    destroySelfPlayStats(&stats);
+
+    /* Perfect play can't lose 3x3 tic-tac-toe. */
+    settings = testSettings(3, 3, 3, PLAYER_TYPE_ALPHA_BETA,
+        PLAYER_TYPE_RANDOM);
+    stats = runSelfPlay(&settings, 5, 1, 3, 0);
+    assert(stats.games == 5);
+    assert(stats.wins[PLAYER_O] == 0);
+    destroySelfPlayStats(&stats);
+}
+
+
+/* Tests that runSelfPlay() ends dead drawn games early, unless playing by
+   strict rules. */
+static void deadDrawSelfPlayTest(void)
+{
+    Settings settings = testSettings(5, 5, 4, PLAYER_TYPE_RANDOM,
+        PLAYER_TYPE_RANDOM);
+    SelfPlayStats strict = zeroedSelfPlayStats();
+    SelfPlayStats early = zeroedSelfPlayStats();
+
+    settings.strictRules = 1;
+    strict = runSelfPlay(&settings, 200, 1, 4, 0);
+    settings.strictRules = 0;
+    early = runSelfPlay(&settings, 200, 1, 4, 1);
+
+    /* The same games are played, but most draws stop before the board is
+       full. A draw still live until the last move isn't a dead draw. */
+    assert(strict.deadDraws == 0);
+    assert(early.deadDraws > 0 && early.deadDraws <= early.draws);
+    assert(early.draws == strict.draws);
+    assert(early.wins[PLAYER_X] == strict.wins[PLAYER_X]);
+    assert(early.moves < strict.moves);
+    assert(early.cutShort == 0);
+
+    assert(countGameLogs() == 200);
+    freeGameLogs();
+
+    printSelfPlayStats(&early);
+    destroySelfPlayStats(&strict);
+    destroySelfPlayStats(&early);
+}
+
+
+/* Tests runSelfPlay() on several threads, with logging. */
+static void threadedSelfPlayTest(void)
+{
+    Settings const settings = testSettings(7, 6, 4, PLAYER_TYPE_RANDOM,
+        PLAYER_TYPE_RANDOM);
+    SelfPlayStats single = runSelfPlay(&settings, 300, 1, 5, 0);
+    SelfPlayStats stats = runSelfPlay(&settings, 300, 4, 5, 1);
+    unsigned long games = 0;
+    unsigned long moves = 0;
+    unsigned i = 0;
+
+    assert(stats.threads == 4);
+    assert(stats.games == 300);
+    for (i = 0; i < stats.threads; ++i)
+    {
+        games += stats.threadStats[i].games;
+        moves += stats.threadStats[i].moves;
+    }
+    assert(games == 300);
+    assert(moves == stats.moves);
+    assert(stats.turnChecks.count == stats.moves);
+    assert(stats.fullChecks.count == 300);
+
+    /* Games are seeded by number, so the thread count doesn't change them. */
+    assert(stats.moves == single.moves);
+    assert(stats.wins[PLAYER_X] == single.wins[PLAYER_X]);
+    assert(stats.wins[PLAYER_O] == single.wins[PLAYER_O]);
+
+    assert(countGameLogs() == 300);
+    freeGameLogs();
+
+    printSelfPlayStats(&stats);
+    destroySelfPlayStats(&single);
+    destroySelfPlayStats(&stats);
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+void selfPlayTest(void)
+{
+    moduleTestHeader("selfplay");
+
+    runUnitTest("zeroedSelfPlayStats() and destroySelfPlayStats()",
+        zeroedDestroySelfPlayStatsTest);
+    runUnitTest("runSelfPlay() with random players", randomSelfPlayTest);
+    runUnitTest("runSelfPlay() drawn games and search players",
+        drawnSelfPlayTest);
+    runUnitTest("runSelfPlay() dead draws", deadDrawSelfPlayTest);
+    runUnitTest("runSelfPlay() on several threads", threadedSelfPlayTest);
+}
@@ -0,0 +1,11 @@
+/* Unit tests for the self-play module. */
+
+#ifndef TESTS_SELFPLAY_TEST_H
+#define TESTS_SELFPLAY_TEST_H
+
+
+/* Runs the tests for the self-play module. */
+void selfPlayTest(void);
+
+
+#endif
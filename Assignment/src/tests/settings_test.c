@@ -3,6 +3,7 @@
 #include "settings_test.h"
 
 #include "common.h"
+#include "../main/common.h"
 #include "../main/settings.h"
 
 #include <assert.h>
@@ -33,6 +34,8 @@
 #define VALID_NO_NEWLINE TEST_FILE_DIR "valid_no_newline.txt"
 #define VALID_EXTRA_SPACE TEST_FILE_DIR "valid_extra_space.txt"
 #define VALID_BLANK_LINES TEST_FILE_DIR "valid_blank_lines.txt"
+#define VALID_TIME_CONTROL TEST_FILE_DIR "valid_time_control.txt"
+#define INCREMENT_ONLY TEST_FILE_DIR "increment_only.txt"
 
 
 /* Asserts that all members of a Settings instance are zeroed out. */
@@ -41,6 +44,13 @@ static void assertSettingsZero(Settings const* settings)
     assert(settings->n == 0);
     assert(settings->m == 0);
     assert(settings->k == 0);
+    assert(settings->gameSeconds == 0);
+    assert(settings->incrementSeconds == 0);
+    assert(settings->players[PLAYER_X] == PLAYER_TYPE_HUMAN);
+    assert(settings->players[PLAYER_O] == PLAYER_TYPE_HUMAN);
+    assert(settings->threads == 0);
+    assert(settings->strictRules == 0);
+    assert(settings->ansiRedraw == 0);
 }
 
 
@@ -198,6 +208,37 @@ static void readSettingsTest(void)
     assert(settings.n == 3);
     assert(settings.m == 10);
     assert(settings.k == 4);
+    assert(settings.gameSeconds == 0);
+    printf("\n");
+
+    printf("Valid file with time control:\n");
+    error = 0;
+    settings = readSettings(VALID_TIME_CONTROL, &error);
+    assert(!error);
+    assert(settings.m == 7);
+    assert(settings.gameSeconds == 300);
+    assert(settings.incrementSeconds == 5);
+    printf("\n");
+
+    printf("Increment without game time (valid format):\n");
+    error = 0;
+    settings = readSettings(INCREMENT_ONLY, &error);
+    assert(!error);
+    assert(settings.gameSeconds == 0);
+    assert(settings.incrementSeconds == 5);
+    assert(!validateSettings(&settings, 1));
+    printf("\n");
+}
+
+
+/* Tests validateTimeSettings(). */
+static void validateTimeSettingsTest(void)
+{
+    assert(validateTimeSettings(0, 0));
+    assert(validateTimeSettings(60, 0));
+    assert(validateTimeSettings(60, 2));
+    printf("Increment without game time:\n");
+    assert(!validateTimeSettings(0, 2));
     printf("\n");
 }
 
@@ -401,6 +442,10 @@ static void writeSettingsTest(void)
     settings.m = 1;
     settings.k = 5;
     writeSettings(stdout, &settings);
+
+    settings.gameSeconds = 300;
+    settings.incrementSeconds = 5;
+    writeSettings(stdout, &settings);
 }
 
 
@@ -417,6 +462,7 @@ void settingsTest(void)
     runUnitTest("validateMSetting()", validateMSettingTest);
     runUnitTest("validateNSetting()", validateNSettingTest);
     runUnitTest("validateKSetting()", validateKSettingTest);
+    runUnitTest("validateTimeSettings()", validateTimeSettingsTest);
     runUnitTest("validateSettings()", validateSettingsTest);
     runUnitTest("validateSettingsCombo()", validateSettingsComboTest);
     runUnitTest("writeSettings()", writeSettingsTest);
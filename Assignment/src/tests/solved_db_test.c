@@ -0,0 +1,334 @@
+/* Unit tests for the solved-position database module. */
+
+#include "solved_db_test.h"
+
+#include "common.h"
+#include "../main/board.h"
+#include "../main/common.h"
+#include "../main/solved_db.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* File written by the tests, then removed. */
+#define TEST_FILE_PATH "solved_db_test.tmp"
+
+
+/* Works out the value of a position by searching the whole game tree, without
+   the database. */
+static SolvedValue bruteForceValue(GameBoard* board)
+{
+    Player const mover = nextPlayer(board);
+    SolvedValue best;
+    SolvedValue child;
+    unsigned row = 0;
+    unsigned column = 0;
+    int over = 0;
+    int found = 0;
+
+    best.outcome = SOLVED_UNKNOWN;
+    best.distance = 0;
+
+    if (board->occupied > 0 && hasPlayerWon(board, otherPlayer(mover)))
+    {
+        best.outcome = SOLVED_LOSS;
+        over = 1;
+    }
+    else if (board->occupied == (unsigned long)board->rows * board->columns)
+    {
+        best.outcome = SOLVED_DRAW;
+        over = 1;
+    }
+
+    for (row = 0; row < board->rows && !over; ++row)
+    {
+        for (column = 0; column < board->columns; ++column)
+        {
+            if (getBoardCell(board, row, column) == CELL_EMPTY)
+            {
+                makeMove(board, row, column, playerToCell(mover));
+                child = bruteForceValue(board);
+                unmakeMove(board);
+
+                if (child.outcome == SOLVED_LOSS)
+                {
+                    child.outcome = SOLVED_WIN;
+                }
+                else if (child.outcome == SOLVED_WIN)
+                {
+                    child.outcome = SOLVED_LOSS;
+                }
+                ++child.distance;
+
+                /* Fastest win, otherwise draw, otherwise slowest loss. */
+                if (!found || child.outcome > best.outcome
+                    || (child.outcome == best.outcome
+                        && (child.outcome == SOLVED_WIN
+                            ? child.distance < best.distance
+                            : child.distance > best.distance)))
+                {
+                    best = child;
+                    found = 1;
+                }
+            }
+        }
+    }
+
+    return best;
+}
+
+
+/* Plays random moves from an empty board until the given number of cells
+   are occupied or someone wins. */
+static void playRandomMoves(GameBoard* board, unsigned long occupied)
+{
+    unsigned row = 0;
+    unsigned column = 0;
+    int won = 0;
+
+    clearBoardCells(board);
+    while (board->occupied < occupied && !won)
+    {
+        row = (unsigned)rand() % board->rows;
+        column = (unsigned)rand() % board->columns;
+        if (getBoardCell(board, row, column) == CELL_EMPTY)
+        {
+            makeMove(board, row, column, playerToCell(nextPlayer(board)));
+            won = hasPlayerWonAt(board, row, column);
+        }
+    }
+}
+
+
+/* Checks random positions of a database against a brute force search, along
+   with the moves it chooses. Only positions with at most 9 cells empty are
+   checked, to keep the search quick. */
+static void checkAgainstBruteForce(SolvedDatabase const* database)
+{
+    unsigned const cells = database->rows * database->columns;
+    GameBoard board = createGameBoard(database->rows, database->columns,
+        database->winRequirement);
+    SolvedValue value;
+    SolvedValue expected;
+    SolvedValue after;
+    unsigned row = 0;
+    unsigned column = 0;
+    unsigned i = 0;
+
+    for (i = 0; i < 30u; ++i)
+    {
+        playRandomMoves(&board, (cells > 9u ? cells - 9u : 0)
+            + (unsigned)rand() % (cells < 9u ? cells + 1u : 10u));
+
+        value = lookupSolvedPosition(database, &board);
+        expected = bruteForceValue(&board);
+        assert(value.outcome == expected.outcome);
+        assert(value.distance == expected.distance);
+
+        if (solvedBestMove(database, &board, &row, &column, &after))
+        {
+            assert(after.outcome == value.outcome);
+            assert(after.distance == value.distance);
+            assert(getBoardCell(&board, row, column) == CELL_EMPTY);
+
+            /* The move keeps the value, one move closer to the end. */
+            makeMove(&board, row, column, playerToCell(nextPlayer(&board)));
+            after = lookupSolvedPosition(database, &board);
+            assert(after.distance + 1u == value.distance);
+            assert(after.outcome == (value.outcome == SOLVED_WIN ? SOLVED_LOSS
+                : value.outcome == SOLVED_LOSS ? SOLVED_WIN : SOLVED_DRAW));
+        }
+        else
+        {
+            assert(value.distance == 0);
+        }
+    }
+
+    destroyGameBoard(&board);
+}
+
+
+/* Tests zeroedSolvedDatabase(). */
+static void zeroedSolvedDatabaseTest(void)
+{
+    SolvedDatabase const database = zeroedSolvedDatabase();
+
+    assert(database.rows == 0);
+    assert(database.columns == 0);
+    assert(database.winRequirement == 0);
+    assert(database.positions == 0);
+    assert(database.binomials == NULL);
+    assert(database.layerOffsets == NULL);
+    assert(database.entries == NULL);
+    assert(database.ownedEntries == NULL);
+    assert(database.mapping == NULL);
+}
+
+
+/* Tests solveDatabase() and lookups on regular tic-tac-toe. */
+static void ticTacToeTest(void)
+{
+    SolvedDatabase database = solveDatabase(3, 3, 3, 0);
+    GameBoard board = createGameBoard(3, 3, 3);
+    GameBoard other = createGameBoard(4, 3, 3);
+    SolvedValue value;
+    unsigned row = 0;
+    unsigned column = 0;
+
+    /* Positions with as many X as O cells, or one more. */
+    assert(database.positions == 6046);
+    assert(solvedDatabaseMatches(&database, &board));
+    assert(!solvedDatabaseMatches(&database, &other));
+
+    value = lookupSolvedPosition(&database, &board);
+    assert(value.outcome == SOLVED_DRAW && value.distance == 9);
+
+    /* O answering a centre opening on an edge loses. */
+    setBoardCell(&board, 1, 1, CELL_X);
+    setBoardCell(&board, 0, 1, CELL_O);
+    value = lookupSolvedPosition(&database, &board);
+    assert(value.outcome == SOLVED_WIN);
+
+    /* X takes an immediate win. */
+    clearBoardCells(&board);
+    setBoardCell(&board, 0, 0, CELL_X);
+    setBoardCell(&board, 2, 0, CELL_O);
+    setBoardCell(&board, 0, 1, CELL_X);
+    setBoardCell(&board, 2, 1, CELL_O);
+    assert(solvedBestMove(&database, &board, &row, &column, &value));
+    assert(row == 0 && column == 2);
+    assert(value.outcome == SOLVED_WIN && value.distance == 1);
+
+    /* Game already won, and too many O cells to arise in a game. */
+    setBoardCell(&board, 0, 2, CELL_X);
+    value = lookupSolvedPosition(&database, &board);
+    assert(value.outcome == SOLVED_LOSS && value.distance == 0);
+    assert(!solvedBestMove(&database, &board, &row, &column, &value));
+    setBoardCell(&board, 0, 2, CELL_O);
+    setBoardCell(&board, 1, 2, CELL_O);
+    value = lookupSolvedPosition(&database, &board);
+    assert(value.outcome == SOLVED_UNKNOWN);
+
+    printf("Values (should be win in 3 moves, loss in 1 move, lost, draw, "
+        "unknown):\n");
+    value.outcome = SOLVED_WIN;
+    value.distance = 3;
+    writeSolvedValue(stdout, value);
+    printf("\n");
+    value.outcome = SOLVED_LOSS;
+    value.distance = 1;
+    writeSolvedValue(stdout, value);
+    printf("\n");
+    value.distance = 0;
+    writeSolvedValue(stdout, value);
+    printf("\n");
+    value.outcome = SOLVED_DRAW;
+    writeSolvedValue(stdout, value);
+    printf("\n");
+    value.outcome = SOLVED_UNKNOWN;
+    writeSolvedValue(stdout, value);
+    printf("\n");
+
+    checkAgainstBruteForce(&database);
+
+    destroyGameBoard(&other);
+    destroyGameBoard(&board);
+    destroySolvedDatabase(&database);
+    assert(database.binomials == NULL);
+}
+
+
+/* Tests solveDatabase() against a brute force search on other boards. */
+static void bruteForceTest(void)
+{
+    unsigned const settings[][3] = {{1, 1, 1}, {2, 2, 2}, {3, 4, 3},
+        {4, 3, 4}, {2, 5, 2}};
+    SolvedDatabase database = zeroedSolvedDatabase();
+    unsigned i = 0;
+
+    for (i = 0; i < sizeof settings / sizeof settings[0]; ++i)
+    {
+        database = solveDatabase(settings[i][0], settings[i][1],
+            settings[i][2], 0);
+        checkAgainstBruteForce(&database);
+        destroySolvedDatabase(&database);
+    }
+}
+
+
+/* Tests writeSolvedDatabase() and openSolvedDatabase(). */
+static void fileTest(void)
+{
+    SolvedDatabase solved = solveDatabase(3, 4, 3, 0);
+    SolvedDatabase opened = zeroedSolvedDatabase();
+    GameBoard board = createGameBoard(3, 4, 3);
+    SolvedValue solvedValue;
+    SolvedValue openedValue;
+    FILE* file = fopen(TEST_FILE_PATH, "wb");
+    int error = 0;
+    unsigned i = 0;
+
+    assert(file);
+    writeSolvedDatabase(file, &solved);
+    assert(!ferror(file));
+    fclose(file);
+
+    opened = openSolvedDatabase(TEST_FILE_PATH, &error);
+    assert(!error);
+    assert(opened.mapping != NULL);
+    assert(opened.ownedEntries == NULL);
+    assert(opened.positions == solved.positions);
+    assert(solvedDatabaseMatches(&opened, &board));
+
+    for (i = 0; i < 200u; ++i)
+    {
+        playRandomMoves(&board, (unsigned)rand() % 13u);
+        solvedValue = lookupSolvedPosition(&solved, &board);
+        openedValue = lookupSolvedPosition(&opened, &board);
+        assert(solvedValue.outcome == openedValue.outcome);
+        assert(solvedValue.distance == openedValue.distance);
+    }
+
+    destroySolvedDatabase(&opened);
+    assert(opened.mapping == NULL);
+
+    /* Truncated file. */
+    file = fopen(TEST_FILE_PATH, "wb");
+    assert(file);
+    fwrite("MNKSOLV1", 1, 8, file);
+    fclose(file);
+    printf("Invalid database (should print an error):\n");
+    opened = openSolvedDatabase(TEST_FILE_PATH, &error);
+    assert(error);
+    assert(opened.entries == NULL);
+
+    remove(TEST_FILE_PATH);
+    error = 0;
+    printf("Missing database (should print an error):\n");
+    opened = openSolvedDatabase(TEST_FILE_PATH, &error);
+    assert(error);
+    assert(opened.entries == NULL);
+
+    destroyGameBoard(&board);
+    destroySolvedDatabase(&solved);
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+void solvedDatabaseTest(void)
+{
+    moduleTestHeader("solved_db");
+
+    runUnitTest("zeroedSolvedDatabase()", zeroedSolvedDatabaseTest);
+    runUnitTest("Tic-tac-toe", ticTacToeTest);
+    runUnitTest("Brute force comparison", bruteForceTest);
+    runUnitTest("Database files", fileTest);
+}
@@ -0,0 +1,11 @@
+/* Unit tests for the solved-position database module. */
+
+#ifndef TESTS_SOLVED_DB_TEST_H
+#define TESTS_SOLVED_DB_TEST_H
+
+
+/* Runs the tests for the solved-position database module. */
+void solvedDatabaseTest(void);
+
+
+#endif
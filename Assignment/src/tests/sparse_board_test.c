@@ -0,0 +1,149 @@
+/* Unit tests for the sparse board module. */
+
+#include "sparse_board_test.h"
+
+#include "common.h"
+#include "../main/sparse_board.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+
+/* Controls the number of cells stored when testing. */
+#define TEST_SIZE 20000u
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Gets the value stored for the i-th test cell. Never 0. */
+static unsigned char testValue(unsigned i)
+{
+    return (unsigned char)(i % 2u + 1u);
+}
+
+
+/* Tests zeroedSparseBoard(). */
+static void zeroedSparseBoardTest(void)
+{
+    SparseBoard sparse = zeroedSparseBoard();
+    assert(sparse.capacity == 0);
+    assert(sparse.count == 0);
+    assert(sparse.slots == NULL);
+}
+
+
+/* Tests createSparseBoard() and destroySparseBoard(). */
+static void createDestroySparseBoardTest(void)
+{
+    SparseBoard sparse = createSparseBoard();
+    assert(sparse.capacity > 0);
+    assert(sparse.count == 0);
+    assert(sparse.slots != NULL);
+    assert(getSparseCell(&sparse, 0, 0) == 0);
+    assert(getSparseCell(&sparse, UINT_MAX, UINT_MAX) == 0);
+
+    destroySparseBoard(&sparse);
+    assert(sparse.capacity == 0);
+    assert(sparse.slots == NULL);
+}
+
+
+/* Tests setSparseCell() and getSparseCell(), including growth and removal. */
+static void setGetSparseCellTest(void)
+{
+    SparseBoard sparse = createSparseBoard();
+    unsigned i = 0;
+
+    /* Cells spread along a diagonal and clustered near the origin. */
+    for (i = 0; i < TEST_SIZE; ++i)
+    {
+        setSparseCell(&sparse, i * 7919u, UINT_MAX - i, testValue(i));
+        setSparseCell(&sparse, i / 100u, i % 100u, testValue(i + 1u));
+    }
+    assert(sparse.count == TEST_SIZE * 2u);
+    assert(sparse.count * 2u <= sparse.capacity);
+
+    for (i = 0; i < TEST_SIZE; ++i)
+    {
+        assert(getSparseCell(&sparse, i * 7919u, UINT_MAX - i) == testValue(i));
+        assert(getSparseCell(&sparse, i / 100u, i % 100u)
+            == testValue(i + 1u));
+        assert(getSparseCell(&sparse, UINT_MAX - i, i * 7919u) == 0);
+    }
+
+    /* Overwrite. */
+    setSparseCell(&sparse, 0, 0, 2);
+    assert(getSparseCell(&sparse, 0, 0) == 2);
+    assert(sparse.count == TEST_SIZE * 2u);
+
+    /* Remove every other cell, the rest must still be found. */
+    for (i = 0; i < TEST_SIZE; i += 2u)
+    {
+        setSparseCell(&sparse, i * 7919u, UINT_MAX - i, 0);
+        setSparseCell(&sparse, i / 100u, i % 100u, 0);
+    }
+    assert(sparse.count == TEST_SIZE);
+    for (i = 0; i < TEST_SIZE; ++i)
+    {
+        if (i % 2u == 0)
+        {
+            assert(getSparseCell(&sparse, i * 7919u, UINT_MAX - i) == 0);
+            assert(getSparseCell(&sparse, i / 100u, i % 100u) == 0);
+        }
+        else
+        {
+            assert(getSparseCell(&sparse, i * 7919u, UINT_MAX - i)
+                == testValue(i));
+            assert(getSparseCell(&sparse, i / 100u, i % 100u)
+                == testValue(i + 1u));
+        }
+    }
+
+    /* Removing a cell that isn't stored does nothing. */
+    setSparseCell(&sparse, 12345u, 54321u, 0);
+    assert(sparse.count == TEST_SIZE);
+
+    destroySparseBoard(&sparse);
+}
+
+
+/* Tests clearSparseBoard(). */
+static void clearSparseBoardTest(void)
+{
+    SparseBoard sparse = createSparseBoard();
+    unsigned i = 0;
+    unsigned row = 0;
+    unsigned column = 0;
+
+    for (i = 0; i < TEST_SIZE; ++i)
+    {
+        row = rand();
+        column = rand();
+        setSparseCell(&sparse, row, column, 1);
+    }
+
+    clearSparseBoard(&sparse);
+    assert(sparse.count == 0);
+    assert(getSparseCell(&sparse, row, column) == 0);
+
+    destroySparseBoard(&sparse);
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+void sparseBoardTest(void)
+{
+    moduleTestHeader("sparse board");
+
+    runUnitTest("zeroedSparseBoard()", zeroedSparseBoardTest);
+    runUnitTest("createSparseBoard() and destroySparseBoard()",
+        createDestroySparseBoardTest);
+    runUnitTest("setSparseCell() and getSparseCell()", setGetSparseCellTest);
+    runUnitTest("clearSparseBoard()", clearSparseBoardTest);
+}
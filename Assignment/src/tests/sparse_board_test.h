@@ -0,0 +1,11 @@
+/* Unit tests for the sparse board module. */
+
+#ifndef TESTS_SPARSE_BOARD_TEST_H
+#define TESTS_SPARSE_BOARD_TEST_H
+
+
+/* Runs the tests for the sparse board module. */
+void sparseBoardTest(void);
+
+
+#endif
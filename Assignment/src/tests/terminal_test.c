@@ -0,0 +1,80 @@
+/* Unit tests for the terminal module. */
+
+#include "terminal_test.h"
+
+#include "common.h"
+#include "../main/terminal.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Checks that a file holds exactly the given text, then empties it. */
+static void assertFileText(FILE* file, char const* expected)
+{
+    char text[64] = {0};
+    size_t length = 0;
+
+    rewind(file);
+    length = fread(text, 1, sizeof text - 1u, file);
+    assert(length == strlen(expected));
+    assert(memcmp(text, expected, length) == 0);
+
+    fclose(file);
+}
+
+
+/* Tests isTerminal() and terminalSize() on a file. */
+static void isTerminalTest(void)
+{
+    FILE* file = tmpfile();
+    unsigned long lines = 7;
+    unsigned long characters = 9;
+
+    assert(file);
+    assert(!isTerminal(file));
+    assert(!terminalSize(file, &lines, &characters));
+    assert(lines == 7 && characters == 9);
+    fclose(file);
+}
+
+
+/* Tests the escape codes written by clearScreen(), moveCursor() and
+   clearToScreenEnd(). */
+static void escapeCodesTest(void)
+{
+    FILE* file = tmpfile();
+
+    assert(file);
+    clearScreen(file);
+    assertFileText(file, "\033[2J\033[H");
+
+    file = tmpfile();
+    assert(file);
+    /* Counted from 1 by the terminal. */
+    moveCursor(file, 0, 0);
+    moveCursor(file, 11, 40);
+    assertFileText(file, "\033[1;1H\033[12;41H");
+
+    file = tmpfile();
+    assert(file);
+    clearToScreenEnd(file);
+    assertFileText(file, "\033[J");
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+void terminalTest(void)
+{
+    moduleTestHeader("terminal");
+
+    runUnitTest("isTerminal() and terminalSize()", isTerminalTest);
+    runUnitTest("escape codes", escapeCodesTest);
+}
@@ -0,0 +1,11 @@
+/* Unit tests for the terminal module. */
+
+#ifndef TESTS_TERMINAL_TEST_H
+#define TESTS_TERMINAL_TEST_H
+
+
+/* Runs the tests for the terminal module. */
+void terminalTest(void);
+
+
+#endif
@@ -0,0 +1,125 @@
+/* Unit tests for the threads module. */
+
+#include "threads_test.h"
+
+#include "common.h"
+#include "../main/threads.h"
+
+#include <assert.h>
+#include <stdlib.h>
+
+
+/* Controls the number of tasks run when testing. */
+#define TEST_SIZE 10000ul
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Counts the runs of each task. */
+typedef struct
+{
+    unsigned* runs;             /* Times each task was run. */
+    unsigned long* perWorker;   /* Tasks run by each thread. */
+} TaskCounts;
+
+
+/* Task function recording that a task was run. Tasks of the first thread are
+   slow, so that the other threads steal from it. */
+static void countTask(unsigned long index, unsigned worker, void* context)
+{
+    TaskCounts* const counts = context;
+    unsigned long spin = 0;
+    unsigned long volatile sink = 0;
+
+    if (worker == 0)
+    {
+        for (spin = 0; spin < 20000ul; ++spin)
+        {
+            sink += spin;
+        }
+    }
+
+    /* Each task is only run once, and each thread only writes its own
+       counter, so no locking is needed. */
+    ++counts->runs[index];
+    ++counts->perWorker[worker];
+}
+
+
+/* Tests processorCount(). */
+static void processorCountTest(void)
+{
+    assert(processorCount() >= 1);
+}
+
+
+/* Tests that runWorkStealing() runs every task exactly once. */
+static void runWorkStealingTest(void)
+{
+    static unsigned const THREAD_COUNTS[] = {1, 2, 3, 8};
+    TaskCounts counts;
+    unsigned long steals[8] = {0};
+    unsigned long total = 0;
+    unsigned long i = 0;
+    unsigned t = 0;
+    unsigned threads = 0;
+
+    counts.runs = malloc(TEST_SIZE * sizeof(unsigned));
+    counts.perWorker = malloc(8 * sizeof(unsigned long));
+
+    for (t = 0; t < sizeof THREAD_COUNTS / sizeof THREAD_COUNTS[0]; ++t)
+    {
+        threads = THREAD_COUNTS[t];
+        for (i = 0; i < TEST_SIZE; ++i)
+        {
+            counts.runs[i] = 0;
+        }
+        for (i = 0; i < threads; ++i)
+        {
+            counts.perWorker[i] = 0;
+        }
+
+        runWorkStealing(TEST_SIZE, threads, countTask, &counts, steals);
+
+        for (i = 0; i < TEST_SIZE; ++i)
+        {
+            assert(counts.runs[i] == 1);
+        }
+        total = 0;
+        for (i = 0; i < threads; ++i)
+        {
+            total += counts.perWorker[i];
+        }
+        assert(total == TEST_SIZE);
+        if (threads == 1)
+        {
+            assert(steals[0] == 0);
+        }
+    }
+
+    /* Fewer tasks than threads, and no tasks. */
+    for (i = 0; i < 3; ++i)
+    {
+        counts.runs[i] = 0;
+    }
+    runWorkStealing(3, 8, countTask, &counts, NULL);
+    assert(counts.runs[0] == 1 && counts.runs[1] == 1 && counts.runs[2] == 1);
+    runWorkStealing(0, 4, countTask, &counts, NULL);
+
+    free(counts.runs);
+    free(counts.perWorker);
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+void threadsTest(void)
+{
+    moduleTestHeader("threads");
+
+    runUnitTest("processorCount()", processorCountTest);
+    runUnitTest("runWorkStealing()", runWorkStealingTest);
+}
@@ -0,0 +1,11 @@
+/* Unit tests for the threads module. */
+
+#ifndef TESTS_THREADS_TEST_H
+#define TESTS_THREADS_TEST_H
+
+
+/* Runs the tests for the threads module. */
+void threadsTest(void);
+
+
+#endif
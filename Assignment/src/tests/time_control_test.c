@@ -0,0 +1,92 @@
+/* Unit tests for the time control module. */
+
+#include "time_control_test.h"
+
+#include "common.h"
+#include "../main/board.h"
+#include "../main/time_control.h"
+
+#include <assert.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Tests createGameClock(). */
+static void createGameClockTest(void)
+{
+    GameClock const clock = createGameClock(60.0, 2.0);
+    assert(clock.remaining[PLAYER_X] == 60.0);
+    assert(clock.remaining[PLAYER_O] == 60.0);
+    assert(clock.increment == 2.0);
+}
+
+
+/* Tests moveTimeBudget(). */
+static void moveTimeBudgetTest(void)
+{
+    GameClock clock = createGameClock(60.0, 0.0);
+    GameBoard board = createGameBoard(20, 20, 5);
+    double soft = 0.0;
+    double hard = 0.0;
+    double first = 0.0;
+
+    /* Spread over many moves on an empty board, with room to overrun. */
+    moveTimeBudget(&clock, &board, &soft, &hard);
+    assert(soft > 0.0 && soft < 60.0 / 20.0);
+    assert(hard > soft && hard < 60.0);
+
+    /* Only the mover's clock counts. */
+    first = soft;
+    clock.remaining[PLAYER_O] = 1.0;
+    moveTimeBudget(&clock, &board, &soft, &hard);
+    assert(soft == first);
+
+    /* The increment can be spent every move. */
+    clock.increment = 5.0;
+    moveTimeBudget(&clock, &board, &soft, &hard);
+    assert(soft > 5.0 && hard >= soft);
+    destroyGameBoard(&board);
+
+    /* With one move left, the hard limit is nearly all the time left. */
+    board = createGameBoard(1, 2, 2);
+    setBoardCell(&board, 0, 0, CELL_X);
+    clock.increment = 0.0;
+    moveTimeBudget(&clock, &board, &soft, &hard);
+    assert(hard < 1.0 && hard > 0.5 && soft <= hard);
+
+    /* Never negative, even with no time left. */
+    clock.remaining[PLAYER_O] = -1.0;
+    moveTimeBudget(&clock, &board, &soft, &hard);
+    assert(soft == 0.0 && hard == 0.0);
+    destroyGameBoard(&board);
+}
+
+
+/* Tests chargeGameClock(). */
+static void chargeGameClockTest(void)
+{
+    GameClock clock = createGameClock(10.0, 1.0);
+
+    assert(chargeGameClock(&clock, PLAYER_X, 4.0));
+    assert(clock.remaining[PLAYER_X] == 7.0);
+    assert(clock.remaining[PLAYER_O] == 10.0);
+
+    /* Running out isn't made up for by the increment. */
+    assert(!chargeGameClock(&clock, PLAYER_O, 10.5));
+    assert(clock.remaining[PLAYER_O] < 0.0);
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+void timeControlTest(void)
+{
+    moduleTestHeader("time control");
+
+    runUnitTest("createGameClock()", createGameClockTest);
+    runUnitTest("moveTimeBudget()", moveTimeBudgetTest);
+    runUnitTest("chargeGameClock()", chargeGameClockTest);
+}
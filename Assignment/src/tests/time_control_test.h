@@ -0,0 +1,11 @@
+/* Unit tests for the time control module. */
+
+#ifndef TESTS_TIME_CONTROL_TEST_H
+#define TESTS_TIME_CONTROL_TEST_H
+
+
+/* Runs the tests for the time control module. */
+void timeControlTest(void);
+
+
+#endif
@@ -0,0 +1,68 @@
+/* Unit tests for the timer module. */
+
+#include "timer_test.h"
+
+#include "common.h"
+#include "../main/timer.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Tests monotonicSeconds(). */
+static void monotonicSecondsTest(void)
+{
+    double const first = monotonicSeconds();
+    double const second = monotonicSeconds();
+    assert(second >= first);
+}
+
+
+/* Tests zeroedLatencySamples(), addLatencySample(), latencyPercentile() and
+   destroyLatencySamples(). */
+static void latencySamplesTest(void)
+{
+    LatencySamples latencies = zeroedLatencySamples();
+    unsigned i = 0;
+
+    assert(latencies.samples == NULL);
+    assert(latencies.count == 0);
+    assert(latencyPercentile(&latencies, 50.0) == 0.0);
+
+    /* 1 to 2000, added out of order. */
+    for (i = 0; i < 2000; ++i)
+    {
+        addLatencySample(&latencies, (i * 7u) % 2000u + 1.0);
+    }
+    assert(latencies.count == 2000);
+
+    assert(latencyPercentile(&latencies, 0.0) == 1.0);
+    assert(latencyPercentile(&latencies, 50.0) == 1000.0);
+    assert(latencyPercentile(&latencies, 75.0) == 1500.0);
+    assert(latencyPercentile(&latencies, 87.5) == 1750.0);
+    assert(latencyPercentile(&latencies, 100.0) == 2000.0);
+
+    /* Adding after sorting. */
+    addLatencySample(&latencies, 0.5);
+    assert(latencyPercentile(&latencies, 0.0) == 0.5);
+
+    destroyLatencySamples(&latencies);
+    assert(latencies.samples == NULL);
+    assert(latencies.count == 0);
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+void timerTest(void)
+{
+    moduleTestHeader("timer");
+
+    runUnitTest("monotonicSeconds()", monotonicSecondsTest);
+    runUnitTest("Latency samples", latencySamplesTest);
+}
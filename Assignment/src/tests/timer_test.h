@@ -0,0 +1,11 @@
+/* Unit tests for the timer module. */
+
+#ifndef TESTS_TIMER_TEST_H
+#define TESTS_TIMER_TEST_H
+
+
+/* Runs the tests for the timer module. */
+void timerTest(void);
+
+
+#endif
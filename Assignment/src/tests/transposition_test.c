@@ -0,0 +1,240 @@
+/* Unit tests for the transposition table module. */
+
+#include "transposition_test.h"
+
+#include "common.h"
+#include "../main/threads.h"
+#include "../main/transposition.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Keys stored and probed by concurrentTask(). Few enough to share buckets. */
+#define CONCURRENT_KEYS 64ul
+
+
+/* Makes an entry with the given key and depth and an exact score. */
+static TableEntry testEntry(unsigned long key, unsigned depth, int score)
+{
+    TableEntry entry;
+
+    entry.key = key;
+    entry.score = score;
+    entry.depth = (unsigned short)depth;
+    entry.bound = BOUND_EXACT;
+    entry.generation = 0;
+    entry.hasMove = 1;
+    entry.row = depth;
+    entry.column = depth + 1u;
+
+    return entry;
+}
+
+
+/* Tests zeroedTranspositionTable(). */
+static void zeroedTranspositionTableTest(void)
+{
+    TranspositionTable table = zeroedTranspositionTable();
+    assert(table.bucketCount == 0);
+    assert(table.entries == NULL);
+    assert(table.probes == 0);
+    assert(table.hits == 0);
+}
+
+
+/* Tests createTranspositionTable() and destroyTranspositionTable(). */
+static void createDestroyTranspositionTableTest(void)
+{
+    TranspositionTable table = createTranspositionTable(1000);
+    TableEntry entry;
+
+    /* Rounded down to a power of 2 buckets. */
+    assert(table.bucketCount == 128);
+    assert(table.entries != NULL);
+    assert(!probeTable(&table, 12345, &entry));
+
+    destroyTranspositionTable(&table);
+    assert(table.bucketCount == 0);
+    assert(table.entries == NULL);
+}
+
+
+/* Tests storeTable() and probeTable(). */
+static void storeProbeTableTest(void)
+{
+    TranspositionTable table = createTranspositionTable(1024);
+    TableEntry stored = testEntry(0xdeadbeeful, 5, -42);
+    TableEntry entry;
+    unsigned long key = 0;
+
+    newTableSearch(&table);
+    storeTable(&table, &stored);
+    assert(probeTable(&table, stored.key, &entry));
+    assert(entry.key == stored.key);
+    assert(entry.score == -42);
+    assert(entry.depth == 5);
+    assert(entry.bound == BOUND_EXACT);
+    assert(entry.hasMove);
+    assert(entry.row == 5 && entry.column == 6);
+    assert(!probeTable(&table, stored.key + 1u, &entry));
+    assert(table.probes == 2);
+    assert(table.hits == 1);
+
+    /* Same key is overwritten in place. */
+    stored.score = 17;
+    stored.depth = 2;
+    storeTable(&table, &stored);
+    assert(probeTable(&table, stored.key, &entry));
+    assert(entry.score == 17 && entry.depth == 2);
+
+    /* Many keys, each retrievable while the table is lightly loaded. */
+    for (key = 1; key <= 100; ++key)
+    {
+        stored = testEntry(key * 0x9e3779b97f4a7c15ul, key % 7u, (int)key);
+        storeTable(&table, &stored);
+    }
+    for (key = 1; key <= 100; ++key)
+    {
+        assert(probeTable(&table, key * 0x9e3779b97f4a7c15ul, &entry));
+        assert(entry.score == (int)key);
+    }
+
+    clearTranspositionTable(&table);
+    assert(!probeTable(&table, 0x9e3779b97f4a7c15ul, &entry));
+
+    destroyTranspositionTable(&table);
+}
+
+
+/* Tests that full buckets replace the shallowest entry, and prefer entries
+   from earlier searches. */
+static void replacementTest(void)
+{
+    /* One bucket, so every key collides. */
+    TranspositionTable table = createTranspositionTable(TABLE_BUCKET_SIZE);
+    TableEntry stored;
+    TableEntry entry;
+    unsigned i = 0;
+
+    assert(table.bucketCount == 1);
+
+    newTableSearch(&table);
+    for (i = 0; i < TABLE_BUCKET_SIZE; ++i)
+    {
+        stored = testEntry(100u + i, 10u + i, 0);
+        storeTable(&table, &stored);
+    }
+
+    /* The shallowest entry (key 100) is replaced. */
+    stored = testEntry(200, 1, 0);
+    storeTable(&table, &stored);
+    assert(probeTable(&table, 200, &entry));
+    assert(!probeTable(&table, 100, &entry));
+    for (i = 1; i < TABLE_BUCKET_SIZE; ++i)
+    {
+        assert(probeTable(&table, 100u + i, &entry));
+    }
+
+    /* After a new search, old deep entries are replaced before new shallow
+       ones. */
+    newTableSearch(&table);
+    assert(table.probes == 0 && table.hits == 0);
+    stored = testEntry(300, 0, 0);
+    storeTable(&table, &stored);
+    stored = testEntry(301, 0, 0);
+    storeTable(&table, &stored);
+    assert(probeTable(&table, 300, &entry));
+    assert(probeTable(&table, 301, &entry));
+
+    destroyTranspositionTable(&table);
+}
+
+
+
+/* Tests that an entry torn by concurrent writes doesn't match its key. */
+static void tornEntryTest(void)
+{
+    TranspositionTable table = createTranspositionTable(TABLE_BUCKET_SIZE);
+    TableEntry stored = testEntry(1234, 3, 10);
+    TableEntry entry;
+    TableSlot first;
+    TableSlot second;
+
+    storeTable(&table, &stored);
+    first = table.entries[0];
+    stored = testEntry(1234, 4, -10);
+    storeTable(&table, &stored);
+    assert(probeTable(&table, 1234, &entry));
+    assert(entry.depth == 4 && entry.score == -10);
+    second = table.entries[0];
+
+    /* The first write's key check, with the second's data. */
+    table.entries[0].check = first.check;
+    assert(!probeTable(&table, 1234, &entry));
+
+    /* The first write's move, with the rest from the second. */
+    table.entries[0] = second;
+    table.entries[0].move = first.move;
+    assert(!probeTable(&table, 1234, &entry));
+
+    destroyTranspositionTable(&table);
+}
+
+
+/* Stores and probes entries for a few keys through a copy of a shared table,
+   checking that every entry found is one that was stored. */
+static void concurrentTask(unsigned long index, unsigned _, void* context)
+{
+    TranspositionTable table = *(TranspositionTable const*)context;
+    TableEntry stored;
+    TableEntry entry;
+    unsigned long i = 0;
+    unsigned long key = 0;
+
+    for (i = 0; i < 1000u; ++i)
+    {
+        key = (index * 7u + i) % CONCURRENT_KEYS + 1u;
+        stored = testEntry(key, (unsigned)(index + i) % 50u, -(int)key);
+        storeTable(&table, &stored);
+        if (probeTable(&table, key, &entry))
+        {
+            assert(entry.key == key && entry.score == -(int)key);
+            assert(entry.row == entry.depth
+                && entry.column == entry.depth + 1u);
+        }
+    }
+}
+
+
+/* Tests storeTable() and probeTable() from several threads at once. */
+static void concurrentTest(void)
+{
+    TranspositionTable table = createTranspositionTable(16);
+
+    newTableSearch(&table);
+    runWorkStealing(256, 4, concurrentTask, &table, NULL);
+
+    destroyTranspositionTable(&table);
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+void transpositionTest(void)
+{
+    moduleTestHeader("transposition");
+
+    runUnitTest("zeroedTranspositionTable()", zeroedTranspositionTableTest);
+    runUnitTest("createTranspositionTable() and destroyTranspositionTable()",
+        createDestroyTranspositionTableTest);
+    runUnitTest("storeTable() and probeTable()", storeProbeTableTest);
+    runUnitTest("Torn entries", tornEntryTest);
+    runUnitTest("Concurrent access", concurrentTest);
+    runUnitTest("Replacement policy", replacementTest);
+}
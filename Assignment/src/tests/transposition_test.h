@@ -0,0 +1,11 @@
+/* Unit tests for the transposition table module. */
+
+#ifndef TESTS_TRANSPOSITION_TEST_H
+#define TESTS_TRANSPOSITION_TEST_H
+
+
+/* Runs the tests for the transposition table module. */
+void transpositionTest(void);
+
+
+#endif
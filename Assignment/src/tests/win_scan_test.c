@@ -0,0 +1,187 @@
+/* Unit tests for the win scan module. */
+
+#include "win_scan_test.h"
+
+#include "common.h"
+#include "../main/board.h"
+#include "../main/win_scan.h"
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Board widths tested, around the vector and bit mask widths. */
+static unsigned const COLUMNS[] = {1, 3, 4, 5, 7, 8, 9, 16, 31, 32, 33, 65};
+/* Win requirements tested, around the bit mask width. */
+static unsigned const WIN_REQUIREMENTS[] = {1, 2, 3, 5, 8, 31, 32, 33};
+/* Direction of each line tested by lineTest(). */
+static int const ROW_STEPS[] = {0, 1, 1, 1};
+static int const COLUMN_STEPS[] = {1, 0, 1, -1};
+
+/* The vector kernels. */
+static WinScanKernel const VECTOR_KERNELS[] = {WIN_SCAN_SSE2, WIN_SCAN_AVX2};
+
+/* Checks that every supported vector kernel agrees with the scalar scan on a
+   board, for both players. */
+static void assertKernelsAgree(GameBoard const* board)
+{
+    int scalar[2];
+    unsigned i = 0;
+
+    selectWinScanKernel(WIN_SCAN_SCALAR);
+    scalar[PLAYER_X] = hasPlayerWon(board, PLAYER_X);
+    scalar[PLAYER_O] = hasPlayerWon(board, PLAYER_O);
+    selectWinScanKernel(WIN_SCAN_AUTO);
+
+    for (i = 0; i < 2u; ++i)
+    {
+        if (winScanKernelSupported(VECTOR_KERNELS[i]))
+        {
+            assert(vectorHasWon(board, CELL_X, VECTOR_KERNELS[i])
+                == scalar[PLAYER_X]);
+            assert(vectorHasWon(board, CELL_O, VECTOR_KERNELS[i])
+                == scalar[PLAYER_O]);
+        }
+    }
+    assert(hasPlayerWon(board, PLAYER_X) == scalar[PLAYER_X]);
+    assert(hasPlayerWon(board, PLAYER_O) == scalar[PLAYER_O]);
+}
+
+
+/* Tests the kernel selection functions. */
+static void kernelSelectionTest(void)
+{
+    assert(winScanKernelSupported(WIN_SCAN_AUTO));
+    assert(winScanKernelSupported(WIN_SCAN_SCALAR));
+    /* AVX2 processors all have SSE2. */
+    assert(!winScanKernelSupported(WIN_SCAN_AVX2)
+        || winScanKernelSupported(WIN_SCAN_SSE2));
+
+    assert(selectWinScanKernel(WIN_SCAN_SCALAR));
+    assert(activeWinScanKernel() == WIN_SCAN_SCALAR);
+    assert(selectWinScanKernel(WIN_SCAN_AUTO));
+    assert(activeWinScanKernel() != WIN_SCAN_AUTO);
+    assert(winScanKernelSupported(activeWinScanKernel()));
+    assert(activeWinScanKernel() == WIN_SCAN_AVX2
+        || !winScanKernelSupported(WIN_SCAN_AVX2));
+
+    assert(strcmp(winScanKernelName(WIN_SCAN_SCALAR), "scalar") == 0);
+    assert(strcmp(winScanKernelName(WIN_SCAN_AVX2), "avx2") == 0);
+}
+
+
+/* Tests vectorHasWon() against the scalar scan on random boards of many
+   shapes, with X filling more or less of each. */
+static void randomBoardTest(void)
+{
+    GameBoard board;
+    unsigned rows = 0;
+    unsigned c = 0;
+    unsigned w = 0;
+    unsigned percent = 0;
+    unsigned trial = 0;
+    unsigned i = 0;
+    unsigned j = 0;
+    unsigned draw = 0;
+
+    for (rows = 1; rows <= 40u; rows += 3u)
+    {
+        for (c = 0; c < sizeof COLUMNS / sizeof COLUMNS[0]; ++c)
+        {
+            for (w = 0; w < sizeof WIN_REQUIREMENTS
+                / sizeof WIN_REQUIREMENTS[0]; ++w)
+            {
+                board = createGameBoard(rows, COLUMNS[c], WIN_REQUIREMENTS[w]);
+                for (percent = 50; percent < 100u; percent += 20u)
+                {
+                    for (trial = 0; trial < 2u; ++trial)
+                    {
+                        for (i = 0; i < rows; ++i)
+                        {
+                            for (j = 0; j < COLUMNS[c]; ++j)
+                            {
+                                draw = (unsigned)rand() % 100u;
+                                setBoardCell(&board, i, j, draw < percent
+                                    ? CELL_X : draw % 2u ? CELL_O
+                                    : CELL_EMPTY);
+                            }
+                        }
+                        assertKernelsAgree(&board);
+                    }
+                }
+                destroyGameBoard(&board);
+            }
+        }
+    }
+}
+
+
+/* Tests vectorHasWon() on single lines of X in each direction, of exactly the
+   win requirement and one short of it, among O cells. */
+static void lineTest(void)
+{
+    unsigned const rows = 40;
+    unsigned const columns = 45;
+    unsigned const k = 9;
+    GameBoard board = createGameBoard(rows, columns, k);
+    unsigned d = 0;
+    unsigned trial = 0;
+    unsigned length = 0;
+    unsigned i = 0;
+    unsigned j = 0;
+    long row = 0;
+    long column = 0;
+
+    for (d = 0; d < 4u; ++d)
+    {
+        for (trial = 0; trial < 20u; ++trial)
+        {
+            for (length = k - 1u; length <= k; ++length)
+            {
+                for (i = 0; i < rows; ++i)
+                {
+                    for (j = 0; j < columns; ++j)
+                    {
+                        setBoardCell(&board, i, j, CELL_O);
+                    }
+                }
+                /* Picked so the whole line fits, from any cell to an edge. */
+                row = ROW_STEPS[d] ? rand() % (long)(rows - k + 1u)
+                    : rand() % (long)rows;
+                column = COLUMN_STEPS[d] > 0
+                    ? rand() % (long)(columns - k + 1u)
+                    : COLUMN_STEPS[d] < 0
+                    ? (long)k - 1 + rand() % (long)(columns - k + 1u)
+                    : rand() % (long)columns;
+                for (i = 0; i < length; ++i)
+                {
+                    setBoardCell(&board, row + (long)i * ROW_STEPS[d],
+                        column + (long)i * COLUMN_STEPS[d], CELL_X);
+                }
+                assertKernelsAgree(&board);
+                selectWinScanKernel(WIN_SCAN_AUTO);
+                assert(hasPlayerWon(&board, PLAYER_X) == (length == k));
+            }
+        }
+    }
+
+    destroyGameBoard(&board);
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+void winScanTest(void)
+{
+    moduleTestHeader("win scan");
+
+    runUnitTest("kernel selection", kernelSelectionTest);
+    runUnitTest("vectorHasWon() on random boards", randomBoardTest);
+    runUnitTest("vectorHasWon() on lines", lineTest);
+}
@@ -0,0 +1,11 @@
+/* Unit tests for the win scan module. */
+
+#ifndef TESTS_WIN_SCAN_TEST_H
+#define TESTS_WIN_SCAN_TEST_H
+
+
+/* Runs the tests for the win scan module. */
+void winScanTest(void);
+
+
+#endif
@@ -0,0 +1,118 @@
+/* Unit tests for the window counts module. */
+
+#include "window_counts_test.h"
+
+#include "common.h"
+#include "../main/common.h"
+#include "../main/window_counts.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+
+/* PRIVATE INTERFACE */
+
+
+/* Tests zeroedWindowCounts(). */
+static void zeroedWindowCountsTest(void)
+{
+    WindowCounts windows = zeroedWindowCounts();
+    assert(windows.rows == 0);
+    assert(windows.columns == 0);
+    assert(windows.counts == NULL);
+    assert(windows.open[PLAYER_X] == NULL);
+    assert(windows.open[PLAYER_O] == NULL);
+    assert(windows.total == 0);
+}
+
+
+/* Tests createWindowCounts() and destroyWindowCounts(). */
+static void createDestroyWindowCountsTest(void)
+{
+    WindowCounts windows = createWindowCounts(3, 3, 3);
+
+    /* 3 rows, 3 columns and 2 diagonals. */
+    assert(windows.total == 8);
+    assert(windows.maxCount == 3);
+    assert(countOpenWindows(&windows, PLAYER_X, 0) == 8);
+    assert(countDeadWindows(&windows) == 0);
+    destroyWindowCounts(&windows);
+    assert(windows.counts == NULL);
+
+    /* Rows 4 * 3, columns 2 * 5, and 2 * 3 along each diagonal. */
+    windows = createWindowCounts(4, 5, 3);
+    assert(windows.total == 34);
+    destroyWindowCounts(&windows);
+
+    /* Windows only fit along rows. */
+    windows = createWindowCounts(2, 6, 4);
+    assert(windows.total == 6);
+    destroyWindowCounts(&windows);
+
+    /* No windows fit at all. */
+    windows = createWindowCounts(3, 4, 5);
+    assert(windows.total == 0);
+    assert(windows.maxCount == 0);
+    updateWindowCounts(&windows, PLAYER_X, 2, 3, 1);
+    assert(countOpenWindows(&windows, PLAYER_X, 1) == 0);
+    assert(!windowCountsHasWon(&windows, PLAYER_X));
+    assert(windowCountsAllDead(&windows));
+    destroyWindowCounts(&windows);
+}
+
+
+/* Tests updateWindowCounts() and the window queries. */
+static void updateWindowCountsTest(void)
+{
+    WindowCounts windows = createWindowCounts(3, 3, 3);
+    WindowCounts copy = zeroedWindowCounts();
+
+    /* The centre is in its row, column and both diagonals. */
+    updateWindowCounts(&windows, PLAYER_X, 1, 1, 1);
+    assert(countOpenWindows(&windows, PLAYER_X, 1) == 4);
+    assert(countOpenWindows(&windows, PLAYER_O, 1) == 0);
+    assert(countOpenWindows(&windows, PLAYER_X, 0) == 4);
+
+    /* A corner shares the top row with nothing, and a diagonal with X. */
+    updateWindowCounts(&windows, PLAYER_O, 0, 0, 1);
+    assert(countOpenWindows(&windows, PLAYER_X, 1) == 3);
+    assert(countOpenWindows(&windows, PLAYER_O, 1) == 2);
+    assert(countDeadWindows(&windows) == 1);
+    assert(!windowCountsAllDead(&windows));
+
+    updateWindowCounts(&windows, PLAYER_X, 0, 2, 1);
+    updateWindowCounts(&windows, PLAYER_X, 2, 0, 1);
+    assert(countOpenWindows(&windows, PLAYER_X, 3) == 1);
+    assert(windowCountsHasWon(&windows, PLAYER_X));
+    assert(!windowCountsHasWon(&windows, PLAYER_O));
+
+    /* Copies are independent. */
+    copy = copyWindowCounts(&windows);
+    updateWindowCounts(&windows, PLAYER_X, 2, 0, 0);
+    assert(!windowCountsHasWon(&windows, PLAYER_X));
+    assert(countOpenWindows(&windows, PLAYER_X, 2) == 1);
+    assert(windowCountsHasWon(&copy, PLAYER_X));
+
+    clearWindowCounts(&windows);
+    assert(countOpenWindows(&windows, PLAYER_X, 0) == 8);
+    assert(countOpenWindows(&windows, PLAYER_X, 1) == 0);
+    assert(countDeadWindows(&windows) == 0);
+
+    destroyWindowCounts(&copy);
+    destroyWindowCounts(&windows);
+}
+
+
+
+/* PUBLIC INTERFACE */
+
+
+void windowCountsTest(void)
+{
+    moduleTestHeader("window counts");
+
+    runUnitTest("zeroedWindowCounts()", zeroedWindowCountsTest);
+    runUnitTest("createWindowCounts() and destroyWindowCounts()",
+        createDestroyWindowCountsTest);
+    runUnitTest("updateWindowCounts() and queries", updateWindowCountsTest);
+}
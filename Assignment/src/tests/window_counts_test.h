@@ -0,0 +1,11 @@
+/* Unit tests for the window counts module. */
+
+#ifndef TESTS_WINDOW_COUNTS_TEST_H
+#define TESTS_WINDOW_COUNTS_TEST_H
+
+
+/* Runs the tests for the window counts module. */
+void windowCountsTest(void);
+
+
+#endif
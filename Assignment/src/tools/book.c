@@ -0,0 +1,131 @@
+/* Opening book builder entry point. Searches the positions near the start of
+   games with the given settings much deeper than computer players do while
+   playing, and writes their best moves to a book for the game to open with
+   --book. */
+
+#include "../main/board.h"
+#include "../main/common.h"
+#include "../main/book.h"
+#include "../main/search.h"
+#include "../main/settings.h"
+
+#include <stdio.h>
+#include <string.h>
+
+
+/* Moves played in the deepest positions in the book, plus one. */
+#define DEFAULT_DEPTH 3ul
+
+/* Time limit for the search of each position. */
+#define DEFAULT_SECONDS 10ul
+
+
+/* Prints the command line usage to stderr. */
+void printUsage(void)
+{
+    fprintf(stderr, "Usage: tictactoe_book <settings_file_path> <output_file> "
+        "[--depth <moves>] [--seconds <seconds>]\n");
+    fprintf(stderr, "Positions with fewer than --depth moves played (default "
+        "%lu) are searched for --seconds each (default %lu). The number of "
+        "positions grows by about the number of cells for each move.\n",
+        DEFAULT_DEPTH, DEFAULT_SECONDS);
+}
+
+
+/* Parses the options after the output file path. */
+int parseOptions(int argc, char* argv[], unsigned long* depth,
+    SearchLimits* limits)
+{
+    unsigned long value = 0;
+    int res = 1;
+    int i = 3;
+
+    while (res && i < argc)
+    {
+        if (i + 1 >= argc)
+        {
+            res = 0;
+        }
+        else if (strcmp(argv[i], "--depth") == 0)
+        {
+            res = parseCount(argv[i + 1], depth, 0);
+            i += 2;
+        }
+        else if (strcmp(argv[i], "--seconds") == 0)
+        {
+            res = parseCount(argv[i + 1], &value, 0);
+            limits->softSeconds = value;
+            limits->maxSeconds = value;
+            i += 2;
+        }
+        else
+        {
+            res = 0;
+        }
+    }
+
+    return res;
+}
+
+
+int main(int argc, char* argv[])
+{
+    int error = 0;
+    unsigned long depth = DEFAULT_DEPTH;
+    SearchLimits limits = defaultSearchLimits();
+    Settings settings = zeroedSettings();
+    OpeningBook book = zeroedOpeningBook();
+    FILE* file = NULL;
+
+    limits.softSeconds = DEFAULT_SECONDS;
+    limits.maxSeconds = DEFAULT_SECONDS;
+
+    if (argc < 3 || !parseOptions(argc, argv, &depth, &limits))
+    {
+        printUsage();
+        error = 1;
+    }
+
+    if (!error)
+    {
+        settings = readSettings(argv[1], &error);
+    }
+
+    if (!error)
+    {
+        error = !validateSettings(&settings, 0);
+    }
+
+    if (!error)
+    {
+        /* No position has more moves played than there are cells. */
+        if (depth > (unsigned long)settings.m * settings.n)
+        {
+            depth = (unsigned long)settings.m * settings.n;
+        }
+        book = buildOpeningBook(settings.n, settings.m, settings.k, depth,
+            limits, 1);
+        printf("%lu positions in the book.\n", (unsigned long)book.count);
+
+        file = fopen(argv[2], "wb");
+        if (file)
+        {
+            writeOpeningBook(file, &book);
+            if (ferror(file))
+            {
+                perror("Error writing to book file");
+                error = 1;
+            }
+            fclose(file);
+        }
+        else
+        {
+            perror("Error opening book file");
+            error = 1;
+        }
+
+        destroyOpeningBook(&book);
+    }
+
+    return error;
+}
@@ -0,0 +1,112 @@
+/* Game log converter entry point. Converts game logs saved by the game
+   between the text format and the compact binary formats of --log-format, in
+   either direction. */
+
+#include "../main/log.h"
+#include "../main/settings.h"
+
+#include <stdio.h>
+#include <string.h>
+
+
+/* Names of each LogFormat. */
+static char const* const LOG_FORMAT_NAMES[] = {"text", "binary", "delta"};
+
+
+/* Prints the command line usage to stderr. */
+void printUsage(void)
+{
+    fprintf(stderr, "Usage: tictactoe_logconv <input_file> <output_file> "
+        "[--format text|binary|delta]\n");
+    fprintf(stderr, "The input may be in any format. The output defaults to "
+        "text for binary input, and binary for text input. Text logs' time "
+        "control settings aren't kept in binary ones.\n");
+}
+
+
+int main(int argc, char* argv[])
+{
+    int error = 0;
+    int formatGiven = 0;
+    Settings settings = zeroedSettings();
+    LogFormat inputFormat = LOG_FORMAT_TEXT;
+    FILE* file = NULL;
+    long inputSize = 0;
+
+    if (argc == 5 && strcmp(argv[3], "--format") == 0)
+    {
+        error = !parseLogFormat(argv[4], &settings.logFormat);
+        formatGiven = 1;
+    }
+    else if (argc != 3)
+    {
+        error = 1;
+    }
+    if (error)
+    {
+        printUsage();
+    }
+
+    if (!error)
+    {
+        file = fopen(argv[1], "rb");
+        if (file)
+        {
+            error = !readGameLogs(file, &settings.m, &settings.n, &settings.k,
+                &inputFormat);
+            if (error)
+            {
+                fprintf(stderr, "Error: \"%s\" is not a valid game log.\n",
+                    argv[1]);
+            }
+            inputSize = ftell(file);
+            fclose(file);
+        }
+        else
+        {
+            perror("Error opening input file");
+            error = 1;
+        }
+    }
+
+    if (!error)
+    {
+        if (!formatGiven)
+        {
+            settings.logFormat = inputFormat == LOG_FORMAT_TEXT
+                ? LOG_FORMAT_BINARY : LOG_FORMAT_TEXT;
+        }
+
+        file = fopen(argv[2],
+            settings.logFormat == LOG_FORMAT_TEXT ? "w" : "wb");
+        if (file)
+        {
+            if (!writeLogs(file, &settings))
+            {
+                error = 1;
+            }
+            else if (ferror(file))
+            {
+                perror("Error writing to output file");
+                error = 1;
+            }
+            else
+            {
+                printf("Converted %lu games from %s (%ld bytes) to %s (%ld "
+                    "bytes).\n", countGameLogs(),
+                    LOG_FORMAT_NAMES[inputFormat], inputSize,
+                    LOG_FORMAT_NAMES[settings.logFormat], ftell(file));
+            }
+            fclose(file);
+        }
+        else
+        {
+            perror("Error opening output file");
+            error = 1;
+        }
+    }
+
+    freeGameLogs();
+
+    return error;
+}
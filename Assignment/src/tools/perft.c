@@ -0,0 +1,201 @@
+/* Perft tool entry point. Counts the move sequences, and optionally the
+   distinct positions, of each length up to a depth from the empty board of a
+   settings file, for comparing board backends against each other and known
+   results, and as a benchmark of making and undoing moves. */
+
+#include "../main/board.h"
+#include "../main/common.h"
+#include "../main/perft.h"
+#include "../main/settings.h"
+#include "../main/threads.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* Command line options, other than the settings file and depth. */
+typedef struct
+{
+    unsigned long depth;
+    int unique;                 /* Whether to count distinct positions. */
+    int divide;                 /* Whether to count each first move's
+                                   sequences. */
+    unsigned long threads;
+    BoardBackend backend;
+    int backendGiven;           /* Whether backend was set, rather than left
+                                   to createGameBoard(). */
+} Arguments;
+
+
+/* Prints the command line usage to stderr. */
+void printUsage(void)
+{
+    fprintf(stderr, "Usage: tictactoe_perft <settings_file_path> <depth> "
+        "[--unique] [--divide] [--threads <count>] "
+        "[--backend array|bitboard|sparse]\n");
+    fprintf(stderr, "Counts the move sequences of each length up to depth "
+        "from the empty board. --unique also counts the distinct positions "
+        "reached, reusing the counts of positions reached again. --divide "
+        "shows how many sequences of the full depth start with each move. "
+        "Threads default to one per processor.\n");
+}
+
+
+/* Parses the name of a board backend.
+   If it's invalid, prints an error to stderr and returns 0. */
+int parseBackend(char const* arg, BoardBackend* backend)
+{
+    int res = 1;
+
+    if (strcmp(arg, "array") == 0)
+    {
+        *backend = BOARD_BACKEND_ARRAY;
+    }
+    else if (strcmp(arg, "bitboard") == 0)
+    {
+        *backend = BOARD_BACKEND_BITBOARD;
+    }
+    else if (strcmp(arg, "sparse") == 0)
+    {
+        *backend = BOARD_BACKEND_SPARSE;
+    }
+    else
+    {
+        fprintf(stderr, "Error: unknown board backend \"%s\".\n", arg);
+        res = 0;
+    }
+
+    return res;
+}
+
+
+/* Parses the options after the settings file path. */
+int parseOptions(int argc, char* argv[], Arguments* args)
+{
+    int res = argc >= 3 && parseCount(argv[2], &args->depth, 0);
+    int i = 3;
+
+    while (res && i < argc)
+    {
+        if (strcmp(argv[i], "--unique") == 0)
+        {
+            args->unique = 1;
+            ++i;
+        }
+        else if (strcmp(argv[i], "--divide") == 0)
+        {
+            args->divide = 1;
+            ++i;
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            res = parseCount(argv[i + 1], &args->threads, 0)
+                && args->threads <= 4096u;
+            i += 2;
+        }
+        else if (strcmp(argv[i], "--backend") == 0 && i + 1 < argc)
+        {
+            res = parseBackend(argv[i + 1], &args->backend);
+            args->backendGiven = 1;
+            i += 2;
+        }
+        else
+        {
+            res = 0;
+        }
+    }
+
+    return res;
+}
+
+
+/* Prints the sequences of the full depth starting with each first move. */
+void printDivide(GameBoard const* board, Arguments const* args)
+{
+    unsigned long const cells = (unsigned long)board->rows * board->columns;
+    unsigned long* counts = malloc(cells * sizeof(unsigned long));
+    unsigned long i = 0;
+
+    dividePerft(board, args->depth, args->threads, counts);
+    printf("\nSequences of depth %lu by first move:\n", args->depth);
+    for (i = 0; i < cells; ++i)
+    {
+        if (counts[i] > 0)
+        {
+            printf("%lu,%lu: %lu\n", i % board->columns, i / board->columns,
+                counts[i]);
+        }
+    }
+
+    free(counts);
+}
+
+
+int main(int argc, char* argv[])
+{
+    int error = 0;
+    Arguments args;
+    Settings settings = zeroedSettings();
+    GameBoard board = zeroedGameBoard();
+    PerftResult result;
+    unsigned long depth = 0;
+
+    args.depth = 0;
+    args.unique = 0;
+    args.divide = 0;
+    args.threads = processorCount();
+    args.backend = BOARD_BACKEND_ARRAY;
+    args.backendGiven = 0;
+
+    if (!parseOptions(argc, argv, &args))
+    {
+        printUsage();
+        error = 1;
+    }
+
+    if (!error)
+    {
+        settings = readSettings(argv[1], &error);
+    }
+
+    if (!error)
+    {
+        error = !validateSettings(&settings, 0);
+    }
+
+    if (!error)
+    {
+        board = args.backendGiven
+            ? createGameBoardWithBackend(settings.n, settings.m, settings.k,
+                args.backend)
+            : createGameBoard(settings.n, settings.m, settings.k);
+
+        printf("%5s %20s %20s %20s %10s %14s\n", "Depth", "Sequences",
+            "Unique positions", "Moves made", "Seconds", "Moves/s");
+        for (depth = 1; depth <= args.depth; ++depth)
+        {
+            result = runPerft(&board, depth, args.unique, args.threads);
+            printf("%5lu %20lu ", depth, result.sequences);
+            if (args.unique)
+            {
+                printf("%20lu ", result.uniquePositions);
+            }
+            else
+            {
+                printf("%20s ", "-");
+            }
+            printf("%20lu %10.3f %14.0f\n", result.moves, result.seconds,
+                result.seconds > 0.0 ? result.moves / result.seconds : 0.0);
+        }
+
+        if (args.divide)
+        {
+            printDivide(&board, &args);
+        }
+
+        destroyGameBoard(&board);
+    }
+
+    return error;
+}
@@ -0,0 +1,154 @@
+/* Proof-number solver entry point. Proves or disproves that the first player
+   can force a win with the given settings, checkpointing long runs so they
+   can resume after an interruption. */
+
+#include "../main/common.h"
+#include "../main/dfpn.h"
+#include "../main/settings.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+
+
+/* Set by the signal handler to stop the search and save a checkpoint. */
+static volatile sig_atomic_t stopRequested = 0;
+
+
+/* Stops the search on SIGINT or SIGTERM. */
+void requestStop(int _)
+{
+    stopRequested = 1;
+}
+
+
+/* Prints the command line usage to stderr. */
+void printUsage(void)
+{
+    fprintf(stderr, "Usage: tictactoe_prove <settings_file_path> "
+        "[--table-mb <size>] [--checkpoint <file>] [--interval <seconds>] "
+        "[--resume] [--progress <seconds>]\n");
+    fprintf(stderr, "The table defaults to 64MB. Checkpoints are saved every "
+        "600 seconds by default, and on SIGINT or SIGTERM. Progress is "
+        "reported to stderr every 10 seconds by default, or never if 0.\n");
+}
+
+
+/* Parses the options after the settings file path. */
+int parseOptions(int argc, char* argv[], DfpnOptions* options)
+{
+    unsigned long value = 0;
+    int res = 1;
+    int i = 2;
+
+    while (res && i < argc)
+    {
+        if (strcmp(argv[i], "--resume") == 0)
+        {
+            options->resume = 1;
+            i += 1;
+        }
+        else if (i + 1 >= argc)
+        {
+            res = 0;
+        }
+        else if (strcmp(argv[i], "--table-mb") == 0)
+        {
+            res = parseCount(argv[i + 1], &value, 1) && value > 0
+                && value <= ((size_t)-1 >> 20);
+            options->tableBytes = (size_t)value << 20;
+            i += 2;
+        }
+        else if (strcmp(argv[i], "--checkpoint") == 0)
+        {
+            options->checkpointPath = argv[i + 1];
+            i += 2;
+        }
+        else if (strcmp(argv[i], "--interval") == 0)
+        {
+            res = parseCount(argv[i + 1], &value, 1) && value > 0;
+            options->checkpointSeconds = value;
+            i += 2;
+        }
+        else if (strcmp(argv[i], "--progress") == 0)
+        {
+            res = parseCount(argv[i + 1], &value, 1);
+            options->progressSeconds = value;
+            i += 2;
+        }
+        else
+        {
+            res = 0;
+        }
+    }
+
+    /* Resuming needs a checkpoint to resume from. */
+    if (options->resume && !options->checkpointPath)
+    {
+        res = 0;
+    }
+
+    return res;
+}
+
+
+int main(int argc, char* argv[])
+{
+    int error = 0;
+    Settings settings = zeroedSettings();
+    DfpnOptions options = defaultDfpnOptions();
+    DfpnResult result;
+
+    options.progressSeconds = 10.0;
+    options.stop = &stopRequested;
+
+    if (argc < 2 || !parseOptions(argc, argv, &options))
+    {
+        printUsage();
+        error = 1;
+    }
+
+    if (!error)
+    {
+        settings = readSettings(argv[1], &error);
+    }
+
+    if (!error)
+    {
+        error = !validateSettings(&settings, 0);
+    }
+
+    if (!error && settings.n > DFPN_MAX_CELLS / settings.m)
+    {
+        fprintf(stderr, "Error: board too big to solve, the most cells is "
+            "%u.\n", DFPN_MAX_CELLS);
+        error = 1;
+    }
+
+    if (!error)
+    {
+        signal(SIGINT, requestStop);
+        signal(SIGTERM, requestStop);
+
+        result = proveFirstPlayerWin(settings.n, settings.m, settings.k,
+            &options);
+        error = result.error;
+
+        printf("Result: ");
+        switch (result.outcome)
+        {
+            case DFPN_PROVEN:
+                printf("X can force a win.\n");
+                break;
+            case DFPN_DISPROVEN:
+                printf("X can't force a win (O can force a draw or win).\n");
+                break;
+            default:
+                printf("unknown, stopped early.\n");
+        }
+        printf("%lu nodes in %.1fs, table %.1f%% full.\n", result.nodes,
+            result.seconds, 100.0 * result.tableFill);
+    }
+
+    return error;
+}
@@ -0,0 +1,98 @@
+/* Offline solver entry point. Writes a solved-position database for the given
+   board settings, for the game to open with --solved. */
+
+#include "../main/board.h"
+#include "../main/solved_db.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+/* Parses a positive whole number command line argument.
+   If it's invalid, prints an error to stderr and returns 0. */
+int parseSetting(char const* arg, unsigned* value)
+{
+    int res = 0;
+    char* end = NULL;
+    unsigned long parsed = 0;
+
+    errno = 0;
+    parsed = strtoul(arg, &end, 10);
+    res = errno == 0 && *end == '\0' && arg[0] >= '1' && arg[0] <= '9'
+        && parsed <= SOLVED_DB_MAX_CELLS;
+    if (res)
+    {
+        *value = parsed;
+    }
+    else
+    {
+        fprintf(stderr, "Error: invalid setting \"%s\".\n", arg);
+    }
+
+    return res;
+}
+
+
+int main(int argc, char* argv[])
+{
+    unsigned m = 0;
+    unsigned n = 0;
+    unsigned k = 0;
+    int error = 0;
+    FILE* file = NULL;
+    SolvedDatabase database = zeroedSolvedDatabase();
+    GameBoard board = zeroedGameBoard();
+
+    if (argc != 5)
+    {
+        fprintf(stderr, "Usage: tictactoe_solve <m> <n> <k> <output_file>\n");
+        fprintf(stderr, "Boards may have at most %u cells.\n",
+            SOLVED_DB_MAX_CELLS);
+        error = 1;
+    }
+    else
+    {
+        error = !parseSetting(argv[1], &m) || !parseSetting(argv[2], &n)
+            || !parseSetting(argv[3], &k);
+    }
+
+    if (!error && m * n > SOLVED_DB_MAX_CELLS)
+    {
+        fprintf(stderr, "Error: boards may have at most %u cells.\n",
+            SOLVED_DB_MAX_CELLS);
+        error = 1;
+    }
+
+    if (!error)
+    {
+        database = solveDatabase(n, m, k, 1);
+
+        board = createGameBoard(n, m, k);
+        printf("Value of the empty board for X: ");
+        writeSolvedValue(stdout, lookupSolvedPosition(&database, &board));
+        printf(".\n");
+        destroyGameBoard(&board);
+
+        file = fopen(argv[4], "wb");
+        if (file)
+        {
+            writeSolvedDatabase(file, &database);
+            if (ferror(file))
+            {
+                perror("Error writing to database file");
+                error = 1;
+            }
+            fclose(file);
+        }
+        else
+        {
+            perror("Error opening database file");
+            error = 1;
+        }
+
+        destroySolvedDatabase(&database);
+    }
+
+    return error;
+}